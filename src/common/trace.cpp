@@ -0,0 +1,366 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "common/config.h"
+#include "trace.h"
+#include "thread/threads.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace love
+{
+namespace trace
+{
+
+std::atomic<bool> enabled(false);
+
+// Events are 24 bytes, so about 1.5 MB per thread which records events.
+static const uint64 MAX_THREAD_EVENTS = 64 * 1024;
+
+// GPU zones are only added a few dozen times per frame.
+static const size_t MAX_GPU_ZONES = 16 * 1024;
+
+struct Event
+{
+	const char *name;
+	int64 time;
+	bool begin;
+};
+
+// A ring buffer slot. toJSON reads slots while the owning thread may be
+// writing them, so each field is atomic. Slots overwritten during the copy
+// are discarded afterwards.
+struct EventSlot
+{
+	std::atomic<const char *> name;
+	std::atomic<int64> time;
+	std::atomic<bool> begin;
+};
+
+struct GPUZone
+{
+	const char *name;
+	int64 begin;
+	int64 end;
+};
+
+struct ThreadBuffer
+{
+	uint32 id = 0;
+	std::string name;
+	bool active = true;
+	std::unique_ptr<EventSlot[]> events;
+
+	// Only written by the thread which owns the buffer.
+	std::atomic<uint64> written;
+	std::atomic<uint32> session;
+
+	ThreadBuffer()
+		: written(0)
+		, session(0)
+	{}
+};
+
+struct State
+{
+	thread::MutexRef mutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+	std::unordered_set<std::string> names;
+
+	// Oldest first, protected by the mutex.
+	std::deque<GPUZone> gpuZones;
+
+	std::atomic<uint32> session;
+	std::atomic<int64> epoch;
+
+	State()
+		: session(0)
+		, epoch(0)
+	{}
+};
+
+// Never destroyed, since threads may still record events while the program
+// shuts down.
+static State *state = new State();
+
+struct ThreadBufferRef
+{
+	ThreadBuffer *buffer = nullptr;
+	std::string name;
+
+	~ThreadBufferRef()
+	{
+		// Let another thread reuse the buffer once its events are stale.
+		if (buffer != nullptr)
+		{
+			thread::Lock lock(state->mutex);
+			buffer->active = false;
+		}
+	}
+};
+
+static thread_local ThreadBufferRef threadBuffer;
+
+static int64 getClockTime()
+{
+	auto now = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+static ThreadBuffer *getThreadBuffer()
+{
+	if (threadBuffer.buffer != nullptr)
+		return threadBuffer.buffer;
+
+	thread::Lock lock(state->mutex);
+
+	uint32 session = state->session.load(std::memory_order_acquire);
+	ThreadBuffer *buffer = nullptr;
+
+	for (const auto &b : state->buffers)
+	{
+		if (!b->active && b->session.load(std::memory_order_relaxed) != session)
+		{
+			buffer = b.get();
+			break;
+		}
+	}
+
+	if (buffer == nullptr)
+	{
+		buffer = new ThreadBuffer();
+		buffer->id = (uint32) state->buffers.size() + 1;
+		buffer->events.reset(new EventSlot[MAX_THREAD_EVENTS]);
+		state->buffers.emplace_back(buffer);
+	}
+
+	buffer->active = true;
+	buffer->name = threadBuffer.name;
+	if (buffer->name.empty())
+		buffer->name = "Thread " + std::to_string(buffer->id);
+
+	threadBuffer.buffer = buffer;
+	return buffer;
+}
+
+static void record(const char *name, bool begin)
+{
+	ThreadBuffer *buffer = getThreadBuffer();
+
+	uint32 session = state->session.load(std::memory_order_acquire);
+	if (buffer->session.load(std::memory_order_relaxed) != session)
+	{
+		buffer->written.store(0, std::memory_order_relaxed);
+		buffer->session.store(session, std::memory_order_release);
+	}
+
+	uint64 index = buffer->written.load(std::memory_order_relaxed);
+
+	// Makes the previous count visible to toJSON before this slot changes.
+	std::atomic_thread_fence(std::memory_order_release);
+
+	EventSlot &e = buffer->events[index % MAX_THREAD_EVENTS];
+	e.name.store(name, std::memory_order_relaxed);
+	e.time.store(getTime(), std::memory_order_relaxed);
+	e.begin.store(begin, std::memory_order_relaxed);
+
+	buffer->written.store(index + 1, std::memory_order_release);
+}
+
+void setEnabled(bool enable)
+{
+	if (enable && !isEnabled())
+	{
+		{
+			thread::Lock lock(state->mutex);
+			state->gpuZones.clear();
+		}
+
+		state->epoch.store(getClockTime(), std::memory_order_relaxed);
+		state->session.fetch_add(1, std::memory_order_acq_rel);
+	}
+
+	enabled.store(enable, std::memory_order_relaxed);
+}
+
+void setThreadName(const char *name)
+{
+	threadBuffer.name = name != nullptr ? name : "";
+
+	if (threadBuffer.buffer != nullptr && name != nullptr)
+	{
+		thread::Lock lock(state->mutex);
+		threadBuffer.buffer->name = name;
+	}
+}
+
+void beginZone(const char *name)
+{
+	record(name, true);
+}
+
+void endZone()
+{
+	record(nullptr, false);
+}
+
+const char *intern(const std::string &name)
+{
+	thread::Lock lock(state->mutex);
+	return state->names.insert(name).first->c_str();
+}
+
+int64 getTime()
+{
+	return getClockTime() - state->epoch.load(std::memory_order_relaxed);
+}
+
+void addGPUZone(const std::string &name, int64 begin, int64 end)
+{
+	thread::Lock lock(state->mutex);
+
+	if (state->gpuZones.size() >= MAX_GPU_ZONES)
+		state->gpuZones.pop_front();
+
+	const char *interned = state->names.insert(name).first->c_str();
+	state->gpuZones.push_back({interned, begin, std::max(begin, end)});
+}
+
+static void appendEscaped(std::string &out, const char *str)
+{
+	for (const char *c = str; *c != '\0'; c++)
+	{
+		if (*c == '"' || *c == '\\')
+		{
+			out += '\\';
+			out += *c;
+		}
+		else if ((unsigned char) *c < 0x20)
+		{
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int) *c);
+			out += escaped;
+		}
+		else
+			out += *c;
+	}
+}
+
+std::string toJSON()
+{
+	thread::Lock lock(state->mutex);
+
+	uint32 session = state->session.load(std::memory_order_acquire);
+
+	std::string out = "{\"traceEvents\":[";
+	bool first = true;
+
+	std::vector<Event> events;
+
+	for (const auto &buffer : state->buffers)
+	{
+		if (buffer->session.load(std::memory_order_acquire) != session)
+			continue;
+
+		uint64 end = buffer->written.load(std::memory_order_acquire);
+		uint64 start = end > MAX_THREAD_EVENTS ? end - MAX_THREAD_EVENTS : 0;
+
+		events.clear();
+		for (uint64 i = start; i < end; i++)
+		{
+			const EventSlot &slot = buffer->events[i % MAX_THREAD_EVENTS];
+			Event e;
+			e.name = slot.name.load(std::memory_order_relaxed);
+			e.time = slot.time.load(std::memory_order_relaxed);
+			e.begin = slot.begin.load(std::memory_order_relaxed);
+			events.push_back(e);
+		}
+
+		// The owning thread may have overwritten the oldest events while we
+		// were copying them, including the slot of the event it's writing
+		// now, which isn't counted in written yet.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		uint64 written = buffer->written.load(std::memory_order_relaxed) + 1;
+		size_t skip = 0;
+		if (written > MAX_THREAD_EVENTS && written - MAX_THREAD_EVENTS > start)
+			skip = (size_t) std::min<uint64>(written - MAX_THREAD_EVENTS - start, events.size());
+
+		char header[128];
+
+		if (!first)
+			out += ",";
+		first = false;
+
+		snprintf(header, sizeof(header), "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"", buffer->id);
+		out += header;
+		appendEscaped(out, buffer->name.c_str());
+		out += "\"}}";
+
+		for (size_t i = skip; i < events.size(); i++)
+		{
+			const Event &e = events[i];
+
+			snprintf(header, sizeof(header), ",{\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f",
+			         e.begin ? "B" : "E", buffer->id, e.time / 1000.0);
+			out += header;
+
+			if (e.name != nullptr)
+			{
+				out += ",\"name\":\"";
+				appendEscaped(out, e.name);
+				out += "\"";
+			}
+
+			out += "}";
+		}
+	}
+
+	if (!state->gpuZones.empty())
+	{
+		char header[128];
+
+		if (!first)
+			out += ",";
+
+		// Thread IDs start at 1, so the GPU track uses 0.
+		out += "{\"ph\":\"M\",\"pid\":1,\"tid\":0,\"name\":\"thread_name\",\"args\":{\"name\":\"GPU\"}}";
+
+		for (const GPUZone &zone : state->gpuZones)
+		{
+			snprintf(header, sizeof(header), ",{\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,\"name\":\"",
+			         zone.begin / 1000.0, (zone.end - zone.begin) / 1000.0);
+			out += header;
+			appendEscaped(out, zone.name);
+			out += "\"}";
+		}
+	}
+
+	out += "],\"displayTimeUnit\":\"ms\"}";
+	return out;
+}
+
+} // trace
+} // love
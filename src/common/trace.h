@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+#include "int.h"
+
+#include <atomic>
+#include <string>
+
+namespace love
+{
+namespace trace
+{
+
+// Opt-in CPU/GPU timeline tracing. Each thread records begin/end events into
+// its own fixed-size ring buffer without locking, so only the most recent
+// events of each thread are kept. GPU work measured with timestamp queries is
+// added to a separate track. Recorded events can be exported in the Chrome
+// trace event format, which chrome://tracing and Perfetto can both open.
+
+extern std::atomic<bool> enabled;
+
+inline bool isEnabled()
+{
+	return enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * Starts or stops recording. Starting a new recording discards any events
+ * from the previous one.
+ **/
+void setEnabled(bool enable);
+
+/**
+ * Sets the name of the calling thread, as shown in exported traces.
+ **/
+void setThreadName(const char *name);
+
+/**
+ * Zone names are not copied, they must remain valid for the lifetime of the
+ * program. Use intern() for names which aren't string literals.
+ **/
+void beginZone(const char *name);
+void endZone();
+
+const char *intern(const std::string &name);
+
+/**
+ * Nanoseconds since recording started.
+ **/
+int64 getTime();
+
+/**
+ * Adds a zone to the GPU track. Times are in nanoseconds, on the same clock
+ * as getTime. The name is copied.
+ **/
+void addGPUZone(const std::string &name, int64 begin, int64 end);
+
+/**
+ * Returns the recorded events of every thread as Chrome trace event JSON.
+ **/
+std::string toJSON();
+
+class Zone
+{
+public:
+
+	Zone(const char *name)
+		: active(isEnabled())
+	{
+		if (active)
+			beginZone(name);
+	}
+
+	~Zone()
+	{
+		if (active)
+			endZone();
+	}
+
+private:
+
+	bool active;
+
+}; // Zone
+
+} // trace
+} // love
+
+#define LOVE_TRACE_CONCAT_(a, b) a##b
+#define LOVE_TRACE_CONCAT(a, b) LOVE_TRACE_CONCAT_(a, b)
+#define LOVE_TRACE_ZONE(name) love::trace::Zone LOVE_TRACE_CONCAT(love_trace_zone_, __LINE__)(name)
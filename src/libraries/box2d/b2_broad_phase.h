@@ -27,6 +27,7 @@
 #include "b2_settings.h"
 #include "b2_collision.h"
 #include "b2_dynamic_tree.h"
+#include "b2_world_callbacks.h"
 
 struct B2_API b2Pair
 {
@@ -69,6 +70,9 @@ class B2_API b2BroadPhase
 	/// Get user data from a proxy. Returns nullptr if the id is invalid.
 	void* GetUserData(int32 proxyId) const;
 
+	/// LOVE: Does the id refer to an existing proxy?
+	bool IsProxy(int32 proxyId) const;
+
 	/// Test overlap of fat AABBs.
 	bool TestOverlap(int32 proxyIdA, int32 proxyIdB) const;
 
@@ -77,7 +81,7 @@ class B2_API b2BroadPhase
 
 	/// Update the pairs. This results in pair callbacks. This can only add pairs.
 	template <typename T>
-	void UpdatePairs(T* callback);
+	void UpdatePairs(T* callback, b2TaskExecutor* executor = nullptr);
 
 	/// Query an AABB for overlapping proxies. The callback class
 	/// is called for each proxy that overlaps the supplied AABB.
@@ -108,6 +112,16 @@ class B2_API b2BroadPhase
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// LOVE: Get the size in bytes of the state written by SaveState.
+	int32 GetStateSize() const;
+
+	/// LOVE: Save the tree and the move buffer.
+	void SaveState(void* data) const;
+
+	/// LOVE: Restore a state written by SaveState, for the same set of proxies.
+	/// @return the number of bytes read, or 0 if the data doesn't match.
+	int32 RestoreState(const void* data, int32 size);
+
 private:
 
 	friend class b2DynamicTree;
@@ -117,6 +131,12 @@ class B2_API b2BroadPhase
 
 	bool QueryCallback(int32 proxyId);
 
+	// LOVE: Query the tree for all moved proxies on multiple threads. Pairs
+	// end up in the same order as when querying serially.
+	void QueryMovedParallel(b2TaskExecutor* executor);
+
+	friend class b2BroadPhaseQueryTask;
+
 	b2DynamicTree m_tree;
 
 	int32 m_proxyCount;
@@ -137,6 +157,11 @@ inline void* b2BroadPhase::GetUserData(int32 proxyId) const
 	return m_tree.GetUserData(proxyId);
 }
 
+inline bool b2BroadPhase::IsProxy(int32 proxyId) const
+{
+	return m_tree.IsProxy(proxyId);
+}
+
 inline bool b2BroadPhase::TestOverlap(int32 proxyIdA, int32 proxyIdB) const
 {
 	const b2AABB& aabbA = m_tree.GetFatAABB(proxyIdA);
@@ -170,26 +195,33 @@ inline float b2BroadPhase::GetTreeQuality() const
 }
 
 template <typename T>
-void b2BroadPhase::UpdatePairs(T* callback)
+void b2BroadPhase::UpdatePairs(T* callback, b2TaskExecutor* executor)
 {
 	// Reset pair buffer
 	m_pairCount = 0;
 
-	// Perform tree queries for all moving proxies.
-	for (int32 i = 0; i < m_moveCount; ++i)
+	if (executor != nullptr && executor->GetThreadCount() > 1)
+	{
+		QueryMovedParallel(executor);
+	}
+	else
 	{
-		m_queryProxyId = m_moveBuffer[i];
-		if (m_queryProxyId == e_nullProxy)
+		// Perform tree queries for all moving proxies.
+		for (int32 i = 0; i < m_moveCount; ++i)
 		{
-			continue;
+			m_queryProxyId = m_moveBuffer[i];
+			if (m_queryProxyId == e_nullProxy)
+			{
+				continue;
+			}
+
+			// We have to query the tree with the fat AABB so that
+			// we don't fail to create a pair that may touch later.
+			const b2AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
+
+			// Query tree, create pairs and add them pair buffer.
+			m_tree.Query(this, fatAABB);
 		}
-
-		// We have to query the tree with the fat AABB so that
-		// we don't fail to create a pair that may touch later.
-		const b2AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
-
-		// Query tree, create pairs and add them pair buffer.
-		m_tree.Query(this, fatAABB);
 	}
 
 	// Send pairs to caller
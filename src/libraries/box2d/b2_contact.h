@@ -167,6 +167,7 @@ class B2_API b2Contact
 
 protected:
 	friend class b2ContactManager;
+	friend class b2ContactUpdateTask;
 	friend class b2World;
 	friend class b2ContactSolver;
 	friend class b2Body;
@@ -210,6 +211,12 @@ class B2_API b2Contact
 
 	void Update(b2ContactListener* listener);
 
+	// LOVE: Update() split in two, so manifolds can be computed in parallel.
+	// UpdateManifold only modifies this contact, FinishUpdate wakes bodies and
+	// calls the listener.
+	bool UpdateManifold(b2Manifold* oldManifold);
+	void FinishUpdate(const b2Manifold* oldManifold, bool touching, b2ContactListener* listener);
+
 	static b2ContactRegister s_registers[b2Shape::e_typeCount][b2Shape::e_typeCount];
 	static bool s_initialized;
 
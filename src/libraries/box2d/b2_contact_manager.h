@@ -29,29 +29,56 @@
 class b2Contact;
 class b2ContactFilter;
 class b2ContactListener;
+class b2Fixture;
 class b2BlockAllocator;
+class b2TaskExecutor;
+struct b2Manifold;
 
 // Delegate of b2World.
 class B2_API b2ContactManager
 {
 public:
 	b2ContactManager();
+	~b2ContactManager();
 
 	// Broad-phase callback.
 	void AddPair(void* proxyUserDataA, void* proxyUserDataB);
 
 	void FindNewContacts();
 
+	// LOVE: Create a contact and link it to the world and bodies, without any
+	// filtering. Used by AddPair and when restoring world snapshots.
+	b2Contact* CreateContact(b2Fixture* fixtureA, int32 indexA, b2Fixture* fixtureB, int32 indexB);
+
 	void Destroy(b2Contact* c);
 
 	void Collide();
 
+	// LOVE: narrow phase with manifolds computed on the task executor.
+	void CollideParallel();
+
 	b2BroadPhase m_broadPhase;
 	b2Contact* m_contactList;
 	int32 m_contactCount;
 	b2ContactFilter* m_contactFilter;
 	b2ContactListener* m_contactListener;
 	b2BlockAllocator* m_allocator;
+
+	// LOVE: added for parallel stepping.
+	b2TaskExecutor* m_taskExecutor;
+
+private:
+
+	friend class b2ContactUpdateTask;
+
+	void ReserveCollideBuffers(int32 count);
+
+	b2Contact** m_collideContacts;
+	uint8* m_collideStates;
+	b2Contact** m_updateContacts;
+	b2Manifold* m_oldManifolds;
+	bool* m_touching;
+	int32 m_collideCapacity;
 };
 
 #endif
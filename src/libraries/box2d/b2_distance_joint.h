@@ -141,6 +141,10 @@ class B2_API b2DistanceJoint : public b2Joint
 	void SolveVelocityConstraints(const b2SolverData& data) override;
 	bool SolvePositionConstraints(const b2SolverData& data) override;
 
+	// LOVE: added for world snapshots.
+	int32 SaveState(float* state) const override;
+	void RestoreState(const float* state) override;
+
 	float m_stiffness;
 	float m_damping;
 	float m_bias;
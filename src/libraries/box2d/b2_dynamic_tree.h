@@ -93,6 +93,9 @@ class B2_API b2DynamicTree
 	bool WasMoved(int32 proxyId) const;
 	void ClearMoved(int32 proxyId);
 
+	/// LOVE: Does the id refer to a proxy in this tree?
+	bool IsProxy(int32 proxyId) const;
+
 	/// Get the fat AABB for a proxy.
 	const b2AABB& GetFatAABB(int32 proxyId) const;
 
@@ -133,6 +136,18 @@ class B2_API b2DynamicTree
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// LOVE: Get the size in bytes of the state written by SaveState.
+	int32 GetStateSize() const;
+
+	/// LOVE: Save the node pool, so the exact tree structure can be restored
+	/// later. Proxy user data is not saved.
+	void SaveState(void* data) const;
+
+	/// LOVE: Restore a node pool written by SaveState. The saved tree must have
+	/// its proxies at the same ids as this tree, which keep their user data.
+	/// @return the number of bytes read, or 0 if the data doesn't match this tree.
+	int32 RestoreState(const void* data, int32 size);
+
 private:
 
 	int32 AllocateNode();
@@ -172,6 +187,11 @@ inline bool b2DynamicTree::WasMoved(int32 proxyId) const
 	return m_nodes[proxyId].moved;
 }
 
+inline bool b2DynamicTree::IsProxy(int32 proxyId) const
+{
+	return 0 <= proxyId && proxyId < m_nodeCapacity && m_nodes[proxyId].height == 0;
+}
+
 inline void b2DynamicTree::ClearMoved(int32 proxyId)
 {
 	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
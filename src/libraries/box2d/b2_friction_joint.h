@@ -97,6 +97,10 @@ class B2_API b2FrictionJoint : public b2Joint
 	void SolveVelocityConstraints(const b2SolverData& data) override;
 	bool SolvePositionConstraints(const b2SolverData& data) override;
 
+	// LOVE: added for world snapshots.
+	int32 SaveState(float* state) const override;
+	void RestoreState(const float* state) override;
+
 	b2Vec2 m_localAnchorA;
 	b2Vec2 m_localAnchorB;
 
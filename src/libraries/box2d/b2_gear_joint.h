@@ -89,6 +89,10 @@ class B2_API b2GearJoint : public b2Joint
 	void SolveVelocityConstraints(const b2SolverData& data) override;
 	bool SolvePositionConstraints(const b2SolverData& data) override;
 
+	// LOVE: added for world snapshots.
+	int32 SaveState(float* state) const override;
+	void RestoreState(const float* state) override;
+
 	b2Joint* m_joint1;
 	b2Joint* m_joint2;
 
@@ -32,6 +32,9 @@ class b2Joint;
 struct b2SolverData;
 class b2BlockAllocator;
 
+// LOVE: size of the joint state saved in world snapshots.
+#define b2_maxJointStateFloats 6
+
 enum b2JointType
 {
 	e_unknownJoint,
@@ -174,6 +177,11 @@ class B2_API b2Joint
 	// This returns true if the position errors are within tolerance.
 	virtual bool SolvePositionConstraints(const b2SolverData& data) = 0;
 
+	// LOVE: warm starting impulses, for world snapshots. SaveState writes at
+	// most b2_maxJointStateFloats floats and returns how many it wrote.
+	virtual int32 SaveState(float* state) const { B2_NOT_USED(state); return 0; }
+	virtual void RestoreState(const float* state) { B2_NOT_USED(state); }
+
 	b2JointType m_type;
 	b2Joint* m_prev;
 	b2Joint* m_next;
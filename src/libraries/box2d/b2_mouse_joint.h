@@ -109,6 +109,10 @@ class B2_API b2MouseJoint : public b2Joint
 	void SolveVelocityConstraints(const b2SolverData& data) override;
 	bool SolvePositionConstraints(const b2SolverData& data) override;
 
+	// LOVE: added for world snapshots.
+	int32 SaveState(float* state) const override;
+	void RestoreState(const float* state) override;
+
 	b2Vec2 m_localAnchorB;
 	b2Vec2 m_targetA;
 	float m_stiffness;
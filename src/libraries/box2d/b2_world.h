@@ -66,6 +66,16 @@ class B2_API b2World
 	/// remain in scope.
 	void SetContactListener(b2ContactListener* listener);
 
+	/// LOVE: Register a task executor used to spread the broad-phase, narrow
+	/// phase and island solver over several threads. The results are identical
+	/// to a serial step, and all listener callbacks are still made from the
+	/// calling thread. Pass nullptr to step serially. The executor is owned by
+	/// you and must remain in scope.
+	void SetTaskExecutor(b2TaskExecutor* executor);
+
+	/// LOVE: Get the registered task executor, if any.
+	b2TaskExecutor* GetTaskExecutor() const;
+
 	/// Register a routine for debug drawing. The debug draw functions are called
 	/// inside with b2World::DebugDraw method. The debug draw object is owned
 	/// by you and must remain in scope.
@@ -210,6 +220,23 @@ class B2_API b2World
 	/// Get the current profile.
 	const b2Profile& GetProfile() const;
 
+	/// LOVE: Get the size in bytes of the snapshot written by SaveState.
+	int32 GetStateSize() const;
+
+	/// LOVE: Save the simulation state of all bodies, joints, contacts and the
+	/// broad-phase into data, which must hold GetStateSize() bytes. Stepping a
+	/// restored world gives the same results as stepping the saved one.
+	void SaveState(void* data) const;
+
+	/// LOVE: Restore a snapshot written by SaveState. Only snapshots of this
+	/// world are accepted, and only while it has the same bodies, fixtures and
+	/// joints as when it was saved: creating, destroying, enabling or disabling
+	/// any of them invalidates older snapshots. Contacts are recreated without
+	/// calling the contact listener.
+	/// @return false, leaving the world untouched, if the data doesn't match.
+	/// @warning this should be called outside of a time step.
+	bool RestoreState(const void* data, int32 size);
+
 	/// Dump the world into the log file.
 	/// @warning this should be called outside of a time step.
 	void Dump();
@@ -220,8 +247,11 @@ class B2_API b2World
 	friend class b2Fixture;
 	friend class b2ContactManager;
 	friend class b2Controller;
+	friend class b2IslandSolveTask;
 
 	void Solve(const b2TimeStep& step);
+	void SolveParallel(const b2TimeStep& step);
+	void SynchronizeFixtures();
 	void SolveTOI(const b2TimeStep& step);
 
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
@@ -259,6 +289,17 @@ class B2_API b2World
 	bool m_stepComplete;
 
 	b2Profile m_profile;
+
+	// LOVE: added for parallel stepping.
+	b2TaskExecutor* m_taskExecutor;
+	b2StackAllocator** m_threadAllocators;
+	b2Profile* m_threadProfiles;
+	int32 m_threadCount;
+
+	// LOVE: identify the world and its current set of bodies, fixtures and
+	// joints, so snapshots can't be restored onto a different one.
+	uint32 m_worldId;
+	uint32 m_topologyId;
 };
 
 inline b2Body* b2World::GetBodyList()
@@ -158,4 +158,34 @@ class B2_API b2RayCastCallback
 									const b2Vec2& normal, float fraction) = 0;
 };
 
+/// A unit of work which can be split over multiple threads. Execute is
+/// called for disjoint ranges covering [0, count), possibly concurrently.
+/// LOVE: added for parallel stepping.
+class B2_API b2Task
+{
+public:
+	virtual ~b2Task() {}
+
+	/// Process the items in [begin, end). threadIndex is in
+	/// [0, b2TaskExecutor::GetThreadCount()) and is never used by two
+	/// concurrent calls.
+	virtual void Execute(int32 begin, int32 end, int32 threadIndex) = 0;
+};
+
+/// Implement this to let the world spread parts of a time step over several
+/// threads. The results don't depend on how work is split or scheduled.
+/// LOVE: added for parallel stepping.
+class B2_API b2TaskExecutor
+{
+public:
+	virtual ~b2TaskExecutor() {}
+
+	/// The maximum number of threads a task may run on, including the caller.
+	virtual int32 GetThreadCount() const = 0;
+
+	/// Run the task over [0, count) and return once every item is done.
+	/// Ranges should be at least minRange items long.
+	virtual void ParallelFor(int32 count, int32 minRange, b2Task* task) = 0;
+};
+
 #endif
@@ -129,3 +129,194 @@ bool b2BroadPhase::QueryCallback(int32 proxyId)
 
 	return true;
 }
+
+// LOVE: Collects the pairs of one block of the move buffer.
+struct b2BroadPhaseBlock
+{
+	const b2DynamicTree* tree;
+	int32 queryProxyId;
+
+	b2Pair* pairs;
+	int32 pairCount;
+	int32 pairCapacity;
+
+	bool QueryCallback(int32 proxyId)
+	{
+		// Same as b2BroadPhase::QueryCallback, but with a buffer per block.
+		if (proxyId == queryProxyId)
+		{
+			return true;
+		}
+
+		const bool moved = tree->WasMoved(proxyId);
+		if (moved && proxyId > queryProxyId)
+		{
+			return true;
+		}
+
+		if (pairCount == pairCapacity)
+		{
+			b2Pair* oldBuffer = pairs;
+			pairCapacity = pairCapacity + (pairCapacity >> 1);
+			pairs = (b2Pair*)b2Alloc(pairCapacity * sizeof(b2Pair));
+			memcpy(pairs, oldBuffer, pairCount * sizeof(b2Pair));
+			b2Free(oldBuffer);
+		}
+
+		pairs[pairCount].proxyIdA = b2Min(proxyId, queryProxyId);
+		pairs[pairCount].proxyIdB = b2Max(proxyId, queryProxyId);
+		++pairCount;
+
+		return true;
+	}
+};
+
+class b2BroadPhaseQueryTask : public b2Task
+{
+public:
+	b2BroadPhase* broadPhase;
+	b2BroadPhaseBlock* blocks;
+	int32 blockSize;
+
+	void Execute(int32 begin, int32 end, int32 threadIndex) override
+	{
+		B2_NOT_USED(threadIndex);
+
+		for (int32 b = begin; b < end; ++b)
+		{
+			b2BroadPhaseBlock* block = blocks + b;
+			int32 first = b * blockSize;
+			int32 last = b2Min(first + blockSize, broadPhase->m_moveCount);
+
+			for (int32 i = first; i < last; ++i)
+			{
+				block->queryProxyId = broadPhase->m_moveBuffer[i];
+				if (block->queryProxyId == b2BroadPhase::e_nullProxy)
+				{
+					continue;
+				}
+
+				const b2AABB& fatAABB = broadPhase->m_tree.GetFatAABB(block->queryProxyId);
+				broadPhase->m_tree.Query(block, fatAABB);
+			}
+		}
+	}
+};
+
+void b2BroadPhase::QueryMovedParallel(b2TaskExecutor* executor)
+{
+	if (m_moveCount == 0)
+	{
+		return;
+	}
+
+	// Split the move buffer into a fixed number of blocks and concatenate
+	// their pairs in order, so the result doesn't depend on scheduling.
+	int32 blockCount = b2Min(m_moveCount, 4 * executor->GetThreadCount());
+	int32 blockSize = (m_moveCount + blockCount - 1) / blockCount;
+	blockCount = (m_moveCount + blockSize - 1) / blockSize;
+
+	b2BroadPhaseBlock* blocks = (b2BroadPhaseBlock*)b2Alloc(blockCount * sizeof(b2BroadPhaseBlock));
+	for (int32 b = 0; b < blockCount; ++b)
+	{
+		blocks[b].tree = &m_tree;
+		blocks[b].queryProxyId = e_nullProxy;
+		blocks[b].pairCapacity = 16;
+		blocks[b].pairCount = 0;
+		blocks[b].pairs = (b2Pair*)b2Alloc(blocks[b].pairCapacity * sizeof(b2Pair));
+	}
+
+	b2BroadPhaseQueryTask task;
+	task.broadPhase = this;
+	task.blocks = blocks;
+	task.blockSize = blockSize;
+	executor->ParallelFor(blockCount, 1, &task);
+
+	int32 total = 0;
+	for (int32 b = 0; b < blockCount; ++b)
+	{
+		total += blocks[b].pairCount;
+	}
+
+	if (total > m_pairCapacity)
+	{
+		b2Free(m_pairBuffer);
+		m_pairCapacity = total;
+		m_pairBuffer = (b2Pair*)b2Alloc(m_pairCapacity * sizeof(b2Pair));
+	}
+
+	m_pairCount = 0;
+	for (int32 b = 0; b < blockCount; ++b)
+	{
+		memcpy(m_pairBuffer + m_pairCount, blocks[b].pairs, blocks[b].pairCount * sizeof(b2Pair));
+		m_pairCount += blocks[b].pairCount;
+		b2Free(blocks[b].pairs);
+	}
+
+	b2Free(blocks);
+}
+
+int32 b2BroadPhase::GetStateSize() const
+{
+	return int32((1 + m_moveCount) * sizeof(int32)) + m_tree.GetStateSize();
+}
+
+void b2BroadPhase::SaveState(void* data) const
+{
+	uint8* out = (uint8*)data;
+	memcpy(out, &m_moveCount, sizeof(int32));
+	out += sizeof(int32);
+	memcpy(out, m_moveBuffer, m_moveCount * sizeof(int32));
+	out += m_moveCount * sizeof(int32);
+
+	m_tree.SaveState(out);
+}
+
+int32 b2BroadPhase::RestoreState(const void* data, int32 size)
+{
+	const uint8* in = (const uint8*)data;
+
+	if (size < int32(sizeof(int32)))
+	{
+		return 0;
+	}
+
+	int32 moveCount;
+	memcpy(&moveCount, in, sizeof(int32));
+	if (moveCount < 0 || moveCount > (size - int32(sizeof(int32))) / int32(sizeof(int32)))
+	{
+		return 0;
+	}
+
+	const uint8* moveBuffer = in + sizeof(int32);
+	int32 moveSize = int32((1 + moveCount) * sizeof(int32));
+
+	// Moved proxies must exist. The tree keeps the same proxies when restored.
+	for (int32 i = 0; i < moveCount; ++i)
+	{
+		int32 proxyId;
+		memcpy(&proxyId, moveBuffer + i * sizeof(int32), sizeof(int32));
+		if (proxyId != e_nullProxy && m_tree.IsProxy(proxyId) == false)
+		{
+			return 0;
+		}
+	}
+
+	int32 treeSize = m_tree.RestoreState(in + moveSize, size - moveSize);
+	if (treeSize == 0)
+	{
+		return 0;
+	}
+
+	if (moveCount > m_moveCapacity)
+	{
+		b2Free(m_moveBuffer);
+		m_moveCapacity = moveCount;
+		m_moveBuffer = (int32*)b2Alloc(m_moveCapacity * sizeof(int32));
+	}
+
+	m_moveCount = moveCount;
+	memcpy(m_moveBuffer, moveBuffer, moveCount * sizeof(int32));
+
+	return moveSize + treeSize;
+}
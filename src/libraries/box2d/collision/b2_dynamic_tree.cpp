@@ -799,3 +799,157 @@ void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
 		m_nodes[i].aabb.upperBound -= newOrigin;
 	}
 }
+
+// LOVE: the node pool, minus the user data, as saved in world snapshots.
+struct b2TreeState
+{
+	int32 root;
+	int32 nodeCount;
+	int32 nodeCapacity;
+	int32 freeList;
+	int32 insertionCount;
+};
+
+struct b2TreeNodeState
+{
+	b2AABB aabb;
+	int32 parent;
+	int32 child1;
+	int32 child2;
+	int32 height;
+	int32 moved;
+};
+
+int32 b2DynamicTree::GetStateSize() const
+{
+	return int32(sizeof(b2TreeState) + m_nodeCapacity * sizeof(b2TreeNodeState));
+}
+
+void b2DynamicTree::SaveState(void* data) const
+{
+	b2TreeState state;
+	state.root = m_root;
+	state.nodeCount = m_nodeCount;
+	state.nodeCapacity = m_nodeCapacity;
+	state.freeList = m_freeList;
+	state.insertionCount = m_insertionCount;
+
+	uint8* out = (uint8*)data;
+	memcpy(out, &state, sizeof(state));
+	out += sizeof(state);
+
+	for (int32 i = 0; i < m_nodeCapacity; ++i)
+	{
+		const b2TreeNode* node = m_nodes + i;
+
+		b2TreeNodeState nodeState;
+		nodeState.aabb = node->aabb;
+		nodeState.parent = node->parent;
+		nodeState.child1 = node->child1;
+		nodeState.child2 = node->child2;
+		nodeState.height = node->height;
+		nodeState.moved = node->moved ? 1 : 0;
+
+		memcpy(out, &nodeState, sizeof(nodeState));
+		out += sizeof(nodeState);
+	}
+}
+
+int32 b2DynamicTree::RestoreState(const void* data, int32 size)
+{
+	if (size < int32(sizeof(b2TreeState)))
+	{
+		return 0;
+	}
+
+	const uint8* in = (const uint8*)data;
+
+	b2TreeState state;
+	memcpy(&state, in, sizeof(state));
+	in += sizeof(state);
+
+	int32 capacity = state.nodeCapacity;
+	if (capacity <= 0 || capacity > (size - int32(sizeof(b2TreeState))) / int32(sizeof(b2TreeNodeState)))
+	{
+		return 0;
+	}
+
+	if (state.root < b2_nullNode || state.root >= capacity || state.freeList < b2_nullNode || state.freeList >= capacity)
+	{
+		return 0;
+	}
+
+	// Leaves are proxies, and must line up with the proxies of this tree.
+	int32 savedLeafCount = 0;
+	for (int32 i = 0; i < capacity; ++i)
+	{
+		b2TreeNodeState nodeState;
+		memcpy(&nodeState, in + i * sizeof(b2TreeNodeState), sizeof(nodeState));
+
+		if (nodeState.parent < b2_nullNode || nodeState.parent >= capacity
+			|| nodeState.child1 < b2_nullNode || nodeState.child1 >= capacity
+			|| nodeState.child2 < b2_nullNode || nodeState.child2 >= capacity)
+		{
+			return 0;
+		}
+
+		if (nodeState.height == 0)
+		{
+			if (i >= m_nodeCapacity || m_nodes[i].height != 0)
+			{
+				return 0;
+			}
+			++savedLeafCount;
+		}
+	}
+
+	int32 leafCount = 0;
+	for (int32 i = 0; i < m_nodeCapacity; ++i)
+	{
+		if (m_nodes[i].height == 0)
+		{
+			++leafCount;
+		}
+	}
+
+	if (leafCount != savedLeafCount)
+	{
+		return 0;
+	}
+
+	b2TreeNode* oldNodes = m_nodes;
+	if (capacity != m_nodeCapacity)
+	{
+		m_nodes = (b2TreeNode*)b2Alloc(capacity * sizeof(b2TreeNode));
+		memset(m_nodes, 0, capacity * sizeof(b2TreeNode));
+	}
+
+	for (int32 i = 0; i < capacity; ++i)
+	{
+		b2TreeNodeState nodeState;
+		memcpy(&nodeState, in, sizeof(nodeState));
+		in += sizeof(nodeState);
+
+		b2TreeNode* node = m_nodes + i;
+		node->userData = nodeState.height == 0 ? oldNodes[i].userData : nullptr;
+		node->aabb = nodeState.aabb;
+		node->parent = nodeState.parent;
+		node->child1 = nodeState.child1;
+		node->child2 = nodeState.child2;
+		node->height = nodeState.height;
+		node->moved = nodeState.moved != 0;
+	}
+
+	if (oldNodes != m_nodes)
+	{
+		b2Free(oldNodes);
+	}
+
+	m_root = state.root;
+	m_nodeCount = state.nodeCount;
+	m_nodeCapacity = capacity;
+	m_freeList = state.freeList;
+	m_insertionCount = state.insertionCount;
+
+	return int32(sizeof(b2TreeState) + capacity * sizeof(b2TreeNodeState));
+}
@@ -29,9 +29,10 @@
 
 #include <stdio.h>
 
-B2_API float b2_toiTime, b2_toiMaxTime;
-B2_API int32 b2_toiCalls, b2_toiIters, b2_toiMaxIters;
-B2_API int32 b2_toiRootIters, b2_toiMaxRootIters;
+// LOVE: per thread, since worlds can be stepped on worker threads.
+B2_API thread_local float b2_toiTime, b2_toiMaxTime;
+B2_API thread_local int32 b2_toiCalls, b2_toiIters, b2_toiMaxIters;
+B2_API thread_local int32 b2_toiRootIters, b2_toiMaxRootIters;
 
 //
 struct b2SeparationFunction
@@ -185,6 +185,7 @@ b2Fixture* b2Body::CreateFixture(const b2FixtureDef* def)
 	fixture->m_next = m_fixtureList;
 	m_fixtureList = fixture;
 	++m_fixtureCount;
+	++m_world->m_topologyId; // LOVE
 
 	fixture->m_body = this;
 
@@ -277,6 +278,7 @@ void b2Body::DestroyFixture(b2Fixture* fixture)
 	allocator->Free(fixture, sizeof(b2Fixture));
 
 	--m_fixtureCount;
+	++m_world->m_topologyId; // LOVE
 
 	// Reset the mass data.
 	ResetMassData();
@@ -472,6 +474,9 @@ void b2Body::SetEnabled(bool flag)
 		return;
 	}
 
+	// LOVE: proxies are recreated, so older snapshots no longer apply.
+	++m_world->m_topologyId;
+
 	if (flag)
 	{
 		m_flags |= e_enabledFlag;
@@ -26,6 +26,9 @@
 #include "box2d/b2_fixture.h"
 #include "box2d/b2_world_callbacks.h"
 
+// LOVE: minimum number of contacts handed to a task at once.
+static const int32 b2_contactUpdateBatch = 32;
+
 b2ContactFilter b2_defaultFilter;
 b2ContactListener b2_defaultListener;
 
@@ -36,6 +39,23 @@ b2ContactManager::b2ContactManager()
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
 	m_allocator = nullptr;
+	m_taskExecutor = nullptr;
+
+	m_collideContacts = nullptr;
+	m_collideStates = nullptr;
+	m_updateContacts = nullptr;
+	m_oldManifolds = nullptr;
+	m_touching = nullptr;
+	m_collideCapacity = 0;
+}
+
+b2ContactManager::~b2ContactManager()
+{
+	b2Free(m_collideContacts);
+	b2Free(m_collideStates);
+	b2Free(m_updateContacts);
+	b2Free(m_oldManifolds);
+	b2Free(m_touching);
 }
 
 void b2ContactManager::Destroy(b2Contact* c)
@@ -108,6 +128,13 @@ void b2ContactManager::Destroy(b2Contact* c)
 // contact list.
 void b2ContactManager::Collide()
 {
+	// LOVE: only worth farming out when there are enough contacts.
+	if (m_taskExecutor != nullptr && m_taskExecutor->GetThreadCount() > 1 && m_contactCount >= 2 * b2_contactUpdateBatch)
+	{
+		CollideParallel();
+		return;
+	}
+
 	// Update awake contacts.
 	b2Contact* c = m_contactList;
 	while (c)
@@ -173,9 +200,190 @@ void b2ContactManager::Collide()
 	}
 }
 
+// LOVE: computes the manifolds of a range of persisting contacts.
+class b2ContactUpdateTask : public b2Task
+{
+public:
+
+	b2ContactUpdateTask(b2ContactManager* manager)
+		: m_manager(manager)
+	{}
+
+	void Execute(int32 begin, int32 end, int32 threadIndex) override
+	{
+		B2_NOT_USED(threadIndex);
+
+		for (int32 i = begin; i < end; ++i)
+		{
+			b2Contact* c = m_manager->m_updateContacts[i];
+			m_manager->m_touching[i] = c->UpdateManifold(m_manager->m_oldManifolds + i);
+		}
+	}
+
+private:
+
+	b2ContactManager* m_manager;
+};
+
+void b2ContactManager::ReserveCollideBuffers(int32 count)
+{
+	if (count <= m_collideCapacity)
+	{
+		return;
+	}
+
+	b2Free(m_collideContacts);
+	b2Free(m_collideStates);
+	b2Free(m_updateContacts);
+	b2Free(m_oldManifolds);
+	b2Free(m_touching);
+
+	m_collideCapacity = b2Max(count, m_collideCapacity + (m_collideCapacity >> 1));
+	m_collideContacts = (b2Contact**)b2Alloc(m_collideCapacity * sizeof(b2Contact*));
+	m_collideStates = (uint8*)b2Alloc(m_collideCapacity * sizeof(uint8));
+	m_updateContacts = (b2Contact**)b2Alloc(m_collideCapacity * sizeof(b2Contact*));
+	m_oldManifolds = (b2Manifold*)b2Alloc(m_collideCapacity * sizeof(b2Manifold));
+	m_touching = (bool*)b2Alloc(m_collideCapacity * sizeof(bool));
+}
+
+// LOVE: same result as Collide(), in three passes. The first pass classifies
+// contacts without touching the contact list, the second computes manifolds in
+// parallel, and the last applies everything in list order. Waking a body can
+// only activate contacts further down the list, so skipped contacts are checked
+// again in the last pass to match the serial behaviour exactly. Contacts which
+// need the user filter are left entirely to the last pass, so filter callbacks
+// stay interleaved with Begin/End/PreSolve as in a serial step.
+void b2ContactManager::CollideParallel()
+{
+	enum
+	{
+		e_skip,
+		e_filter,
+		e_destroy,
+		e_update
+	};
+
+	ReserveCollideBuffers(m_contactCount);
+
+	int32 count = 0;
+	int32 updateCount = 0;
+
+	for (b2Contact* c = m_contactList; c; c = c->GetNext())
+	{
+		b2Fixture* fixtureA = c->GetFixtureA();
+		b2Fixture* fixtureB = c->GetFixtureB();
+		b2Body* bodyA = fixtureA->GetBody();
+		b2Body* bodyB = fixtureB->GetBody();
+
+		uint8 state = e_update;
+
+		if (c->m_flags & b2Contact::e_filterFlag)
+		{
+			if (bodyB->ShouldCollide(bodyA) == false)
+			{
+				state = e_destroy;
+			}
+			else if (m_contactFilter)
+			{
+				state = e_filter;
+			}
+			else
+			{
+				c->m_flags &= ~b2Contact::e_filterFlag;
+			}
+		}
+
+		if (state == e_update)
+		{
+			bool activeA = bodyA->IsAwake() && bodyA->m_type != b2_staticBody;
+			bool activeB = bodyB->IsAwake() && bodyB->m_type != b2_staticBody;
+
+			if (activeA == false && activeB == false)
+			{
+				state = e_skip;
+			}
+			else
+			{
+				int32 proxyIdA = fixtureA->m_proxies[c->GetChildIndexA()].proxyId;
+				int32 proxyIdB = fixtureB->m_proxies[c->GetChildIndexB()].proxyId;
+
+				if (m_broadPhase.TestOverlap(proxyIdA, proxyIdB) == false)
+				{
+					state = e_destroy;
+				}
+			}
+		}
+
+		if (state == e_update)
+		{
+			m_updateContacts[updateCount++] = c;
+		}
+
+		m_collideContacts[count] = c;
+		m_collideStates[count] = state;
+		++count;
+	}
+
+	b2ContactUpdateTask task(this);
+	m_taskExecutor->ParallelFor(updateCount, b2_contactUpdateBatch, &task);
+
+	int32 updateIndex = 0;
+	for (int32 i = 0; i < count; ++i)
+	{
+		b2Contact* c = m_collideContacts[i];
+
+		if (m_collideStates[i] == e_update)
+		{
+			c->FinishUpdate(m_oldManifolds + updateIndex, m_touching[updateIndex], m_contactListener);
+			++updateIndex;
+		}
+		else if (m_collideStates[i] == e_destroy)
+		{
+			Destroy(c);
+		}
+		else
+		{
+			b2Fixture* fixtureA = c->GetFixtureA();
+			b2Fixture* fixtureB = c->GetFixtureB();
+			b2Body* bodyA = fixtureA->GetBody();
+			b2Body* bodyB = fixtureB->GetBody();
+
+			if (m_collideStates[i] == e_filter)
+			{
+				if (m_contactFilter->ShouldCollide(fixtureA, fixtureB) == false)
+				{
+					Destroy(c);
+					continue;
+				}
+
+				c->m_flags &= ~b2Contact::e_filterFlag;
+			}
+
+			bool activeA = bodyA->IsAwake() && bodyA->m_type != b2_staticBody;
+			bool activeB = bodyB->IsAwake() && bodyB->m_type != b2_staticBody;
+
+			if (activeA == false && activeB == false)
+			{
+				continue;
+			}
+
+			int32 proxyIdA = fixtureA->m_proxies[c->GetChildIndexA()].proxyId;
+			int32 proxyIdB = fixtureB->m_proxies[c->GetChildIndexB()].proxyId;
+
+			if (m_broadPhase.TestOverlap(proxyIdA, proxyIdB) == false)
+			{
+				Destroy(c);
+				continue;
+			}
+
+			c->Update(m_contactListener);
+		}
+	}
+}
+
 void b2ContactManager::FindNewContacts()
 {
-	m_broadPhase.UpdatePairs(this);
+	m_broadPhase.UpdatePairs(this, m_taskExecutor);
 }
 
 void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
@@ -239,20 +447,21 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 		return;
 	}
 
+	CreateContact(fixtureA, indexA, fixtureB, indexB);
+}
+
+b2Contact* b2ContactManager::CreateContact(b2Fixture* fixtureA, int32 indexA, b2Fixture* fixtureB, int32 indexB)
+{
 	// Call the factory.
 	b2Contact* c = b2Contact::Create(fixtureA, indexA, fixtureB, indexB, m_allocator);
 	if (c == nullptr)
 	{
-		return;
+		return nullptr;
 	}
 
 	// Contact creation may swap fixtures.
-	fixtureA = c->GetFixtureA();
-	fixtureB = c->GetFixtureB();
-	indexA = c->GetChildIndexA();
-	indexB = c->GetChildIndexB();
-	bodyA = fixtureA->GetBody();
-	bodyB = fixtureB->GetBody();
+	b2Body* bodyA = c->GetFixtureA()->GetBody();
+	b2Body* bodyB = c->GetFixtureB()->GetBody();
 
 	// Insert into the world.
 	c->m_prev = nullptr;
@@ -290,4 +499,6 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 	bodyB->m_contactList = &c->m_nodeB;
 
 	++m_contactCount;
+
+	return c;
 }
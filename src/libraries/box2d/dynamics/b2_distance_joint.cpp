@@ -419,3 +419,18 @@ void b2DistanceJoint::Draw(b2Draw* draw) const
 		}
 	}
 }
+
+int32 b2DistanceJoint::SaveState(float* state) const
+{
+	state[0] = m_impulse;
+	state[1] = m_lowerImpulse;
+	state[2] = m_upperImpulse;
+	return 3;
+}
+
+void b2DistanceJoint::RestoreState(const float* state)
+{
+	m_impulse = state[0];
+	m_lowerImpulse = state[1];
+	m_upperImpulse = state[2];
+}
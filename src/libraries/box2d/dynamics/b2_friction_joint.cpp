@@ -253,3 +253,18 @@ void b2FrictionJoint::Dump()
 	b2Dump("  jd.maxTorque = %.9g;\n", m_maxTorque);
 	b2Dump("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+int32 b2FrictionJoint::SaveState(float* state) const
+{
+	state[0] = m_linearImpulse.x;
+	state[1] = m_linearImpulse.y;
+	state[2] = m_angularImpulse;
+	return 3;
+}
+
+void b2FrictionJoint::RestoreState(const float* state)
+{
+	m_linearImpulse.x = state[0];
+	m_linearImpulse.y = state[1];
+	m_angularImpulse = state[2];
+}
@@ -427,3 +427,14 @@ void b2GearJoint::Dump()
 	b2Dump("  jd.ratio = %.9g;\n", m_ratio);
 	b2Dump("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+int32 b2GearJoint::SaveState(float* state) const
+{
+	state[0] = m_impulse;
+	return 1;
+}
+
+void b2GearJoint::RestoreState(const float* state)
+{
+	m_impulse = state[0];
+}
@@ -32,6 +32,7 @@ class b2Joint;
 class b2StackAllocator;
 class b2ContactListener;
 struct b2ContactVelocityConstraint;
+struct b2ContactImpulse;
 struct b2Profile;
 
 /// This is an internal class.
@@ -40,6 +41,16 @@ class b2Island
 public:
 	b2Island(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity,
 			b2StackAllocator* allocator, b2ContactListener* listener);
+
+	// LOVE: island over arrays owned by the caller, used by the parallel
+	// solver. Bodies must already have their island index set, and static
+	// bodies may be shared with other islands solved at the same time, so
+	// they are never written to. Contact impulses are stored in impulses
+	// instead of being reported to a listener.
+	b2Island(b2Body** bodies, int32 bodyCount, b2Contact** contacts, int32 contactCount,
+			b2Joint** joints, int32 jointCount, b2Position* positions, b2Velocity* velocities,
+			b2StackAllocator* allocator, b2ContactImpulse* impulses);
+
 	~b2Island();
 
 	void Clear()
@@ -92,6 +103,11 @@ class b2Island
 	int32 m_bodyCapacity;
 	int32 m_contactCapacity;
 	int32 m_jointCapacity;
+
+	// LOVE: added for parallel stepping.
+	b2ContactImpulse* m_impulses;
+	bool m_sharedStatics;
+	bool m_ownsArrays;
 };
 
 #endif
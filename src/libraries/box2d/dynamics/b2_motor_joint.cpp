@@ -309,3 +309,18 @@ void b2MotorJoint::Dump()
 	b2Dump("  jd.correctionFactor = %.9g;\n", m_correctionFactor);
 	b2Dump("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+int32 b2MotorJoint::SaveState(float* state) const
+{
+	state[0] = m_linearImpulse.x;
+	state[1] = m_linearImpulse.y;
+	state[2] = m_angularImpulse;
+	return 3;
+}
+
+void b2MotorJoint::RestoreState(const float* state)
+{
+	m_linearImpulse.x = state[0];
+	m_linearImpulse.y = state[1];
+	m_angularImpulse = state[2];
+}
@@ -190,3 +190,16 @@ void b2MouseJoint::ShiftOrigin(const b2Vec2& newOrigin)
 {
 	m_targetA -= newOrigin;
 }
+
+int32 b2MouseJoint::SaveState(float* state) const
+{
+	state[0] = m_impulse.x;
+	state[1] = m_impulse.y;
+	return 2;
+}
+
+void b2MouseJoint::RestoreState(const float* state)
+{
+	m_impulse.x = state[0];
+	m_impulse.y = state[1];
+}
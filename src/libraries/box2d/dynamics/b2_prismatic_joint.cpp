@@ -641,3 +641,22 @@ void b2PrismaticJoint::Draw(b2Draw* draw) const
 	draw->DrawPoint(pA, 5.0f, c1);
 	draw->DrawPoint(pB, 5.0f, c4);
 }
+
+int32 b2PrismaticJoint::SaveState(float* state) const
+{
+	state[0] = m_impulse.x;
+	state[1] = m_impulse.y;
+	state[2] = m_motorImpulse;
+	state[3] = m_lowerImpulse;
+	state[4] = m_upperImpulse;
+	return 5;
+}
+
+void b2PrismaticJoint::RestoreState(const float* state)
+{
+	m_impulse.x = state[0];
+	m_impulse.y = state[1];
+	m_motorImpulse = state[2];
+	m_lowerImpulse = state[3];
+	m_upperImpulse = state[4];
+}
@@ -350,3 +350,14 @@ void b2PulleyJoint::ShiftOrigin(const b2Vec2& newOrigin)
 	m_groundAnchorA -= newOrigin;
 	m_groundAnchorB -= newOrigin;
 }
+
+int32 b2PulleyJoint::SaveState(float* state) const
+{
+	state[0] = m_impulse;
+	return 1;
+}
+
+void b2PulleyJoint::RestoreState(const float* state)
+{
+	m_impulse = state[0];
+}
@@ -499,3 +499,22 @@ void b2RevoluteJoint::Draw(b2Draw* draw) const
 	draw->DrawSegment(pA, pB, color);
 	draw->DrawSegment(xfB.p, pB, color);
 }
+
+int32 b2RevoluteJoint::SaveState(float* state) const
+{
+	state[0] = m_impulse.x;
+	state[1] = m_impulse.y;
+	state[2] = m_motorImpulse;
+	state[3] = m_lowerImpulse;
+	state[4] = m_upperImpulse;
+	return 5;
+}
+
+void b2RevoluteJoint::RestoreState(const float* state)
+{
+	m_impulse.x = state[0];
+	m_impulse.y = state[1];
+	m_motorImpulse = state[2];
+	m_lowerImpulse = state[3];
+	m_upperImpulse = state[4];
+}
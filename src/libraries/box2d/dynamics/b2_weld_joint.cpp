@@ -342,3 +342,18 @@ void b2WeldJoint::Dump()
 	b2Dump("  jd.damping = %.9g;\n", m_damping);
 	b2Dump("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+int32 b2WeldJoint::SaveState(float* state) const
+{
+	state[0] = m_impulse.x;
+	state[1] = m_impulse.y;
+	state[2] = m_impulse.z;
+	return 3;
+}
+
+void b2WeldJoint::RestoreState(const float* state)
+{
+	m_impulse.x = state[0];
+	m_impulse.y = state[1];
+	m_impulse.z = state[2];
+}
@@ -670,3 +670,22 @@ void b2WheelJoint::Draw(b2Draw* draw) const
 	draw->DrawPoint(pA, 5.0f, c1);
 	draw->DrawPoint(pB, 5.0f, c4);
 }
+
+int32 b2WheelJoint::SaveState(float* state) const
+{
+	state[0] = m_impulse;
+	state[1] = m_motorImpulse;
+	state[2] = m_springImpulse;
+	state[3] = m_lowerImpulse;
+	state[4] = m_upperImpulse;
+	return 5;
+}
+
+void b2WheelJoint::RestoreState(const float* state)
+{
+	m_impulse = state[0];
+	m_motorImpulse = state[1];
+	m_springImpulse = state[2];
+	m_lowerImpulse = state[3];
+	m_upperImpulse = state[4];
+}
@@ -32,12 +32,14 @@
 #include "box2d/b2_draw.h"
 #include "box2d/b2_edge_shape.h"
 #include "box2d/b2_fixture.h"
+#include "box2d/b2_joint.h"
 #include "box2d/b2_polygon_shape.h"
 #include "box2d/b2_pulley_joint.h"
 #include "box2d/b2_time_of_impact.h"
 #include "box2d/b2_timer.h"
 #include "box2d/b2_world.h"
 
+#include <atomic>
 #include <new>
 
 b2World::b2World(const b2Vec2& gravity)
@@ -69,6 +71,16 @@ b2World::b2World(const b2Vec2& gravity)
 	m_contactManager.m_allocator = &m_blockAllocator;
 
 	memset(&m_profile, 0, sizeof(b2Profile));
+
+	m_taskExecutor = nullptr;
+	m_threadAllocators = nullptr;
+
+	// LOVE: worlds can be created on any thread.
+	static std::atomic<uint32> s_nextWorldId(1);
+	m_worldId = s_nextWorldId.fetch_add(1);
+	m_topologyId = 0;
+	m_threadProfiles = nullptr;
+	m_threadCount = 0;
 }
 
 b2World::~b2World()
@@ -90,6 +102,8 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	SetTaskExecutor(nullptr);
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -107,6 +121,51 @@ void b2World::SetContactListener(b2ContactListener* listener)
 	m_contactManager.m_contactListener = listener;
 }
 
+void b2World::SetTaskExecutor(b2TaskExecutor* executor)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < m_threadCount; ++i)
+	{
+		m_threadAllocators[i]->~b2StackAllocator();
+		b2Free(m_threadAllocators[i]);
+	}
+
+	b2Free(m_threadAllocators);
+	b2Free(m_threadProfiles);
+
+	m_threadAllocators = nullptr;
+	m_threadProfiles = nullptr;
+	m_threadCount = 0;
+
+	m_taskExecutor = executor;
+	m_contactManager.m_taskExecutor = executor;
+
+	if (executor == nullptr)
+	{
+		return;
+	}
+
+	m_threadCount = b2Max(executor->GetThreadCount(), 1);
+	m_threadAllocators = (b2StackAllocator**)b2Alloc(m_threadCount * sizeof(b2StackAllocator*));
+	m_threadProfiles = (b2Profile*)b2Alloc(m_threadCount * sizeof(b2Profile));
+
+	for (int32 i = 0; i < m_threadCount; ++i)
+	{
+		void* mem = b2Alloc(sizeof(b2StackAllocator));
+		m_threadAllocators[i] = new (mem) b2StackAllocator;
+	}
+}
+
+b2TaskExecutor* b2World::GetTaskExecutor() const
+{
+	return m_taskExecutor;
+}
+
 void b2World::SetDebugDraw(b2Draw* debugDraw)
 {
 	m_debugDraw = debugDraw;
@@ -132,6 +191,7 @@ b2Body* b2World::CreateBody(const b2BodyDef* def)
 	}
 	m_bodyList = b;
 	++m_bodyCount;
+	++m_topologyId; // LOVE
 
 	return b;
 }
@@ -213,6 +273,7 @@ void b2World::DestroyBody(b2Body* b)
 	}
 
 	--m_bodyCount;
+	++m_topologyId; // LOVE
 	b->~b2Body();
 	m_blockAllocator.Free(b, sizeof(b2Body));
 }
@@ -236,6 +297,7 @@ b2Joint* b2World::CreateJoint(const b2JointDef* def)
 	}
 	m_jointList = j;
 	++m_jointCount;
+	++m_topologyId; // LOVE
 
 	// Connect to the bodies' doubly linked lists.
 	j->m_edgeA.joint = j;
@@ -353,6 +415,7 @@ void b2World::DestroyJoint(b2Joint* j)
 
 	b2Assert(m_jointCount > 0);
 	--m_jointCount;
+	++m_topologyId; // LOVE
 
 	// If the joint prevents collisions, then flag any contacts for filtering.
 	if (collideConnected == false)
@@ -555,6 +618,12 @@ void b2World::Solve(const b2TimeStep& step)
 
 	m_stackAllocator.Free(stack);
 
+	SynchronizeFixtures();
+}
+
+// LOVE: split out of Solve so SolveParallel can share it.
+void b2World::SynchronizeFixtures()
+{
 	{
 		b2Timer timer;
 		// Synchronize fixtures, check for out of range bodies.
@@ -581,6 +650,305 @@ void b2World::Solve(const b2TimeStep& step)
 	}
 }
 
+// LOVE: a contiguous range of the flat arrays built by SolveParallel.
+struct b2IslandRange
+{
+	int32 bodyStart, bodyCount;
+	int32 contactStart, contactCount;
+	int32 jointStart, jointCount;
+};
+
+// LOVE: solves a range of islands with the arrays of one thread.
+class b2IslandSolveTask : public b2Task
+{
+public:
+
+	void Execute(int32 begin, int32 end, int32 threadIndex) override
+	{
+		b2StackAllocator* allocator = world->m_threadAllocators[threadIndex];
+		b2Profile* threadProfile = world->m_threadProfiles + threadIndex;
+
+		b2Position* positions = (b2Position*)allocator->Allocate(slotCount * sizeof(b2Position));
+		b2Velocity* velocities = (b2Velocity*)allocator->Allocate(slotCount * sizeof(b2Velocity));
+
+		for (int32 i = begin; i < end; ++i)
+		{
+			const b2IslandRange& range = islands[i];
+
+			b2Island island(bodies + range.bodyStart, range.bodyCount,
+							contacts + range.contactStart, range.contactCount,
+							joints + range.jointStart, range.jointCount,
+							positions, velocities, allocator, impulses + range.contactStart);
+
+			b2Profile profile;
+			island.Solve(&profile, *step, world->m_gravity, world->m_allowSleep);
+			threadProfile->solveInit += profile.solveInit;
+			threadProfile->solveVelocity += profile.solveVelocity;
+			threadProfile->solvePosition += profile.solvePosition;
+		}
+
+		allocator->Free(velocities);
+		allocator->Free(positions);
+	}
+
+	b2World* world;
+	const b2TimeStep* step;
+	const b2IslandRange* islands;
+	b2Body** bodies;
+	b2Contact** contacts;
+	b2Joint** joints;
+	b2ContactImpulse* impulses;
+	int32 slotCount;
+};
+
+// LOVE: parallel version of Solve. The islands are built serially in the same
+// order as Solve, then solved on the task executor, and finally the PostSolve
+// callbacks are made in island order. Static bodies can be part of several
+// islands, so they get a fixed island index shared by all of them, and each
+// thread has its own position and velocity arrays.
+void b2World::SolveParallel(const b2TimeStep& step)
+{
+	// Gear joints read bodies outside of their island.
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		if (j->m_type == e_gearJoint)
+		{
+			Solve(step);
+			return;
+		}
+	}
+
+	m_profile.solveInit = 0.0f;
+	m_profile.solveVelocity = 0.0f;
+	m_profile.solvePosition = 0.0f;
+
+	// Clear all the island flags.
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b->m_flags &= ~b2Body::e_islandFlag;
+		if (b->GetType() == b2_staticBody)
+		{
+			b->m_islandIndex = -1;
+		}
+	}
+	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		c->m_flags &= ~b2Contact::e_islandFlag;
+	}
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		j->m_islandFlag = false;
+	}
+
+	// Static bodies can appear once per island they touch.
+	int32 bodyCapacity = m_bodyCount + m_contactManager.m_contactCount + m_jointCount;
+	b2Body** bodies = (b2Body**)m_stackAllocator.Allocate(bodyCapacity * sizeof(b2Body*));
+	b2Contact** contacts = (b2Contact**)m_stackAllocator.Allocate(m_contactManager.m_contactCount * sizeof(b2Contact*));
+	b2Joint** joints = (b2Joint**)m_stackAllocator.Allocate(m_jointCount * sizeof(b2Joint*));
+	b2IslandRange* islands = (b2IslandRange*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandRange));
+
+	int32 bodyTotal = 0;
+	int32 contactTotal = 0;
+	int32 jointTotal = 0;
+	int32 islandCount = 0;
+	int32 staticCount = 0;
+	int32 maxIslandBodies = 0;
+
+	// Build all awake islands.
+	int32 stackSize = m_bodyCount;
+	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	{
+		if (seed->m_flags & b2Body::e_islandFlag)
+		{
+			continue;
+		}
+
+		if (seed->IsAwake() == false || seed->IsEnabled() == false)
+		{
+			continue;
+		}
+
+		// The seed can be dynamic or kinematic.
+		if (seed->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		b2IslandRange* range = islands + islandCount++;
+		range->bodyStart = bodyTotal;
+		range->contactStart = contactTotal;
+		range->jointStart = jointTotal;
+
+		int32 stackCount = 0;
+		stack[stackCount++] = seed;
+		seed->m_flags |= b2Body::e_islandFlag;
+
+		// Perform a depth first search (DFS) on the constraint graph.
+		while (stackCount > 0)
+		{
+			// Grab the next body off the stack and add it to the island.
+			b2Body* b = stack[--stackCount];
+			b2Assert(b->IsEnabled() == true);
+			b2Assert(bodyTotal < bodyCapacity);
+			bodies[bodyTotal++] = b;
+
+			// Static bodies share one slot in every island.
+			if (b->GetType() == b2_staticBody)
+			{
+				if (b->m_islandIndex < 0)
+				{
+					b->m_islandIndex = staticCount++;
+				}
+				continue;
+			}
+
+			b->m_islandIndex = bodyTotal - 1 - range->bodyStart;
+
+			// Make sure the body is awake (without resetting sleep timer).
+			b->m_flags |= b2Body::e_awakeFlag;
+
+			// Search all contacts connected to this body.
+			for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+			{
+				b2Contact* contact = ce->contact;
+
+				// Has this contact already been added to an island?
+				if (contact->m_flags & b2Contact::e_islandFlag)
+				{
+					continue;
+				}
+
+				// Is this contact solid and touching?
+				if (contact->IsEnabled() == false ||
+					contact->IsTouching() == false)
+				{
+					continue;
+				}
+
+				// Skip sensors.
+				bool sensorA = contact->m_fixtureA->m_isSensor;
+				bool sensorB = contact->m_fixtureB->m_isSensor;
+				if (sensorA || sensorB)
+				{
+					continue;
+				}
+
+				contacts[contactTotal++] = contact;
+				contact->m_flags |= b2Contact::e_islandFlag;
+
+				b2Body* other = ce->other;
+
+				// Was the other body already added to this island?
+				if (other->m_flags & b2Body::e_islandFlag)
+				{
+					continue;
+				}
+
+				b2Assert(stackCount < stackSize);
+				stack[stackCount++] = other;
+				other->m_flags |= b2Body::e_islandFlag;
+			}
+
+			// Search all joints connect to this body.
+			for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+			{
+				if (je->joint->m_islandFlag == true)
+				{
+					continue;
+				}
+
+				b2Body* other = je->other;
+
+				// Don't simulate joints connected to diabled bodies.
+				if (other->IsEnabled() == false)
+				{
+					continue;
+				}
+
+				joints[jointTotal++] = je->joint;
+				je->joint->m_islandFlag = true;
+
+				if (other->m_flags & b2Body::e_islandFlag)
+				{
+					continue;
+				}
+
+				b2Assert(stackCount < stackSize);
+				stack[stackCount++] = other;
+				other->m_flags |= b2Body::e_islandFlag;
+			}
+		}
+
+		range->bodyCount = bodyTotal - range->bodyStart;
+		range->contactCount = contactTotal - range->contactStart;
+		range->jointCount = jointTotal - range->jointStart;
+		maxIslandBodies = b2Max(maxIslandBodies, range->bodyCount);
+
+		// Allow static bodies to participate in other islands.
+		for (int32 i = range->bodyStart; i < bodyTotal; ++i)
+		{
+			b2Body* b = bodies[i];
+			if (b->GetType() == b2_staticBody)
+			{
+				b->m_flags &= ~b2Body::e_islandFlag;
+			}
+		}
+	}
+
+	m_stackAllocator.Free(stack);
+
+	// Move the other bodies past the static slots.
+	for (int32 i = 0; i < bodyTotal; ++i)
+	{
+		b2Body* b = bodies[i];
+		if (b->GetType() != b2_staticBody)
+		{
+			b->m_islandIndex += staticCount;
+		}
+	}
+
+	b2ContactImpulse* impulses = (b2ContactImpulse*)m_stackAllocator.Allocate(contactTotal * sizeof(b2ContactImpulse));
+
+	memset(m_threadProfiles, 0, m_threadCount * sizeof(b2Profile));
+
+	b2IslandSolveTask task;
+	task.world = this;
+	task.step = &step;
+	task.islands = islands;
+	task.bodies = bodies;
+	task.contacts = contacts;
+	task.joints = joints;
+	task.impulses = impulses;
+	task.slotCount = staticCount + maxIslandBodies;
+
+	m_taskExecutor->ParallelFor(islandCount, 1, &task);
+
+	for (int32 i = 0; i < m_threadCount; ++i)
+	{
+		m_profile.solveInit += m_threadProfiles[i].solveInit;
+		m_profile.solveVelocity += m_threadProfiles[i].solveVelocity;
+		m_profile.solvePosition += m_threadProfiles[i].solvePosition;
+	}
+
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+	if (listener != nullptr)
+	{
+		for (int32 i = 0; i < contactTotal; ++i)
+		{
+			listener->PostSolve(contacts[i], impulses + i);
+		}
+	}
+
+	m_stackAllocator.Free(impulses);
+	m_stackAllocator.Free(islands);
+	m_stackAllocator.Free(joints);
+	m_stackAllocator.Free(contacts);
+	m_stackAllocator.Free(bodies);
+
+	SynchronizeFixtures();
+}
+
 // Find TOI contacts and solve them.
 void b2World::SolveTOI(const b2TimeStep& step)
 {
@@ -943,7 +1311,14 @@ void b2World::Step(float dt, int32 velocityIterations, int32 positionIterations)
 	if (m_stepComplete && step.dt > 0.0f)
 	{
 		b2Timer timer;
-		Solve(step);
+		if (m_taskExecutor != nullptr && m_threadCount > 1)
+		{
+			SolveParallel(step);
+		}
+		else
+		{
+			Solve(step);
+		}
 		m_profile.solve = timer.GetMilliseconds();
 	}
 
@@ -1257,6 +1632,300 @@ void b2World::ShiftOrigin(const b2Vec2& newOrigin)
 	m_contactManager.m_broadPhase.ShiftOrigin(newOrigin);
 }
 
+// LOVE: world snapshots. Bodies, fixture proxies and joints are stored in list
+// order. Contacts are identified by their broad-phase proxies, and are stored in
+// list order so they can be recreated in the same order.
+static const uint32 b2_stateMagic = 0x53573242; // "B2WS"
+static const uint32 b2_stateVersion = 2;
+
+struct b2WorldState
+{
+	uint32 magic;
+	uint32 version;
+	uint32 worldId;
+	uint32 topologyId;
+	int32 bodyCount;
+	int32 proxyCount;
+	int32 jointCount;
+	int32 contactCount;
+	float inv_dt0;
+	uint32 stepComplete;
+	uint32 newContacts;
+};
+
+struct b2BodyState
+{
+	b2Transform xf;
+	b2Sweep sweep;
+	b2Vec2 linearVelocity;
+	float angularVelocity;
+	b2Vec2 force;
+	float torque;
+	float sleepTime;
+	uint32 flags;
+};
+
+struct b2JointState
+{
+	float impulses[b2_maxJointStateFloats];
+};
+
+struct b2ContactState
+{
+	int32 proxyIdA;
+	int32 proxyIdB;
+	uint32 flags;
+	b2Manifold manifold;
+	float friction;
+	float restitution;
+	float restitutionThreshold;
+	float tangentSpeed;
+	int32 toiCount;
+	float toi;
+};
+
+int32 b2World::GetStateSize() const
+{
+	int32 proxyCount = m_contactManager.m_broadPhase.GetProxyCount();
+
+	int32 size = sizeof(b2WorldState);
+	size += m_bodyCount * sizeof(b2BodyState);
+	size += proxyCount * sizeof(b2AABB);
+	size += m_jointCount * sizeof(b2JointState);
+	size += m_contactManager.m_contactCount * sizeof(b2ContactState);
+	size += m_contactManager.m_broadPhase.GetStateSize();
+	return size;
+}
+
+void b2World::SaveState(void* data) const
+{
+	uint8* out = (uint8*)data;
+
+	b2WorldState state;
+	state.magic = b2_stateMagic;
+	state.version = b2_stateVersion;
+	state.worldId = m_worldId;
+	state.topologyId = m_topologyId;
+	state.bodyCount = m_bodyCount;
+	state.proxyCount = m_contactManager.m_broadPhase.GetProxyCount();
+	state.jointCount = m_jointCount;
+	state.contactCount = m_contactManager.m_contactCount;
+	state.inv_dt0 = m_inv_dt0;
+	state.stepComplete = m_stepComplete ? 1 : 0;
+	state.newContacts = m_newContacts ? 1 : 0;
+
+	memcpy(out, &state, sizeof(state));
+	out += sizeof(state);
+
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b2BodyState bodyState;
+		bodyState.xf = b->m_xf;
+		bodyState.sweep = b->m_sweep;
+		bodyState.linearVelocity = b->m_linearVelocity;
+		bodyState.angularVelocity = b->m_angularVelocity;
+		bodyState.force = b->m_force;
+		bodyState.torque = b->m_torque;
+		bodyState.sleepTime = b->m_sleepTime;
+		bodyState.flags = b->m_flags & (b2Body::e_islandFlag | b2Body::e_awakeFlag | b2Body::e_toiFlag);
+
+		memcpy(out, &bodyState, sizeof(bodyState));
+		out += sizeof(bodyState);
+	}
+
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				memcpy(out, &f->m_proxies[i].aabb, sizeof(b2AABB));
+				out += sizeof(b2AABB);
+			}
+		}
+	}
+
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		b2JointState jointState = {};
+		j->SaveState(jointState.impulses);
+
+		memcpy(out, &jointState, sizeof(jointState));
+		out += sizeof(jointState);
+	}
+
+	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		b2ContactState contactState;
+		contactState.proxyIdA = c->m_fixtureA->m_proxies[c->m_indexA].proxyId;
+		contactState.proxyIdB = c->m_fixtureB->m_proxies[c->m_indexB].proxyId;
+		contactState.flags = c->m_flags;
+		contactState.manifold = c->m_manifold;
+		contactState.friction = c->m_friction;
+		contactState.restitution = c->m_restitution;
+		contactState.restitutionThreshold = c->m_restitutionThreshold;
+		contactState.tangentSpeed = c->m_tangentSpeed;
+		contactState.toiCount = c->m_toiCount;
+		contactState.toi = c->m_toi;
+
+		memcpy(out, &contactState, sizeof(contactState));
+		out += sizeof(contactState);
+	}
+
+	m_contactManager.m_broadPhase.SaveState(out);
+}
+
+bool b2World::RestoreState(const void* data, int32 size)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return false;
+	}
+
+	const uint8* in = (const uint8*)data;
+	b2BroadPhase& broadPhase = m_contactManager.m_broadPhase;
+
+	if (size < int32(sizeof(b2WorldState)))
+	{
+		return false;
+	}
+
+	b2WorldState state;
+	memcpy(&state, in, sizeof(state));
+
+	// Matching counts aren't enough: the same number of bodies could be
+	// different ones, from another world or recreated since the save.
+	if (state.magic != b2_stateMagic || state.version != b2_stateVersion
+		|| state.worldId != m_worldId || state.topologyId != m_topologyId
+		|| state.bodyCount != m_bodyCount || state.jointCount != m_jointCount
+		|| state.proxyCount != broadPhase.GetProxyCount()
+		|| state.contactCount < 0)
+	{
+		return false;
+	}
+
+	int32 fixedSize = sizeof(b2WorldState);
+	fixedSize += m_bodyCount * sizeof(b2BodyState);
+	fixedSize += state.proxyCount * sizeof(b2AABB);
+	fixedSize += m_jointCount * sizeof(b2JointState);
+	if (fixedSize > size || state.contactCount > (size - fixedSize) / int32(sizeof(b2ContactState)))
+	{
+		return false;
+	}
+
+	fixedSize += state.contactCount * sizeof(b2ContactState);
+
+	const uint8* bodies = in + sizeof(b2WorldState);
+	const uint8* aabbs = bodies + m_bodyCount * sizeof(b2BodyState);
+	const uint8* joints = aabbs + state.proxyCount * sizeof(b2AABB);
+	const uint8* contacts = joints + m_jointCount * sizeof(b2JointState);
+	const uint8* broadPhaseState = contacts + state.contactCount * sizeof(b2ContactState);
+
+	// Validate contacts before anything is modified. Restoring the broad-phase
+	// keeps the same proxies, so the current ones can be checked.
+	for (int32 i = 0; i < state.contactCount; ++i)
+	{
+		b2ContactState contactState;
+		memcpy(&contactState, contacts + i * sizeof(b2ContactState), sizeof(contactState));
+
+		if (broadPhase.IsProxy(contactState.proxyIdA) == false || broadPhase.IsProxy(contactState.proxyIdB) == false)
+		{
+			return false;
+		}
+
+		b2FixtureProxy* proxyA = (b2FixtureProxy*)broadPhase.GetUserData(contactState.proxyIdA);
+		b2FixtureProxy* proxyB = (b2FixtureProxy*)broadPhase.GetUserData(contactState.proxyIdB);
+		if (proxyA->fixture->m_body == proxyB->fixture->m_body
+			|| contactState.manifold.pointCount < 0 || contactState.manifold.pointCount > b2_maxManifoldPoints)
+		{
+			return false;
+		}
+	}
+
+	if (broadPhase.RestoreState(broadPhaseState, size - fixedSize) == 0)
+	{
+		return false;
+	}
+
+	// Remove the current contacts without reporting them.
+	while (m_contactManager.m_contactList)
+	{
+		b2Contact* c = m_contactManager.m_contactList;
+		c->m_flags &= ~b2Contact::e_touchingFlag;
+		c->m_manifold.pointCount = 0;
+		m_contactManager.Destroy(c);
+	}
+
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b2BodyState bodyState;
+		memcpy(&bodyState, bodies, sizeof(bodyState));
+		bodies += sizeof(bodyState);
+
+		b->m_xf = bodyState.xf;
+		b->m_sweep = bodyState.sweep;
+		b->m_linearVelocity = bodyState.linearVelocity;
+		b->m_angularVelocity = bodyState.angularVelocity;
+		b->m_force = bodyState.force;
+		b->m_torque = bodyState.torque;
+		b->m_sleepTime = bodyState.sleepTime;
+		// Only restore the flags that are simulation state rather than settings.
+		const uint16 stateFlags = b2Body::e_islandFlag | b2Body::e_awakeFlag | b2Body::e_toiFlag;
+		b->m_flags = (b->m_flags & ~stateFlags) | (uint16(bodyState.flags) & stateFlags);
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				memcpy(&f->m_proxies[i].aabb, aabbs, sizeof(b2AABB));
+				aabbs += sizeof(b2AABB);
+			}
+		}
+	}
+
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		b2JointState jointState;
+		memcpy(&jointState, joints, sizeof(jointState));
+		joints += sizeof(jointState);
+
+		j->RestoreState(jointState.impulses);
+	}
+
+	// New contacts are pushed to the front of the lists, so create them in
+	// reverse to get the saved order back.
+	for (int32 i = state.contactCount - 1; i >= 0; --i)
+	{
+		b2ContactState contactState;
+		memcpy(&contactState, contacts + i * sizeof(b2ContactState), sizeof(contactState));
+
+		b2FixtureProxy* proxyA = (b2FixtureProxy*)broadPhase.GetUserData(contactState.proxyIdA);
+		b2FixtureProxy* proxyB = (b2FixtureProxy*)broadPhase.GetUserData(contactState.proxyIdB);
+
+		b2Contact* c = m_contactManager.CreateContact(proxyA->fixture, proxyA->childIndex, proxyB->fixture, proxyB->childIndex);
+		if (c == nullptr)
+		{
+			continue;
+		}
+
+		c->m_flags = contactState.flags;
+		c->m_manifold = contactState.manifold;
+		c->m_friction = contactState.friction;
+		c->m_restitution = contactState.restitution;
+		c->m_restitutionThreshold = contactState.restitutionThreshold;
+		c->m_tangentSpeed = contactState.tangentSpeed;
+		c->m_toiCount = contactState.toiCount;
+		c->m_toi = contactState.toi;
+	}
+
+	m_inv_dt0 = state.inv_dt0;
+	m_stepComplete = state.stepComplete != 0;
+	m_newContacts = state.newContacts != 0;
+
+	return true;
+}
+
 void b2World::Dump()
 {
 	if (m_locked)
@@ -27,6 +27,7 @@
 // LOVE
 #include "common/Module.h"
 #include "common/StringMap.h"
+#include "common/int.h"
 #include "Source.h"
 #include "Effect.h"
 #include "RecordingDevice.h"
@@ -73,6 +74,23 @@ void requestRecordingPermission();
  */
 void showRecordingPermissionMissingDialog();
 
+/**
+ * Identifies encoded audio in the static Source cache. Two independent hashes
+ * and the size must all match, so a hash collision can't return the wrong
+ * decoded audio.
+ **/
+struct StaticCacheKey
+{
+	uint64 hash;
+	uint32 check;
+	size_t size;
+
+	bool operator == (const StaticCacheKey &other) const
+	{
+		return hash == other.hash && check == other.check && size == other.size;
+	}
+};
+
 /**
  * The Audio module is responsible for playing back raw sound samples.
  **/
@@ -105,6 +123,38 @@ class Audio : public Module
 	virtual Source *newSource(love::sound::SoundData *soundData) = 0;
 	virtual Source *newSource(int sampleRate, int bitDepth, int channels, int buffers) = 0;
 
+	/**
+	 * Creates a static Source which shares its decoded audio with other
+	 * Sources created using the same cache key.
+	 * @param soundData The decoded audio. Only used if nothing is cached yet.
+	 * @param cacheKey Identifies the encoded audio.
+	 **/
+	virtual Source *newSource(love::sound::SoundData *soundData, const StaticCacheKey &cacheKey) = 0;
+
+	/**
+	 * Creates a static Source from previously cached decoded audio.
+	 * @param cacheKey Identifies the encoded audio.
+	 * @return The new Source, or null if nothing is cached for the key.
+	 **/
+	virtual Source *newCachedSource(const StaticCacheKey &cacheKey) = 0;
+
+	/**
+	 * Sets how much memory decoded audio which isn't used by any Source may
+	 * occupy in the static Source cache. The least recently used data is
+	 * evicted first.
+	 * @param bytes The limit in bytes.
+	 **/
+	virtual void setStaticCacheLimit(size_t bytes) = 0;
+	virtual size_t getStaticCacheLimit() const = 0;
+
+	/**
+	 * Gets the memory used by the static Source cache, including decoded audio
+	 * still in use by Sources.
+	 * @param bytes The total size of the cached audio in bytes.
+	 * @param count The number of cached entries.
+	 **/
+	virtual void getStaticCacheUsage(size_t &bytes, int &count) const = 0;
+
 	/**
 	 * Gets the current number of simultaneous playing sources.
 	 * @return The current number of simultaneous playing sources.
@@ -117,6 +167,13 @@ class Audio : public Module
 	 **/
 	virtual int getMaxSources() const = 0;
 
+	/**
+	 * Gets the number of playing sources which currently aren't audible
+	 * because all voices are used by higher priority sources.
+	 * @return The current number of virtual sources.
+	 **/
+	virtual int getVirtualSourceCount() const = 0;
+
 	/**
 	 * Play the specified Source.
 	 * @param source The Source to play.
@@ -122,6 +122,19 @@ class Source : public Object
 	virtual int getFreeBufferCount() const = 0;
 	virtual bool queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels) = 0;
 
+	/**
+	 * Sources with a higher priority keep their voice when more Sources are
+	 * playing than the audio device can mix at once.
+	 **/
+	virtual void setPriority(int priority) = 0;
+	virtual int getPriority() const = 0;
+
+	/**
+	 * Gets whether the Source is playing as a virtual voice, i.e. its playback
+	 * position is advancing but it is not currently audible.
+	 **/
+	virtual bool isVirtual() const = 0;
+
 	virtual Type getType() const;
 
 	static bool getConstant(const char *in, Type &out);
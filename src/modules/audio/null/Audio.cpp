@@ -52,6 +52,31 @@ love::audio::Source *Audio::newSource(int, int, int, int)
 	return new Source();
 }
 
+love::audio::Source *Audio::newSource(love::sound::SoundData *, const StaticCacheKey &)
+{
+	return new Source();
+}
+
+love::audio::Source *Audio::newCachedSource(const StaticCacheKey &)
+{
+	return nullptr;
+}
+
+void Audio::setStaticCacheLimit(size_t)
+{
+}
+
+size_t Audio::getStaticCacheLimit() const
+{
+	return 0;
+}
+
+void Audio::getStaticCacheUsage(size_t &bytes, int &count) const
+{
+	bytes = 0;
+	count = 0;
+}
+
 int Audio::getActiveSourceCount() const
 {
 	return 0;
@@ -62,6 +87,11 @@ int Audio::getMaxSources() const
 	return 0;
 }
 
+int Audio::getVirtualSourceCount() const
+{
+	return 0;
+}
+
 bool Audio::play(love::audio::Source *)
 {
 	return false;
@@ -45,8 +45,14 @@ class Audio : public love::audio::Audio
 	love::audio::Source *newSource(love::sound::Decoder *decoder);
 	love::audio::Source *newSource(love::sound::SoundData *soundData);
 	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers);
+	love::audio::Source *newSource(love::sound::SoundData *soundData, const StaticCacheKey &cacheKey);
+	love::audio::Source *newCachedSource(const StaticCacheKey &cacheKey);
+	void setStaticCacheLimit(size_t bytes);
+	size_t getStaticCacheLimit() const;
+	void getStaticCacheUsage(size_t &bytes, int &count) const;
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
+	int getVirtualSourceCount() const;
 	bool play(love::audio::Source *source);
 	bool play(const std::vector<love::audio::Source*> &sources);
 	void stop(love::audio::Source *source);
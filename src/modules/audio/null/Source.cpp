@@ -239,6 +239,21 @@ bool Source::queue(void *, size_t, int, int, int)
 	return false;
 }
 
+void Source::setPriority(int priority)
+{
+	this->priority = priority;
+}
+
+int Source::getPriority() const
+{
+	return priority;
+}
+
+bool Source::isVirtual() const
+{
+	return false;
+}
+
 bool Source::setFilter(const std::map<Filter::Parameter, float> &)
 {
 	return false;
@@ -86,6 +86,10 @@ class Source : public love::audio::Source
 	virtual int getFreeBufferCount() const;
 	virtual bool queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels);
 
+	virtual void setPriority(int priority);
+	virtual int getPriority() const;
+	virtual bool isVirtual() const;
+
 	virtual bool setFilter(const std::map<Filter::Parameter, float> &params);
 	virtual bool setFilter();
 	virtual bool getFilter(std::map<Filter::Parameter, float> &params);
@@ -112,6 +116,7 @@ class Source : public love::audio::Source
 	float rolloffFactor = 1.0f;
 	float maxDistance = std::numeric_limits<float>::max();
 	float absorptionFactor = 0.0f;
+	int priority = 0;
 
 }; // Source
 
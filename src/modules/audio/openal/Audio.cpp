@@ -20,6 +20,7 @@
 
 #include "Audio.h"
 #include "common/delay.h"
+#include "common/trace.h"
 #include "RecordingDevice.h"
 #include "sound/Decoder.h"
 
@@ -61,7 +62,11 @@ void Audio::PoolThread::threadFunction()
 			}
 		}
 
-		pool->update();
+		{
+			LOVE_TRACE_ZONE("Pool::update");
+			pool->update();
+		}
+
 		sleep(5);
 	}
 }
@@ -110,6 +115,9 @@ Audio::Audio()
 	, device(nullptr)
 	, context(nullptr)
 	, pool(nullptr)
+	, staticCacheLimit(DEFAULT_STATIC_CACHE_LIMIT)
+	, staticCacheSize(0)
+	, staticCacheClock(0)
 	, poolThread(nullptr)
 	, distanceModel(DISTANCE_INVERSE_CLAMPED)
 {
@@ -233,6 +241,9 @@ Audio::~Audio()
 	delete poolThread;
 	delete pool;
 
+	// The cached buffers must be deleted while the context still exists.
+	staticCache.clear();
+
 	for (auto c : capture)
 		delete c;
 
@@ -272,6 +283,87 @@ love::audio::Source *Audio::newSource(int sampleRate, int bitDepth, int channels
 	return new Source(pool, sampleRate, bitDepth, channels, buffers);
 }
 
+love::audio::Source *Audio::newSource(love::sound::SoundData *soundData, const StaticCacheKey &cacheKey)
+{
+	thread::Lock lock(staticCacheMutex);
+
+	auto it = staticCache.find(cacheKey);
+	if (it != staticCache.end())
+	{
+		it->second.lastUse = ++staticCacheClock;
+		return new Source(pool, it->second.buffer.get());
+	}
+
+	Source *source = new Source(pool, soundData);
+
+	StaticCacheEntry entry;
+	entry.buffer.set(source->getStaticBuffer());
+	entry.lastUse = ++staticCacheClock;
+
+	staticCache[cacheKey] = entry;
+	staticCacheSize += (size_t) entry.buffer->getSize();
+
+	trimStaticCache();
+	return source;
+}
+
+love::audio::Source *Audio::newCachedSource(const StaticCacheKey &cacheKey)
+{
+	thread::Lock lock(staticCacheMutex);
+
+	auto it = staticCache.find(cacheKey);
+	if (it == staticCache.end())
+		return nullptr;
+
+	it->second.lastUse = ++staticCacheClock;
+	return new Source(pool, it->second.buffer.get());
+}
+
+void Audio::setStaticCacheLimit(size_t bytes)
+{
+	thread::Lock lock(staticCacheMutex);
+	staticCacheLimit = bytes;
+	trimStaticCache();
+}
+
+size_t Audio::getStaticCacheLimit() const
+{
+	thread::Lock lock(staticCacheMutex);
+	return staticCacheLimit;
+}
+
+void Audio::getStaticCacheUsage(size_t &bytes, int &count) const
+{
+	thread::Lock lock(staticCacheMutex);
+	bytes = staticCacheSize;
+	count = (int) staticCache.size();
+}
+
+void Audio::trimStaticCache()
+{
+	while (staticCacheSize > staticCacheLimit)
+	{
+		auto lru = staticCache.end();
+
+		// Buffers still referenced by a Source are never evicted, since that
+		// wouldn't free any memory.
+		for (auto it = staticCache.begin(); it != staticCache.end(); ++it)
+		{
+			if (it->second.buffer->getReferenceCount() > 1)
+				continue;
+
+			if (lru == staticCache.end() || it->second.lastUse < lru->second.lastUse)
+				lru = it;
+		}
+
+		if (lru == staticCache.end())
+			break;
+
+		staticCacheSize -= (size_t) lru->second.buffer->getSize();
+		staticCache.erase(lru);
+	}
+}
+
 int Audio::getActiveSourceCount() const
 {
 	return pool->getActiveSourceCount();
@@ -282,6 +374,11 @@ int Audio::getMaxSources() const
 	return pool->getMaxSources();
 }
 
+int Audio::getVirtualSourceCount() const
+{
+	return pool->getVirtualSourceCount();
+}
+
 bool Audio::play(love::audio::Source *source)
 {
 	return source->play();
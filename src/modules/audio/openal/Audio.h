@@ -24,6 +24,7 @@
 // STD
 #include <queue>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <stack>
 #include <cmath>
@@ -62,6 +63,8 @@ namespace audio
 namespace openal
 {
 
+class StaticDataBuffer;
+
 class Audio : public love::audio::Audio
 {
 public:
@@ -82,8 +85,14 @@ class Audio : public love::audio::Audio
 	love::audio::Source *newSource(love::sound::Decoder *decoder);
 	love::audio::Source *newSource(love::sound::SoundData *soundData);
 	love::audio::Source *newSource(int sampleRate, int bitDepth, int channels, int buffers);
+	love::audio::Source *newSource(love::sound::SoundData *soundData, const StaticCacheKey &cacheKey);
+	love::audio::Source *newCachedSource(const StaticCacheKey &cacheKey);
+	void setStaticCacheLimit(size_t bytes);
+	size_t getStaticCacheLimit() const;
+	void getStaticCacheUsage(size_t &bytes, int &count) const;
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
+	int getVirtualSourceCount() const;
 	bool play(love::audio::Source *source);
 	bool play(const std::vector<love::audio::Source*> &sources);
 	void stop(love::audio::Source *source);
@@ -130,6 +139,12 @@ class Audio : public love::audio::Audio
 
 private:
 	void initializeEFX();
+
+	/**
+	 * Evicts the least recently used cached buffers which aren't used by any
+	 * Source until the cache fits in its limit.
+	 **/
+	void trimStaticCache();
 	// The OpenAL device.
 	ALCdevice *device;
 
@@ -154,6 +169,29 @@ class Audio : public love::audio::Audio
 	// The Pool.
 	Pool *pool;
 
+	static const size_t DEFAULT_STATIC_CACHE_LIMIT = 64 * 1024 * 1024;
+
+	// Decoded audio shared by static Sources, keyed by the caller's cache key.
+	struct StaticCacheEntry
+	{
+		StrongRef<StaticDataBuffer> buffer;
+		uint64 lastUse;
+	};
+
+	struct StaticCacheKeyHash
+	{
+		size_t operator () (const StaticCacheKey &key) const
+		{
+			return (size_t) key.hash;
+		}
+	};
+
+	std::unordered_map<StaticCacheKey, StaticCacheEntry, StaticCacheKeyHash> staticCache;
+	size_t staticCacheLimit;
+	size_t staticCacheSize;
+	uint64 staticCacheClock;
+	mutable love::thread::MutexRef staticCacheMutex;
+
 	class PoolThread: public thread::Threadable
 	{
 	protected:
@@ -21,8 +21,12 @@
 #include "Pool.h"
 
 #include "event/Event.h"
+#include "timer/Timer.h"
 #include "Source.h"
 
+// STD
+#include <limits>
+
 namespace love
 {
 namespace audio
@@ -30,7 +34,7 @@ namespace audio
 namespace openal
 {
 
-static Variant::SharedTable *putSourcesAsSharedTable(std::vector<audio::Source *> &sources)
+static Variant::SharedTable *putSourcesAsSharedTable(const std::vector<audio::Source *> &sources)
 {
 	Variant::SharedTable *table = new Variant::SharedTable();
 
@@ -43,8 +47,18 @@ static Variant::SharedTable *putSourcesAsSharedTable(std::vector<audio::Source *
 Pool::Pool(ALCdevice *device)
 	: device(device)
 	, sources()
+	, slots()
+	, freeSlots()
+	, freeCount(0)
+	, activeSlots()
+	, activeCount(0)
+	, listenerPosition()
+	, distanceModel(AL_INVERSE_DISTANCE_CLAMPED)
 	, disconnectNotified(false)
 	, totalSources(0)
+	, streamCursor(0)
+	, decodeFinish(false)
+	, decodeThreads()
 {
 	// Clear errors.
 	alGetError();
@@ -69,8 +83,9 @@ Pool::Pool(ALCdevice *device)
 	ALboolean hasext = alIsExtensionPresent("AL_SOFT_direct_channels");
 #endif
 
-	// Make all sources available initially.
-	for (int i = 0; i < totalSources; i++)
+	// Make all sources available initially. The free list is a stack, so push
+	// in reverse to hand out the lowest slots first.
+	for (int i = totalSources - 1; i >= 0; i--)
 	{
 #ifdef AL_SOFT_direct_channels
 		if (hasext)
@@ -80,12 +95,32 @@ Pool::Pool(ALCdevice *device)
 		}
 #endif
 
-		available.push(sources[i]);
+		freeSlots[freeCount++] = i;
+	}
+
+	playingList.reserve(totalSources);
+
+	for (int i = 0; i < DECODE_THREADS; i++)
+	{
+		decodeThreads[i] = new DecodeThread(this);
+		decodeThreads[i]->start();
 	}
 }
 
 Pool::~Pool()
 {
+	{
+		thread::Lock lock(streamMutex);
+		decodeFinish = true;
+		streamCond->broadcast();
+	}
+
+	for (int i = 0; i < DECODE_THREADS; i++)
+	{
+		decodeThreads[i]->wait();
+		delete decodeThreads[i];
+	}
+
 	Source::stop(this);
 
 	// Free all sources.
@@ -97,7 +132,7 @@ bool Pool::isAvailable() const
 	bool has = false;
 	{
 		thread::Lock lock(mutex);
-		has = !available.empty();
+		has = freeCount > 0;
 	}
 	return has;
 }
@@ -107,7 +142,7 @@ bool Pool::isPlaying(Source *s)
 	bool p = false;
 	{
 		thread::Lock lock(mutex);
-		p = (playing.find(s) != playing.end());
+		p = findSlot(s) >= 0;
 	}
 	return p;
 }
@@ -151,21 +186,21 @@ void Pool::update()
 		}
 	}
 
-	std::vector<Source *> torelease;
-
-	for (const auto &i : playing)
+	// Walk the active list backwards: releasing a slot moves the last active
+	// entry (which has already been visited) into the released position.
+	for (int i = activeCount - 1; i >= 0; i--)
 	{
-		if (!i.first->update())
-			torelease.push_back(i.first);
+		int index = activeSlots[i];
+		if (!slots[index].owner->update())
+			releaseSlot(index, true);
 	}
 
-	for (Source *s : torelease)
-		releaseSource(s);
+	updateVirtualVoices();
 }
 
 int Pool::getActiveSourceCount() const
 {
-	return (int) playing.size();
+	return activeCount;
 }
 
 int Pool::getMaxSources() const
@@ -173,7 +208,12 @@ int Pool::getMaxSources() const
 	return totalSources;
 }
 
-bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying)
+int Pool::getVirtualSourceCount() const
+{
+	return (int) virtualSources.size();
+}
+
+bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying, bool steal)
 {
 	out = 0;
 
@@ -182,43 +222,290 @@ bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying)
 
 	wasPlaying = false;
 
-	if (available.empty())
-		return false;
+	if (freeCount == 0)
+	{
+		if (!steal || !source->canBeVirtual())
+			return false;
+
+		// Take the source of a lower ranked Source, which keeps playing
+		// virtually until it ranks high enough again.
+		updateListener();
+		int victim = findVictimSlot(getVoiceScore(source));
+		if (victim < 0)
+			return false;
+
+		virtualizeSlot(victim);
+	}
+
+	int index = freeSlots[--freeCount];
+	Slot &slot = slots[index];
+
+	slot.owner = source;
+	slot.activeIndex = activeCount;
+	activeSlots[activeCount++] = index;
 
-	out = available.front();
-	available.pop();
+	source->poolHandle.index = (uint16) index;
+	source->poolHandle.generation = slot.generation;
 
-	playing.insert(std::make_pair(source, out));
+	out = sources[index];
 	source->retain();
 	return true;
 }
 
+bool Pool::assignSources(const std::vector<love::audio::Source*> &list, ALuint *out, char *wasPlaying)
+{
+	for (size_t i = 0; i < list.size(); i++)
+	{
+		if (!assignSource((Source *) list[i], out[i], wasPlaying[i]))
+		{
+			for (size_t j = 0; j < i; j++)
+			{
+				if (!wasPlaying[j])
+					releaseSource((Source *) list[j], false);
+			}
+			return false;
+		}
+	}
+
+	return true;
+}
+
 bool Pool::releaseSource(Source *source, bool stop)
 {
-	ALuint s;
+	int index = findSlot(source);
+
+	if (index < 0)
+		return false;
+
+	releaseSlot(index, stop);
+	return true;
+}
+
+void Pool::releaseSources(const std::vector<love::audio::Source*> &list, bool stop)
+{
+	for (love::audio::Source *s : list)
+		releaseSource((Source *) s, stop);
+}
+
+bool Pool::findSource(Source *source, ALuint &out)
+{
+	int index = findSlot(source);
+
+	if (index < 0)
+		return false;
+
+	out = sources[index];
+	return true;
+}
 
-	if (findSource(source, s))
+int Pool::findSlot(const Source *source) const
+{
+	const Handle &handle = source->poolHandle;
+
+	if (handle.index >= totalSources)
+		return -1;
+
+	const Slot &slot = slots[handle.index];
+	if (slot.owner != source || slot.generation != handle.generation)
+		return -1;
+
+	return handle.index;
+}
+
+void Pool::releaseSlot(int index, bool stop)
+{
+	Slot &slot = slots[index];
+	Source *source = slot.owner;
+
+	// Swap-remove from the active list.
+	int last = activeSlots[--activeCount];
+	activeSlots[slot.activeIndex] = last;
+	slots[last].activeIndex = slot.activeIndex;
+
+	slot.owner = nullptr;
+	slot.activeIndex = -1;
+	slot.generation++;
+
+	freeSlots[freeCount++] = index;
+
+	source->poolHandle = Handle();
+
+	if (stop)
+		source->stopAtomic();
+
+	// This may be the last reference to the Source, so it must be done last.
+	source->release();
+}
+
+bool Pool::addVirtual(Source *source)
+{
+	if (source->virtualVoice)
+		return true;
+
+	if (!source->canBeVirtual())
+		return false;
+
+	source->retain();
+	source->startVirtualAtomic(timer::Timer::getTime());
+	virtualSources.push_back(source);
+	return true;
+}
+
+bool Pool::removeVirtual(Source *source)
+{
+	for (size_t i = 0; i < virtualSources.size(); i++)
 	{
-		if (stop)
-			source->stopAtomic();
+		if (virtualSources[i] != source)
+			continue;
+
+		virtualSources[i] = virtualSources.back();
+		virtualSources.pop_back();
+
+		source->stopVirtualAtomic();
 		source->release();
-		available.push(s);
-		playing.erase(source);
 		return true;
 	}
 
 	return false;
 }
 
-bool Pool::findSource(Source *source, ALuint &out)
+void Pool::removeAllVirtual()
 {
-	std::map<Source *, ALuint>::const_iterator i = playing.find(source);
+	// Releasing may destroy a Source, so detach the whole list first.
+	std::vector<Source *> sources;
+	sources.swap(virtualSources);
 
-	if (i == playing.end())
-		return false;
+	for (Source *source : sources)
+	{
+		source->stopVirtualAtomic();
+		source->release();
+	}
+}
 
-	out = i->second;
-	return true;
+void Pool::virtualizeSlot(int index)
+{
+	Source *source = slots[index].owner;
+
+	// The virtual list takes over the slot's reference.
+	source->retain();
+	source->virtualizeAtomic(timer::Timer::getTime());
+	releaseSlot(index, false);
+
+	virtualSources.push_back(source);
+}
+
+int Pool::findVictimSlot(double score)
+{
+	int victim = -1;
+	double lowest = score;
+
+	for (int i = 0; i < activeCount; i++)
+	{
+		int index = activeSlots[i];
+		const Source *source = slots[index].owner;
+
+		if (!source->canBeVirtual())
+			continue;
+
+		double s = getVoiceScore(source);
+		if (s < lowest)
+		{
+			lowest = s;
+			victim = index;
+		}
+	}
+
+	return victim;
+}
+
+void Pool::updateVirtualVoices()
+{
+	if (virtualSources.empty())
+		return;
+
+	double time = timer::Timer::getTime();
+
+	for (int i = (int) virtualSources.size() - 1; i >= 0; i--)
+	{
+		Source *source = virtualSources[i];
+		if (source->advanceVirtualAtomic(time))
+			continue;
+
+		virtualSources[i] = virtualSources.back();
+		virtualSources.pop_back();
+
+		source->stopVirtualAtomic();
+		source->release();
+	}
+
+	updateListener();
+
+	// Bind the highest ranked virtual voices while there are free sources, or
+	// while they outrank the lowest ranked bound voice. Each iteration binds
+	// one voice, so this can't run longer than there are sources.
+	for (int n = 0; n < totalSources && !virtualSources.empty(); n++)
+	{
+		int best = -1;
+		double bestScore = -std::numeric_limits<double>::infinity();
+
+		for (int i = 0; i < (int) virtualSources.size(); i++)
+		{
+			const Source *source = virtualSources[i];
+			if (source->virtualPaused)
+				continue;
+
+			double score = getVoiceScore(source);
+			if (score > bestScore)
+			{
+				best = i;
+				bestScore = score;
+			}
+		}
+
+		// Nothing audible left to bind.
+		if (best < 0)
+			break;
+
+		if (freeCount == 0)
+		{
+			int victim = findVictimSlot(bestScore);
+			if (victim < 0)
+				break;
+
+			// Appends to the virtual list, so best stays valid.
+			virtualizeSlot(victim);
+		}
+
+		Source *source = virtualSources[best];
+		virtualSources[best] = virtualSources.back();
+		virtualSources.pop_back();
+
+		ALuint out;
+		char wasPlaying;
+		assignSource(source, out, wasPlaying);
+		source->bindVirtualAtomic(out);
+
+		// Drop the virtual list's reference now that the slot holds one.
+		source->release();
+	}
+}
+
+void Pool::updateListener()
+{
+	alGetListenerfv(AL_POSITION, listenerPosition);
+	distanceModel = alGetInteger(AL_DISTANCE_MODEL);
+}
+
+double Pool::getVoiceScore(const Source *source) const
+{
+	float audibility = source->getAudibilityAtomic(listenerPosition, distanceModel);
+
+	// Inaudible Sources rank below everything else.
+	if (audibility <= INAUDIBLE_GAIN)
+		return -std::numeric_limits<double>::infinity();
+
+	// Priority decides first, audibility breaks ties within a priority.
+	return (double) source->getPriority() + std::min(audibility, 1.0f) * 0.5;
 }
 
 thread::Lock Pool::lock()
@@ -226,13 +513,127 @@ thread::Lock Pool::lock()
 	return thread::Lock(mutex);
 }
 
-std::vector<love::audio::Source*> Pool::getPlayingSources()
+const std::vector<love::audio::Source*> &Pool::getPlayingSources()
+{
+	playingList.clear();
+	for (int i = 0; i < activeCount; i++)
+		playingList.push_back(slots[activeSlots[i]].owner);
+	return playingList;
+}
+
+void Pool::addStream(StreamRing *ring)
 {
-	std::vector<love::audio::Source*> sources;
-	sources.reserve(playing.size());
-	for (auto &i : playing)
-		sources.push_back(i.first);
-	return sources;
+	thread::Lock lock(streamMutex);
+
+	// A registered stream may have been seeked, so wake the threads either way.
+	bool found = false;
+	for (const StreamEntry &e : streams)
+		found = found || e.ring.get() == ring;
+
+	if (!found)
+	{
+		streams.push_back({ring, false});
+		ring->setDecodeAhead(true);
+	}
+
+	streamCond->broadcast();
+}
+
+void Pool::removeStream(StreamRing *ring)
+{
+	thread::Lock lock(streamMutex);
+
+	for (size_t i = 0; i < streams.size(); i++)
+	{
+		if (streams[i].ring.get() == ring)
+		{
+			// A decode thread which is still filling the ring holds its own
+			// reference, so it's safe to let go of it here.
+			ring->setDecodeAhead(false);
+			streams.erase(streams.begin() + i);
+			return;
+		}
+	}
+}
+
+void Pool::wakeDecodeThreads()
+{
+	// Signaling under the mutex means a thread which just found nothing to do
+	// is already waiting, so the wakeup can't be missed.
+	thread::Lock lock(streamMutex);
+	streamCond->signal();
+}
+
+StreamRing *Pool::takeStreamAtomic()
+{
+	size_t count = streams.size();
+
+	for (size_t n = 0; n < count; n++)
+	{
+		size_t i = (streamCursor + n) % count;
+		StreamEntry &e = streams[i];
+
+		if (!e.busy && e.ring->needsData())
+		{
+			e.busy = true;
+			streamCursor = (i + 1) % count;
+			return e.ring.get();
+		}
+	}
+
+	return nullptr;
+}
+
+void Pool::finishStreamAtomic(StreamRing *ring)
+{
+	for (StreamEntry &e : streams)
+	{
+		if (e.ring.get() == ring)
+		{
+			e.busy = false;
+			break;
+		}
+	}
+}
+
+Pool::DecodeThread::DecodeThread(Pool *pool)
+	: pool(pool)
+{
+	threadName = "AudioDecode";
+}
+
+Pool::DecodeThread::~DecodeThread()
+{
+}
+
+void Pool::DecodeThread::threadFunction()
+{
+	while (true)
+	{
+		StrongRef<StreamRing> ring;
+
+		{
+			thread::Lock lock(pool->streamMutex);
+
+			if (pool->decodeFinish)
+				return;
+
+			ring.set(pool->takeStreamAtomic());
+
+			if (ring.get() == nullptr)
+			{
+				// Sleep until the pool thread consumes a chunk, or a stream
+				// starts playing, seeks or starts looping.
+				pool->streamCond->wait(pool->streamMutex);
+				continue;
+			}
+		}
+
+		ring->fill();
+
+		thread::Lock lock(pool->streamMutex);
+		pool->finishStreamAtomic(ring.get());
+	}
 }
 
 } // openal
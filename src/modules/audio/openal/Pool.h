@@ -22,16 +22,16 @@
 #define LOVE_AUDIO_OPENAL_POOL_H
 
 // STD
-#include <queue>
-#include <map>
 #include <vector>
 #include <cmath>
 
 // LOVE
 #include "common/config.h"
 #include "common/Exception.h"
+#include "common/int.h"
 #include "thread/threads.h"
 #include "audio/Source.h"
+#include "StreamRing.h"
 
 // OpenAL
 #ifdef LOVE_APPLE_USE_FRAMEWORKS
@@ -64,6 +64,19 @@ class Pool
 {
 public:
 
+	static const uint16 INVALID_SLOT = 0xFFFF;
+
+	/**
+	 * Identifies the slot a Source occupies in the pool's source table. The
+	 * slot's generation is bumped every time it is released, so a stale
+	 * handle never matches a newer owner of the same slot.
+	 **/
+	struct Handle
+	{
+		uint16 index = INVALID_SLOT;
+		uint16 generation = 0;
+	};
+
 	Pool(ALCdevice *device);
 	~Pool();
 
@@ -83,11 +96,22 @@ class Pool
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
 
+	/**
+	 * Gets the number of Sources which are playing without an OpenAL source.
+	 **/
+	int getVirtualSourceCount() const;
+
 private:
 
 	friend class Source;
 	LOVE_WARN_UNUSED thread::Lock lock();
-	std::vector<love::audio::Source*> getPlayingSources();
+
+	/**
+	 * Gets the list of Sources currently holding an OpenAL source. The
+	 * returned list is owned by the pool and is only valid until the next
+	 * call, or until the pool's lock is released.
+	 **/
+	const std::vector<love::audio::Source*> &getPlayingSources();
 
 	/**
 	 * Makes the specified OpenAL source available for use.
@@ -95,34 +119,157 @@ class Pool
 	 **/
 	bool releaseSource(Source *source, bool stop = true);
 
-	bool assignSource(Source *source, ALuint &out, char &wasPlaying);
+	/**
+	 * Assigns an OpenAL source to a Source.
+	 * @param steal Whether a lower ranked Source may be made virtual to free
+	 * up an OpenAL source when none are available.
+	 **/
+	bool assignSource(Source *source, ALuint &out, char &wasPlaying, bool steal = false);
 	bool findSource(Source *source, ALuint &out);
 
+	/**
+	 * Assigns OpenAL sources to a whole group of Sources at once. Either all
+	 * of them get a source or none of them do.
+	 * @param out Receives the OpenAL source of each Source.
+	 * @param wasPlaying Receives whether each Source already had a source.
+	 **/
+	bool assignSources(const std::vector<love::audio::Source*> &sources, ALuint *out, char *wasPlaying);
+
+	/**
+	 * Releases the OpenAL sources of a group of Sources.
+	 **/
+	void releaseSources(const std::vector<love::audio::Source*> &sources, bool stop = true);
+
+	int findSlot(const Source *source) const;
+	void releaseSlot(int index, bool stop);
+
+	/**
+	 * Keeps a Source playing without an OpenAL source. Its playback position
+	 * keeps advancing, and update() binds it again once it ranks high enough.
+	 * @return False if the Source can't be played virtually.
+	 **/
+	bool addVirtual(Source *source);
+	bool removeVirtual(Source *source);
+	void removeAllVirtual();
+
+	/**
+	 * Moves the Source in the given slot to the virtual list, freeing the slot.
+	 **/
+	void virtualizeSlot(int index);
+
+	/**
+	 * Finds the lowest ranked slot whose Source can be made virtual and which
+	 * ranks below the given score, or -1.
+	 **/
+	int findVictimSlot(double score);
+
+	void updateVirtualVoices();
+	void updateListener();
+	double getVoiceScore(const Source *source) const;
+
+	/**
+	 * Registers a playing stream with the decode threads, which decode its
+	 * audio ahead of time until it's removed again.
+	 **/
+	void addStream(StreamRing *ring);
+	void removeStream(StreamRing *ring);
+
+	/**
+	 * Lets the decode threads know a stream may need more data.
+	 **/
+	void wakeDecodeThreads();
+
+	class DecodeThread : public thread::Threadable
+	{
+	public:
+		DecodeThread(Pool *pool);
+		virtual ~DecodeThread();
+		void threadFunction();
+
+	private:
+		Pool *pool;
+	};
+
+	struct StreamEntry
+	{
+		StrongRef<StreamRing> ring;
+
+		// Whether a decode thread is currently filling this ring.
+		bool busy;
+	};
+
+	/**
+	 * Picks the next ring which needs data and isn't being filled already,
+	 * round-robin. The stream mutex must be held.
+	 **/
+	StreamRing *takeStreamAtomic();
+	void finishStreamAtomic(StreamRing *ring);
+
+	// Number of threads decoding streams ahead of time.
+	static const int DECODE_THREADS = 2;
+
 	// Maximum possible number of OpenAL sources the pool attempts to generate.
 	static const int MAX_SOURCES = 64;
 
+	struct Slot
+	{
+		// The love Source currently using this slot's OpenAL source, if any.
+		Source *owner = nullptr;
+
+		// Incremented every time the slot is released.
+		uint16 generation = 0;
+
+		// Position of this slot in the active list, or -1 when free.
+		int activeIndex = -1;
+	};
+
 	// Current OpenAL device
 	ALCdevice *device;
 
 	// OpenAL sources
 	ALuint sources[MAX_SOURCES];
 
+	// Per-source bookkeeping, indexed the same way as sources.
+	Slot slots[MAX_SOURCES];
+
+	// Stack of free slot indices.
+	int freeSlots[MAX_SOURCES];
+	int freeCount;
+
+	// Densely packed indices of the slots which are in use.
+	int activeSlots[MAX_SOURCES];
+	int activeCount;
+
+	// Scratch storage for getPlayingSources, reused to avoid allocations.
+	std::vector<love::audio::Source*> playingList;
+
+	// Sources which are logically playing but don't hold an OpenAL source.
+	std::vector<Source *> virtualSources;
+
+	// Listener state used to rank voices, refreshed every update.
+	float listenerPosition[3];
+	ALint distanceModel;
+
 	// Is device disconnection has been notified?
 	bool disconnectNotified;
 
 	// Total number of created sources in the pool.
 	int totalSources;
 
-	// A queue of available sources.
-	std::queue<ALuint> available;
-
-	// A map of playing sources.
-	std::map<Source *, ALuint> playing;
-
 	// Only one thread can access this object at the same time. This mutex will
 	// make sure of that.
 	love::thread::MutexRef mutex;
 
+	// Streams being decoded ahead and the threads doing it. Guarded by
+	// streamMutex, which may be locked while holding the pool's mutex but
+	// never the other way around.
+	std::vector<StreamEntry> streams;
+	size_t streamCursor;
+	bool decodeFinish;
+	DecodeThread *decodeThreads[DECODE_THREADS];
+	love::thread::MutexRef streamMutex;
+	love::thread::ConditionalRef streamCond;
+
 }; // Pool
 
 } // openal
@@ -106,8 +106,11 @@ class QueueLoopingException : public love::Exception
 
 };
 
-StaticDataBuffer::StaticDataBuffer(ALenum format, const ALvoid *data, ALsizei size, ALsizei freq)
+StaticDataBuffer::StaticDataBuffer(ALenum format, const ALvoid *data, ALsizei size, ALsizei freq, int channels, int bitDepth)
 	: size(size)
+	, sampleRate(freq)
+	, channels(channels)
+	, bitDepth(bitDepth)
 {
 	alGenBuffers(1, &buffer);
 	alBufferData(buffer, format, data, size, freq);
@@ -129,7 +132,7 @@ Source::Source(Pool *pool, love::sound::SoundData *soundData)
 	if (fmt == AL_NONE)
 		throw InvalidFormatException(soundData->getChannelCount(), soundData->getBitDepth());
 
-	staticBuffer.set(new StaticDataBuffer(fmt, soundData->getData(), (ALsizei) soundData->getSize(), sampleRate), Acquire::NORETAIN);
+	staticBuffer.set(new StaticDataBuffer(fmt, soundData->getData(), (ALsizei) soundData->getSize(), sampleRate, channels, bitDepth), Acquire::NORETAIN);
 
 	float z[3] = {0, 0, 0};
 
@@ -141,6 +144,24 @@ Source::Source(Pool *pool, love::sound::SoundData *soundData)
 		slotlist.push(i);
 }
 
+Source::Source(Pool *pool, StaticDataBuffer *buffer)
+	: love::audio::Source(Source::TYPE_STATIC)
+	, pool(pool)
+	, staticBuffer(buffer)
+	, sampleRate(buffer->getSampleRate())
+	, channels(buffer->getChannelCount())
+	, bitDepth(buffer->getBitDepth())
+{
+	float z[3] = {0, 0, 0};
+
+	setFloatv(position, z);
+	setFloatv(velocity, z);
+	setFloatv(direction, z);
+
+	for (int i = 0; i < audiomodule()->getMaxSourceEffects(); i++)
+		slotlist.push(i);
+}
+
 Source::Source(Pool *pool, love::sound::Decoder *decoder)
 	: love::audio::Source(Source::TYPE_STREAM)
 	, pool(pool)
@@ -150,9 +171,12 @@ Source::Source(Pool *pool, love::sound::Decoder *decoder)
 	, decoder(decoder)
 	, buffers(DEFAULT_BUFFERS)
 {
-	if (Audio::getFormat(decoder->getBitDepth(), decoder->getChannelCount()) == AL_NONE)
+	ALenum format = Audio::getFormat(decoder->getBitDepth(), decoder->getChannelCount());
+	if (format == AL_NONE)
 		throw InvalidFormatException(decoder->getChannelCount(), decoder->getBitDepth());
 
+	ring.set(new StreamRing(decoder, format, isLooping()), Acquire::NORETAIN);
+
 	for (int i = 0; i < buffers; i++)
 	{
 		ALuint buf;
@@ -232,6 +256,7 @@ Source::Source(const Source &s)
 	, maxDistance(s.maxDistance)
 	, cone(s.cone)
 	, offsetSamples(0)
+	, priority(s.priority.load())
 	, sampleRate(s.sampleRate)
 	, channels(s.channels)
 	, bitDepth(s.bitDepth)
@@ -242,7 +267,12 @@ Source::Source(const Source &s)
 	if (sourceType == TYPE_STREAM)
 	{
 		if (s.decoder.get())
+		{
 			decoder.set(s.decoder->clone(), Acquire::NORETAIN);
+
+			ALenum format = Audio::getFormat(bitDepth, channels);
+			ring.set(new StreamRing(decoder, format, isLooping()), Acquire::NORETAIN);
+		}
 	}
 	if (sourceType != TYPE_STATIC)
 	{
@@ -326,11 +356,23 @@ love::audio::Source *Source::clone()
 bool Source::play()
 {
 	Lock l = pool->lock();
+
+	if (virtualVoice)
+	{
+		virtualPaused = false;
+		return true;
+	}
+
 	ALuint out;
 
 	char wasPlaying;
-	if (!pool->assignSource(this, out, wasPlaying))
-		return valid = false;
+	if (!pool->assignSource(this, out, wasPlaying, true))
+	{
+		// Every OpenAL source is used by a higher ranked Source. Keep playing
+		// virtually until one becomes available.
+		valid = false;
+		return pool->addVirtual(this);
+	}
 
 	if (!wasPlaying)
 		return valid = playAtomic(out);
@@ -341,22 +383,30 @@ bool Source::play()
 
 void Source::stop()
 {
-	if (!valid)
+	if (!valid && !virtualVoice)
 		return;
 
 	Lock l = pool->lock();
-	pool->releaseSource(this);
+	if (virtualVoice)
+		pool->removeVirtual(this);
+	else
+		pool->releaseSource(this);
 }
 
 void Source::pause()
 {
 	Lock l = pool->lock();
-	if (pool->isPlaying(this))
+	if (virtualVoice)
+		virtualPaused = true;
+	else if (pool->isPlaying(this))
 		pauseAtomic();
 }
 
 bool Source::isPlaying() const
 {
+	if (virtualVoice)
+		return !virtualPaused;
+
 	if (!valid)
 		return false;
 
@@ -370,7 +420,7 @@ bool Source::isFinished() const
 	if (!valid)
 		return false;
 
-	if (sourceType == TYPE_STREAM && (isLooping() || !decoder->isFinished()))
+	if (sourceType == TYPE_STREAM && (isLooping() || !ring->isFinished()))
 		return false;
 
 	ALenum state;
@@ -419,7 +469,7 @@ bool Source::update()
 
 					offsetSamples += (curOffsetSamples - newOffsetSamples);
 
-					if (streamAtomic(buffer, decoder.get()) > 0)
+					if (streamAtomic(buffer) > 0)
 						alSourceQueueBuffers(source, 1, &buffer);
 					else
 						unusedBuffers.push(buffer);
@@ -428,7 +478,7 @@ bool Source::update()
 				while (!unusedBuffers.empty())
 				{
 					ALuint b = unusedBuffers.top();
-					if (streamAtomic(b, decoder.get()) > 0)
+					if (streamAtomic(b) > 0)
 					{
 						alSourceQueueBuffers(source, 1, &b);
 						unusedBuffers.pop();
@@ -526,6 +576,12 @@ void Source::seek(double offset, Source::Unit unit)
 		break;
 	}
 
+	if (virtualVoice)
+	{
+		virtualPosition = offsetSamples;
+		return;
+	}
+
 	bool wasPlaying = isPlaying();
 	switch (sourceType)
 	{
@@ -542,7 +598,7 @@ void Source::seek(double offset, Source::Unit unit)
 			if (valid)
 				stop();
 
-			decoder->seek(offsetSeconds);
+			ring->seek(offsetSeconds);
 
 			if (wasPlaying)
 				play();
@@ -600,7 +656,10 @@ double Source::tell(Source::Unit unit)
 	if (valid)
 		alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
 
-	offset += offsetSamples;
+	if (virtualVoice)
+		offset = (int) virtualPosition;
+	else
+		offset += offsetSamples;
 
 	if (unit == UNIT_SECONDS)
 		return offset / (double) sampleRate;
@@ -626,7 +685,7 @@ double Source::getDuration(Unit unit)
 	}
 	case TYPE_STREAM:
 	{
-		double seconds = decoder->getDuration();
+		double seconds = ring->getDuration();
 
 		if (unit == UNIT_SECONDS)
 			return seconds;
@@ -773,6 +832,14 @@ void Source::setLooping(bool enable)
 	if (valid && sourceType == TYPE_STATIC)
 		alSourcei(source, AL_LOOPING, enable ? AL_TRUE : AL_FALSE);
 
+	if (sourceType == TYPE_STREAM)
+	{
+		ring->setLooping(enable);
+
+		// Looping can make a finished stream need data again.
+		pool->wakeDecodeThreads();
+	}
+
 	looping = enable;
 }
 
@@ -813,6 +880,21 @@ bool Source::queue(void *data, size_t length, int dataSampleRate, int dataBitDep
 	return true;
 }
 
+void Source::setPriority(int priority)
+{
+	this->priority = priority;
+}
+
+int Source::getPriority() const
+{
+	return priority;
+}
+
+bool Source::isVirtual() const
+{
+	return virtualVoice;
+}
+
 int Source::getFreeBufferCount() const
 {
 	switch (sourceType) //why not :^)
@@ -845,15 +927,18 @@ void Source::prepareAtomic()
 		while (!unusedBuffers.empty())
 		{
 			auto b = unusedBuffers.top();
-			if (streamAtomic(b, decoder.get()) == 0)
+			if (streamAtomic(b) == 0)
 				break;
 
 			alSourceQueueBuffers(source, 1, &b);
 			unusedBuffers.pop();
 
-			if (decoder->isFinished())
+			if (ring->isFinished())
 				break;
 		}
+
+		// The first buffers are decoded right away, the rest ahead of time.
+		pool->addStream(ring);
 		break;
 	case TYPE_QUEUE:
 	{
@@ -883,8 +968,10 @@ void Source::teardownAtomic()
 		ALint queued = 0;
 		ALuint buffers[MAX_BUFFERS];
 
+		pool->removeStream(ring);
+
 		// Some decoders (e.g. ModPlug) can rewind() more reliably than seek(0).
-		decoder->rewind();
+		ring->rewind();
 
 		// Drain buffers.
 		// NOTE: The Apple implementation of OpenAL on iOS doesn't return
@@ -991,15 +1078,18 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 	std::vector<char> wasPlaying(sources.size());
 	std::vector<ALuint> ids(sources.size());
 
-	for (size_t i = 0; i < sources.size(); i++)
+	bool hasVirtual = std::any_of(sources.begin(), sources.end(), [](love::audio::Source *s) {
+		return ((Source *) s)->virtualVoice.load();
+	});
+
+	if (hasVirtual || !pool->assignSources(sources, ids.data(), wasPlaying.data()))
 	{
-		if (!pool->assignSource((Source*) sources[i], ids[i], wasPlaying[i]))
-		{
-			for (size_t j = 0; j < i; j++)
-				if (!wasPlaying[j])
-					pool->releaseSource((Source*) sources[j], false);
-			return false;
-		}
+		// The group doesn't fit in the free OpenAL sources. Play its Sources
+		// one by one instead, which lets lower ranked ones become virtual.
+		bool success = true;
+		for (love::audio::Source *s : sources)
+			success = s->play() && success;
+		return success;
 	}
 
 	std::vector<ALuint> toPlay;
@@ -1062,7 +1152,16 @@ void Source::stop(const std::vector<love::audio::Source*> &sources)
 		Source *source = (Source*) _source;
 		if (source->valid)
 			source->teardownAtomic();
-		pool->releaseSource(source, false);
+	}
+
+	pool->releaseSources(sources, false);
+
+	// Done last, since this may release the final reference to a Source.
+	for (auto &_source : sources)
+	{
+		Source *source = (Source*) _source;
+		if (source->virtualVoice)
+			pool->removeVirtual(source);
 	}
 }
 
@@ -1080,6 +1179,8 @@ void Source::pause(const std::vector<love::audio::Source*> &sources)
 		Source *source = (Source*) _source;
 		if (source->valid)
 			sourceIds.push_back(source->source);
+		else if (source->virtualVoice)
+			source->virtualPaused = true;
 	}
 
 	alSourcePausev((ALsizei) sourceIds.size(), &sourceIds[0]);
@@ -1089,6 +1190,7 @@ std::vector<love::audio::Source*> Source::pause(Pool *pool)
 {
 	Lock l = pool->lock();
 	std::vector<love::audio::Source*> sources = pool->getPlayingSources();
+	sources.insert(sources.end(), pool->virtualSources.begin(), pool->virtualSources.end());
 
 	auto newend = std::remove_if(sources.begin(), sources.end(), [](love::audio::Source* s) {
 		return !s->isPlaying();
@@ -1103,6 +1205,7 @@ void Source::stop(Pool *pool)
 {
 	Lock l = pool->lock();
 	stop(pool->getPlayingSources());
+	pool->removeAllVirtual();
 }
 
 void Source::reset()
@@ -1137,6 +1240,149 @@ void Source::reset()
 #endif
 }
 
+float Source::getAudibilityAtomic(const float *listener, ALint distanceModel) const
+{
+	float gain = volume;
+
+	// Only mono Sources are spatialized.
+	if (channels == 1 && distanceModel != AL_NONE)
+	{
+		float d[3] = {position[0], position[1], position[2]};
+		if (!relative)
+		{
+			d[0] -= listener[0];
+			d[1] -= listener[1];
+			d[2] -= listener[2];
+		}
+
+		float distance = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+		float ref = referenceDistance;
+
+		switch (distanceModel)
+		{
+		case AL_INVERSE_DISTANCE_CLAMPED:
+		case AL_LINEAR_DISTANCE_CLAMPED:
+		case AL_EXPONENT_DISTANCE_CLAMPED:
+			distance = std::max(std::min(distance, maxDistance), ref);
+			break;
+		default:
+			break;
+		}
+
+		// These follow the attenuation formulas in the OpenAL specification.
+		switch (distanceModel)
+		{
+		case AL_INVERSE_DISTANCE:
+		case AL_INVERSE_DISTANCE_CLAMPED:
+		{
+			float denom = ref + rolloffFactor * (distance - ref);
+			if (denom > 0.0f)
+				gain *= ref / denom;
+			break;
+		}
+		case AL_LINEAR_DISTANCE:
+		case AL_LINEAR_DISTANCE_CLAMPED:
+			if (maxDistance > ref)
+				gain *= std::max(1.0f - rolloffFactor * (std::min(distance, maxDistance) - ref) / (maxDistance - ref), 0.0f);
+			break;
+		case AL_EXPONENT_DISTANCE:
+		case AL_EXPONENT_DISTANCE_CLAMPED:
+			if (distance > 0.0f && ref > 0.0f)
+				gain *= powf(distance / ref, -rolloffFactor);
+			break;
+		default:
+			break;
+		}
+	}
+
+	return std::min(std::max(gain, minVolume), maxVolume);
+}
+
+void Source::startVirtualAtomic(double time)
+{
+	// Start from the pending offset, if any.
+	virtualVoice = true;
+	virtualPaused = false;
+	virtualPosition = offsetSamples;
+	virtualTime = time;
+}
+
+void Source::virtualizeAtomic(double time)
+{
+	ALint offset = 0;
+	ALint state = AL_PLAYING;
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+
+	double position = (double) (offset + offsetSamples);
+
+	stopAtomic();
+
+	virtualVoice = true;
+	virtualPaused = state == AL_PAUSED;
+	virtualPosition = position;
+	virtualTime = time;
+}
+
+bool Source::advanceVirtualAtomic(double time)
+{
+	double dt = time - virtualTime;
+	virtualTime = time;
+
+	if (virtualPaused)
+		return true;
+
+	virtualPosition += dt * pitch * sampleRate;
+
+	// Streams of unknown length can only find out they've ended once bound.
+	double length = getDuration(UNIT_SAMPLES);
+	if (length > 0.0 && virtualPosition >= length)
+	{
+		if (!isLooping())
+			return false;
+
+		virtualPosition = fmod(virtualPosition, length);
+	}
+
+	return true;
+}
+
+bool Source::bindVirtualAtomic(ALuint source)
+{
+	int position = (int) virtualPosition;
+	virtualVoice = false;
+
+	bool success = false;
+
+	if (sourceType == TYPE_STREAM)
+	{
+		// Streams are positioned by their decoder rather than by OpenAL.
+		ring->seek(position / (double) sampleRate);
+		offsetSamples = 0;
+		success = playAtomic(source);
+		if (success)
+			offsetSamples = position;
+	}
+	else
+	{
+		offsetSamples = position;
+		success = playAtomic(source);
+	}
+
+	return valid = success;
+}
+
+void Source::stopVirtualAtomic()
+{
+	virtualVoice = false;
+	virtualPaused = false;
+	virtualPosition = 0.0;
+	offsetSamples = 0;
+
+	if (sourceType == TYPE_STREAM)
+		ring->rewind();
+}
+
 void Source::setFloatv(float *dst, const float *src) const
 {
 	dst[0] = src[0];
@@ -1144,21 +1390,15 @@ void Source::setFloatv(float *dst, const float *src) const
 	dst[2] = src[2];
 }
 
-int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
+int Source::streamAtomic(ALuint buffer)
 {
 	// Get more sound data.
-	int decoded = std::max(d->decode(), 0);
+	bool loopEnd = false;
+	int decoded = ring->upload(buffer, loopEnd);
 
-	// OpenAL implementations are allowed to ignore 0-size alBufferData calls.
+	// There's room in the ring for another chunk now.
 	if (decoded > 0)
-	{
-		int fmt = Audio::getFormat(d->getBitDepth(), d->getChannelCount());
-
-		if (fmt != AL_NONE)
-			alBufferData(buffer, fmt, d->getBuffer(), decoded, d->getSampleRate());
-		else
-			decoded = 0;
-	}
+		pool->wakeDecodeThreads();
 
 	// This shouldn't run after toLoop is calculated in this streamAtomic call,
 	// otherwise it'll decrease too quickly.
@@ -1173,7 +1413,7 @@ int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
 		}
 	}
 
-	if (decoder->isFinished() && isLooping())
+	if (loopEnd)
 	{
 		int queued, processed;
 		alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
@@ -1182,7 +1422,6 @@ int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
 			toLoop = queued-processed;
 		else
 			toLoop = buffers-processed;
-		d->rewind();
 	}
 
 	return decoded;
@@ -30,8 +30,11 @@
 #include "sound/Decoder.h"
 #include "Audio.h"
 #include "Filter.h"
+#include "Pool.h"
+#include "StreamRing.h"
 
 // STL
+#include <atomic>
 #include <vector>
 #include <stack>
 
@@ -66,6 +69,9 @@ static const float MAX_ATTENUATION_DISTANCE = 1000000.0f;
 static const float MAX_ATTENUATION_DISTANCE = FLT_MAX;
 #endif
 
+// Sources attenuated below this gain (-80 dB) are considered inaudible.
+static const float INAUDIBLE_GAIN = 0.0001f;
+
 class Audio;
 class Pool;
 
@@ -74,7 +80,7 @@ class StaticDataBuffer : public love::Object
 {
 public:
 
-	StaticDataBuffer(ALenum format, const ALvoid *data, ALsizei size, ALsizei freq);
+	StaticDataBuffer(ALenum format, const ALvoid *data, ALsizei size, ALsizei freq, int channels, int bitDepth);
 	virtual ~StaticDataBuffer();
 
 	inline ALuint getBuffer() const
@@ -87,10 +93,28 @@ class StaticDataBuffer : public love::Object
 		return size;
 	}
 
+	inline int getSampleRate() const
+	{
+		return sampleRate;
+	}
+
+	inline int getChannelCount() const
+	{
+		return channels;
+	}
+
+	inline int getBitDepth() const
+	{
+		return bitDepth;
+	}
+
 private:
 
 	ALuint buffer;
 	ALsizei size;
+	int sampleRate;
+	int channels;
+	int bitDepth;
 
 }; // StaticDataBuffer
 
@@ -99,6 +123,7 @@ class Source : public love::audio::Source
 public:
 
 	Source(Pool *pool, love::sound::SoundData *soundData);
+	Source(Pool *pool, StaticDataBuffer *buffer);
 	Source(Pool *pool, love::sound::Decoder *decoder);
 	Source(Pool *pool, int sampleRate, int bitDepth, int channels, int buffers);
 	Source(const Source &s);
@@ -157,6 +182,12 @@ class Source : public love::audio::Source
 	virtual int getFreeBufferCount() const;
 	virtual bool queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels);
 
+	virtual void setPriority(int priority);
+	virtual int getPriority() const;
+	virtual bool isVirtual() const;
+
+	StaticDataBuffer *getStaticBuffer() const { return staticBuffer.get(); }
+
 	void prepareAtomic();
 	void teardownAtomic();
 
@@ -174,13 +205,31 @@ class Source : public love::audio::Source
 
 private:
 
+	friend class Pool;
+
 	void reset();
 
 	void setFloatv(float *dst, const float *src) const;
 
-	int streamAtomic(ALuint buffer, love::sound::Decoder *d);
+	int streamAtomic(ALuint buffer);
+
+	// Queueable Sources can't be resumed at an arbitrary position.
+	bool canBeVirtual() const { return sourceType != TYPE_QUEUE; }
+
+	/**
+	 * Estimates the gain OpenAL would apply to this Source, including distance
+	 * attenuation relative to the given listener position.
+	 **/
+	float getAudibilityAtomic(const float *listener, ALint distanceModel) const;
+
+	void startVirtualAtomic(double time);
+	void virtualizeAtomic(double time);
+	bool advanceVirtualAtomic(double time);
+	bool bindVirtualAtomic(ALuint source);
+	void stopVirtualAtomic();
 
 	Pool *pool = nullptr;
+	Pool::Handle poolHandle;
 	ALuint source = 0;
 	bool valid = false;
 
@@ -215,12 +264,26 @@ class Source : public love::audio::Source
 
 	int offsetSamples = 0;
 
+	// Atomic since the pool thread ranks voices while these can change.
+	std::atomic<int> priority{0};
+
+	// Virtual voice state: the Source is logically playing, but the Pool has
+	// no OpenAL source for it, so it advances its own playback position.
+	std::atomic<bool> virtualVoice{false};
+	bool virtualPaused = false;
+	double virtualPosition = 0.0; // In samples.
+	double virtualTime = 0.0;
+
 	int sampleRate = 0;
 	int channels = 0;
 	int bitDepth = 0;
 
 	StrongRef<love::sound::Decoder> decoder;
 
+	// Decoded audio waiting to be queued, filled ahead by the pool's decode
+	// threads while the Source is playing.
+	StrongRef<StreamRing> ring;
+
 	unsigned int toLoop = 0;
 	ALsizei bufferedBytes = 0;
 	int buffers = 0;
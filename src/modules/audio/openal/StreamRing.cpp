@@ -0,0 +1,312 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "StreamRing.h"
+
+// STD
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+StreamRing::StreamRing(love::sound::Decoder *decoder, ALenum format, bool looping)
+	: decoder(decoder)
+	, format(format)
+	, sampleRate(decoder->getSampleRate())
+	, frameSize(decoder->getChannelCount() * (decoder->getBitDepth() / 8))
+	, chunkSize(0)
+	, maxChunkSize(0)
+	, depth(4)
+	, looping(looping)
+	, finished(false)
+	, decodeAhead(false)
+{
+	int bytesPerSecond = sampleRate * frameSize;
+
+	// Never go below what a single decode call produces.
+	chunkSize = std::max(decoder->getSize(), (int) (bytesPerSecond * MIN_CHUNK_SECONDS));
+	chunkSize -= chunkSize % frameSize;
+
+	maxChunkSize = std::max(chunkSize, (int) (bytesPerSecond * MAX_CHUNK_SECONDS));
+	maxChunkSize -= maxChunkSize % frameSize;
+}
+
+StreamRing::~StreamRing()
+{
+}
+
+int StreamRing::upload(ALuint buffer, bool &loopEnd)
+{
+	Chunk chunk;
+	bool ready = false;
+
+	{
+		thread::Lock lock(queueMutex);
+		if (!chunks.empty())
+		{
+			chunk = std::move(chunks.front());
+			chunks.pop_front();
+			ready = true;
+		}
+		else if (finished)
+			return 0;
+	}
+
+	if (!ready)
+	{
+		thread::Lock lock(decodeMutex);
+		int size = 0;
+
+		{
+			thread::Lock qlock(queueMutex);
+
+			// A decode thread may have finished a chunk while we waited.
+			if (!chunks.empty())
+			{
+				chunk = std::move(chunks.front());
+				chunks.pop_front();
+				ready = true;
+			}
+			else if (finished)
+				return 0;
+			else
+			{
+				// The decode threads fell behind. Decode further ahead from
+				// now on so it doesn't happen again.
+				if (decodeAhead)
+					grow();
+
+				chunk = takeFreeChunk();
+				size = chunkSize;
+			}
+		}
+
+		if (!ready && decodeChunk(chunk, size))
+		{
+			thread::Lock qlock(queueMutex);
+			finished = true;
+		}
+	}
+
+	loopEnd = chunk.loopEnd;
+	int size = chunk.size;
+
+	// OpenAL implementations are allowed to ignore 0-size alBufferData calls.
+	if (size > 0)
+		alBufferData(buffer, format, chunk.data.data(), size, sampleRate);
+
+	thread::Lock lock(queueMutex);
+	freeChunks.push_back(std::move(chunk));
+
+	return size;
+}
+
+void StreamRing::fill()
+{
+	Chunk chunk;
+	int size = 0;
+
+	{
+		thread::Lock lock(queueMutex);
+		if (finished || (int) chunks.size() >= depth)
+			return;
+	}
+
+	thread::Lock lock(decodeMutex);
+
+	{
+		// Check again, the pool thread may have decoded or rewound meanwhile.
+		thread::Lock qlock(queueMutex);
+		if (finished || (int) chunks.size() >= depth)
+			return;
+
+		chunk = takeFreeChunk();
+		size = chunkSize;
+	}
+
+	bool end = decodeChunk(chunk, size);
+
+	// Seeking and rewinding need the decode mutex, so the chunk can't have
+	// been invalidated while it was decoded.
+	thread::Lock qlock(queueMutex);
+	chunks.push_back(std::move(chunk));
+	finished = end;
+}
+
+bool StreamRing::needsData()
+{
+	thread::Lock lock(queueMutex);
+	return !finished && (int) chunks.size() < depth;
+}
+
+bool StreamRing::isFinished()
+{
+	thread::Lock lock(queueMutex);
+	return finished && chunks.empty();
+}
+
+void StreamRing::setDecodeAhead(bool enable)
+{
+	thread::Lock lock(queueMutex);
+	decodeAhead = enable;
+}
+
+void StreamRing::seek(double seconds)
+{
+	thread::Lock lock(decodeMutex);
+	decoder->seek(seconds);
+
+	thread::Lock qlock(queueMutex);
+	clearChunks();
+}
+
+void StreamRing::rewind()
+{
+	thread::Lock lock(decodeMutex);
+	decoder->rewind();
+
+	thread::Lock qlock(queueMutex);
+	clearChunks();
+}
+
+void StreamRing::setLooping(bool looping)
+{
+	thread::Lock lock(decodeMutex);
+	thread::Lock qlock(queueMutex);
+
+	this->looping = looping;
+
+	if (looping)
+	{
+		// The end of the stream was reached before looping was enabled, but
+		// chunks are still waiting: continue from the start after them.
+		if (finished && !chunks.empty())
+		{
+			decoder->rewind();
+			finished = false;
+		}
+	}
+	else
+	{
+		// Drop anything decoded past a loop point which hasn't been uploaded.
+		for (size_t i = 0; i < chunks.size(); i++)
+		{
+			if (chunks[i].loopEnd)
+			{
+				chunks[i].loopEnd = false;
+				while (chunks.size() > i + 1)
+				{
+					freeChunks.push_back(std::move(chunks.back()));
+					chunks.pop_back();
+				}
+				finished = true;
+				break;
+			}
+		}
+	}
+}
+
+double StreamRing::getDuration()
+{
+	thread::Lock lock(decodeMutex);
+	return decoder->getDuration();
+}
+
+bool StreamRing::decodeChunk(Chunk &chunk, int size)
+{
+	chunk.size = 0;
+	chunk.loopEnd = false;
+
+	if ((int) chunk.data.size() < size)
+		chunk.data.resize(size);
+
+	while (chunk.size < size)
+	{
+		int decoded = std::max(decoder->decode(), 0);
+
+		if (decoded > 0)
+		{
+			if ((int) chunk.data.size() < chunk.size + decoded)
+				chunk.data.resize(chunk.size + decoded);
+
+			memcpy(chunk.data.data() + chunk.size, decoder->getBuffer(), decoded);
+			chunk.size += decoded;
+		}
+
+		if (decoder->isFinished())
+		{
+			bool loop = false;
+			{
+				thread::Lock lock(queueMutex);
+				loop = looping;
+			}
+
+			if (!loop)
+				return true;
+
+			// Chunks never span the loop point, so the Source can tell where
+			// playback wraps around.
+			decoder->rewind();
+			chunk.loopEnd = true;
+			return false;
+		}
+
+		if (decoded == 0)
+			break;
+	}
+
+	return false;
+}
+
+StreamRing::Chunk StreamRing::takeFreeChunk()
+{
+	if (freeChunks.empty())
+		return Chunk();
+
+	Chunk chunk = std::move(freeChunks.back());
+	freeChunks.pop_back();
+	return chunk;
+}
+
+void StreamRing::clearChunks()
+{
+	while (!chunks.empty())
+	{
+		freeChunks.push_back(std::move(chunks.front()));
+		chunks.pop_front();
+	}
+
+	finished = false;
+}
+
+void StreamRing::grow()
+{
+	chunkSize = std::min(chunkSize * 2, maxChunkSize);
+	depth = std::min(depth + 2, MAX_DEPTH);
+}
+
+} // openal
+} // audio
+} // love
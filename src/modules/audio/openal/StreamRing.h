@@ -0,0 +1,160 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_OPENAL_STREAM_RING_H
+#define LOVE_AUDIO_OPENAL_STREAM_RING_H
+
+// STD
+#include <deque>
+#include <vector>
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "sound/Decoder.h"
+#include "thread/threads.h"
+
+// OpenAL
+#ifdef LOVE_APPLE_USE_FRAMEWORKS
+#ifdef LOVE_IOS
+#include <OpenAL/alc.h>
+#include <OpenAL/al.h>
+#else
+#include <OpenAL-Soft/alc.h>
+#include <OpenAL-Soft/al.h>
+#endif
+#else
+#include <alc.h>
+#include <al.h>
+#endif
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+/**
+ * Holds audio decoded ahead of time for a streaming Source. While the Source
+ * is playing, the Pool's decode threads keep the ring topped up, so the pool
+ * thread usually only has to upload already decoded chunks to OpenAL.
+ *
+ * Chunks hold at least MIN_CHUNK_SECONDS of audio regardless of the format.
+ * Whenever the pool thread finds the ring empty it decodes the chunk itself,
+ * and the ring starts decoding larger chunks further ahead.
+ **/
+class StreamRing : public love::Object
+{
+public:
+
+	StreamRing(love::sound::Decoder *decoder, ALenum format, bool looping);
+	virtual ~StreamRing();
+
+	/**
+	 * Uploads the next decoded chunk into an OpenAL buffer, decoding it on the
+	 * calling thread if the decode threads haven't gotten to it yet.
+	 * @param buffer The OpenAL buffer to fill.
+	 * @param loopEnd Set to whether the chunk ends at the end of the stream,
+	 * after which the decoder was rewound because the Source is looping.
+	 * @return The number of bytes uploaded.
+	 **/
+	int upload(ALuint buffer, bool &loopEnd);
+
+	/**
+	 * Decodes one more chunk ahead, unless the ring is already full.
+	 **/
+	void fill();
+
+	/**
+	 * Gets whether fill() has any work to do.
+	 **/
+	bool needsData();
+
+	/**
+	 * Gets whether the stream has ended and every chunk has been uploaded.
+	 **/
+	bool isFinished();
+
+	/**
+	 * Sets whether the ring is being filled by the decode threads. Running out
+	 * of chunks only counts as an underrun while it is.
+	 **/
+	void setDecodeAhead(bool enable);
+
+	void seek(double seconds);
+	void rewind();
+	void setLooping(bool looping);
+	double getDuration();
+
+	// Upper bounds for the adaptive chunk size and decode-ahead depth.
+	static const int MAX_DEPTH = 16;
+	static constexpr double MIN_CHUNK_SECONDS = 0.05;
+	static constexpr double MAX_CHUNK_SECONDS = 0.5;
+
+private:
+
+	struct Chunk
+	{
+		std::vector<char> data;
+		int size = 0;
+		bool loopEnd = false;
+	};
+
+	/**
+	 * Decodes up to size bytes into the chunk. The decode mutex must be held.
+	 * @return True if the stream ended and won't be looped.
+	 **/
+	bool decodeChunk(Chunk &chunk, int size);
+
+	// The queue mutex must be held for these.
+	Chunk takeFreeChunk();
+	void clearChunks();
+	void grow();
+
+	StrongRef<love::sound::Decoder> decoder;
+	ALenum format;
+	int sampleRate;
+	int frameSize;
+
+	// Held while the decoder is in use.
+	thread::MutexRef decodeMutex;
+
+	// Guards everything below.
+	thread::MutexRef queueMutex;
+
+	std::deque<Chunk> chunks;
+	std::vector<Chunk> freeChunks;
+
+	int chunkSize;
+	int maxChunkSize;
+	int depth;
+
+	bool looping;
+	bool finished;
+	bool decodeAhead;
+
+}; // StreamRing
+
+} // openal
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_OPENAL_STREAM_RING_H
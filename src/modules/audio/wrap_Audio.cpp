@@ -27,6 +27,8 @@
 
 #include "common/runtime.h"
 
+#include "libraries/xxHash/xxhash.h"
+
 // C++
 #include <iostream>
 #include <cmath>
@@ -44,10 +46,19 @@ int w_getActiveSourceCount(lua_State *L)
 	return 1;
 }
 
+int w_getVirtualSourceCount(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getVirtualSourceCount());
+	return 1;
+}
+
 int w_newSource(lua_State *L)
 {
 	Source::Type stype = Source::TYPE_STREAM;
 
+	bool cached = false;
+	StaticCacheKey cacheKey = {};
+
 	if (!luax_istype(L, 1, love::sound::SoundData::type))
 	{
 		if (!luax_istype(L, 1, love::sound::Decoder::type))
@@ -60,6 +71,37 @@ int w_newSource(lua_State *L)
 				return luaL_error(L, "Cannot create queueable sources using newSource. Use newQueueableSource instead.");
 		}
 
+		if (stype == Source::TYPE_STATIC && love::filesystem::luax_cangetdata(L, 1))
+		{
+			// Identical encoded data decodes to identical audio, so static
+			// Sources share decoded audio keyed by hashes and the size of the
+			// encoded data.
+			// Read files up front so they aren't read again for decoding.
+			if (love::filesystem::luax_cangetfile(L, 1))
+			{
+				love::filesystem::FileData *fd = love::filesystem::luax_getfiledata(L, 1);
+				luax_pushtype(L, fd);
+				fd->release();
+				lua_replace(L, 1);
+			}
+
+			Data *data = luax_checktype<Data>(L, 1);
+			cacheKey.hash = XXH64(data->getData(), data->getSize(), 0);
+			cacheKey.check = XXH32(data->getData(), data->getSize(), 0);
+			cacheKey.size = data->getSize();
+			cached = true;
+
+			Source *t = nullptr;
+			luax_catchexcept(L, [&]() { t = instance()->newCachedSource(cacheKey); });
+
+			if (t != nullptr)
+			{
+				luax_pushtype(L, t);
+				t->release();
+				return 1;
+			}
+		}
+
 		if (love::filesystem::luax_cangetdata(L, 1))
 		{
 			// stream type
@@ -85,7 +127,9 @@ int w_newSource(lua_State *L)
 	Source *t = nullptr;
 
 	luax_catchexcept(L, [&]() {
-		if (luax_istype(L, 1, love::sound::SoundData::type))
+		if (luax_istype(L, 1, love::sound::SoundData::type) && cached)
+			t = instance()->newSource(luax_totype<love::sound::SoundData>(L, 1), cacheKey);
+		else if (luax_istype(L, 1, love::sound::SoundData::type))
 			t = instance()->newSource(luax_totype<love::sound::SoundData>(L, 1));
 		else if (luax_istype(L, 1, love::sound::Decoder::type))
 			t = instance()->newSource(luax_totype<love::sound::Decoder>(L, 1));
@@ -116,6 +160,32 @@ int w_newQueueableSource(lua_State *L)
 	return 1;
 }
 
+int w_setStaticCacheLimit(lua_State *L)
+{
+	lua_Number bytes = luaL_checknumber(L, 1);
+	if (bytes < 0)
+		return luaL_error(L, "Cache limit must be non-negative.");
+
+	instance()->setStaticCacheLimit((size_t) bytes);
+	return 0;
+}
+
+int w_getStaticCacheLimit(lua_State *L)
+{
+	lua_pushnumber(L, (lua_Number) instance()->getStaticCacheLimit());
+	return 1;
+}
+
+int w_getStaticCacheUsage(lua_State *L)
+{
+	size_t bytes = 0;
+	int count = 0;
+	instance()->getStaticCacheUsage(bytes, count);
+	lua_pushnumber(L, (lua_Number) bytes);
+	lua_pushinteger(L, count);
+	return 2;
+}
+
 static std::vector<Source*> readSourceList(lua_State *L, int n)
 {
 	if (n < 0)
@@ -596,8 +666,12 @@ int w_setPlaybackDevice(lua_State* L)
 static const luaL_Reg functions[] =
 {
 	{ "get_active_source_count", w_getActiveSourceCount },
+	{ "get_virtual_source_count", w_getVirtualSourceCount },
 	{ "new_source", w_newSource },
 	{ "new_queueable_source", w_newQueueableSource },
+	{ "set_static_cache_limit", w_setStaticCacheLimit },
+	{ "get_static_cache_limit", w_getStaticCacheLimit },
+	{ "get_static_cache_usage", w_getStaticCacheUsage },
 	{ "play", w_play },
 	{ "stop", w_stop },
 	{ "pause", w_pause },
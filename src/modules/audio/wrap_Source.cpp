@@ -268,6 +268,28 @@ int w_Source_isPlaying(lua_State *L)
 	return 1;
 }
 
+int w_Source_setPriority(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	int priority = (int) luaL_checkinteger(L, 2);
+	t->setPriority(priority);
+	return 0;
+}
+
+int w_Source_getPriority(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	lua_pushinteger(L, t->getPriority());
+	return 1;
+}
+
+int w_Source_isVirtual(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	luax_pushboolean(L, t->isVirtual());
+	return 1;
+}
+
 int w_Source_setVolumeLimits(lua_State *L)
 {
 	Source *t = luax_checksource(L, 1);
@@ -631,6 +653,9 @@ static const luaL_Reg w_Source_functions[] =
 	{ "set_looping", w_Source_setLooping },
 	{ "is_looping", w_Source_isLooping },
 	{ "is_playing", w_Source_isPlaying },
+	{ "set_priority", w_Source_setPriority },
+	{ "get_priority", w_Source_getPriority },
+	{ "is_virtual", w_Source_isVirtual },
 
 	{ "set_volume_limits", w_Source_setVolumeLimits },
 	{ "get_volume_limits", w_Source_getVolumeLimits },
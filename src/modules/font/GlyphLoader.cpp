@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "GlyphLoader.h"
+
+// C++
+#include <algorithm>
+
+namespace love
+{
+namespace font
+{
+
+GlyphLoader::Worker::Worker(GlyphLoader *loader, std::vector<StrongRef<Rasterizer>> &&rasterizers)
+	: loader(loader)
+	, rasterizers(std::move(rasterizers))
+{
+	threadName = "GlyphLoader";
+}
+
+void GlyphLoader::Worker::threadFunction()
+{
+	TextShaper::GlyphIndex glyphindex;
+
+	while (loader->nextRequest(glyphindex))
+	{
+		LoadedGlyph glyph;
+		glyph.glyphIndex = glyphindex;
+
+		// Failed glyphs are returned without data, so the main thread can
+		// rasterize them (and report any errors) itself.
+		try
+		{
+			Rasterizer *r = rasterizers[glyphindex.rasterizerIndex];
+			glyph.glyphData.set(r->getGlyphDataForIndex(glyphindex.index), Acquire::NORETAIN);
+		}
+		catch (love::Exception &)
+		{
+		}
+
+		loader->finishRequest(glyph);
+	}
+}
+
+GlyphLoader::GlyphLoader(const std::vector<StrongRef<Rasterizer>> &rasterizers, int threadcount)
+	: loadable(rasterizers.size(), true)
+	, pendingCount(0)
+	, finished(false)
+{
+	for (int i = 0; i < threadcount; i++)
+	{
+		std::vector<StrongRef<Rasterizer>> copies;
+
+		for (size_t j = 0; j < rasterizers.size(); j++)
+		{
+			Rasterizer *copy = loadable[j] ? rasterizers[j]->newWorkerRasterizer() : nullptr;
+			copies.emplace_back(copy, Acquire::NORETAIN);
+
+			if (copy == nullptr)
+				loadable[j] = false;
+		}
+
+		if (std::find(loadable.begin(), loadable.end(), true) == loadable.end())
+			break;
+
+		Worker *worker = new Worker(this, std::move(copies));
+
+		if (worker->start())
+			workers.push_back(worker);
+		else
+			worker->release();
+	}
+
+	if (workers.empty())
+		std::fill(loadable.begin(), loadable.end(), false);
+}
+
+GlyphLoader::~GlyphLoader()
+{
+	{
+		thread::Lock lock(mutex);
+		finished = true;
+		cond->broadcast();
+	}
+
+	// Releasing the workers destroys their Rasterizers on this thread.
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		worker->release();
+	}
+}
+
+bool GlyphLoader::canLoad(int rasterizerindex) const
+{
+	return rasterizerindex >= 0 && rasterizerindex < (int) loadable.size() && loadable[rasterizerindex];
+}
+
+void GlyphLoader::request(TextShaper::GlyphIndex glyphindex)
+{
+	if (!canLoad(glyphindex.rasterizerIndex))
+		throw love::Exception("Cannot load glyphs from this font on a background thread.");
+
+	thread::Lock lock(mutex);
+	requests.push_back(glyphindex);
+	pendingCount++;
+	cond->signal();
+}
+
+void GlyphLoader::getLoaded(std::vector<LoadedGlyph> &glyphs)
+{
+	thread::Lock lock(mutex);
+
+	if (loaded.empty())
+		return;
+
+	glyphs.insert(glyphs.end(), loaded.begin(), loaded.end());
+	pendingCount -= (int) loaded.size();
+	loaded.clear();
+}
+
+int GlyphLoader::getPendingCount() const
+{
+	thread::Lock lock(mutex);
+	return pendingCount;
+}
+
+int GlyphLoader::getDefaultThreadCount()
+{
+	// Leave a core for the main thread.
+	int cores = thread::getProcessorCount();
+	return std::min(std::max(cores - 1, 1), 4);
+}
+
+bool GlyphLoader::nextRequest(TextShaper::GlyphIndex &glyphindex)
+{
+	thread::Lock lock(mutex);
+
+	while (requests.empty() && !finished)
+		cond->wait(mutex);
+
+	if (finished)
+		return false;
+
+	glyphindex = requests.front();
+	requests.pop_front();
+	return true;
+}
+
+void GlyphLoader::finishRequest(const LoadedGlyph &glyph)
+{
+	thread::Lock lock(mutex);
+	loaded.push_back(glyph);
+}
+
+} // font
+} // love
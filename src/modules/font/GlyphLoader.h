@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/Object.h"
+#include "thread/threads.h"
+#include "GlyphData.h"
+#include "Rasterizer.h"
+#include "TextShaper.h"
+
+// C++
+#include <deque>
+#include <vector>
+
+namespace love
+{
+namespace font
+{
+
+/**
+ * Rasterizes glyphs on worker threads. Each worker has its own copies of the
+ * Rasterizers (see Rasterizer::newWorkerRasterizer), so glyphs can be loaded
+ * while the original Rasterizers are in use on the main thread.
+ *
+ * The GlyphLoader must be created and destroyed on the thread which owns the
+ * Rasterizers.
+ **/
+class GlyphLoader
+{
+public:
+
+	struct LoadedGlyph
+	{
+		TextShaper::GlyphIndex glyphIndex;
+
+		// Null if the glyph couldn't be rasterized on a worker thread.
+		StrongRef<GlyphData> glyphData;
+	};
+
+	GlyphLoader(const std::vector<StrongRef<Rasterizer>> &rasterizers, int threadcount);
+	~GlyphLoader();
+
+	/**
+	 * Whether glyphs from the given Rasterizer can be loaded in the background.
+	 **/
+	bool canLoad(int rasterizerindex) const;
+
+	/**
+	 * Queues a glyph to be rasterized on a worker thread.
+	 **/
+	void request(TextShaper::GlyphIndex glyphindex);
+
+	/**
+	 * Appends the glyphs which have finished loading since the last call.
+	 **/
+	void getLoaded(std::vector<LoadedGlyph> &loaded);
+
+	/**
+	 * Gets the number of requested glyphs which haven't been returned by
+	 * getLoaded yet.
+	 **/
+	int getPendingCount() const;
+
+	static int getDefaultThreadCount();
+
+private:
+
+	class Worker : public love::thread::Threadable
+	{
+	public:
+
+		Worker(GlyphLoader *loader, std::vector<StrongRef<Rasterizer>> &&rasterizers);
+		virtual ~Worker() {}
+
+		void threadFunction() override;
+
+	private:
+
+		GlyphLoader *loader;
+		std::vector<StrongRef<Rasterizer>> rasterizers;
+
+	}; // Worker
+
+	bool nextRequest(TextShaper::GlyphIndex &glyphindex);
+	void finishRequest(const LoadedGlyph &glyph);
+
+	std::vector<Worker *> workers;
+	std::vector<bool> loadable;
+
+	thread::MutexRef mutex;
+	thread::ConditionalRef cond;
+
+	std::deque<TextShaper::GlyphIndex> requests;
+	std::vector<LoadedGlyph> loaded;
+
+	int pendingCount;
+	bool finished;
+
+}; // GlyphLoader
+
+} // font
+} // love
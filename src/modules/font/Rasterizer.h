@@ -143,11 +143,31 @@ class Rasterizer : public Object
 
 	float getDPIScale() const;
 
+	/**
+	 * Whether glyphs hold a signed distance field in their alpha channel,
+	 * with 0.5 on the glyph's outline, rather than coverage.
+	 **/
+	bool isSDF() const { return sdf; }
+
+	/**
+	 * Gets the distance in pixels from the outline of an SDF glyph to where
+	 * its alpha reaches 0 (or 1 inside the glyph).
+	 **/
+	virtual float getSDFSpread() const { return 0.0f; }
+
+	/**
+	 * Creates a Rasterizer with the same font and settings, which can
+	 * rasterize glyphs on another thread while this one is in use. Returns
+	 * null if glyphs can't be rasterized off the thread which owns this.
+	 * Must be called (and the result released) on the owning thread.
+	 **/
+	virtual Rasterizer *newWorkerRasterizer() const { return nullptr; }
+
 protected:
 
 	FontMetrics metrics;
 	float dpiScale;
-	bool sdf;
+	bool sdf = false;
 
 }; // Rasterizer
 
@@ -24,6 +24,9 @@
 #include "common/Exception.h"
 
 #include "libraries/utf8/utf8.h"
+#include "libraries/xxHash/xxhash.h"
+
+#include <string.h>
 
 namespace love
 {
@@ -115,6 +118,9 @@ float TextShaper::getCombinedHeight() const
 
 void TextShaper::setLineHeight(float h)
 {
+	if (h != lineHeight)
+		clearRunCache();
+
 	lineHeight = h;
 }
 
@@ -274,11 +280,145 @@ float TextShaper::getWidth(const std::string& str)
 	getCodepointsFromString(str, codepoints.cps);
 
 	TextInfo info;
-	computeGlyphPositions(codepoints, Range(), Vector2(0.0f, 0.0f), 0.0f, nullptr, nullptr, &info);
+	getGlyphPositions(codepoints, Range(), Vector2(0.0f, 0.0f), 0.0f, nullptr, nullptr, &info);
 
 	return info.width;
 }
 
+static uint64 hashRun(bool wrap, float parameter, const uint32 *codepoints, size_t count, const std::vector<IndexedColor> &colors)
+{
+	uint64 hash = XXH64(codepoints, sizeof(uint32) * count, wrap ? 1 : 0);
+	hash = XXH64(&parameter, sizeof(float), hash);
+	if (!colors.empty())
+		hash = XXH64(colors.data(), sizeof(IndexedColor) * colors.size(), hash);
+	return hash;
+}
+
+TextShaper::ShapedRun *TextShaper::findShapedRun(uint64 hash, bool wrap, float parameter, const uint32 *codepoints, size_t count, const std::vector<IndexedColor> &colors)
+{
+	auto it = runCacheLookup.find(hash);
+	if (it == runCacheLookup.end())
+		return nullptr;
+
+	ShapedRun &run = *it->second;
+
+	if (run.wrap != wrap || run.parameter != parameter || run.codepoints.size() != count || run.colors.size() != colors.size())
+		return nullptr;
+
+	if (count > 0 && memcmp(run.codepoints.data(), codepoints, sizeof(uint32) * count) != 0)
+		return nullptr;
+
+	for (size_t i = 0; i < colors.size(); i++)
+	{
+		if (run.colors[i].index != colors[i].index || run.colors[i].color != colors[i].color)
+			return nullptr;
+	}
+
+	// Move to the front of the LRU list.
+	runCache.splice(runCache.begin(), runCache, it->second);
+	return &run;
+}
+
+TextShaper::ShapedRun &TextShaper::addShapedRun(uint64 hash, bool wrap, float parameter, const uint32 *codepoints, size_t count, const std::vector<IndexedColor> &colors, ShapedRun &&results)
+{
+	ShapedRun newrun = std::move(results);
+	newrun.hash = hash;
+	newrun.wrap = wrap;
+	newrun.parameter = parameter;
+	newrun.codepoints.assign(codepoints, codepoints + count);
+	newrun.colors = colors;
+
+	// A hash collision replaces the older run.
+	auto it = runCacheLookup.find(hash);
+	if (it != runCacheLookup.end())
+	{
+		runCache.erase(it->second);
+		runCacheLookup.erase(it);
+	}
+
+	while (runCache.size() >= MAX_CACHED_RUNS)
+	{
+		runCacheLookup.erase(runCache.back().hash);
+		runCache.pop_back();
+	}
+
+	runCache.push_front(std::move(newrun));
+
+	try
+	{
+		runCacheLookup[hash] = runCache.begin();
+	}
+	catch (...)
+	{
+		runCache.pop_front();
+		throw;
+	}
+
+	return runCache.front();
+}
+
+void TextShaper::clearRunCache()
+{
+	runCache.clear();
+	runCacheLookup.clear();
+}
+
+void TextShaper::getGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info)
+{
+	if (!range.isValid() && !codepoints.cps.empty())
+		range = Range(0, codepoints.cps.size());
+
+	if (!range.isValid() || range.getMax() >= codepoints.cps.size() || range.getSize() > MAX_CACHED_RUN_LENGTH)
+		return computeGlyphPositions(codepoints, range, offset, extraspacing, positions, colors, info);
+
+	// The colors which apply to the run, relative to its start. The color in
+	// effect at the start comes from before the run if it isn't set there.
+	std::vector<IndexedColor> runcolors;
+	for (const IndexedColor &c : codepoints.colors)
+	{
+		int index = c.index - (int) range.first;
+
+		if (index <= 0)
+		{
+			runcolors.resize(1);
+			runcolors[0] = {c.color, 0};
+		}
+		else if (index < (int) range.getSize())
+			runcolors.push_back({c.color, index});
+	}
+
+	const uint32 *runcodepoints = &codepoints.cps[range.first];
+	uint64 hash = hashRun(false, extraspacing, runcodepoints, range.getSize(), runcolors);
+
+	ShapedRun *run = findShapedRun(hash, false, extraspacing, runcodepoints, range.getSize(), runcolors);
+
+	if (run == nullptr)
+	{
+		ShapedRun shaped;
+		shaped.info = TextInfo();
+		computeGlyphPositions(codepoints, range, Vector2(0.0f, 0.0f), extraspacing, &shaped.positions, &shaped.glyphColors, &shaped.info);
+		run = &addShapedRun(hash, false, extraspacing, runcodepoints, range.getSize(), runcolors, std::move(shaped));
+	}
+
+	if (positions != nullptr)
+	{
+		int startindex = (int) positions->size();
+		positions->reserve(positions->size() + run->positions.size());
+
+		for (const GlyphPosition &p : run->positions)
+			positions->push_back({p.position + offset, p.glyphIndex});
+
+		if (colors != nullptr)
+		{
+			for (const IndexedColor &c : run->glyphColors)
+				colors->push_back({c.color, c.index + startindex});
+		}
+	}
+
+	if (info != nullptr)
+		*info = run->info;
+}
+
 static size_t findNewline(const ColoredCodepoints &codepoints, size_t start)
 {
 	for (size_t i = start; i < codepoints.cps.size(); i++)
@@ -293,6 +433,46 @@ static size_t findNewline(const ColoredCodepoints &codepoints, size_t start)
 }
 
 void TextShaper::getWrap(const ColoredCodepoints &codepoints, float wraplimit, std::vector<Range> &lineranges, std::vector<float> *linewidths)
+{
+	// Wrapping doesn't depend on colors.
+	static const std::vector<IndexedColor> nocolors;
+
+	const uint32 *cps = codepoints.cps.data();
+	size_t count = codepoints.cps.size();
+	uint64 hash = 0;
+
+	if (count > 0 && count <= MAX_CACHED_RUN_LENGTH)
+	{
+		hash = hashRun(true, wraplimit, cps, count, nocolors);
+
+		ShapedRun *run = findShapedRun(hash, true, wraplimit, cps, count, nocolors);
+		if (run != nullptr)
+		{
+			lineranges.insert(lineranges.end(), run->lineRanges.begin(), run->lineRanges.end());
+			if (linewidths)
+				linewidths->insert(linewidths->end(), run->lineWidths.begin(), run->lineWidths.end());
+			return;
+		}
+	}
+
+	size_t startline = lineranges.size();
+	std::vector<float> widths;
+
+	computeWrap(codepoints, wraplimit, lineranges, &widths);
+
+	if (linewidths)
+		linewidths->insert(linewidths->end(), widths.begin(), widths.end());
+
+	if (count > 0 && count <= MAX_CACHED_RUN_LENGTH)
+	{
+		ShapedRun wrapped;
+		wrapped.lineRanges.assign(lineranges.begin() + startline, lineranges.end());
+		wrapped.lineWidths = std::move(widths);
+		addShapedRun(hash, true, wraplimit, cps, count, nocolors, std::move(wrapped));
+	}
+}
+
+void TextShaper::computeWrap(const ColoredCodepoints &codepoints, float wraplimit, std::vector<Range> &lineranges, std::vector<float> *linewidths)
 {
 	size_t nextnewline = findNewline(codepoints, 0);
 
@@ -377,6 +557,7 @@ void TextShaper::setFallbacks(const std::vector<Rasterizer*> &fallbacks)
 	// Clear caches.
 	kerning.clear();
 	glyphAdvances.clear();
+	clearRunCache();
 
 	rasterizers.resize(1);
 	dpiScales.resize(1);
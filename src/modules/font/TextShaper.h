@@ -27,6 +27,7 @@
 #include "common/Color.h"
 #include "common/Range.h"
 
+#include <list>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -128,6 +129,12 @@ class TextShaper : public Object
 
 	virtual void setFallbacks(const std::vector<Rasterizer *> &fallbacks);
 
+	/**
+	 * Same as computeGlyphPositions, but reuses the results for text which
+	 * was shaped recently.
+	 **/
+	void getGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info);
+
 	virtual void computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info) = 0;
 	virtual int computeWordWrapIndex(const ColoredCodepoints &codepoints, Range range, float wraplimit, float *width) = 0;
 
@@ -137,6 +144,9 @@ class TextShaper : public Object
 
 	static inline bool isWhitespace(uint32 codepoint) { return codepoint == ' ' || codepoint == '\t'; }
 
+	void computeWrap(const ColoredCodepoints &codepoints, float wraplimit, std::vector<Range> &lineranges, std::vector<float> *linewidths);
+	void clearRunCache();
+
 	std::vector<StrongRef<Rasterizer>> rasterizers;
 	std::vector<float> dpiScales;
 
@@ -154,6 +164,41 @@ class TextShaper : public Object
 	// map of left/right glyph pairs to horizontal kerning.
 	std::unordered_map<uint64, float> kerning;
 
+	// Results of shaping or wrapping a run of text. Glyph positions don't
+	// include any offset, and color and line indices are relative to the run.
+	struct ShapedRun
+	{
+		uint64 hash;
+
+		// Key.
+		bool wrap;
+		float parameter; // Extra spacing, or the wrap limit.
+		std::vector<uint32> codepoints;
+		std::vector<IndexedColor> colors;
+
+		std::vector<GlyphPosition> positions;
+		std::vector<IndexedColor> glyphColors;
+		TextInfo info;
+
+		std::vector<Range> lineRanges;
+		std::vector<float> lineWidths;
+	};
+
+	ShapedRun *findShapedRun(uint64 hash, bool wrap, float parameter, const uint32 *codepoints, size_t count, const std::vector<IndexedColor> &colors);
+	// Caches the results under the given key. Results are only added once
+	// they're complete, so a failure while shaping doesn't leave a bad entry.
+	ShapedRun &addShapedRun(uint64 hash, bool wrap, float parameter, const uint32 *codepoints, size_t count, const std::vector<IndexedColor> &colors, ShapedRun &&results);
+
+	// Most recently used runs first.
+	std::list<ShapedRun> runCache;
+	std::unordered_map<uint64, std::list<ShapedRun>::iterator> runCacheLookup;
+
+	// Enough for a few hundred labels which are redrawn every frame.
+	static const size_t MAX_CACHED_RUNS = 1024;
+
+	// Longer text (a whole chat log, say) would mostly churn the cache.
+	static const size_t MAX_CACHED_RUN_LENGTH = 4096;
+
 }; // TextShaper
 
 } // font
@@ -34,10 +34,14 @@ namespace freetype
 {
 
 TrueTypeRasterizer::TrueTypeRasterizer(FT_Library library, love::Data *data, int size, const Settings &settings, float defaultdpiscale)
-	: data(data)
+	: library(library)
+	, size(size)
+	, settings(settings)
+	, data(data)
 	, hinting(settings.hinting)
 {
 	dpiScale = settings.dpiScale.get(defaultdpiscale);
+	this->settings.dpiScale.set(dpiScale);
 
 	sdf = settings.sdf;
 
@@ -230,6 +234,16 @@ TextShaper *TrueTypeRasterizer::newTextShaper()
 	return new HarfbuzzShaper(this);
 }
 
+Rasterizer *TrueTypeRasterizer::newWorkerRasterizer() const
+{
+	return new TrueTypeRasterizer(library, data, size, settings, dpiScale);
+}
+
+float TrueTypeRasterizer::getSDFSpread() const
+{
+	return sdf ? SDF_SPREAD : 0.0f;
+}
+
 bool TrueTypeRasterizer::accepts(FT_Library library, love::Data *data)
 {
 	const FT_Byte *fbase = (const FT_Byte *) data->getData();
@@ -57,6 +57,8 @@ class TrueTypeRasterizer : public love::font::TrueTypeRasterizer
 	float getKerning(uint32 leftglyph, uint32 rightglyph) const override;
 	DataType getDataType() const override;
 	TextShaper *newTextShaper() override;
+	float getSDFSpread() const override;
+	Rasterizer *newWorkerRasterizer() const override;
 
 	ptrdiff_t getHandle() const override { return (ptrdiff_t) face; }
 
@@ -66,9 +68,18 @@ class TrueTypeRasterizer : public love::font::TrueTypeRasterizer
 
 	static FT_UInt hintingToLoadOption(Hinting hinting);
 
+	// FreeType's default for the "spread" property of its SDF renderer.
+	static constexpr float SDF_SPREAD = 8.0f;
+
 	// TrueType face
 	FT_Face face;
 
+	// Creation parameters, for newWorkerRasterizer. Separate FreeType
+	// faces can be used on different threads at once; a single face can't.
+	FT_Library library;
+	int size;
+	Settings settings;
+
 	// Font data
 	StrongRef<love::Data> data;
 
@@ -24,6 +24,8 @@
 #include "common/math.h"
 #include "common/Matrix.h"
 #include "Graphics.h"
+#include "TextLayout.h"
+#include "thread/TaskPool.h"
 
 #include <math.h>
 #include <sstream>
@@ -61,12 +63,36 @@ Font::Font(love::font::Rasterizer *r, const SamplerState &s)
 	, textureHeight(128)
 	, samplerState()
 	, dpiScale(r->getDPIScale())
+	, sdf(r->isSDF())
+	, sdfSpread(r->getSDFSpread())
+	, atlasBudgetWidth(0)
+	, atlasBudgetHeight(0)
+	, glyphPixels(0)
+	, atlasEvictions(0)
+	, atlasRebuilds(0)
+	, evictionLogStart(0)
+	, evictionID(0)
+	, glyphLoader(nullptr)
+	, async(false)
+	, missingGlyphs(false)
+	, atlasShadowY(0)
+	, atlasDirtyTop(0)
+	, atlasDirtyBottom(0)
+	, batchingUploads(false)
 	, textureCacheID(0)
+	, shapingID(0)
 {
 	samplerState.minFilter = s.minFilter;
 	samplerState.magFilter = s.magFilter;
 	samplerState.maxAnisotropy = s.maxAnisotropy;
 
+	// Distance fields only scale well when they're interpolated.
+	if (sdf)
+	{
+		samplerState.minFilter = SamplerState::FILTER_LINEAR;
+		samplerState.magFilter = SamplerState::FILTER_LINEAR;
+	}
+
 	// Try to find the best texture size match for the font size. default to the
 	// largest texture size if no rough match is found.
 	while (true)
@@ -100,6 +126,7 @@ Font::Font(love::font::Rasterizer *r, const SamplerState &s)
 
 Font::~Font()
 {
+	delete glyphLoader;
 	--fontCount;
 }
 
@@ -118,15 +145,21 @@ Font::TextureSize Font::getNextTextureSize() const
 	int maxwidth  = std::min(8192, maxsize);
 	int maxheight = std::min(4096, maxsize);
 
-	if (size.width * 2 <= maxwidth || size.height * 2 <= maxheight)
+	if (atlasBudgetWidth > 0 && atlasBudgetHeight > 0)
 	{
-		// {128, 128} -> {256, 128} -> {256, 256} -> {512, 256} -> etc.
-		if (size.width == size.height)
-			size.width *= 2;
-		else
-			size.height *= 2;
+		maxwidth = std::min(maxwidth, atlasBudgetWidth);
+		maxheight = std::min(maxheight, atlasBudgetHeight);
 	}
 
+	bool growwidth = size.width * 2 <= maxwidth;
+	bool growheight = size.height * 2 <= maxheight;
+
+	// {128, 128} -> {256, 128} -> {256, 256} -> {512, 256} -> etc.
+	if (growwidth && (size.width == size.height || !growheight))
+		size.width *= 2;
+	else if (growheight)
+		size.height *= 2;
+
 	return size;
 }
 
@@ -134,6 +167,7 @@ bool Font::loadVolatile()
 {
 	textureCacheID++;
 	glyphs.clear();
+	glyphPixels = 0;
 	textures.clear();
 	createTexture();
 	return true;
@@ -144,6 +178,9 @@ void Font::createTexture()
 	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
 	gfx->flushBatchedDraws();
 
+	// Batched glyph uploads belong to the current texture.
+	flushGlyphUploads();
+
 	Texture *texture = nullptr;
 	TextureSize size = {textureWidth, textureHeight};
 	TextureSize nextsize = getNextTextureSize();
@@ -174,24 +211,7 @@ void Font::createTexture()
 		// (since we keep luminance constant and vary alpha in those glyphs),
 		// and transparent black otherwise.
 		std::vector<uint8> emptydata(datasize, 0);
-
-		if (shaper->getRasterizers()[0]->getDataType() == font::Rasterizer::DATA_TRUETYPE)
-		{
-			if (pixelFormat == PIXELFORMAT_LA8_UNORM)
-			{
-				for (size_t i = 0; i < pixelcount; i++)
-					emptydata[i * 2 + 0] = 255;
-			}
-			else if (pixelFormat == PIXELFORMAT_RGBA8_UNORM)
-			{
-				for (size_t i = 0; i < pixelcount; i++)
-				{
-					emptydata[i * 4 + 0] = 255;
-					emptydata[i * 4 + 1] = 255;
-					emptydata[i * 4 + 2] = 255;
-				}
-			}
-		}
+		fillEmptyPixels(emptydata.data(), pixelcount);
 
 		Rect rect = {0, 0, size.width, size.height};
 		texture->replacePixels(emptydata.data(), emptydata.size(), 0, 0, rect, false);
@@ -202,12 +222,18 @@ void Font::createTexture()
 	textureWidth  = size.width;
 	textureHeight = size.height;
 
-	rowHeight = textureX = textureY = TEXTURE_PADDING;
+	// The packer's area leaves padding at the right and bottom edges. Glyphs
+	// are offset by the padding, which covers the left and top edges.
+	packer.reset(textureWidth - TEXTURE_PADDING, textureHeight - TEXTURE_PADDING);
+
+	if (glyphLoader != nullptr)
+		resetAtlasShadow(0);
 
 	// Re-add the old glyphs if we re-created the existing texture object.
 	if (recreatetexture)
 	{
 		textureCacheID++;
+		atlasRebuilds++;
 
 		std::vector<love::font::TextShaper::GlyphIndex> glyphstoadd;
 
@@ -215,14 +241,152 @@ void Font::createTexture()
 			glyphstoadd.push_back(unpackGlyphIndex(glyphpair.first));
 
 		glyphs.clear();
-		
+		glyphPixels = 0;
+
 		for (auto glyphindex : glyphstoadd)
 			addGlyph(glyphindex);
 	}
 }
 
+Texture *Font::allocateGlyphRect(int w, int h, Rect &rect)
+{
+	// Each glyph has padding on its left and top edges.
+	int paddedw = w + TEXTURE_PADDING;
+	int paddedh = h + TEXTURE_PADDING;
+
+	while (true)
+	{
+		int x = 0;
+		int y = 0;
+
+		if (packer.pack(paddedw, paddedh, x, y))
+		{
+			rect = {x, y, paddedw, paddedh};
+			return textures.back();
+		}
+
+		TextureSize nextsize = getNextTextureSize();
+		bool cangrow = nextsize.width > textureWidth || nextsize.height > textureHeight;
+
+		if (!cangrow && atlasBudgetWidth > 0 && atlasBudgetHeight > 0)
+		{
+			Texture *texture = nullptr;
+			if (evictGlyph(paddedw, paddedh, texture, rect))
+				return texture;
+
+			// No single glyph has room, so start over with only the glyphs
+			// used this frame.
+			if (rebuildAtlas())
+				continue;
+		}
+
+		if (packer.getTop() == 0)
+			throw love::Exception("Glyph is too large for the font's texture atlas (%dx%d).", w, h);
+
+		createTexture();
+	}
+}
+
+static uint64 getCurrentFrame()
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	return gfx != nullptr ? gfx->getFrameCount() : 0;
+}
+
+bool Font::evictGlyph(int w, int h, Texture *&texture, Rect &rect)
+{
+	uint64 frame = getCurrentFrame();
+	auto victim = glyphs.end();
+
+	for (auto it = glyphs.begin(); it != glyphs.end(); ++it)
+	{
+		const Glyph &g = it->second;
+
+		// Glyphs used this frame may be part of text which is being drawn.
+		if (g.texture == nullptr || g.lastUse >= frame)
+			continue;
+
+		if (g.atlasRect.w < w || g.atlasRect.h < h)
+			continue;
+
+		if (victim == glyphs.end() || g.lastUse < victim->second.lastUse
+			|| (g.lastUse == victim->second.lastUse && g.atlasRect.w * g.atlasRect.h < victim->second.atlasRect.w * victim->second.atlasRect.h))
+		{
+			victim = it;
+		}
+	}
+
+	if (victim == glyphs.end())
+		return false;
+
+	// The new glyph takes over the whole rectangle, so the space isn't lost
+	// when it's evicted in turn.
+	texture = victim->second.texture;
+	rect = victim->second.atlasRect;
+
+	// Only text which used the evicted glyph has to be regenerated, which is
+	// tracked by the eviction log rather than the texture cache ID.
+	if (evictionLog.size() >= MAX_EVICTION_LOG)
+	{
+		size_t count = evictionLog.size() / 2;
+		evictionLog.erase(evictionLog.begin(), evictionLog.begin() + count);
+		evictionLogStart += (uint32) count;
+	}
+
+	evictionLog.push_back(victim->first);
+	evictionID++;
+
+	glyphPixels -= (int64) rect.w * rect.h;
+	glyphs.erase(victim);
+	atlasEvictions++;
+
+	std::vector<uint8> emptydata(getPixelFormatSliceSize(pixelFormat, rect.w, rect.h), 0);
+	fillEmptyPixels(emptydata.data(), (size_t) rect.w * rect.h);
+	uploadGlyphPixels(texture, rect, emptydata.data());
+
+	return true;
+}
+
+bool Font::rebuildAtlas()
+{
+	uint64 frame = getCurrentFrame();
+	std::vector<love::font::TextShaper::GlyphIndex> glyphstoadd;
+	int64 evicted = 0;
+
+	for (const auto &glyphpair : glyphs)
+	{
+		if (glyphpair.second.lastUse >= frame)
+			glyphstoadd.push_back(unpackGlyphIndex(glyphpair.first));
+		else if (glyphpair.second.texture != nullptr)
+			evicted++;
+	}
+
+	if (evicted == 0)
+		return false;
+
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+	gfx->flushBatchedDraws();
+	flushGlyphUploads();
+
+	glyphs.clear();
+	glyphPixels = 0;
+	textures.clear();
+
+	createTexture();
+
+	textureCacheID++;
+	atlasEvictions += evicted;
+	atlasRebuilds++;
+
+	for (auto glyphindex : glyphstoadd)
+		addGlyph(glyphindex);
+
+	return true;
+}
+
 void Font::unloadVolatile()
 {
+	atlasDirtyTop = atlasDirtyBottom = 0;
 	glyphs.clear();
 	textures.clear();
 }
@@ -234,47 +398,121 @@ love::font::GlyphData *Font::getRasterizerGlyphData(love::font::TextShaper::Glyp
 	return r->getGlyphDataForIndex(glyphindex.index);
 }
 
-const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
+void Font::fillEmptyPixels(uint8 *data, size_t pixelcount) const
 {
-	float glyphdpiscale = getDPIScale();
-	StrongRef<love::font::GlyphData> gd(getRasterizerGlyphData(glyphindex, glyphdpiscale), Acquire::NORETAIN);
-
-	int w = gd->getWidth();
-	int h = gd->getHeight();
+	// Data is expected to be zeroed (transparent black) already.
+	if (shaper->getRasterizers()[0]->getDataType() != font::Rasterizer::DATA_TRUETYPE)
+		return;
 
-	if (w + TEXTURE_PADDING * 2 < textureWidth && h + TEXTURE_PADDING * 2 < textureHeight)
+	if (pixelFormat == PIXELFORMAT_LA8_UNORM)
+	{
+		for (size_t i = 0; i < pixelcount; i++)
+			data[i * 2 + 0] = 255;
+	}
+	else if (pixelFormat == PIXELFORMAT_RGBA8_UNORM)
 	{
-		if (textureX + w + TEXTURE_PADDING > textureWidth)
+		for (size_t i = 0; i < pixelcount; i++)
 		{
-			// Out of space - new row!
-			textureX = TEXTURE_PADDING;
-			textureY += rowHeight;
-			rowHeight = TEXTURE_PADDING;
+			data[i * 4 + 0] = 255;
+			data[i * 4 + 1] = 255;
+			data[i * 4 + 2] = 255;
 		}
+	}
+}
+
+void Font::resetAtlasShadow(int y)
+{
+	y = std::min(y, textureHeight);
+
+	size_t pixelcount = (size_t) textureWidth * (textureHeight - y);
+	atlasShadow.assign(getPixelFormatSliceSize(pixelFormat, textureWidth, textureHeight - y), 0);
+	fillEmptyPixels(atlasShadow.data(), pixelcount);
+
+	atlasShadowY = y;
+	atlasDirtyTop = atlasDirtyBottom = 0;
+}
+
+void Font::uploadGlyphPixels(Texture *texture, const Rect &rect, const uint8 *data)
+{
+	size_t glyphrowsize = getPixelFormatSliceSize(pixelFormat, rect.w, 1);
 
-		if (textureY + h + TEXTURE_PADDING > textureHeight)
+	if (glyphLoader != nullptr && texture == textures.back() && rect.y >= atlasShadowY)
+	{
+		size_t rowsize = getPixelFormatSliceSize(pixelFormat, textureWidth, 1);
+		size_t xoffset = getPixelFormatSliceSize(pixelFormat, rect.x, 1);
+
+		for (int row = 0; row < rect.h; row++)
 		{
-			// Totally out of space - new texture!
-			createTexture();
+			uint8 *dst = &atlasShadow[(rect.y - atlasShadowY + row) * rowsize + xoffset];
+			memcpy(dst, data + row * glyphrowsize, glyphrowsize);
+		}
 
-			// Makes sure the above code for checking if the glyph can fit at
-			// the current position in the texture is run again for this glyph.
-			return addGlyph(glyphindex);
+		if (batchingUploads)
+		{
+			if (atlasDirtyTop >= atlasDirtyBottom)
+			{
+				atlasDirtyTop = rect.y;
+				atlasDirtyBottom = rect.y + rect.h;
+			}
+			else
+			{
+				atlasDirtyTop = std::min(atlasDirtyTop, rect.y);
+				atlasDirtyBottom = std::max(atlasDirtyBottom, rect.y + rect.h);
+			}
+			return;
 		}
 	}
 
+	texture->replacePixels(data, glyphrowsize * rect.h, 0, 0, rect, false);
+}
+
+void Font::flushGlyphUploads()
+{
+	if (atlasDirtyTop >= atlasDirtyBottom || textures.empty())
+	{
+		atlasDirtyTop = atlasDirtyBottom = 0;
+		return;
+	}
+
+	// Whole rows of the shadow copy are contiguous, so the dirty rows can be
+	// uploaded in one call.
+	size_t rowsize = getPixelFormatSliceSize(pixelFormat, textureWidth, 1);
+	const uint8 *data = &atlasShadow[(atlasDirtyTop - atlasShadowY) * rowsize];
+	Rect rect = {0, atlasDirtyTop, textureWidth, atlasDirtyBottom - atlasDirtyTop};
+
+	atlasDirtyTop = atlasDirtyBottom = 0;
+
+	textures.back()->replacePixels(data, rowsize * rect.h, 0, 0, rect, false);
+}
+
+const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
+{
+	float glyphdpiscale = getDPIScale();
+	StrongRef<love::font::GlyphData> gd(getRasterizerGlyphData(glyphindex, glyphdpiscale), Acquire::NORETAIN);
+
+	return addGlyph(glyphindex, gd, glyphdpiscale);
+}
+
+const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex, love::font::GlyphData *gd, float glyphdpiscale)
+{
+	int w = gd->getWidth();
+	int h = gd->getHeight();
+
 	Glyph g;
 
 	g.texture = nullptr;
 	memset(g.vertices, 0, sizeof(GlyphVertex) * 4);
+	g.atlasRect = {0, 0, 0, 0};
+	g.lastUse = getCurrentFrame();
 
 	// Don't waste space for empty glyphs.
 	if (w > 0 && h > 0)
 	{
-		Texture *texture = textures.back();
+		// This may re-create the texture and re-add existing glyphs.
+		Texture *texture = allocateGlyphRect(w, h, g.atlasRect);
 		g.texture = texture;
 
-		Rect rect = {textureX, textureY, gd->getWidth(), gd->getHeight()};
+		Rect rect = {g.atlasRect.x + TEXTURE_PADDING, g.atlasRect.y + TEXTURE_PADDING, w, h};
 
 		if (pixelFormat != gd->getFormat())
 		{
@@ -295,15 +533,15 @@ const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 				dstdata[pixel * 4 + 3] = src[pixel * 2 + 1];
 			}
 
-			texture->replacePixels(dstdata, dstsize, 0, 0, rect, false);
+			uploadGlyphPixels(texture, rect, dstdata);
 		}
 		else
 		{
-			texture->replacePixels(gd->getData(), gd->getSize(), 0, 0, rect, false);
+			uploadGlyphPixels(texture, rect, (const uint8 *) gd->getData());
 		}
 
-		double tX     = (double) textureX,     tY      = (double) textureY;
-		double tWidth = (double) textureWidth, tHeight = (double) textureHeight;
+		double tX     = (double) rect.x,                  tY      = (double) rect.y;
+		double tWidth = (double) texture->getPixelWidth(), tHeight = (double) texture->getPixelHeight();
 
 		Color32 c(255, 255, 255, 255);
 
@@ -333,8 +571,7 @@ const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 			g.vertices[i].y /= glyphdpiscale;
 		}
 
-		textureX += w + TEXTURE_PADDING;
-		rowHeight = std::max(rowHeight, h + TEXTURE_PADDING);
+		glyphPixels += (int64) g.atlasRect.w * g.atlasRect.h;
 	}
 
 	uint64 packedindex = packGlyphIndex(glyphindex);
@@ -345,14 +582,171 @@ const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 const Font::Glyph &Font::findGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 {
 	uint64 packedindex = packGlyphIndex(glyphindex);
-	const auto it = glyphs.find(packedindex);
+	auto it = glyphs.find(packedindex);
 
 	if (it != glyphs.end())
+	{
+		it->second.lastUse = getCurrentFrame();
 		return it->second;
+	}
 
 	return addGlyph(glyphindex);
 }
 
+const Font::Glyph *Font::findGlyphAsync(love::font::TextShaper::GlyphIndex glyphindex)
+{
+	auto it = glyphs.find(packGlyphIndex(glyphindex));
+	if (it != glyphs.end())
+	{
+		it->second.lastUse = getCurrentFrame();
+		return &it->second;
+	}
+
+	love::font::GlyphLoader *loader = getGlyphLoader();
+	if (!loader->canLoad(glyphindex.rasterizerIndex))
+		return &addGlyph(glyphindex);
+
+	requestGlyph(glyphindex);
+	missingGlyphs = true;
+	return nullptr;
+}
+
+love::font::GlyphLoader *Font::getGlyphLoader()
+{
+	if (glyphLoader == nullptr)
+	{
+		int threads = love::font::GlyphLoader::getDefaultThreadCount();
+		glyphLoader = new love::font::GlyphLoader(shaper->getRasterizers(), threads);
+
+		// Glyphs already in the current texture aren't in the shadow copy, so
+		// it starts below all of them.
+		packer.raise(packer.getTop());
+		resetAtlasShadow(packer.getTop());
+	}
+
+	return glyphLoader;
+}
+
+void Font::requestGlyph(love::font::TextShaper::GlyphIndex glyphindex)
+{
+	if (pendingGlyphs.insert(packGlyphIndex(glyphindex)).second)
+		glyphLoader->request(glyphindex);
+}
+
+void Font::preload(const Codepoints &codepoints)
+{
+	love::font::GlyphLoader *loader = getGlyphLoader();
+	std::vector<love::font::TextShaper::GlyphIndex> localglyphs;
+
+	for (uint32 codepoint : codepoints)
+	{
+		love::font::TextShaper::GlyphIndex glyphindex;
+		shaper->getGlyphAdvance(codepoint, &glyphindex);
+
+		uint64 packedindex = packGlyphIndex(glyphindex);
+		if (glyphs.count(packedindex) > 0 || pendingGlyphs.count(packedindex) > 0)
+			continue;
+
+		if (loader->canLoad(glyphindex.rasterizerIndex))
+			requestGlyph(glyphindex);
+		else
+			localglyphs.push_back(glyphindex);
+	}
+
+	if (localglyphs.empty())
+		return;
+
+	// Glyphs from fonts which can't be loaded in the background are still
+	// rasterized here, but uploaded together.
+	batchingUploads = true;
+
+	try
+	{
+		for (auto glyphindex : localglyphs)
+		{
+			if (glyphs.count(packGlyphIndex(glyphindex)) == 0)
+				addGlyph(glyphindex);
+		}
+	}
+	catch (love::Exception &)
+	{
+		batchingUploads = false;
+		flushGlyphUploads();
+		throw;
+	}
+
+	batchingUploads = false;
+	flushGlyphUploads();
+}
+
+void Font::setAsync(bool enable)
+{
+	async = enable;
+}
+
+bool Font::isAsync() const
+{
+	return async;
+}
+
+int Font::getPendingGlyphCount() const
+{
+	return (int) pendingGlyphs.size();
+}
+
+void Font::integrateLoadedGlyphs()
+{
+	if (glyphLoader == nullptr || pendingGlyphs.empty())
+		return;
+
+	std::vector<love::font::GlyphLoader::LoadedGlyph> loaded;
+	glyphLoader->getLoaded(loaded);
+
+	if (loaded.empty())
+		return;
+
+	batchingUploads = true;
+
+	try
+	{
+		for (const auto &glyph : loaded)
+		{
+			uint64 packedindex = packGlyphIndex(glyph.glyphIndex);
+			pendingGlyphs.erase(packedindex);
+
+			// The glyph may have been added synchronously in the meantime.
+			if (glyphs.count(packedindex) > 0)
+				continue;
+
+			// Glyphs which failed on the worker are retried here, which also
+			// reports the error.
+			if (glyph.glyphData.get() != nullptr)
+			{
+				float glyphdpiscale = shaper->getRasterizers()[glyph.glyphIndex.rasterizerIndex]->getDPIScale();
+				addGlyph(glyph.glyphIndex, glyph.glyphData, glyphdpiscale);
+			}
+			else
+				addGlyph(glyph.glyphIndex);
+		}
+	}
+	catch (love::Exception &)
+	{
+		batchingUploads = false;
+		flushGlyphUploads();
+		throw;
+	}
+
+	batchingUploads = false;
+	flushGlyphUploads();
+
+	// Text generated while these glyphs were missing has to be regenerated.
+	if (missingGlyphs)
+	{
+		textureCacheID++;
+		missingGlyphs = !pendingGlyphs.empty();
+	}
+}
+
 float Font::getKerning(uint32 leftglyph, uint32 rightglyph)
 {
 	return shaper->getKerning(leftglyph, rightglyph);
@@ -368,13 +762,22 @@ float Font::getHeight() const
 	return shaper->getHeight();
 }
 
-std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredCodepoints &codepoints, Range range, const Colorf &constantcolor, std::vector<GlyphVertex> &vertices, float extra_spacing, Vector2 offset, love::font::TextShaper::TextInfo *info)
+std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredCodepoints &codepoints, Range range, const Colorf &constantcolor, std::vector<GlyphVertex> &vertices, float extra_spacing, Vector2 offset, love::font::TextShaper::TextInfo *info, std::vector<uint64> *glyphsused)
 {
+	integrateLoadedGlyphs();
+
 	std::vector<love::font::TextShaper::GlyphPosition> glyphpositions;
 	std::vector<love::font::IndexedColor> colors;
-	shaper->computeGlyphPositions(codepoints, range, offset, extra_spacing, &glyphpositions, &colors, info);
+	shaper->getGlyphPositions(codepoints, range, offset, extra_spacing, &glyphpositions, &colors, info);
+
+	return generateGlyphVertices(glyphpositions, colors, constantcolor, vertices, glyphsused);
+}
 
+std::vector<Font::DrawCommand> Font::generateGlyphVertices(const std::vector<love::font::TextShaper::GlyphPosition> &glyphpositions, const std::vector<love::font::IndexedColor> &colors,
+                                                           const Colorf &constantcolor, std::vector<GlyphVertex> &vertices, std::vector<uint64> *glyphsused)
+{
 	size_t vertstartsize = vertices.size();
+	size_t glyphsstartsize = glyphsused != nullptr ? glyphsused->size() : 0;
 	vertices.reserve(vertstartsize + glyphpositions.size() * 4);
 
 	Colorf linearconstantcolor = gammaCorrectColor(constantcolor);
@@ -392,7 +795,7 @@ std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredC
 
 		uint32 cacheid = textureCacheID;
 
-		const Glyph &glyph = findGlyph(info.glyphIndex);
+		const Glyph *glyph = async ? findGlyphAsync(info.glyphIndex) : &findGlyph(info.glyphIndex);
 
 		// If findGlyph invalidates the texture cache, restart the loop.
 		if (cacheid != textureCacheID)
@@ -400,6 +803,8 @@ std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredC
 			i = -1; // The next iteration will increment this to 0.
 			commands.clear();
 			vertices.resize(vertstartsize);
+			if (glyphsused != nullptr)
+				glyphsused->resize(glyphsstartsize);
 			curcolori = 0;
 			curcolor = toColor32(constantcolor);
 			continue;
@@ -422,25 +827,28 @@ std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredC
 			curcolori++;
 		}
 
-		if (glyph.texture != nullptr)
+		if (glyph != nullptr && glyph->texture != nullptr)
 		{
+			if (glyphsused != nullptr)
+				glyphsused->push_back(packGlyphIndex(info.glyphIndex));
+
 			// Copy the vertices and set their colors and relative positions.
 			for (int j = 0; j < 4; j++)
 			{
-				vertices.push_back(glyph.vertices[j]);
+				vertices.push_back(glyph->vertices[j]);
 				vertices.back().x += info.position.x;
 				vertices.back().y += info.position.y;
 				vertices.back().color = curcolor;
 			}
 
 			// Check if glyph texture has changed since the last iteration.
-			if (commands.empty() || commands.back().texture != glyph.texture)
+			if (commands.empty() || commands.back().texture != glyph->texture)
 			{
 				// Add a new draw command if the texture has changed.
 				DrawCommand cmd;
 				cmd.startvertex = (int)vertices.size() - 4;
 				cmd.vertexcount = 0;
-				cmd.texture = glyph.texture;
+				cmd.texture = glyph->texture;
 				commands.push_back(cmd);
 			}
 
@@ -462,105 +870,124 @@ std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredC
 	return commands;
 }
 
-std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font::ColoredCodepoints &text, const Colorf &constantcolor, float wrap, AlignMode align, std::vector<GlyphVertex> &vertices, love::font::TextShaper::TextInfo *info)
+std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font::ColoredCodepoints &text, const Colorf &constantcolor, float wrap, AlignMode align, std::vector<GlyphVertex> &vertices, love::font::TextShaper::TextInfo *info, std::vector<uint64> *glyphsused)
 {
-	wrap = std::max(wrap, 0.0f);
+	integrateLoadedGlyphs();
 
-	uint32 cacheid = textureCacheID;
+	std::vector<love::font::TextShaper::GlyphPosition> glyphpositions;
+	std::vector<love::font::IndexedColor> colors;
+	TextLayout::compute(shaper, text, wrap, align, glyphpositions, colors, nullptr, info);
 
-	std::vector<DrawCommand> drawcommands;
-	vertices.reserve(text.cps.size() * 4);
+	return generateGlyphVertices(glyphpositions, colors, constantcolor, vertices, glyphsused);
+}
 
-	std::vector<Range> ranges;
-	std::vector<float> widths;
-	shaper->getWrap(text, wrap, ranges, &widths);
+std::vector<Font::DrawCommand> Font::generateVertices(const TextLayout *layout, const Colorf &constantcolor, std::vector<GlyphVertex> &vertices, love::font::TextShaper::TextInfo *info, std::vector<uint64> *glyphsused)
+{
+	if (layout->getFont() != this || layout->getShapingID() != shapingID)
+		return generateVerticesFormatted(layout->getText(), constantcolor, layout->getWrap(), layout->getAlign(), vertices, info, glyphsused);
 
-	float y = 0.0f;
-	float maxwidth = 0.0f;
+	integrateLoadedGlyphs();
 
-	for (int i = 0; i < (int)ranges.size(); i++)
+	if (info != nullptr)
 	{
-		const auto &range = ranges[i];
+		info->width = layout->getWidth();
+		info->height = layout->getHeight();
+	}
 
-		if (!range.isValid())
-		{
-			y += shaper->getCombinedHeight();
-			continue;
-		}
+	return generateGlyphVertices(layout->getGlyphPositions(), layout->getGlyphColors(), constantcolor, vertices, glyphsused);
+}
 
-		float width = widths[i];
-		love::Vector2 offset(0.0f, floorf(y));
-		float extraspacing = 0.0f;
+int Font::getLayoutShapers(int count)
+{
+	const auto &rasterizers = shaper->getRasterizers();
 
-		maxwidth = std::max(width, maxwidth);
+	while ((int) layoutShapers.size() < count)
+	{
+		std::vector<StrongRef<love::font::Rasterizer>> copies;
 
-		switch (align)
+		for (const auto &r : rasterizers)
 		{
-			case ALIGN_RIGHT:
-				offset.x = floorf(wrap - width);
-				break;
-			case ALIGN_CENTER:
-				offset.x = floorf((wrap - width) / 2.0f);
-				break;
-			case ALIGN_JUSTIFY:
-			{
-				auto start = text.cps.begin() + range.getOffset();
-				auto end = start + range.getSize();
-				float numspaces = std::count(start, end, ' ');
-
-				if (text.cps[range.last] == ' ')
-					--numspaces;
-
-				if (width < wrap && numspaces >= 1)
-					extraspacing = (wrap - width) / numspaces;
-				else
-					extraspacing = 0.0f;
-				break;
-			}
-			case ALIGN_LEFT:
-			default:
-				break;
+			love::font::Rasterizer *copy = r->newWorkerRasterizer();
+			if (copy == nullptr)
+				return (int) layoutShapers.size();
+
+			copies.emplace_back(copy, Acquire::NORETAIN);
 		}
 
-		std::vector<DrawCommand> newcommands = generateVertices(text, range, constantcolor, vertices, extraspacing, offset);
+		StrongRef<love::font::TextShaper> s(copies[0]->newTextShaper(), Acquire::NORETAIN);
 
-		if (!newcommands.empty())
+		if (copies.size() > 1)
 		{
-			auto firstcmd = newcommands.begin();
+			std::vector<love::font::Rasterizer *> fallbacks;
+			for (size_t i = 1; i < copies.size(); i++)
+				fallbacks.push_back(copies[i].get());
 
-			// If the first draw command in the new list has the same texture
-			// as the last one in the existing list we're building and its
-			// vertices are in-order, we can combine them (saving a draw call.)
-			if (!drawcommands.empty())
-			{
-				auto prevcmd = drawcommands.back();
-				if (prevcmd.texture == firstcmd->texture && (prevcmd.startvertex + prevcmd.vertexcount) == firstcmd->startvertex)
-				{
-					drawcommands.back().vertexcount += firstcmd->vertexcount;
-					++firstcmd;
-				}
-			}
-
-			// Append the new draw commands to the list we're building.
-			drawcommands.insert(drawcommands.end(), firstcmd, newcommands.end());
+			s->setFallbacks(fallbacks);
 		}
 
-		y += shaper->getCombinedHeight();
+		layoutShapers.push_back(s);
 	}
 
-	if (info != nullptr)
+	return count;
+}
+
+std::vector<StrongRef<TextLayout>> Font::newTextLayouts(const std::vector<love::font::ColoredCodepoints> &texts, float wrap, AlignMode align)
+{
+	std::vector<StrongRef<TextLayout>> layouts;
+	layouts.reserve(texts.size());
+
+	for (const auto &text : texts)
+		layouts.emplace_back(new TextLayout(this, text, wrap, align), Acquire::NORETAIN);
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	thread::TaskPool *pool = nullptr;
+
+	// The calling thread uses the Font's own shaper, every other thread in
+	// the pool needs its own copy.
+	if (gfx != nullptr && texts.size() > 1)
 	{
-		info->width = (int) maxwidth;
-		info->height = (int) y;
+		pool = gfx->getTaskPool();
+		int workercount = pool->getThreadCount() - 1;
+
+		if (getLayoutShapers(workercount) < workercount)
+			pool = nullptr;
 	}
 
-	if (cacheid != textureCacheID)
+	if (pool == nullptr)
 	{
-		vertices.clear();
-		drawcommands = generateVerticesFormatted(text, constantcolor, wrap, align, vertices);
+		for (const auto &layout : layouts)
+			layout->layout(shaper, shapingID);
+
+		return layouts;
 	}
 
-	return drawcommands;
+	for (const auto &s : layoutShapers)
+		s->setLineHeight(shaper->getLineHeight());
+
+	std::string error;
+	thread::MutexRef errormutex;
+
+	pool->parallelFor((int) layouts.size(), 1, [&](int begin, int end, int threadindex)
+	{
+		love::font::TextShaper *s = threadindex == 0 ? shaper.get() : layoutShapers[threadindex - 1].get();
+
+		try
+		{
+			for (int i = begin; i < end; i++)
+				layouts[i]->layout(s, shapingID);
+		}
+		catch (std::exception &e)
+		{
+			thread::Lock lock(errormutex);
+			if (error.empty())
+				error = e.what();
+		}
+	});
+
+	if (!error.empty())
+		throw love::Exception("%s", error.c_str());
+
+	return layouts;
 }
 
 void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<DrawCommand> &drawcommands, const std::vector<GlyphVertex> &vertices)
@@ -570,6 +997,10 @@ void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<D
 
 	Matrix4 m(gfx->getTransform(), t);
 
+	// This may flush batched draws, so it can't happen after the requests.
+	if (sdf)
+		applySDFEffects();
+
 	for (const DrawCommand &cmd : drawcommands)
 	{
 		Graphics::BatchedDrawCommand streamcmd;
@@ -577,6 +1008,7 @@ void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<D
 		streamcmd.indexMode = TRIANGLEINDEX_QUADS;
 		streamcmd.vertexCount = cmd.vertexcount;
 		streamcmd.texture = cmd.texture;
+		streamcmd.standardShaderType = sdf ? Shader::STANDARD_SDF : Shader::STANDARD_DEFAULT;
 
 		Graphics::BatchedVertexData data = gfx->requestBatchedDraw(streamcmd);
 		GlyphVertex *vertexdata = (GlyphVertex *) data.stream[0];
@@ -630,6 +1062,9 @@ void Font::getWrap(const std::vector<love::font::ColoredString> &text, float wra
 
 void Font::setLineHeight(float height)
 {
+	if (height != shaper->getLineHeight())
+		shapingID++;
+
 	shaper->setLineHeight(height);
 }
 
@@ -686,13 +1121,27 @@ void Font::setFallbacks(const std::vector<Font *> &fallbacks)
 
 	shaper->setFallbacks(rasterizerfallbacks);
 
+	// Text laid out with the old fallbacks has to be shaped again.
+	shapingID++;
+	layoutShapers.clear();
+
+	// The loader's Rasterizer copies are out of date, and any glyphs it's
+	// still loading would be discarded anyway.
+	flushGlyphUploads();
+	delete glyphLoader;
+	glyphLoader = nullptr;
+	pendingGlyphs.clear();
+	missingGlyphs = false;
+	atlasShadow.clear();
+
 	// Invalidate existing textures.
 	textureCacheID++;
 	glyphs.clear();
+	glyphPixels = 0;
 	while (textures.size() > 1)
 		textures.pop_back();
 
-	rowHeight = textureX = textureY = TEXTURE_PADDING;
+	packer.reset(textureWidth - TEXTURE_PADDING, textureHeight - TEXTURE_PADDING);
 }
 
 float Font::getDPIScale() const
@@ -700,11 +1149,150 @@ float Font::getDPIScale() const
 	return dpiScale;
 }
 
+bool Font::isSDF() const
+{
+	return sdf;
+}
+
+void Font::setSDFOutline(const SDFEffect &outline)
+{
+	sdfOutline = outline;
+	sdfOutline.width = std::max(sdfOutline.width, 0.0f);
+}
+
+const Font::SDFEffect &Font::getSDFOutline() const
+{
+	return sdfOutline;
+}
+
+void Font::setSDFGlow(const SDFEffect &glow)
+{
+	sdfGlow = glow;
+	sdfGlow.width = std::max(sdfGlow.width, 0.0f);
+}
+
+const Font::SDFEffect &Font::getSDFGlow() const
+{
+	return sdfGlow;
+}
+
+// Only updates the uniform (which flushes batched draws) if it has changed.
+static void sendSDFUniform(Shader *shader, const char *name, const float *values, int components)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info == nullptr || info->baseType != Shader::UNIFORM_FLOAT || info->components != components)
+		return;
+
+	if (memcmp(info->floats, values, sizeof(float) * components) == 0)
+		return;
+
+	memcpy(info->floats, values, sizeof(float) * components);
+	shader->updateUniform(info, 1);
+}
+
+void Font::applySDFEffects()
+{
+	Shader *shader = Shader::isDefaultActive() ? Shader::standardShaders[Shader::STANDARD_SDF] : Shader::current;
+	if (shader == nullptr || sdfSpread <= 0.0f)
+		return;
+
+	// Glyph pixels are dpiScale times the font's pixels, and the distance
+	// goes from 0.5 on the glyph's outline to 0 at sdfSpread pixels out.
+	float scale = dpiScale / (2.0f * sdfSpread);
+	float edges[2] =
+	{
+		std::max(0.5f - sdfOutline.width * scale, 0.0f),
+		std::max(0.5f - (sdfOutline.width + sdfGlow.width) * scale, 0.0f),
+	};
+
+	Colorf outlinecolor = sdfOutline.color;
+	Colorf glowcolor = sdfGlow.color;
+	gammaCorrectColor(outlinecolor);
+	gammaCorrectColor(glowcolor);
+
+	sendSDFUniform(shader, "love_SDFEdges", edges, 2);
+	sendSDFUniform(shader, "love_SDFOutlineColor", &outlinecolor.r, 4);
+	sendSDFUniform(shader, "love_SDFGlowColor", &glowcolor.r, 4);
+}
+
+void Font::setAtlasBudget(int width, int height)
+{
+	if (width < 0 || height < 0)
+		throw love::Exception("Font atlas budget dimensions must not be negative.");
+
+	atlasBudgetWidth = width;
+	atlasBudgetHeight = height;
+}
+
+void Font::getAtlasBudget(int &width, int &height) const
+{
+	width = atlasBudgetWidth;
+	height = atlasBudgetHeight;
+}
+
+Font::AtlasStats Font::getAtlasStats() const
+{
+	AtlasStats stats = {};
+
+	stats.textureCount = (int) textures.size();
+	stats.width = textureWidth;
+	stats.height = textureHeight;
+	stats.glyphCount = (int) glyphs.size();
+	stats.glyphPixels = glyphPixels;
+	stats.evictions = atlasEvictions;
+	stats.rebuilds = atlasRebuilds;
+
+	for (const auto &texture : textures)
+		stats.texturePixels += (int64) texture->getPixelWidth() * texture->getPixelHeight();
+
+	return stats;
+}
+
+void Font::touchGlyphs(const std::vector<uint64> &glyphlist)
+{
+	uint64 frame = getCurrentFrame();
+
+	for (uint64 packedindex : glyphlist)
+	{
+		auto it = glyphs.find(packedindex);
+		if (it != glyphs.end())
+			it->second.lastUse = frame;
+	}
+}
+
+uint32 Font::getEvictionID() const
+{
+	return evictionID;
+}
+
+bool Font::wereGlyphsEvicted(const std::vector<uint64> &glyphlist, uint32 sinceid) const
+{
+	if (sinceid == evictionID || glyphlist.empty())
+		return false;
+
+	// Older evictions have been dropped from the log.
+	if (sinceid < evictionLogStart)
+		return true;
+
+	for (size_t i = sinceid - evictionLogStart; i < evictionLog.size(); i++)
+	{
+		if (std::binary_search(glyphlist.begin(), glyphlist.end(), evictionLog[i]))
+			return true;
+	}
+
+	return false;
+}
+
 uint32 Font::getTextureCacheID() const
 {
 	return textureCacheID;
 }
 
+uint32 Font::getShapingID() const
+{
+	return shapingID;
+}
+
 bool Font::getConstant(const char *in, AlignMode &out)
 {
 	return alignModes.find(in, out);
@@ -22,6 +22,7 @@
 
 // STD
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <vector>
 #include <stddef.h>
@@ -32,8 +33,10 @@
 #include "common/Matrix.h"
 #include "common/Vector.h"
 
+#include "font/GlyphLoader.h"
 #include "font/Rasterizer.h"
 #include "font/TextShaper.h"
+#include "SkylinePacker.h"
 #include "Texture.h"
 #include "vertex.h"
 #include "Volatile.h"
@@ -44,6 +47,7 @@ namespace graphics
 {
 
 class Graphics;
+class TextLayout;
 
 class Font : public Object, public Volatile
 {
@@ -65,6 +69,29 @@ class Font : public Object, public Volatile
 		ALIGN_MAX_ENUM
 	};
 
+	// An outline or glow around the glyphs of an SDF font.
+	struct SDFEffect
+	{
+		// Width outside the glyph's outline, in the font's pixels.
+		float width = 0.0f;
+		Colorf color = Colorf(0.0f, 0.0f, 0.0f, 1.0f);
+	};
+
+	struct AtlasStats
+	{
+		int textureCount;
+		// Size of the newest texture.
+		int width;
+		int height;
+		int glyphCount;
+		// Area used by glyphs (including padding) and by all textures.
+		int64 glyphPixels;
+		int64 texturePixels;
+		int64 evictions;
+		// Number of times textures were re-created and glyphs re-added.
+		int64 rebuilds;
+	};
+
 	// Used to determine when to change textures in the generated vertex array.
 	struct DrawCommand
 	{
@@ -77,11 +104,30 @@ class Font : public Object, public Volatile
 
 	virtual ~Font();
 
+	/**
+	 * The packed index of every glyph the vertices use is added to glyphsUsed,
+	 * if it's set. See touchGlyphs and wereGlyphsEvicted.
+	 **/
 	std::vector<DrawCommand> generateVertices(const love::font::ColoredCodepoints &codepoints, Range range, const Colorf &constantColor, std::vector<GlyphVertex> &vertices,
-	                                          float extra_spacing = 0.0f, Vector2 offset = {}, love::font::TextShaper::TextInfo *info = nullptr);
+	                                          float extra_spacing = 0.0f, Vector2 offset = {}, love::font::TextShaper::TextInfo *info = nullptr,
+	                                          std::vector<uint64> *glyphsUsed = nullptr);
 
 	std::vector<DrawCommand> generateVerticesFormatted(const love::font::ColoredCodepoints &text, const Colorf &constantColor, float wrap, AlignMode align,
-	                                                   std::vector<GlyphVertex> &vertices, love::font::TextShaper::TextInfo *info = nullptr);
+	                                                   std::vector<GlyphVertex> &vertices, love::font::TextShaper::TextInfo *info = nullptr,
+	                                                   std::vector<uint64> *glyphsUsed = nullptr);
+
+	/**
+	 * Generates vertices from the layout's glyph positions. Layouts which are
+	 * out of date, or were made with a different Font, are shaped again.
+	 **/
+	std::vector<DrawCommand> generateVertices(const TextLayout *layout, const Colorf &constantColor, std::vector<GlyphVertex> &vertices,
+	                                          love::font::TextShaper::TextInfo *info = nullptr, std::vector<uint64> *glyphsUsed = nullptr);
+
+	/**
+	 * Wraps and shapes each of the texts, in parallel on worker threads when
+	 * the font's rasterizers support it.
+	 **/
+	std::vector<StrongRef<TextLayout>> newTextLayouts(const std::vector<love::font::ColoredCodepoints> &texts, float wrap, AlignMode align);
 
 	/**
 	 * Draws the specified text.
@@ -148,8 +194,93 @@ class Font : public Object, public Volatile
 
 	float getDPIScale() const;
 
+	/**
+	 * Whether the Font's glyphs are signed distance fields. SDF fonts are
+	 * drawn with a standard shader which keeps edges sharp at any scale, so
+	 * a single Font can be drawn at many sizes.
+	 **/
+	bool isSDF() const;
+
+	/**
+	 * Sets the outline and glow drawn around the glyphs of an SDF font. The
+	 * glow starts at the outer edge of the outline. Their combined width is
+	 * limited by the distance range of the glyphs.
+	 **/
+	void setSDFOutline(const SDFEffect &outline);
+	const SDFEffect &getSDFOutline() const;
+	void setSDFGlow(const SDFEffect &glow);
+	const SDFEffect &getSDFGlow() const;
+
+	/**
+	 * Sends the outline and glow settings to the active shader (or to the
+	 * standard SDF shader if no custom shader is active).
+	 **/
+	void applySDFEffects();
+
+	/**
+	 * Rasterizes the glyphs for the given codepoints ahead of time, on worker
+	 * threads when the font supports it. Atlas uploads for glyphs which have
+	 * finished loading are batched and happen the next time text is drawn.
+	 **/
+	void preload(const Codepoints &codepoints);
+
+	/**
+	 * In async mode, glyphs which haven't been loaded yet are rasterized in
+	 * the background instead of stalling the current frame, and are left out
+	 * of drawn text until they're ready.
+	 **/
+	void setAsync(bool enable);
+	bool isAsync() const;
+
+	/**
+	 * Gets the number of glyphs which are still loading in the background.
+	 **/
+	int getPendingGlyphCount() const;
+
+	/**
+	 * Adds glyphs which have finished loading in the background to the
+	 * texture atlas. Invalidates the texture cache if text was drawn without
+	 * them.
+	 **/
+	void integrateLoadedGlyphs();
+
+	/**
+	 * Limits the size the glyph atlas texture can grow to. Once it's full,
+	 * glyphs which haven't been used for the most frames are evicted to make
+	 * room for new ones. Another texture is only added if the text drawn in
+	 * a single frame doesn't fit. A size of 0 removes the limit.
+	 **/
+	void setAtlasBudget(int width, int height);
+	void getAtlasBudget(int &width, int &height) const;
+
+	AtlasStats getAtlasStats() const;
+
+	/**
+	 * Marks the glyphs as used this frame, so they aren't evicted. Used by
+	 * retained text which keeps its vertices between frames.
+	 **/
+	void touchGlyphs(const std::vector<uint64> &glyphs);
+
+	/**
+	 * ID which is incremented whenever a single glyph is evicted. Unlike the
+	 * texture cache ID, an eviction only affects text which used the glyph.
+	 **/
+	uint32 getEvictionID() const;
+
+	/**
+	 * Whether any of the glyphs (sorted packed indices) were evicted since
+	 * the given eviction ID.
+	 **/
+	bool wereGlyphsEvicted(const std::vector<uint64> &glyphs, uint32 sinceID) const;
+
 	uint32 getTextureCacheID() const;
 
+	/**
+	 * ID which is incremented when text needs to be shaped again, because
+	 * the line height or fallbacks changed.
+	 **/
+	uint32 getShapingID() const;
+
 	VertexAttributesID getVertexAttributesID() const { return vertexAttributesID; }
 
 	// Implements Volatile.
@@ -168,6 +299,12 @@ class Font : public Object, public Volatile
 	{
 		Texture *texture;
 		GlyphVertex vertices[4];
+
+		// Space used in the texture, including padding.
+		Rect atlasRect;
+
+		// Frame the glyph was last used in.
+		uint64 lastUse;
 	};
 
 	struct TextureSize
@@ -177,12 +314,26 @@ class Font : public Object, public Volatile
 	};
 
 	void createTexture();
+	Texture *allocateGlyphRect(int width, int height, Rect &rect);
+	bool evictGlyph(int width, int height, Texture *&texture, Rect &rect);
+	bool rebuildAtlas();
 
 	TextureSize getNextTextureSize() const;
 	love::font::GlyphData *getRasterizerGlyphData(love::font::TextShaper::GlyphIndex glyphindex, float &dpiscale);
 	const Glyph &addGlyph(love::font::TextShaper::GlyphIndex glyphindex);
+	const Glyph &addGlyph(love::font::TextShaper::GlyphIndex glyphindex, love::font::GlyphData *gd, float glyphdpiscale);
 	const Glyph &findGlyph(love::font::TextShaper::GlyphIndex glyphindex);
+	const Glyph *findGlyphAsync(love::font::TextShaper::GlyphIndex glyphindex);
+	love::font::GlyphLoader *getGlyphLoader();
+	void requestGlyph(love::font::TextShaper::GlyphIndex glyphindex);
+	void fillEmptyPixels(uint8 *data, size_t pixelcount) const;
+	void resetAtlasShadow(int y);
+	void uploadGlyphPixels(Texture *texture, const Rect &rect, const uint8 *data);
+	void flushGlyphUploads();
 	void printv(Graphics *gfx, const Matrix4 &t, const std::vector<DrawCommand> &drawcommands, const std::vector<GlyphVertex> &vertices);
+	std::vector<DrawCommand> generateGlyphVertices(const std::vector<love::font::TextShaper::GlyphPosition> &glyphpositions, const std::vector<love::font::IndexedColor> &colors,
+	                                               const Colorf &constantcolor, std::vector<GlyphVertex> &vertices, std::vector<uint64> *glyphsused);
+	int getLayoutShapers(int count);
 
 	StrongRef<love::font::TextShaper> shaper;
 
@@ -200,12 +351,54 @@ class Font : public Object, public Volatile
 
 	float dpiScale;
 
-	int textureX, textureY;
-	int rowHeight;
+	bool sdf;
+	float sdfSpread;
+	SDFEffect sdfOutline;
+	SDFEffect sdfGlow;
+
+	// Packs glyphs into the newest texture.
+	SkylinePacker packer;
+
+	int atlasBudgetWidth;
+	int atlasBudgetHeight;
+
+	int64 glyphPixels;
+	int64 atlasEvictions;
+	int64 atlasRebuilds;
+
+	// Packed indices of the most recently evicted glyphs. The first one was
+	// evicted at evictionLogStart, and evictionID is the total so far.
+	std::vector<uint64> evictionLog;
+	uint32 evictionLogStart;
+	uint32 evictionID;
+
+	// Created the first time glyphs are preloaded or loaded asynchronously.
+	love::font::GlyphLoader *glyphLoader;
+
+	// Glyphs which have been requested from the loader but not yet added.
+	std::unordered_set<uint64> pendingGlyphs;
+
+	bool async;
+
+	// Whether text was generated without some glyphs in async mode.
+	bool missingGlyphs;
+
+	// A CPU copy of rows [atlasShadowY, textureHeight) of the newest texture,
+	// which lets glyphs added in one go be uploaded with a single call.
+	std::vector<uint8> atlasShadow;
+	int atlasShadowY;
+	int atlasDirtyTop, atlasDirtyBottom;
+	bool batchingUploads;
 
 	// ID which is incremented when the texture cache is invalidated.
 	uint32 textureCacheID;
 
+	uint32 shapingID;
+
+	// Copies of the shaper for worker threads laying out text. Created the
+	// first time they're needed.
+	std::vector<StrongRef<love::font::TextShaper>> layoutShapers;
+
 	VertexAttributesID vertexAttributesID;
 
 	// 1 pixel of transparent padding between glyphs (so quads won't pick up
@@ -213,6 +406,10 @@ class Font : public Object, public Volatile
 	// use, for edge antialiasing.
 	static const int TEXTURE_PADDING = 2;
 
+	// Evictions older than this are dropped from the log, and text which
+	// hasn't been drawn since then is regenerated.
+	static const size_t MAX_EVICTION_LOG = 1024;
+
 	static StringMap<AlignMode, ALIGN_MAX_ENUM>::Entry alignModeEntries[];
 	static StringMap<AlignMode, ALIGN_MAX_ENUM> alignModes;
 	
@@ -31,7 +31,10 @@
 #include "Font.h"
 #include "Video.h"
 #include "TextBatch.h"
+#include "ShapeBatch.h"
+#include "thread/TaskPool.h"
 #include "common/deprecation.h"
+#include "common/trace.h"
 #include "common/config.h"
 
 // C++
@@ -208,10 +211,16 @@ Graphics::Graphics(const char *name)
 	, created(false)
 	, active(true)
 	, batchedDrawState()
+	, shapeCapture(nullptr)
 	, deviceProjectionMatrix()
 	, renderTargetSwitchCount(0)
 	, drawCalls(0)
 	, drawCallsBatched(0)
+	, streamBufferGrows(0)
+	, frameWaitTime(0.0)
+	, streamBufferFrames(0)
+	, frameCount(0)
+	, taskPool(nullptr)
 	, quadIndexBuffer(nullptr)
 	, fanIndexBuffer(nullptr)
 	, capabilities()
@@ -219,6 +228,13 @@ Graphics::Graphics(const char *name)
 	, defaultTexelBuffers()
 	, defaultStorageBuffer(nullptr)
 	, cachedShaderStages()
+	, gpuProfiling(false)
+	, gpuTimingFrameActive(false)
+	, gpuPassScope(-1)
+	, gpuTimingsFrame(0)
+	, adaptiveStreamBuffers(false)
+	, streamBufferPacingFrames(0)
+	, streamBufferPacingTime(0.0)
 {
 	transformStack.reserve(16);
 	transformStack.push_back(Matrix4());
@@ -274,6 +290,8 @@ Graphics::~Graphics()
 	pendingReadbacks.clear();
 	clearTemporaryResources();
 
+	delete taskPool;
+
 	Shader::deinitialize();
 }
 
@@ -471,6 +489,11 @@ love::graphics::TextBatch *Graphics::newTextBatch(graphics::Font *font, const st
 	return new TextBatch(font, text);
 }
 
+love::graphics::ShapeBatch *Graphics::newShapeBatch(BufferDataUsage usage)
+{
+	return new ShapeBatch(this, usage);
+}
+
 love::data::ByteData *Graphics::readbackBuffer(Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset)
 {
 	StrongRef<GraphicsReadback> readback;
@@ -1131,6 +1154,8 @@ void Graphics::setRenderTargets(const RenderTargets &rts)
 
 	flushBatchedDraws();
 
+	endGPUTimingScope(gpuPassScope);
+
 	if (rts.depthStencil.texture == nullptr && rts.temporaryRTFlags != 0)
 	{
 		bool wantsdepth   = (rts.temporaryRTFlags & TEMPORARY_RT_DEPTH) != 0;
@@ -1202,6 +1227,8 @@ void Graphics::setRenderTargets(const RenderTargets &rts)
 
 	renderTargetSwitchCount++;
 
+	beginGPUTimingPass();
+
 	resetProjection();
 
 	// generateMipmaps can't be used for depth/stencil textures.
@@ -1233,11 +1260,14 @@ void Graphics::setRenderTarget()
 	const RenderTargetsStrongRef prevRTs = state.renderTargets;
 
 	flushBatchedDraws();
+	endGPUTimingScope(gpuPassScope);
 	setRenderTargetsInternal(RenderTargets(), pixelWidth, pixelHeight, isGammaCorrect());
 
 	state.renderTargets = RenderTargetsStrongRef();
 	renderTargetSwitchCount++;
 
+	beginGPUTimingPass();
+
 	resetProjection();
 
 	// generateMipmaps can't be used for depth/stencil textures.
@@ -1407,6 +1437,9 @@ void Graphics::releaseTemporaryBuffer(Buffer *buffer)
 
 void Graphics::updateTemporaryResources()
 {
+	// Called once per present.
+	frameCount++;
+
 	for (int i = (int) temporaryTextures.size() - 1; i >= 0; i--)
 	{
 		auto &t = temporaryTextures[i];
@@ -1948,6 +1981,9 @@ void Graphics::dispatchIndirect(Shader *shader, Buffer *indirectargs, int argsin
 
 Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawCommand &cmd)
 {
+	if (shapeCapture != nullptr)
+		return shapeCapture->captureBatchedDraw(cmd);
+
 	BatchedDrawState &state = batchedDrawState;
 
 	bool shouldflush = false;
@@ -2030,6 +2066,8 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 
 	if (shouldresize)
 	{
+		streamBufferGrows++;
+
 		for (int i = 0; i < 2; i++)
 		{
 			if (state.vb[i]->getSize() < buffersizes[i])
@@ -2081,6 +2119,11 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 	return d;
 }
 
+void Graphics::setShapeCapture(ShapeBatch *batch)
+{
+	shapeCapture = batch;
+}
+
 void Graphics::flushBatchedDraws()
 {
 	auto &sbstate = batchedDrawState;
@@ -2088,6 +2131,8 @@ void Graphics::flushBatchedDraws()
 	if ((sbstate.vertexCount == 0 && sbstate.indexCount == 0) || sbstate.flushing)
 		return;
 
+	LOVE_TRACE_ZONE("Graphics::flushBatchedDraws");
+
 	VertexAttributes attributes;
 	BufferBindings buffers;
 
@@ -2744,10 +2789,298 @@ Graphics::Stats Graphics::getStats() const
 	stats.buffers = Buffer::bufferCount;
 	stats.textureMemory = Texture::totalGraphicsMemory;
 	stats.bufferMemory = Buffer::totalGraphicsMemory;
+	stats.streamBufferGrows = streamBufferGrows;
+	stats.streamBufferWaits = StreamBuffer::waitCount;
+	stats.streamBufferWaitTime = StreamBuffer::waitTime;
+	stats.streamBufferFrames = batchedDrawState.vb[0] != nullptr ? batchedDrawState.vb[0]->getFrameCount() : 0;
+	stats.frameWaitTime = frameWaitTime;
 
 	return stats;
 }
 
+void Graphics::setAdaptiveStreamBuffersEnabled(bool enable)
+{
+	adaptiveStreamBuffers = enable;
+	streamBufferPacingFrames = 0;
+	streamBufferPacingTime = 0.0;
+}
+
+bool Graphics::isAdaptiveStreamBuffersEnabled() const
+{
+	return adaptiveStreamBuffers;
+}
+
+void Graphics::updateStreamBufferPacing()
+{
+	BatchedDrawState &state = batchedDrawState;
+
+	if (adaptiveStreamBuffers && state.vb[0] != nullptr && state.vertexCount == 0)
+	{
+		streamBufferPacingTime += StreamBuffer::waitTime;
+		streamBufferPacingFrames++;
+
+		if (streamBufferPacingFrames >= STREAM_BUFFER_PACING_FRAMES)
+		{
+			double average = streamBufferPacingTime / streamBufferPacingFrames;
+			int frames = state.vb[0]->getFrameCount();
+
+			// More frames in flight give the GPU longer to finish with each
+			// section before the CPU wants to write to it again.
+			if (average > STREAM_BUFFER_WAIT_THRESHOLD && frames > 0 && frames < getMaxStreamBufferFrames())
+			{
+				streamBufferFrames = frames + 1;
+
+				for (int i = 0; i < 2; i++)
+				{
+					size_t size = state.vb[i]->getSize();
+					state.vb[i]->release();
+					state.vb[i] = newStreamBuffer(BUFFERUSAGE_VERTEX, size);
+				}
+
+				size_t size = state.indexBuffer->getSize();
+				state.indexBuffer->release();
+				state.indexBuffer = newStreamBuffer(BUFFERUSAGE_INDEX, size);
+			}
+
+			streamBufferPacingFrames = 0;
+			streamBufferPacingTime = 0.0;
+		}
+	}
+
+	streamBufferGrows = 0;
+	frameWaitTime = 0.0;
+	StreamBuffer::waitCount = 0;
+	StreamBuffer::waitTime = 0.0;
+}
+
+void Graphics::setGPUProfilingEnabled(bool enable)
+{
+	if (enable && !capabilities.features[FEATURE_GPU_TIMESTAMPS])
+		throw love::Exception("GPU timestamps are not supported on this system.");
+
+	// Takes effect at the start of the next frame.
+	gpuProfiling = enable;
+}
+
+bool Graphics::isGPUProfilingEnabled() const
+{
+	return gpuProfiling;
+}
+
+void Graphics::pushGPUMarker(const std::string &name)
+{
+	if (gpuMarkerStack.size() >= MAX_USER_STACK_DEPTH)
+		throw love::Exception("Maximum GPU marker depth reached (more pushes than pops?)");
+
+	int scope = -1;
+
+	if (gpuTimingFrameActive)
+	{
+		flushBatchedDraws();
+		scope = beginGPUTimingScope(name, (int) gpuMarkerStack.size(), false);
+	}
+
+	gpuMarkerStack.push_back(scope);
+}
+
+void Graphics::popGPUMarker()
+{
+	if (gpuMarkerStack.empty())
+		throw love::Exception("Minimum GPU marker depth reached (more pops than pushes?)");
+
+	int scope = gpuMarkerStack.back();
+	gpuMarkerStack.pop_back();
+
+	if (scope >= 0)
+	{
+		flushBatchedDraws();
+		endGPUTimingScope(scope);
+	}
+}
+
+uint64 Graphics::getGPUTimings(std::vector<GPUTiming> &timings) const
+{
+	timings = gpuTimings;
+	return gpuTimingsFrame;
+}
+
+int Graphics::beginGPUTimingScope(const std::string &name, int depth, bool pass)
+{
+	if (!gpuTimingFrameActive || (int) gpuTimingFrame.scopes.size() >= MAX_GPU_TIMING_SCOPES)
+		return -1;
+
+	GPUTimingScope scope = {name, depth, pass, 0, 0, false};
+	if (!writeGPUTimestamp(scope.begin))
+		return -1;
+
+	gpuTimingFrame.scopes.push_back(scope);
+	return (int) gpuTimingFrame.scopes.size() - 1;
+}
+
+void Graphics::endGPUTimingScope(int scope)
+{
+	if (!gpuTimingFrameActive || scope < 0 || scope >= (int) gpuTimingFrame.scopes.size())
+		return;
+
+	GPUTimingScope &s = gpuTimingFrame.scopes[scope];
+	if (!s.ended)
+		s.ended = writeGPUTimestamp(s.end);
+}
+
+void Graphics::beginGPUTimingPass()
+{
+	gpuPassScope = -1;
+
+	if (!gpuTimingFrameActive)
+		return;
+
+	const auto &rts = states.back().renderTargets;
+	Texture *tex = rts.getFirstTarget().texture.get();
+
+	std::string name = "screen";
+	if (tex != nullptr && !tex->getDebugName().empty())
+		name = tex->getDebugName();
+	else if (tex != nullptr)
+		name = "canvas " + std::to_string(tex->getPixelWidth()) + "x" + std::to_string(tex->getPixelHeight());
+
+	gpuPassScope = beginGPUTimingScope(name, 0, true);
+}
+
+void Graphics::beginGPUTimingFrame()
+{
+	resolveGPUTimingFrames();
+
+	if (!gpuProfiling || gpuTimingFrameActive)
+		return;
+
+	gpuTimingFrameActive = true;
+	gpuTimingFrame.frame = frameCount;
+	gpuTimingFrame.scopes.clear();
+	gpuTimingFrame.traceTime = trace::isEnabled() ? trace::getTime() : -1;
+
+	beginGPUTimingPass();
+}
+
+void Graphics::endGPUTimingFrame()
+{
+	if (!gpuTimingFrameActive)
+		return;
+
+	flushBatchedDraws();
+
+	// Markers which are still open at the end of the frame stop being timed.
+	for (int i = (int) gpuMarkerStack.size() - 1; i >= 0; i--)
+	{
+		endGPUTimingScope(gpuMarkerStack[i]);
+		gpuMarkerStack[i] = -1;
+	}
+
+	endGPUTimingScope(gpuPassScope);
+	gpuPassScope = -1;
+
+	pendingGPUTimingFrames.push_back(std::move(gpuTimingFrame));
+	gpuTimingFrame = GPUTimingFrame();
+	gpuTimingFrameActive = false;
+}
+
+void Graphics::releaseGPUTimingFrame(const GPUTimingFrame &frame)
+{
+	for (const GPUTimingScope &scope : frame.scopes)
+	{
+		releaseGPUTimestamp(scope.begin);
+		if (scope.ended)
+			releaseGPUTimestamp(scope.end);
+	}
+}
+
+void Graphics::resolveGPUTimingFrames()
+{
+	while (!pendingGPUTimingFrames.empty())
+	{
+		const GPUTimingFrame &frame = pendingGPUTimingFrames.front();
+
+		std::vector<GPUTiming> timings;
+		timings.reserve(frame.scopes.size());
+
+		// Raw timestamps of each timing, for the trace's GPU track.
+		std::vector<std::pair<uint64, uint64>> timestamps;
+		timestamps.reserve(frame.scopes.size());
+
+		bool available = true;
+
+		for (const GPUTimingScope &scope : frame.scopes)
+		{
+			if (!scope.ended)
+				continue;
+
+			uint64 begin = 0;
+			uint64 end = 0;
+			if (!getGPUTimestamp(scope.begin, begin) || !getGPUTimestamp(scope.end, end))
+			{
+				available = false;
+				break;
+			}
+
+			double time = end > begin ? (end - begin) / 1000000000.0 : 0.0;
+			timings.push_back({scope.name, time, scope.depth, scope.pass});
+			timestamps.push_back({begin, end});
+		}
+
+		// Results are available in submission order, so later frames won't
+		// be ready either. Very old frames are dropped.
+		if (!available && (int) pendingGPUTimingFrames.size() <= MAX_PENDING_GPU_TIMING_FRAMES)
+			break;
+
+		// GPU timestamps use their own clock, so the frame's first timestamp
+		// is lined up with the time the frame started on the CPU. The GPU
+		// can only start later than that, so zones may appear early.
+		if (available && frame.traceTime >= 0 && trace::isEnabled() && !timestamps.empty())
+		{
+			uint64 origin = timestamps[0].first;
+			for (const auto &t : timestamps)
+				origin = std::min(origin, t.first);
+
+			for (size_t i = 0; i < timings.size(); i++)
+			{
+				int64 begin = frame.traceTime + (int64) (timestamps[i].first - origin);
+				int64 end = frame.traceTime + (int64) (std::max(timestamps[i].second, timestamps[i].first) - origin);
+				trace::addGPUZone(timings[i].name, begin, end);
+			}
+		}
+
+		if (available)
+		{
+			gpuTimings = std::move(timings);
+			gpuTimingsFrame = frame.frame;
+		}
+
+		releaseGPUTimingFrame(frame);
+		pendingGPUTimingFrames.pop_front();
+	}
+}
+
+void Graphics::clearGPUTiming()
+{
+	for (const GPUTimingFrame &frame : pendingGPUTimingFrames)
+		releaseGPUTimingFrame(frame);
+	pendingGPUTimingFrames.clear();
+
+	releaseGPUTimingFrame(gpuTimingFrame);
+	gpuTimingFrame = GPUTimingFrame();
+	gpuTimingFrameActive = false;
+	gpuPassScope = -1;
+
+	for (int &scope : gpuMarkerStack)
+		scope = -1;
+}
+
+thread::TaskPool *Graphics::getTaskPool()
+{
+	if (taskPool == nullptr)
+		taskPool = new thread::TaskPool(thread::getProcessorCount(), "GraphicsWorker");
+	return taskPool;
+}
+
 size_t Graphics::getStackDepth() const
 {
 	return stackTypeStack.size();
@@ -2964,6 +3297,7 @@ STRINGMAP_CLASS_BEGIN(Graphics, Graphics::Feature, Graphics::FEATURE_MAX_ENUM, f
 	{ "texelbuffer",              Graphics::FEATURE_TEXEL_BUFFER         },
 	{ "copytexturetobuffer",      Graphics::FEATURE_COPY_TEXTURE_TO_BUFFER },
 	{ "indirectdraw",             Graphics::FEATURE_INDIRECT_DRAW        },
+	{ "gputimestamps",            Graphics::FEATURE_GPU_TIMESTAMPS       },
 }
 STRINGMAP_CLASS_END(Graphics, Graphics::Feature, Graphics::FEATURE_MAX_ENUM, feature)
 
@@ -47,18 +47,25 @@
 #include "data/HashFunction.h"
 
 // C++
+#include <deque>
 #include <string>
 #include <vector>
 
 namespace love
 {
 
+namespace thread
+{
+class TaskPool;
+}
+
 namespace graphics
 {
 
 class SpriteBatch;
 class ParticleSystem;
 class TextBatch;
+class ShapeBatch;
 class Video;
 class Buffer;
 
@@ -163,6 +170,7 @@ class Graphics : public Module
 		FEATURE_TEXEL_BUFFER,
 		FEATURE_COPY_TEXTURE_TO_BUFFER,
 		FEATURE_INDIRECT_DRAW,
+		FEATURE_GPU_TIMESTAMPS,
 		FEATURE_MAX_ENUM
 	};
 
@@ -230,6 +238,37 @@ class Graphics : public Module
 		int buffers;
 		int64 textureMemory;
 		int64 bufferMemory;
+
+		// Times batched vertex or index data didn't fit in the rest of the
+		// frame's section of a stream buffer, forcing it to be reallocated.
+		int streamBufferGrows;
+
+		// CPU waits for the GPU to finish with stream buffer memory, and the
+		// total time spent waiting in seconds.
+		int streamBufferWaits;
+		double streamBufferWaitTime;
+
+		// Frames of batched data the stream buffers cycle through.
+		int streamBufferFrames;
+
+		// Time in seconds spent waiting for an earlier frame to finish on the
+		// GPU before starting a new one (vsync or GPU-bound pacing). Kept
+		// apart from stream buffer waits.
+		double frameWaitTime;
+	};
+
+	struct GPUTiming
+	{
+		std::string name;
+
+		// Time the GPU spent on the scope's work, in seconds.
+		double time;
+
+		// Nesting depth of a marker. Passes are always at depth 0.
+		int depth;
+
+		// Whether this is a render pass rather than a user marker.
+		bool pass;
 	};
 
 	struct DrawCommand
@@ -474,6 +513,8 @@ class Graphics : public Module
 
 	TextBatch *newTextBatch(Font *font, const std::vector<love::font::ColoredString> &text = {});
 
+	ShapeBatch *newShapeBatch(BufferDataUsage usage);
+
 	data::ByteData *readbackBuffer(Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset);
 	GraphicsReadback *readbackBufferAsync(Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset);
 
@@ -856,6 +897,42 @@ class Graphics : public Module
 	 **/
 	Stats getStats() const;
 
+	/**
+	 * Returns the number of frames which have been presented.
+	 **/
+	uint64 getFrameCount() const { return frameCount; }
+
+	/**
+	 * Worker threads for CPU-side work such as text layout. Created the first
+	 * time it's used.
+	 **/
+	thread::TaskPool *getTaskPool();
+
+	/**
+	 * Enables GPU timestamp queries around each render pass and each marker.
+	 * Results are read back once the GPU has finished with them, usually a
+	 * few frames later, so the CPU never waits for them.
+	 **/
+	void setGPUProfilingEnabled(bool enable);
+	bool isGPUProfilingEnabled() const;
+
+	/**
+	 * When enabled, the batched draw stream buffers are recreated with more
+	 * frames of data (up to the backend's limit) if the CPU keeps waiting on
+	 * them.
+	 **/
+	void setAdaptiveStreamBuffersEnabled(bool enable);
+	bool isAdaptiveStreamBuffersEnabled() const;
+
+	void pushGPUMarker(const std::string &name);
+	void popGPUMarker();
+
+	/**
+	 * Gets the GPU timings of the newest frame whose results are available,
+	 * and returns its frame number (0 if there's none yet.)
+	 **/
+	uint64 getGPUTimings(std::vector<GPUTiming> &timings) const;
+
 	size_t getStackDepth() const;
 	void push(StackType type = STACK_TRANSFORM);
 	void pop();
@@ -885,6 +962,12 @@ class Graphics : public Module
 	void flushBatchedDraws();
 	BatchedVertexData requestBatchedDraw(const BatchedDrawCommand &command);
 
+	/**
+	 * While set, batched draws are handed to the ShapeBatch instead of being
+	 * written to the stream buffers.
+	 **/
+	void setShapeCapture(ShapeBatch *batch);
+
 	static void flushBatchedDrawsGlobal();
 
 	Texture *getTemporaryTexture(PixelFormat format, int w, int h, int samples);
@@ -1028,6 +1111,29 @@ class Graphics : public Module
 	virtual void initCapabilities() = 0;
 	virtual void getAPIStats(int &shaderswitches) const = 0;
 
+	// Backends with FEATURE_GPU_TIMESTAMPS write a timestamp after all
+	// previously recorded GPU work. Getting a result must never wait for the
+	// GPU. IDs are only meaningful to the backend which returned them.
+	virtual bool writeGPUTimestamp(uint64 &/*id*/) { return false; }
+	virtual bool getGPUTimestamp(uint64 /*id*/, uint64 &/*nanoseconds*/) { return false; }
+	virtual void releaseGPUTimestamp(uint64 /*id*/) {}
+
+	// Called by backends at the start of a frame, and at the end of a frame
+	// before its commands are submitted.
+	void beginGPUTimingFrame();
+	void endGPUTimingFrame();
+
+	// Releases all timestamps, for when the backend is about to destroy them.
+	void clearGPUTiming();
+
+	// Most frames of data the backend's stream buffers can cycle through, or
+	// 0 if it can't be changed.
+	virtual int getMaxStreamBufferFrames() const { return 0; }
+
+	// Called by backends at the end of a frame, before the per-frame stats
+	// are reset.
+	void updateStreamBufferPacing();
+
 	void createQuadIndexBuffer();
 	void createFanIndexBuffer();
 
@@ -1067,6 +1173,7 @@ class Graphics : public Module
 	std::vector<StrongRef<GraphicsReadback>> pendingReadbacks;
 
 	BatchedDrawState batchedDrawState;
+	ShapeBatch *shapeCapture;
 
 	std::vector<Matrix4> transformStack;
 	Matrix4 deviceProjectionMatrix;
@@ -1082,6 +1189,15 @@ class Graphics : public Module
 	int renderTargetSwitchCount;
 	int drawCalls;
 	int drawCallsBatched;
+	int streamBufferGrows;
+	double frameWaitTime;
+
+	// Requested frames of data for new stream buffers, 0 for the default.
+	int streamBufferFrames;
+
+	uint64 frameCount;
+
+	thread::TaskPool *taskPool;
 
 	Buffer *quadIndexBuffer;
 	Buffer *fanIndexBuffer;
@@ -1095,8 +1211,44 @@ class Graphics : public Module
 	static const size_t MAX_USER_STACK_DEPTH = 128;
 	static const int MAX_TEMPORARY_RESOURCE_UNUSED_FRAMES = 16;
 
+	// Scopes (passes and markers) timed in a single frame.
+	static const int MAX_GPU_TIMING_SCOPES = 256;
+
+	// Frames whose results aren't available by then are dropped.
+	static const int MAX_PENDING_GPU_TIMING_FRAMES = 8;
+
+	// Adaptive stream buffers add a frame of data when the average wait over
+	// this many frames exceeds the threshold (in seconds).
+	static const int STREAM_BUFFER_PACING_FRAMES = 60;
+	static constexpr double STREAM_BUFFER_WAIT_THRESHOLD = 0.0005;
+
 private:
 
+	struct GPUTimingScope
+	{
+		std::string name;
+		int depth;
+		bool pass;
+		uint64 begin;
+		uint64 end;
+		bool ended;
+	};
+
+	struct GPUTimingFrame
+	{
+		uint64 frame = 0;
+		std::vector<GPUTimingScope> scopes;
+
+		// Trace time the frame started on the CPU, or -1 when not tracing.
+		int64 traceTime = -1;
+	};
+
+	int beginGPUTimingScope(const std::string &name, int depth, bool pass);
+	void endGPUTimingScope(int scope);
+	void beginGPUTimingPass();
+	void releaseGPUTimingFrame(const GPUTimingFrame &frame);
+	void resolveGPUTimingFrames();
+
 	void checkSetDefaultFont();
 	int calculateEllipsePoints(float rx, float ry) const;
 
@@ -1112,6 +1264,23 @@ class Graphics : public Module
 
 	VertexAttributesID noAttributesID;
 
+	bool gpuProfiling;
+	bool gpuTimingFrameActive;
+	GPUTimingFrame gpuTimingFrame;
+
+	// Scope indices of the open markers, or -1 for ones which aren't timed.
+	std::vector<int> gpuMarkerStack;
+	int gpuPassScope;
+
+	std::deque<GPUTimingFrame> pendingGPUTimingFrames;
+
+	std::vector<GPUTiming> gpuTimings;
+	uint64 gpuTimingsFrame;
+
+	bool adaptiveStreamBuffers;
+	int streamBufferPacingFrames;
+	double streamBufferPacingTime;
+
 }; // Graphics
 
 STRINGMAP_DECLARE(Renderer);
@@ -1798,6 +1798,45 @@ void effect()
 }
 )";
 
+// Text from signed distance field fonts. The alpha channel holds the distance
+// to the glyph's outline, with 0.5 on the outline. The edge is antialiased over
+// about one screen pixel at any scale. love_SDFEdges holds the distances of the
+// outer edges of the outline and the glow, which Font sets for SDF fonts.
+static const std::string defaultSDFPixel = R"(
+uniform vec4 love_SDFOutlineColor;
+uniform vec4 love_SDFGlowColor;
+uniform vec2 love_SDFEdges;
+
+vec4 love_premultipliedOver(vec4 dst, vec4 src)
+{
+	return src + dst * (1.0 - src.a);
+}
+
+vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord)
+{
+	float dist = Texel(tex, texcoord).a;
+	float aa = max(fwidth(dist) * 0.75, 1.0 / 255.0);
+	vec4 result = vec4(0.0);
+
+	if (love_SDFEdges.y < love_SDFEdges.x)
+	{
+		float glow = smoothstep(love_SDFEdges.y, love_SDFEdges.x, dist) * love_SDFGlowColor.a * vcolor.a;
+		result = vec4(love_SDFGlowColor.rgb * glow, glow);
+	}
+
+	if (love_SDFEdges.x < 0.5)
+	{
+		float outline = smoothstep(love_SDFEdges.x - aa, love_SDFEdges.x + aa, dist) * love_SDFOutlineColor.a * vcolor.a;
+		result = love_premultipliedOver(result, vec4(love_SDFOutlineColor.rgb * outline, outline));
+	}
+
+	float fill = smoothstep(0.5 - aa, 0.5 + aa, dist) * vcolor.a;
+	result = love_premultipliedOver(result, vec4(vcolor.rgb * fill, fill));
+
+	return result.a > 0.0 ? vec4(result.rgb / result.a, result.a) : vec4(0.0);
+}
+)";
+
 const std::string &Shader::getDefaultCode(StandardShader shader, ShaderStageType stage)
 {
 	if (stage == SHADERSTAGE_VERTEX)
@@ -1816,6 +1855,7 @@ const std::string &Shader::getDefaultCode(StandardShader shader, ShaderStageType
 		case STANDARD_VIDEO: return defaultVideoPixel;
 		case STANDARD_ARRAY: return defaultArrayPixel;
 		case STANDARD_POINTS: return defaultStandardPixel;
+		case STANDARD_SDF: return defaultSDFPixel;
 		case STANDARD_MAX_ENUM: return nocode;
 	}
 
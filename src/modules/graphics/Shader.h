@@ -89,6 +89,7 @@ class Shader : public Object, public Resource
 		STANDARD_VIDEO,
 		STANDARD_ARRAY,
 		STANDARD_POINTS,
+		STANDARD_SDF,
 		STANDARD_MAX_ENUM
 	};
 
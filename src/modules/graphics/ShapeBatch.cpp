@@ -0,0 +1,419 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "ShapeBatch.h"
+#include "Shader.h"
+
+#include <algorithm>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type ShapeBatch::type("ShapeBatch", &Drawable::type);
+
+// Compacting rewrites every entry's indices, so it waits until at least this
+// many vertices or indices are dead.
+static const size_t MIN_COMPACT_ELEMENTS = 4 * 1024;
+
+ShapeBatch::ShapeBatch(Graphics *gfx, BufferDataUsage usage)
+	: usage(usage)
+	, color(1.0f, 1.0f, 1.0f, 1.0f)
+	, attributesID(gfx->registerVertexAttributes(VertexAttributes(CommonFormat::XYf_STf_RGBAub, 0)))
+	, usedVertices(0)
+	, usedIndices(0)
+	, hasCapturedCommand(false)
+{
+}
+
+ShapeBatch::~ShapeBatch()
+{
+}
+
+int ShapeBatch::add(const RecordFunction &recordfunc)
+{
+	record(recordfunc);
+
+	Entry e = {};
+	writeEntry(e);
+	entries.push_back(e);
+
+	return (int) entries.size() - 1;
+}
+
+void ShapeBatch::set(int index, const RecordFunction &recordfunc)
+{
+	if (index < 0 || index >= (int) entries.size())
+		throw love::Exception("Invalid shape entry index: %d", index + 1);
+
+	record(recordfunc);
+	writeEntry(entries[index]);
+
+	compact();
+}
+
+void ShapeBatch::remove(int index)
+{
+	if (index < 0 || index >= (int) entries.size())
+		throw love::Exception("Invalid shape entry index: %d", index + 1);
+
+	// Zeroed indices draw nothing, so the rest of the batch doesn't have to
+	// be touched until compact() reclaims the space.
+	const Entry &e = entries[index];
+
+	clearEntryIndices(e);
+	usedVertices -= e.vertexCount;
+	usedIndices -= e.indexCount;
+
+	entries.erase(entries.begin() + index);
+
+	compact();
+}
+
+int ShapeBatch::getEntryCount() const
+{
+	return (int) entries.size();
+}
+
+void ShapeBatch::clear()
+{
+	entries.clear();
+	vertices.clear();
+	indices.clear();
+	modifiedVertices.invalidate();
+	modifiedIndices.invalidate();
+	usedVertices = 0;
+	usedIndices = 0;
+}
+
+void ShapeBatch::setColor(const Colorf &color)
+{
+	this->color = color;
+}
+
+Colorf ShapeBatch::getColor() const
+{
+	return color;
+}
+
+void ShapeBatch::record(const RecordFunction &recordfunc)
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	// Anything already batched belongs to the screen, not to this batch.
+	gfx->flushBatchedDraws();
+
+	recordedVertices.clear();
+	recordedIndices.clear();
+	hasCapturedCommand = false;
+
+	gfx->push(Graphics::STACK_ALL);
+	gfx->origin();
+	gfx->setColor(color);
+	gfx->setShapeCapture(this);
+
+	try
+	{
+		recordfunc(gfx);
+		finishCapturedDraw();
+	}
+	catch (...)
+	{
+		hasCapturedCommand = false;
+		gfx->setShapeCapture(nullptr);
+		gfx->pop();
+		throw;
+	}
+
+	gfx->setShapeCapture(nullptr);
+	gfx->pop();
+}
+
+Graphics::BatchedVertexData ShapeBatch::captureBatchedDraw(const Graphics::BatchedDrawCommand &cmd)
+{
+	finishCapturedDraw();
+
+	if (cmd.primitiveMode != PRIMITIVE_TRIANGLES || cmd.formats[1] != CommonFormat::STf_RGBAub)
+		throw love::Exception("Only filled or outlined shapes can be recorded into a ShapeBatch.");
+
+	if (cmd.formats[0] != CommonFormat::XYf && cmd.formats[0] != CommonFormat::XYZf)
+		throw love::Exception("Unsupported vertex format for a ShapeBatch.");
+
+	capturedCommand = cmd;
+	hasCapturedCommand = true;
+
+	Graphics::BatchedVertexData d;
+
+	for (int i = 0; i < 2; i++)
+	{
+		capturedStreams[i].resize(getFormatStride(cmd.formats[i]) * cmd.vertexCount);
+		d.stream[i] = capturedStreams[i].data();
+	}
+
+	return d;
+}
+
+void ShapeBatch::finishCapturedDraw()
+{
+	if (!hasCapturedCommand)
+		return;
+
+	hasCapturedCommand = false;
+
+	const Graphics::BatchedDrawCommand &cmd = capturedCommand;
+
+	size_t vertexstart = recordedVertices.size();
+	recordedVertices.resize(vertexstart + cmd.vertexCount);
+
+	size_t posstride = getFormatStride(cmd.formats[0]);
+	const uint8 *positions = capturedStreams[0].data();
+	const STf_RGBAub *attributes = (const STf_RGBAub *) capturedStreams[1].data();
+
+	for (int i = 0; i < cmd.vertexCount; i++)
+	{
+		const float *pos = (const float *) (positions + i * posstride);
+
+		Vertex &v = recordedVertices[vertexstart + i];
+		v.x = pos[0];
+		v.y = pos[1];
+		v.s = attributes[i].s;
+		v.t = attributes[i].t;
+		v.color = attributes[i].color;
+	}
+
+	// Everything is drawn as one indexed triangle list, so fans, strips and
+	// quads are expanded here.
+	size_t indexstart = recordedIndices.size();
+
+	if (cmd.indexMode == TRIANGLEINDEX_NONE)
+	{
+		for (int i = 0; i < cmd.vertexCount; i++)
+			recordedIndices.push_back((uint32) (vertexstart + i));
+	}
+	else
+	{
+		int indexcount = getIndexCount(cmd.indexMode, cmd.vertexCount);
+		recordedIndices.resize(indexstart + indexcount);
+		fillIndices(cmd.indexMode, (uint32) vertexstart, (uint32) cmd.vertexCount, &recordedIndices[indexstart]);
+	}
+}
+
+void ShapeBatch::writeEntry(Entry &e)
+{
+	size_t vertexcount = recordedVertices.size();
+	size_t indexcount = recordedIndices.size();
+
+	// Geometry which doesn't fit in the entry's existing space moves to the
+	// end of the buffers.
+	if (vertexcount > e.vertexCapacity || indexcount > e.indexCapacity)
+	{
+		clearEntryIndices(e);
+
+		e.vertexStart = vertices.size();
+		e.vertexCapacity = vertexcount;
+		e.indexStart = indices.size();
+		e.indexCapacity = indexcount;
+
+		vertices.resize(vertices.size() + vertexcount);
+		indices.resize(indices.size() + indexcount);
+	}
+
+	usedVertices = usedVertices - e.vertexCount + vertexcount;
+	usedIndices = usedIndices - e.indexCount + indexcount;
+
+	e.vertexCount = vertexcount;
+	e.indexCount = indexcount;
+
+	if (vertexcount > 0)
+	{
+		std::copy(recordedVertices.begin(), recordedVertices.end(), vertices.begin() + e.vertexStart);
+		modifiedVertices.encapsulate(e.vertexStart * sizeof(Vertex), vertexcount * sizeof(Vertex));
+	}
+
+	if (e.indexCapacity > 0)
+	{
+		for (size_t i = 0; i < indexcount; i++)
+			indices[e.indexStart + i] = (uint32) (e.vertexStart + recordedIndices[i]);
+
+		// All indices are drawn at once, so the unused rest of the entry's
+		// space has to be degenerate triangles.
+		std::fill(indices.begin() + e.indexStart + indexcount, indices.begin() + e.indexStart + e.indexCapacity, 0);
+
+		modifiedIndices.encapsulate(e.indexStart * sizeof(uint32), e.indexCapacity * sizeof(uint32));
+	}
+}
+
+void ShapeBatch::clearEntryIndices(const Entry &e)
+{
+	if (e.indexCapacity == 0)
+		return;
+
+	std::fill(indices.begin() + e.indexStart, indices.begin() + e.indexStart + e.indexCapacity, 0);
+	modifiedIndices.encapsulate(e.indexStart * sizeof(uint32), e.indexCapacity * sizeof(uint32));
+}
+
+void ShapeBatch::compact()
+{
+	size_t unusedvertices = vertices.size() - usedVertices;
+	size_t unusedindices = indices.size() - usedIndices;
+
+	// Dead space must also make up at least half of the buffer.
+	bool compactvertices = unusedvertices >= MIN_COMPACT_ELEMENTS && unusedvertices >= usedVertices;
+	bool compactindices = unusedindices >= MIN_COMPACT_ELEMENTS && unusedindices >= usedIndices;
+
+	if (!compactvertices && !compactindices)
+		return;
+
+	std::vector<Vertex> newvertices;
+	std::vector<uint32> newindices;
+	newvertices.reserve(usedVertices);
+	newindices.reserve(usedIndices);
+
+	for (Entry &e : entries)
+	{
+		size_t vertexstart = newvertices.size();
+		size_t indexstart = newindices.size();
+
+		newvertices.insert(newvertices.end(), vertices.begin() + e.vertexStart, vertices.begin() + e.vertexStart + e.vertexCount);
+
+		for (size_t i = 0; i < e.indexCount; i++)
+			newindices.push_back((uint32) (indices[e.indexStart + i] - e.vertexStart + vertexstart));
+
+		e.vertexStart = vertexstart;
+		e.vertexCapacity = e.vertexCount;
+		e.indexStart = indexstart;
+		e.indexCapacity = e.indexCount;
+	}
+
+	vertices.swap(newvertices);
+	indices.swap(newindices);
+
+	modifiedVertices.invalidate();
+	modifiedIndices.invalidate();
+
+	if (!vertices.empty())
+		modifiedVertices.encapsulate(0, vertices.size() * sizeof(Vertex));
+	if (!indices.empty())
+		modifiedIndices.encapsulate(0, indices.size() * sizeof(uint32));
+}
+
+void ShapeBatch::updateBuffers(Graphics *gfx)
+{
+	size_t vertexsize = vertices.size() * sizeof(Vertex);
+	size_t indexsize = indices.size() * sizeof(uint32);
+
+	// Make new buffers bigger than necessary to reduce potential future
+	// allocations. The new buffers don't have any of the existing data yet.
+	if (vertexBuffer == nullptr || vertexsize > vertexBuffer->getSize())
+	{
+		size_t count = vertices.size() + vertices.size() / 2;
+		if (vertexBuffer != nullptr)
+			count = std::max(count, (vertexBuffer->getSize() / sizeof(Vertex)) * 3 / 2);
+
+		Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, usage);
+		auto decl = Buffer::getCommonFormatDeclaration(CommonFormat::XYf_STf_RGBAub);
+
+		vertexBuffer.set(gfx->newBuffer(settings, decl, nullptr, count * sizeof(Vertex), 0), Acquire::NORETAIN);
+		vertexBuffers.set(0, vertexBuffer, 0);
+
+		modifiedVertices = Range(0, vertexsize);
+	}
+
+	if (indexBuffer == nullptr || indexsize > indexBuffer->getSize())
+	{
+		size_t count = indices.size() + indices.size() / 2;
+		if (indexBuffer != nullptr)
+			count = std::max(count, (indexBuffer->getSize() / sizeof(uint32)) * 3 / 2);
+
+		Buffer::Settings settings(BUFFERUSAGEFLAG_INDEX, usage);
+		indexBuffer.set(gfx->newBuffer(settings, DATAFORMAT_UINT32, nullptr, count * sizeof(uint32), 0), Acquire::NORETAIN);
+
+		modifiedIndices = Range(0, indexsize);
+	}
+
+	if (modifiedVertices.isValid())
+	{
+		size_t offset = modifiedVertices.getOffset();
+		size_t size = modifiedVertices.getSize();
+
+		if (usage == BUFFERDATAUSAGE_STREAM)
+			vertexBuffer->fill(0, vertexsize, vertices.data());
+		else
+			vertexBuffer->fill(offset, size, (const uint8 *) vertices.data() + offset);
+
+		modifiedVertices.invalidate();
+	}
+
+	if (modifiedIndices.isValid())
+	{
+		size_t offset = modifiedIndices.getOffset();
+		size_t size = modifiedIndices.getSize();
+
+		if (usage == BUFFERDATAUSAGE_STREAM)
+			indexBuffer->fill(0, indexsize, indices.data());
+		else
+			indexBuffer->fill(offset, size, (const uint8 *) indices.data() + offset);
+
+		modifiedIndices.invalidate();
+	}
+}
+
+void ShapeBatch::draw(Graphics *gfx, const Matrix4 &m)
+{
+	gfx->flushBatchedDraws();
+
+	if (usedIndices == 0)
+		return;
+
+	updateBuffers(gfx);
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+	if (Shader::current)
+		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, nullptr);
+
+	Graphics::TempTransform transform(gfx, m);
+
+	Graphics::DrawIndexedCommand cmd(attributesID, &vertexBuffers, indexBuffer);
+
+	cmd.primitiveType = PRIMITIVE_TRIANGLES;
+	cmd.indexType = INDEX_UINT32;
+	cmd.indexCount = (int) indices.size();
+	cmd.texture = gfx->getTextureOrDefaultForActiveShader(nullptr);
+	cmd.cullMode = gfx->getMeshCullMode();
+
+	gfx->draw(cmd);
+}
+
+STRINGMAP_CLASS_BEGIN(ShapeBatch, ShapeBatch::ShapeType, ShapeBatch::SHAPE_MAX_ENUM, shapeType)
+{
+	{ "rectangle", ShapeBatch::SHAPE_RECTANGLE },
+	{ "circle",    ShapeBatch::SHAPE_CIRCLE    },
+	{ "ellipse",   ShapeBatch::SHAPE_ELLIPSE   },
+	{ "arc",       ShapeBatch::SHAPE_ARC       },
+	{ "polygon",   ShapeBatch::SHAPE_POLYGON   },
+	{ "line",      ShapeBatch::SHAPE_LINE      },
+}
+STRINGMAP_CLASS_END(ShapeBatch, ShapeBatch::ShapeType, ShapeBatch::SHAPE_MAX_ENUM, shapeType)
+
+} // graphics
+} // love
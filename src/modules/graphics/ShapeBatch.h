@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Color.h"
+#include "common/Range.h"
+#include "common/StringMap.h"
+#include "Drawable.h"
+#include "Buffer.h"
+#include "Graphics.h"
+#include "vertex.h"
+
+// C++
+#include <functional>
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Retained geometry for Graphics primitives. The vertices generated by
+ * rectangle, circle, polygon etc. are recorded once into GPU buffers, and the
+ * whole batch is drawn with a single draw call afterwards.
+ **/
+class ShapeBatch : public Drawable
+{
+public:
+
+	static love::Type type;
+
+	enum ShapeType
+	{
+		SHAPE_RECTANGLE,
+		SHAPE_CIRCLE,
+		SHAPE_ELLIPSE,
+		SHAPE_ARC,
+		SHAPE_POLYGON,
+		SHAPE_LINE,
+		SHAPE_MAX_ENUM
+	};
+
+	typedef std::function<void(Graphics *gfx)> RecordFunction;
+
+	ShapeBatch(Graphics *gfx, BufferDataUsage usage);
+	virtual ~ShapeBatch();
+
+	/**
+	 * Records the primitives drawn by the given function into a new entry,
+	 * and returns the entry's index. Shapes are recorded without the current
+	 * transform, and with the batch's color instead of the current one.
+	 **/
+	int add(const RecordFunction &record);
+
+	/**
+	 * Replaces the geometry of an existing entry. Geometry which still fits
+	 * in the entry's space is updated in place, otherwise the entry moves to
+	 * the end of the buffers.
+	 **/
+	void set(int index, const RecordFunction &record);
+
+	/**
+	 * Removes an entry. The indices of later entries shift down by one.
+	 **/
+	void remove(int index);
+
+	int getEntryCount() const;
+
+	void clear();
+
+	void setColor(const Colorf &color);
+	Colorf getColor() const;
+
+	/**
+	 * Called by Graphics::requestBatchedDraw while this batch is recording,
+	 * in place of writing to the stream buffers.
+	 **/
+	Graphics::BatchedVertexData captureBatchedDraw(const Graphics::BatchedDrawCommand &cmd);
+
+	// Implements Drawable.
+	void draw(Graphics *gfx, const Matrix4 &m) override;
+
+	STRINGMAP_CLASS_DECLARE(ShapeType);
+
+private:
+
+	struct Entry
+	{
+		size_t vertexStart;
+		size_t vertexCount;
+		size_t vertexCapacity;
+
+		size_t indexStart;
+		size_t indexCount;
+		size_t indexCapacity;
+	};
+
+	void record(const RecordFunction &record);
+	void finishCapturedDraw();
+	void writeEntry(Entry &e);
+	void clearEntryIndices(const Entry &e);
+	void compact();
+	void updateBuffers(Graphics *gfx);
+
+	BufferDataUsage usage;
+	Colorf color;
+
+	VertexAttributesID attributesID;
+	BufferBindings vertexBuffers;
+
+	StrongRef<Buffer> vertexBuffer;
+	StrongRef<Buffer> indexBuffer;
+
+	// CPU copies of the buffer contents. Entries index into these.
+	std::vector<Vertex> vertices;
+	std::vector<uint32> indices;
+
+	Range modifiedVertices;
+	Range modifiedIndices;
+
+	std::vector<Entry> entries;
+
+	// Vertices and indices still referenced by an entry. The rest is space
+	// left behind by removed, shrunk or moved entries.
+	size_t usedVertices;
+	size_t usedIndices;
+
+	// Geometry of the entry currently being recorded, as triangle lists with
+	// indices relative to the entry's first vertex.
+	std::vector<Vertex> recordedVertices;
+	std::vector<uint32> recordedIndices;
+
+	// The last captured command's data is converted once the caller has
+	// filled it in, i.e. when the next command comes in or recording ends.
+	Graphics::BatchedDrawCommand capturedCommand;
+	std::vector<uint8> capturedStreams[2];
+	bool hasCapturedCommand;
+
+}; // ShapeBatch
+
+} // graphics
+} // love
@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "SkylinePacker.h"
+
+// C++
+#include <algorithm>
+#include <limits>
+
+namespace love
+{
+namespace graphics
+{
+
+SkylinePacker::SkylinePacker()
+	: width(0)
+	, height(0)
+{
+}
+
+SkylinePacker::SkylinePacker(int width, int height)
+{
+	reset(width, height);
+}
+
+void SkylinePacker::reset(int width, int height)
+{
+	this->width = std::max(width, 0);
+	this->height = std::max(height, 0);
+
+	skyline.clear();
+	skyline.push_back({0, 0, this->width});
+}
+
+bool SkylinePacker::fits(size_t index, int w, int h, int &y) const
+{
+	int x = skyline[index].x;
+	if (x + w > width)
+		return false;
+
+	// The rectangle rests on the highest node it spans.
+	y = skyline[index].y;
+	int remaining = w;
+
+	while (remaining > 0 && index < skyline.size())
+	{
+		y = std::max(y, skyline[index].y);
+		if (y + h > height)
+			return false;
+
+		remaining -= skyline[index].width;
+		index++;
+	}
+
+	return remaining <= 0;
+}
+
+bool SkylinePacker::pack(int w, int h, int &x, int &y)
+{
+	if (w <= 0 || h <= 0)
+		return false;
+
+	size_t bestindex = skyline.size();
+	int besttop = std::numeric_limits<int>::max();
+	int bestwidth = std::numeric_limits<int>::max();
+	int besty = 0;
+
+	// Bottom-left: the lowest resulting top edge wins, then the narrowest
+	// node (which leaves wider gaps for wider rectangles).
+	for (size_t i = 0; i < skyline.size(); i++)
+	{
+		int nodey = 0;
+		if (!fits(i, w, h, nodey))
+			continue;
+
+		int top = nodey + h;
+		if (top < besttop || (top == besttop && skyline[i].width < bestwidth))
+		{
+			bestindex = i;
+			besttop = top;
+			bestwidth = skyline[i].width;
+			besty = nodey;
+		}
+	}
+
+	if (bestindex == skyline.size())
+		return false;
+
+	x = skyline[bestindex].x;
+	y = besty;
+
+	Node node = {x, y + h, w};
+	skyline.insert(skyline.begin() + bestindex, node);
+
+	// Trim the nodes which are now under the new one.
+	for (size_t i = bestindex + 1; i < skyline.size();)
+	{
+		const Node &prev = skyline[i - 1];
+		int prevend = prev.x + prev.width;
+
+		if (skyline[i].x >= prevend)
+			break;
+
+		int shrink = prevend - skyline[i].x;
+		skyline[i].x += shrink;
+		skyline[i].width -= shrink;
+
+		if (skyline[i].width > 0)
+			break;
+
+		skyline.erase(skyline.begin() + i);
+	}
+
+	// Merge neighbouring nodes at the same height.
+	for (size_t i = 0; i + 1 < skyline.size();)
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+			i++;
+	}
+
+	return true;
+}
+
+void SkylinePacker::raise(int y)
+{
+	y = std::min(std::max(y, getTop()), height);
+
+	skyline.clear();
+	skyline.push_back({0, y, width});
+}
+
+int SkylinePacker::getTop() const
+{
+	int top = 0;
+	for (const Node &node : skyline)
+		top = std::max(top, node.y);
+	return top;
+}
+
+} // graphics
+} // love
@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// C++
+#include <vector>
+#include <stddef.h>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Packs rectangles into a fixed area, bottom-left first. The packer tracks
+ * the top edge (the skyline) of everything packed so far, which wastes much
+ * less space than packing in rows when rectangle heights vary.
+ **/
+class SkylinePacker
+{
+public:
+
+	SkylinePacker();
+	SkylinePacker(int width, int height);
+
+	/**
+	 * Removes all packed rectangles and sets the size of the packing area.
+	 **/
+	void reset(int width, int height);
+
+	/**
+	 * Finds space for a rectangle of the given size. Returns false if there
+	 * is none left.
+	 **/
+	bool pack(int width, int height, int &x, int &y);
+
+	/**
+	 * Raises the skyline to at least the given height, so nothing is packed
+	 * above it.
+	 **/
+	void raise(int y);
+
+	/**
+	 * Gets the height of the highest point of the skyline.
+	 **/
+	int getTop() const;
+
+	int getWidth() const { return width; }
+	int getHeight() const { return height; }
+
+private:
+
+	struct Node
+	{
+		int x;
+		int y;
+		int width;
+	};
+
+	bool fits(size_t index, int width, int height, int &y) const;
+
+	std::vector<Node> skyline;
+
+	int width;
+	int height;
+
+}; // SkylinePacker
+
+} // graphics
+} // love
@@ -26,6 +26,9 @@ namespace love
 namespace graphics
 {
 
+int StreamBuffer::waitCount = 0;
+double StreamBuffer::waitTime = 0.0;
+
 StreamBuffer::StreamBuffer(BufferUsage mode, size_t size)
 	: bufferSize(size)
 	, frameGPUReadOffset(0)
@@ -33,5 +36,11 @@ StreamBuffer::StreamBuffer(BufferUsage mode, size_t size)
 {
 }
 
+void StreamBuffer::recordWait(double seconds)
+{
+	waitCount++;
+	waitTime += seconds;
+}
+
 } // graphics
 } // love
@@ -65,6 +65,21 @@ class StreamBuffer : public love::Object, public Resource
 
 	virtual void nextFrame() {}
 
+	/**
+	 * Number of frames of data the buffer cycles through before reusing
+	 * memory, or 0 if it doesn't wait for the GPU itself.
+	 **/
+	virtual int getFrameCount() const { return 0; }
+
+	/**
+	 * Records a CPU wait for the GPU to finish with previously written data.
+	 **/
+	static void recordWait(double seconds);
+
+	// Waits across all stream buffers since the counters were last reset.
+	static int waitCount;
+	static double waitTime;
+
 protected:
 
 	StreamBuffer(BufferUsage mode, size_t size);
@@ -30,13 +30,21 @@ namespace graphics
 
 love::Type TextBatch::type("TextBatch", &Drawable::type);
 
+// Vertex space left behind by removed or moved entries is only compacted once
+// at least this much of it has built up.
+static const size_t MIN_COMPACT_VERTICES = 4 * 1024;
+
 TextBatch::TextBatch(Font *font, const std::vector<love::font::ColoredString> &text)
 	: font(font)
 	, vertexAttributesID(font->getVertexAttributesID())
 	, vertexData(nullptr)
 	, modifiedVertices()
 	, vertOffset(0)
+	, usedVertices(0)
+	, drawCommandsDirty(false)
 	, textureCacheID(font->getTextureCacheID())
+	, evictionID(font->getEvictionID())
+	, glyphUseFrame(0)
 {
 	set(text);
 }
@@ -82,6 +90,10 @@ void TextBatch::uploadVertices(const std::vector<Font::GlyphVertex> &vertices, s
 		vertexBuffer = newbuffer;
 
 		vertexBuffers.set(0, vertexBuffer, 0);
+
+		// The new buffer doesn't have any of the existing vertices yet.
+		if (offset > 0)
+			modifiedVertices.encapsulate(0, offset);
 	}
 
 	if (vertexData != nullptr && datasize > 0)
@@ -94,85 +106,195 @@ void TextBatch::uploadVertices(const std::vector<Font::GlyphVertex> &vertices, s
 void TextBatch::regenerateVertices()
 {
 	// If the font's texture cache was invalidated then we need to recreate the
-	// text's vertices, since glyph texcoords might have changed.
-	if (font->getTextureCacheID() != textureCacheID)
+	// text's vertices, since glyph texcoords might have changed. Each entry is
+	// regenerated in its existing space, so only entries whose vertex count
+	// grew are moved. Generating vertices can invalidate the cache again.
+	while (font->getTextureCacheID() != textureCacheID)
 	{
-		std::vector<TextData> textdata = textData;
+		textureCacheID = font->getTextureCacheID();
+		evictionID = font->getEvictionID();
 
-		clear();
+		for (TextData &t : textData)
+			updateTextData(t);
+
+		drawCommandsDirty = true;
+	}
+}
 
-		for (const TextData &t : textdata)
-			addTextData(t);
+void TextBatch::regenerateEvictedVertices()
+{
+	// Only entries which used an evicted glyph point at stale texture space.
+	// Adding their glyphs back can evict others in turn, but not glyphs this
+	// batch has already marked as used in the current frame.
+	while (font->getEvictionID() != evictionID)
+	{
+		uint32 sinceid = evictionID;
+		evictionID = font->getEvictionID();
 
-		textureCacheID = font->getTextureCacheID();
+		for (TextData &t : textData)
+		{
+			if (font->wereGlyphsEvicted(t.glyphs, sinceid))
+			{
+				updateTextData(t);
+				drawCommandsDirty = true;
+			}
+		}
 	}
 }
 
-void TextBatch::addTextData(const TextData &t)
+void TextBatch::updateTextData(TextData &t)
 {
 	std::vector<Font::GlyphVertex> vertices;
-	std::vector<Font::DrawCommand> newcommands;
-
-	love::font::TextShaper::TextInfo textinfo;
 
 	Colorf constantcolor = Colorf(1.0f, 1.0f, 1.0f, 1.0f);
 
 	// We only have formatted text if the align mode is valid.
-	if (t.align == Font::ALIGN_MAX_ENUM)
-		newcommands = font->generateVertices(t.codepoints, Range(), constantcolor, vertices, 0.0f, Vector2(0.0f, 0.0f), &textinfo);
+	t.glyphs.clear();
+
+	if (t.layout.get() != nullptr)
+		t.drawCommands = font->generateVertices(t.layout, constantcolor, vertices, &t.textInfo, &t.glyphs);
+	else if (t.align == Font::ALIGN_MAX_ENUM)
+		t.drawCommands = font->generateVertices(t.codepoints, Range(), constantcolor, vertices, 0.0f, Vector2(0.0f, 0.0f), &t.textInfo, &t.glyphs);
 	else
-		newcommands = font->generateVerticesFormatted(t.codepoints, constantcolor, t.wrap, t.align, vertices, &textinfo);
+		t.drawCommands = font->generateVerticesFormatted(t.codepoints, constantcolor, t.wrap, t.align, vertices, &t.textInfo, &t.glyphs);
 
-	size_t voffset = vertOffset;
+	std::sort(t.glyphs.begin(), t.glyphs.end());
+	t.glyphs.erase(std::unique(t.glyphs.begin(), t.glyphs.end()), t.glyphs.end());
 
-	if (!t.appendVertices)
+	if (t.useMatrix && !vertices.empty())
+		t.matrix.transformXY(vertices.data(), vertices.data(), (int) vertices.size());
+
+	if (vertices.size() > t.vertexCapacity)
 	{
-		voffset = 0;
-		vertOffset = 0;
-		drawCommands.clear();
-		textData.clear();
+		t.vertexStart = vertOffset;
+		t.vertexCapacity = vertices.size();
+		vertOffset += vertices.size();
 	}
 
-	if (t.useMatrix && !vertices.empty())
-		t.matrix.transformXY(vertices.data(), vertices.data(), (int) vertices.size());
+	usedVertices = usedVertices - t.vertexCount + vertices.size();
+	t.vertexCount = vertices.size();
 
-	uploadVertices(vertices, voffset);
+	uploadVertices(vertices, t.vertexStart);
+}
 
-	if (!newcommands.empty())
-	{
-		// The start vertex should be adjusted to account for the vertex offset.
-		for (Font::DrawCommand &cmd : newcommands)
-			cmd.startvertex += (int) voffset;
+void TextBatch::appendDrawCommands(const TextData &t)
+{
+	auto firstcmd = t.drawCommands.begin();
 
-		auto firstcmd = newcommands.begin();
+	if (firstcmd == t.drawCommands.end())
+		return;
 
-		// If the first draw command in the new list has the same texture as the
-		// last one in the existing list we're building and its vertices are
-		// in-order, we can combine them (saving a draw call.)
-		if (!drawCommands.empty())
+	// If the first draw command in the new list has the same texture as the
+	// last one in the existing list we're building and its vertices are
+	// in-order, we can combine them (saving a draw call.)
+	if (!drawCommands.empty())
+	{
+		const Font::DrawCommand &prevcmd = drawCommands.back();
+		if (prevcmd.texture == firstcmd->texture && (size_t) (prevcmd.startvertex + prevcmd.vertexcount) == firstcmd->startvertex + t.vertexStart)
 		{
-			auto prevcmd = drawCommands.back();
-			if (prevcmd.texture == firstcmd->texture && (prevcmd.startvertex + prevcmd.vertexcount) == firstcmd->startvertex)
-			{
-				drawCommands.back().vertexcount += firstcmd->vertexcount;
-				++firstcmd;
-			}
+			drawCommands.back().vertexcount += firstcmd->vertexcount;
+			++firstcmd;
 		}
+	}
 
-		// Append the new draw commands to the list we're building.
-		drawCommands.insert(drawCommands.end(), firstcmd, newcommands.end());
+	// Append the new draw commands to the list we're building. The start
+	// vertex is adjusted to account for the entry's vertex offset.
+	for (auto it = firstcmd; it != t.drawCommands.end(); ++it)
+	{
+		Font::DrawCommand cmd = *it;
+		cmd.startvertex += (int) t.vertexStart;
+		drawCommands.push_back(cmd);
 	}
+}
 
-	vertOffset = voffset + vertices.size();
+void TextBatch::rebuildDrawCommands()
+{
+	drawCommands.clear();
+
+	for (const TextData &t : textData)
+		appendDrawCommands(t);
+
+	drawCommandsDirty = false;
+}
+
+void TextBatch::compactVertices()
+{
+	size_t unused = vertOffset - usedVertices;
+
+	// Only worth it once a good portion of the vertex data is unreferenced.
+	if (vertexData == nullptr || unused < MIN_COMPACT_VERTICES || unused < usedVertices)
+		return;
+
+	uint8 *newdata = (uint8 *) malloc(vertexBuffer->getSize());
+	if (newdata == nullptr)
+		throw love::Exception("Out of memory.");
+
+	// Entries are packed in index order, so draw commands of neighbouring
+	// entries can be merged again.
+	size_t offset = 0;
+	for (TextData &t : textData)
+	{
+		size_t vertsize = sizeof(Font::GlyphVertex);
+		memcpy(newdata + offset * vertsize, vertexData + t.vertexStart * vertsize, t.vertexCount * vertsize);
+
+		t.vertexStart = offset;
+		t.vertexCapacity = t.vertexCount;
+		offset += t.vertexCount;
+	}
+
+	free(vertexData);
+	vertexData = newdata;
+
+	vertOffset = offset;
+	modifiedVertices.encapsulate(0, offset * sizeof(Font::GlyphVertex));
+	drawCommandsDirty = true;
+}
+
+void TextBatch::addTextData(const TextData &t)
+{
+	if (!t.appendVertices)
+		clear();
 
 	textData.push_back(t);
-	textData.back().textInfo = textinfo;
+
+	TextData &newdata = textData.back();
+	newdata.vertexStart = vertOffset;
+	newdata.vertexCount = 0;
+	newdata.vertexCapacity = 0;
+
+	updateTextData(newdata);
+
+	if (!drawCommandsDirty)
+		appendDrawCommands(newdata);
 
 	// Font::generateVertices can invalidate the font's texture cache.
 	if (font->getTextureCacheID() != textureCacheID)
 		regenerateVertices();
 }
 
+void TextBatch::setTextData(int index, const TextData &t)
+{
+	if (index < 0 || index >= (int) textData.size())
+		throw love::Exception("Invalid text entry index: %d", index + 1);
+
+	TextData &olddata = textData[index];
+
+	TextData newdata = t;
+	newdata.vertexStart = olddata.vertexStart;
+	newdata.vertexCount = olddata.vertexCount;
+	newdata.vertexCapacity = olddata.vertexCapacity;
+
+	olddata = newdata;
+
+	updateTextData(olddata);
+	drawCommandsDirty = true;
+
+	if (font->getTextureCacheID() != textureCacheID)
+		regenerateVertices();
+
+	compactVertices();
+}
+
 void TextBatch::set(const std::vector<love::font::ColoredString> &text)
 {
 	return set(text, -1.0f, Font::ALIGN_MAX_ENUM);
@@ -204,12 +326,59 @@ int TextBatch::addf(const std::vector<love::font::ColoredString> &text, float wr
 	return (int) textData.size() - 1;
 }
 
+int TextBatch::addLayout(TextLayout *layout, const Matrix4 &m)
+{
+	addTextData({{}, layout->getWrap(), layout->getAlign(), {}, true, true, m, 0, 0, 0, {}, layout});
+
+	return (int) textData.size() - 1;
+}
+
+void TextBatch::setEntry(int index, const std::vector<love::font::ColoredString> &text, const Matrix4 &m)
+{
+	setEntryf(index, text, -1.0f, Font::ALIGN_MAX_ENUM, m);
+}
+
+void TextBatch::setEntryf(int index, const std::vector<love::font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m)
+{
+	love::font::ColoredCodepoints codepoints;
+	love::font::getCodepointsFromString(text, codepoints);
+
+	setTextData(index, {codepoints, wrap, align, {}, true, true, m});
+}
+
+void TextBatch::setEntryLayout(int index, TextLayout *layout, const Matrix4 &m)
+{
+	setTextData(index, {{}, layout->getWrap(), layout->getAlign(), {}, true, true, m, 0, 0, 0, {}, layout});
+}
+
+void TextBatch::remove(int index)
+{
+	if (index < 0 || index >= (int) textData.size())
+		throw love::Exception("Invalid text entry index: %d", index + 1);
+
+	// The entry's vertices are left where they are, they just stop being
+	// drawn. The space is reclaimed once enough of it has built up.
+	usedVertices -= textData[index].vertexCount;
+	textData.erase(textData.begin() + index);
+	drawCommandsDirty = true;
+
+	compactVertices();
+}
+
+int TextBatch::getEntryCount() const
+{
+	return (int) textData.size();
+}
+
 void TextBatch::clear()
 {
 	textData.clear();
 	drawCommands.clear();
+	drawCommandsDirty = false;
 	textureCacheID = font->getTextureCacheID();
+	evictionID = font->getEvictionID();
 	vertOffset = 0;
+	usedVertices = 0;
 }
 
 void TextBatch::setFont(Font *f)
@@ -252,17 +421,38 @@ int TextBatch::getHeight(int index) const
 
 void TextBatch::draw(Graphics *gfx, const Matrix4 &m)
 {
-	if (vertexBuffer == nullptr || vertexData == nullptr || drawCommands.empty())
-		return;
-
 	gfx->flushBatchedDraws();
 
+	// Glyphs which finished loading in the background invalidate the cache
+	// if this text was generated without them.
+	font->integrateLoadedGlyphs();
+
+	// Text drawn every frame keeps its glyphs in the atlas, rather than
+	// looking unused to the font's eviction.
+	if (gfx->getFrameCount() != glyphUseFrame)
+	{
+		glyphUseFrame = gfx->getFrameCount();
+		for (const TextData &t : textData)
+			font->touchGlyphs(t.glyphs);
+	}
+
+	regenerateEvictedVertices();
+
 	// Re-generate the text if the Font's texture cache was invalidated.
 	if (font->getTextureCacheID() != textureCacheID)
 		regenerateVertices();
 
+	if (drawCommandsDirty)
+		rebuildDrawCommands();
+
+	if (vertexBuffer == nullptr || vertexData == nullptr || drawCommands.empty())
+		return;
+
 	if (Shader::isDefaultActive())
-		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+		Shader::attachDefault(font->isSDF() ? Shader::STANDARD_SDF : Shader::STANDARD_DEFAULT);
+
+	if (font->isSDF())
+		font->applySDFEffects();
 
 	Texture *firsttex = nullptr;
 	if (!drawCommands.empty())
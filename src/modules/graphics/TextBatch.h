@@ -25,6 +25,7 @@
 #include "common/Range.h"
 #include "Drawable.h"
 #include "Font.h"
+#include "TextLayout.h"
 #include "Buffer.h"
 
 namespace love
@@ -49,6 +50,26 @@ class TextBatch : public Drawable
 	int add(const std::vector<love::font::ColoredString> &text, const Matrix4 &m);
 	int addf(const std::vector<love::font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m);
 
+	/**
+	 * Adds text which has already been wrapped and shaped.
+	 **/
+	int addLayout(TextLayout *layout, const Matrix4 &m);
+
+	/**
+	 * Replaces the text of an existing entry. Only that entry's vertices are
+	 * regenerated and uploaded, the rest of the batch is left untouched.
+	 **/
+	void setEntry(int index, const std::vector<love::font::ColoredString> &text, const Matrix4 &m);
+	void setEntryf(int index, const std::vector<love::font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m);
+	void setEntryLayout(int index, TextLayout *layout, const Matrix4 &m);
+
+	/**
+	 * Removes an entry. The indices of later entries shift down by one.
+	 **/
+	void remove(int index);
+
+	int getEntryCount() const;
+
 	void clear();
 
 	void setFont(Font *f);
@@ -78,11 +99,33 @@ class TextBatch : public Drawable
 		bool useMatrix;
 		bool appendVertices;
 		Matrix4 matrix;
+
+		// The entry's space in the vertex buffer. Text which still fits is
+		// updated in place, otherwise the entry moves to the end.
+		size_t vertexStart;
+		size_t vertexCount;
+		size_t vertexCapacity;
+
+		// Relative to vertexStart.
+		std::vector<Font::DrawCommand> drawCommands;
+
+		// Glyph positions are taken from the layout instead of shaping the
+		// codepoints, when it's set.
+		StrongRef<TextLayout> layout;
+
+		// Sorted packed indices of the glyphs the entry's vertices use.
+		std::vector<uint64> glyphs;
 	};
 
 	void uploadVertices(const std::vector<Font::GlyphVertex> &vertices, size_t vertoffset);
 	void regenerateVertices();
+	void regenerateEvictedVertices();
 	void addTextData(const TextData &s);
+	void updateTextData(TextData &t);
+	void setTextData(int index, const TextData &t);
+	void appendDrawCommands(const TextData &t);
+	void rebuildDrawCommands();
+	void compactVertices();
 
 	StrongRef<Font> font;
 
@@ -98,9 +141,21 @@ class TextBatch : public Drawable
 	std::vector<TextData> textData;
 
 	size_t vertOffset;
+
+	// Vertices still referenced by an entry. The rest of [0, vertOffset) is
+	// space left behind by removed, shrunk or moved entries.
+	size_t usedVertices;
+
+	bool drawCommandsDirty;
 	
 	// Used so we know when the font's texture cache is invalidated.
 	uint32 textureCacheID;
+
+	// Used so we know when glyphs were evicted from the font's atlas.
+	uint32 evictionID;
+
+	// Frame the glyphs were last marked as used in the font.
+	uint64 glyphUseFrame;
 	
 }; // Text
 
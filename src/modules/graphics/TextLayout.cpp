@@ -0,0 +1,243 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "TextLayout.h"
+
+// C++
+#include <algorithm>
+#include <limits>
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type TextLayout::type("TextLayout", &Object::type);
+
+TextLayout::TextLayout(Font *font, const love::font::ColoredCodepoints &text, float wrap, Font::AlignMode align)
+	: font(font)
+	, text(text)
+	, wrap(wrap)
+	, align(align)
+	, shapingID(0)
+	, info()
+{
+}
+
+TextLayout::~TextLayout()
+{
+}
+
+void TextLayout::layout(love::font::TextShaper *shaper, uint32 shapingID)
+{
+	lines.clear();
+	glyphPositions.clear();
+	glyphColors.clear();
+
+	compute(shaper, text, wrap, align, glyphPositions, glyphColors, &lines, &info);
+
+	this->shapingID = shapingID;
+}
+
+void TextLayout::compute(love::font::TextShaper *shaper, const love::font::ColoredCodepoints &text, float wrap, Font::AlignMode align,
+                         std::vector<love::font::TextShaper::GlyphPosition> &positions, std::vector<love::font::IndexedColor> &colors,
+                         std::vector<Line> *lines, love::font::TextShaper::TextInfo *info)
+{
+	wrap = std::max(wrap, 0.0f);
+
+	std::vector<Range> ranges;
+	std::vector<float> widths;
+	shaper->getWrap(text, wrap, ranges, &widths);
+
+	positions.reserve(positions.size() + text.cps.size());
+
+	std::vector<love::font::TextShaper::GlyphPosition> linepositions;
+	std::vector<love::font::IndexedColor> linecolors;
+
+	float y = 0.0f;
+	float maxwidth = 0.0f;
+
+	for (int i = 0; i < (int)ranges.size(); i++)
+	{
+		const auto &range = ranges[i];
+		float lineheight = shaper->getCombinedHeight();
+
+		if (!range.isValid())
+		{
+			if (lines != nullptr)
+				lines->push_back({0.0f, floorf(y), 0.0f, lineheight, (int) positions.size(), 0});
+
+			y += lineheight;
+			continue;
+		}
+
+		float width = widths[i];
+		love::Vector2 offset(0.0f, floorf(y));
+		float extraspacing = 0.0f;
+
+		maxwidth = std::max(width, maxwidth);
+
+		switch (align)
+		{
+			case Font::ALIGN_RIGHT:
+				offset.x = floorf(wrap - width);
+				break;
+			case Font::ALIGN_CENTER:
+				offset.x = floorf((wrap - width) / 2.0f);
+				break;
+			case Font::ALIGN_JUSTIFY:
+			{
+				auto start = text.cps.begin() + range.getOffset();
+				auto end = start + range.getSize();
+				float numspaces = std::count(start, end, ' ');
+
+				if (text.cps[range.last] == ' ')
+					--numspaces;
+
+				if (width < wrap && numspaces >= 1)
+				{
+					extraspacing = (wrap - width) / numspaces;
+					width = wrap;
+				}
+				else
+					extraspacing = 0.0f;
+				break;
+			}
+			case Font::ALIGN_LEFT:
+			default:
+				break;
+		}
+
+		linepositions.clear();
+		linecolors.clear();
+		shaper->getGlyphPositions(text, range, offset, extraspacing, &linepositions, &linecolors, nullptr);
+
+		int firstglyph = (int) positions.size();
+
+		for (love::font::IndexedColor c : linecolors)
+		{
+			c.index += firstglyph;
+
+			// A color change at the very end of the previous line applies to
+			// the same glyph as this line's starting color.
+			if (!colors.empty() && colors.back().index >= c.index)
+				colors.back() = c;
+			else
+				colors.push_back(c);
+		}
+
+		positions.insert(positions.end(), linepositions.begin(), linepositions.end());
+
+		if (lines != nullptr)
+			lines->push_back({offset.x, offset.y, width, lineheight, firstglyph, (int) linepositions.size()});
+
+		y += lineheight;
+	}
+
+	if (info != nullptr)
+	{
+		info->width = (int) maxwidth;
+		info->height = (int) y;
+	}
+}
+
+Font *TextLayout::getFont() const
+{
+	return font.get();
+}
+
+const love::font::ColoredCodepoints &TextLayout::getText() const
+{
+	return text;
+}
+
+float TextLayout::getWrap() const
+{
+	return wrap;
+}
+
+Font::AlignMode TextLayout::getAlign() const
+{
+	return align;
+}
+
+uint32 TextLayout::getShapingID() const
+{
+	return shapingID;
+}
+
+float TextLayout::getWidth() const
+{
+	return info.width;
+}
+
+float TextLayout::getHeight() const
+{
+	return info.height;
+}
+
+void TextLayout::getBounds(float &x, float &y, float &w, float &h) const
+{
+	if (lines.empty())
+	{
+		x = y = w = h = 0.0f;
+		return;
+	}
+
+	float minx = std::numeric_limits<float>::max();
+	float maxx = std::numeric_limits<float>::lowest();
+
+	for (const Line &line : lines)
+	{
+		// Empty lines only contribute to the height.
+		if (line.glyphCount == 0)
+			continue;
+
+		minx = std::min(minx, line.x);
+		maxx = std::max(maxx, line.x + line.width);
+	}
+
+	if (minx > maxx)
+		minx = maxx = 0.0f;
+
+	x = minx;
+	y = lines.front().y;
+	w = maxx - minx;
+	h = lines.back().y + lines.back().height - y;
+}
+
+const std::vector<TextLayout::Line> &TextLayout::getLines() const
+{
+	return lines;
+}
+
+const std::vector<love::font::TextShaper::GlyphPosition> &TextLayout::getGlyphPositions() const
+{
+	return glyphPositions;
+}
+
+const std::vector<love::font::IndexedColor> &TextLayout::getGlyphColors() const
+{
+	return glyphColors;
+}
+
+} // graphics
+} // love
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_GRAPHICS_TEXT_LAYOUT_H
+#define LOVE_GRAPHICS_TEXT_LAYOUT_H
+
+// LOVE
+#include "common/Object.h"
+#include "font/TextShaper.h"
+#include "Font.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+namespace graphics
+{
+
+/**
+ * Wrapped and shaped text. Layouts are made by Font::newTextLayouts, and can
+ * be added to a TextBatch without shaping the text again.
+ **/
+class TextLayout : public Object
+{
+public:
+
+	static love::Type type;
+
+	struct Line
+	{
+		// Bounds of the line, relative to the layout's origin.
+		float x, y;
+		float width, height;
+
+		// The line's glyphs in the layout's glyph positions.
+		int firstGlyph;
+		int glyphCount;
+	};
+
+	TextLayout(Font *font, const love::font::ColoredCodepoints &text, float wrap, Font::AlignMode align);
+	virtual ~TextLayout();
+
+	/**
+	 * Wraps and shapes the text using the given shaper. Can be called from
+	 * any thread, as long as no other thread is using the shaper.
+	 **/
+	void layout(love::font::TextShaper *shaper, uint32 shapingID);
+
+	/**
+	 * Computes glyph positions for the text the same way Font::printf does.
+	 * Color indices refer to the glyph positions.
+	 **/
+	static void compute(love::font::TextShaper *shaper, const love::font::ColoredCodepoints &text, float wrap, Font::AlignMode align,
+	                    std::vector<love::font::TextShaper::GlyphPosition> &positions, std::vector<love::font::IndexedColor> &colors,
+	                    std::vector<Line> *lines, love::font::TextShaper::TextInfo *info);
+
+	Font *getFont() const;
+	const love::font::ColoredCodepoints &getText() const;
+	float getWrap() const;
+	Font::AlignMode getAlign() const;
+
+	/**
+	 * The Font's shaping ID when the layout was computed. Layouts made with
+	 * a different line height or different fallbacks are out of date.
+	 **/
+	uint32 getShapingID() const;
+
+	float getWidth() const;
+	float getHeight() const;
+
+	/**
+	 * Gets the smallest rectangle containing every line.
+	 **/
+	void getBounds(float &x, float &y, float &w, float &h) const;
+
+	const std::vector<Line> &getLines() const;
+	const std::vector<love::font::TextShaper::GlyphPosition> &getGlyphPositions() const;
+	const std::vector<love::font::IndexedColor> &getGlyphColors() const;
+
+private:
+
+	StrongRef<Font> font;
+
+	love::font::ColoredCodepoints text;
+	float wrap;
+	Font::AlignMode align;
+
+	uint32 shapingID;
+
+	love::font::TextShaper::TextInfo info;
+
+	std::vector<Line> lines;
+	std::vector<love::font::TextShaper::GlyphPosition> glyphPositions;
+	std::vector<love::font::IndexedColor> glyphColors;
+
+}; // TextLayout
+
+} // graphics
+} // love
+
+#endif // LOVE_GRAPHICS_TEXT_LAYOUT_H
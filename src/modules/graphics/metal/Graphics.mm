@@ -28,6 +28,7 @@
 #include "window/Window.h"
 #include "image/Image.h"
 #include "common/memory.h"
+#include "common/trace.h"
 
 #import <QuartzCore/CAMetalLayer.h>
 
@@ -1657,6 +1658,8 @@ void Graphics::present(void *screenshotCallbackData)
 	if (!isActive())
 		return;
 
+	LOVE_TRACE_ZONE("Graphics::present");
+
 	if (isRenderTargetActive())
 		throw love::Exception("present cannot be called while a render target is active.");
 
@@ -1765,6 +1768,8 @@ void Graphics::present(void *screenshotCallbackData)
 	// This is set to NO when there are pending screen captures.
 	metalLayer.framebufferOnly = YES;
 
+	updateStreamBufferPacing();
+
 	// Reset the per-frame stat counts.
 	drawCalls = 0;
 	shaderSwitches = 0;
@@ -2265,8 +2270,10 @@ void Graphics::initCapabilities()
 		capabilities.features[FEATURE_INDIRECT_DRAW] = true;
 	else
 		capabilities.features[FEATURE_INDIRECT_DRAW] = false;
+
+	capabilities.features[FEATURE_GPU_TIMESTAMPS] = false;
 	
-	static_assert(FEATURE_MAX_ENUM == 13, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
+	static_assert(FEATURE_MAX_ENUM == 14, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
 
 	// https://developer.apple.com/metal/Metal-Feature-Set-Tables.pdf
 	capabilities.limits[LIMIT_POINT_SIZE] = 511;
@@ -22,6 +22,7 @@
 #include "Metal.h"
 #include "Graphics.h"
 #include "common/int.h"
+#include "timer/Timer.h"
 
 #include <dispatch/semaphore.h>
 
@@ -77,7 +78,12 @@ public:
 		// Make sure this frame's section of the buffer is done being used.
 		if (!mappedFrames[frameIndex])
 		{
-			dispatch_semaphore_wait(frameSemaphores[frameIndex], DISPATCH_TIME_FOREVER);
+			if (dispatch_semaphore_wait(frameSemaphores[frameIndex], DISPATCH_TIME_NOW) != 0)
+			{
+				double start = love::timer::Timer::getTime();
+				dispatch_semaphore_wait(frameSemaphores[frameIndex], DISPATCH_TIME_FOREVER);
+				recordWait(love::timer::Timer::getTime() - start);
+			}
 			mappedFrames[frameIndex] = true;
 		}
 
@@ -116,6 +122,11 @@ public:
 		frameGPUReadOffset = 0;
 	}
 
+	int getFrameCount() const override
+	{
+		return BUFFER_FRAMES;
+	}
+
 	void markUsed(size_t usedsize) override
 	{
 		// We insert a fence for all data from this frame at the end of the
@@ -22,6 +22,7 @@
 #include "common/config.h"
 #include "common/math.h"
 #include "common/Vector.h"
+#include "common/trace.h"
 
 #include "Graphics.h"
 #include "font/Font.h"
@@ -150,7 +151,7 @@ Graphics::~Graphics()
 
 love::graphics::StreamBuffer *Graphics::newStreamBuffer(BufferUsage type, size_t size)
 {
-	return CreateStreamBuffer(type, size);
+	return CreateStreamBuffer(type, size, streamBufferFrames);
 }
 
 love::graphics::Texture *Graphics::newTexture(const Texture::Settings &settings, const Texture::Slices *data)
@@ -356,9 +357,9 @@ bool Graphics::setMode(void */*context*/, int width, int height, int pixelwidth,
 	{
 		// Initial sizes that should be good enough for most cases. It will
 		// resize to fit if needed, later.
-		batchedDrawState.vb[0] = CreateStreamBuffer(BUFFERUSAGE_VERTEX, 1024 * 1024 * 1);
-		batchedDrawState.vb[1] = CreateStreamBuffer(BUFFERUSAGE_VERTEX, 256  * 1024 * 1);
-		batchedDrawState.indexBuffer = CreateStreamBuffer(BUFFERUSAGE_INDEX, sizeof(uint16) * LOVE_UINT16_MAX);
+		batchedDrawState.vb[0] = CreateStreamBuffer(BUFFERUSAGE_VERTEX, 1024 * 1024 * 1, streamBufferFrames);
+		batchedDrawState.vb[1] = CreateStreamBuffer(BUFFERUSAGE_VERTEX, 256  * 1024 * 1, streamBufferFrames);
+		batchedDrawState.indexBuffer = CreateStreamBuffer(BUFFERUSAGE_INDEX, sizeof(uint16) * LOVE_UINT16_MAX, streamBufferFrames);
 	}
 
 	// Reload all volatile objects.
@@ -427,6 +428,17 @@ void Graphics::unSetMode()
 
 	clearTemporaryResources();
 
+	clearGPUTiming();
+
+	if (!freeTimestampQueries.empty())
+	{
+		if (GLAD_ES_VERSION_2_0)
+			glDeleteQueriesEXT((GLsizei) freeTimestampQueries.size(), freeTimestampQueries.data());
+		else
+			glDeleteQueries((GLsizei) freeTimestampQueries.size(), freeTimestampQueries.data());
+		freeTimestampQueries.clear();
+	}
+
 	for (const auto &pair : framebufferObjects)
 		gl.deleteFramebuffer(pair.second);
 
@@ -1184,6 +1196,8 @@ void Graphics::present(void *screenshotCallbackData)
 	if (!isActive())
 		return;
 
+	LOVE_TRACE_ZONE("Graphics::present");
+
 	if (isRenderTargetActive())
 		throw love::Exception("present cannot be called while a render target is active.");
 
@@ -1191,6 +1205,8 @@ void Graphics::present(void *screenshotCallbackData)
 
 	flushBatchedDraws();
 
+	endGPUTimingFrame();
+
 	endPass(true);
 
 	int w = getPixelWidth();
@@ -1304,6 +1320,8 @@ void Graphics::present(void *screenshotCallbackData)
 
 	gl.bindFramebuffer(OpenGL::FRAMEBUFFER_ALL, getInternalBackbufferFBO());
 
+	updateStreamBufferPacing();
+
 	// Reset the per-frame stat counts.
 	drawCalls = 0;
 	gl.stats.shaderSwitches = 0;
@@ -1312,6 +1330,8 @@ void Graphics::present(void *screenshotCallbackData)
 
 	updatePendingReadbacks();
 	updateTemporaryResources();
+
+	beginGPUTimingFrame();
 }
 
 int Graphics::getRequestedBackbufferMSAA() const
@@ -1594,6 +1614,75 @@ void Graphics::getAPIStats(int &shaderswitches) const
 	shaderswitches = gl.stats.shaderSwitches;
 }
 
+int Graphics::getMaxStreamBufferFrames() const
+{
+	return MAX_STREAM_BUFFER_FRAMES;
+}
+
+bool Graphics::writeGPUTimestamp(uint64 &id)
+{
+	if (!capabilities.features[FEATURE_GPU_TIMESTAMPS])
+		return false;
+
+	GLuint query = 0;
+
+	if (!freeTimestampQueries.empty())
+	{
+		query = freeTimestampQueries.back();
+		freeTimestampQueries.pop_back();
+	}
+	else if (GLAD_ES_VERSION_2_0)
+		glGenQueriesEXT(1, &query);
+	else
+		glGenQueries(1, &query);
+
+	if (GLAD_ES_VERSION_2_0)
+		glQueryCounterEXT(query, GL_TIMESTAMP_EXT);
+	else
+		glQueryCounter(query, GL_TIMESTAMP);
+
+	id = query;
+	return true;
+}
+
+bool Graphics::getGPUTimestamp(uint64 id, uint64 &nanoseconds)
+{
+	GLuint query = (GLuint) id;
+	GLint available = 0;
+	GLuint64 result = 0;
+
+	if (GLAD_ES_VERSION_2_0)
+	{
+		glGetQueryObjectivEXT(query, GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+		if (!available)
+			return false;
+
+		// Timings are meaningless if the GPU's clock changed in the meantime.
+		GLint disjoint = 0;
+		glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+		if (disjoint)
+			return false;
+
+		glGetQueryObjectui64vEXT(query, GL_QUERY_RESULT_EXT, &result);
+	}
+	else
+	{
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			return false;
+
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &result);
+	}
+
+	nanoseconds = result;
+	return true;
+}
+
+void Graphics::releaseGPUTimestamp(uint64 id)
+{
+	freeTimestampQueries.push_back((GLuint) id);
+}
+
 void Graphics::initCapabilities()
 {
 	capabilities.features[FEATURE_MULTI_RENDER_TARGET_FORMATS] = true;
@@ -1609,7 +1698,8 @@ void Graphics::initCapabilities()
 	capabilities.features[FEATURE_TEXEL_BUFFER] = gl.isBufferUsageSupported(BUFFERUSAGE_TEXEL);
 	capabilities.features[FEATURE_COPY_TEXTURE_TO_BUFFER] = gl.isCopyTextureToBufferSupported();
 	capabilities.features[FEATURE_INDIRECT_DRAW] = capabilities.features[FEATURE_GLSL4];
-	static_assert(FEATURE_MAX_ENUM == 13, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
+	capabilities.features[FEATURE_GPU_TIMESTAMPS] = GLAD_ES_VERSION_2_0 ? GLAD_EXT_disjoint_timer_query : (GLAD_VERSION_3_3 || GLAD_ARB_timer_query);
+	static_assert(FEATURE_MAX_ENUM == 14, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
 
 	capabilities.limits[LIMIT_POINT_SIZE] = gl.getMaxPointSize();
 	capabilities.limits[LIMIT_TEXTURE_SIZE] = gl.getMax2DTextureSize();
@@ -145,6 +145,11 @@ class Graphics final : public love::graphics::Graphics
 	void initCapabilities() override;
 	void getAPIStats(int &shaderswitches) const override;
 
+	int getMaxStreamBufferFrames() const override;
+	bool writeGPUTimestamp(uint64 &id) override;
+	bool getGPUTimestamp(uint64 id, uint64 &nanoseconds) override;
+	void releaseGPUTimestamp(uint64 id) override;
+
 	void endPass(bool presenting);
 	GLuint bindCachedFBO(const RenderTargets &targets);
 	void discard(OpenGL::FramebufferTarget target, const std::vector<bool> &colorbuffers, bool depthstencil);
@@ -174,6 +179,9 @@ class Graphics final : public love::graphics::Graphics
 	// [non-readable, readable]
 	uint32 pixelFormatUsage[PIXELFORMAT_MAX_ENUM][2];
 
+	// Timestamp query objects which can be reused.
+	std::vector<GLuint> freeTimestampQueries;
+
 }; // Graphics
 
 } // opengl
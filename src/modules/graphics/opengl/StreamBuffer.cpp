@@ -25,6 +25,7 @@
 #include "graphics/Volatile.h"
 #include "common/Exception.h"
 #include "common/memory.h"
+#include "timer/Timer.h"
 
 #include <vector>
 #include <algorithm>
@@ -194,9 +195,10 @@ class StreamBufferSync : public love::graphics::StreamBuffer
 {
 public:
 
-	StreamBufferSync(BufferUsage type, size_t size)
+	StreamBufferSync(BufferUsage type, size_t size, int frames)
 		: love::graphics::StreamBuffer(type, size)
 		, frameIndex(0)
+		, frameCount(std::min(std::max(frames, BUFFER_FRAMES), MAX_STREAM_BUFFER_FRAMES))
 		, syncs()
 	{}
 
@@ -207,13 +209,18 @@ class StreamBufferSync : public love::graphics::StreamBuffer
 		return (frameIndex * bufferSize) + frameGPUReadOffset;
 	}
 
+	int getFrameCount() const override
+	{
+		return frameCount;
+	}
+
 	void nextFrame() override
 	{
 		// Insert a GPU fence for this frame's section of the data, we'll wait
 		// for it when we try to map that data for writing in subsequent frames.
 		syncs[frameIndex].fence();
 
-		frameIndex = (frameIndex + 1) % BUFFER_FRAMES;
+		frameIndex = (frameIndex + 1) % frameCount;
 		frameGPUReadOffset = 0;
 	}
 
@@ -226,8 +233,25 @@ class StreamBufferSync : public love::graphics::StreamBuffer
 
 protected:
 
+	// Make sure this frame's section of the buffer is done being used.
+	void waitForFrame()
+	{
+		FenceSync &sync = syncs[frameIndex];
+
+		if (sync.isComplete())
+		{
+			sync.cleanup();
+			return;
+		}
+
+		double start = love::timer::Timer::getTime();
+		sync.cpuWait();
+		recordWait(love::timer::Timer::getTime() - start);
+	}
+
 	int frameIndex;
-	FenceSync syncs[BUFFER_FRAMES];
+	int frameCount;
+	FenceSync syncs[MAX_STREAM_BUFFER_FRAMES];
 
 }; // StreamBufferSync
 
@@ -235,8 +259,8 @@ class StreamBufferMapSync final : public StreamBufferSync, public Volatile
 {
 public:
 
-	StreamBufferMapSync(BufferUsage type, size_t size)
-		: StreamBufferSync(type, size)
+	StreamBufferMapSync(BufferUsage type, size_t size, int frames)
+		: StreamBufferSync(type, size, frames)
 		, vbo(0)
 		, glMode(OpenGL::getGLBufferType(mode))
 	{
@@ -252,8 +276,7 @@ class StreamBufferMapSync final : public StreamBufferSync, public Volatile
 	{
 		gl.bindBuffer(mode, vbo);
 
-		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		waitForFrame();
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -284,7 +307,7 @@ class StreamBufferMapSync final : public StreamBufferSync, public Volatile
 
 		glGenBuffers(1, &vbo);
 		gl.bindBuffer(mode, vbo);
-		glBufferData(glMode, bufferSize * BUFFER_FRAMES, nullptr, GL_STREAM_DRAW);
+		glBufferData(glMode, bufferSize * frameCount, nullptr, GL_STREAM_DRAW);
 
 		frameGPUReadOffset = 0;
 		frameIndex = 0;
@@ -317,8 +340,8 @@ class StreamBufferPersistentMapSync final : public StreamBufferSync, public Vola
 
 	// Coherent mapping is supposedly faster on intel/nvidia aside from a couple
 	// old nvidia GPUs.
-	StreamBufferPersistentMapSync(BufferUsage type, size_t size, bool coherent = true)
-		: StreamBufferSync(type, size)
+	StreamBufferPersistentMapSync(BufferUsage type, size_t size, int frames, bool coherent = true)
+		: StreamBufferSync(type, size, frames)
 		, vbo(0)
 		, glMode(OpenGL::getGLBufferType(mode))
 		, data(nullptr)
@@ -334,8 +357,7 @@ class StreamBufferPersistentMapSync final : public StreamBufferSync, public Vola
 
 	MapInfo map(size_t /*minsize*/) override
 	{
-		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		waitForFrame();
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -372,8 +394,8 @@ class StreamBufferPersistentMapSync final : public StreamBufferSync, public Vola
 		storageflags |= (coherent ? GL_MAP_COHERENT_BIT : 0);
 		mapflags |= (coherent ? GL_MAP_COHERENT_BIT : GL_MAP_FLUSH_EXPLICIT_BIT);
 
-		glBufferStorage(glMode, bufferSize * BUFFER_FRAMES, nullptr, storageflags);
-		data = (uint8 *) glMapBufferRange(glMode, 0, bufferSize * BUFFER_FRAMES, mapflags);
+		glBufferStorage(glMode, bufferSize * frameCount, nullptr, storageflags);
+		data = (uint8 *) glMapBufferRange(glMode, 0, bufferSize * frameCount, mapflags);
 
 		frameGPUReadOffset = 0;
 		frameIndex = 0;
@@ -408,15 +430,15 @@ class StreamBufferPinnedMemory final : public StreamBufferSync, public Volatile
 {
 public:
 
-	StreamBufferPinnedMemory(BufferUsage type, size_t size)
-		: StreamBufferSync(type, size)
+	StreamBufferPinnedMemory(BufferUsage type, size_t size, int frames)
+		: StreamBufferSync(type, size, frames)
 		, vbo(0)
 		, glMode(OpenGL::getGLBufferType(mode))
 		, data(nullptr)
 		, alignedSize(0)
 	{
 		size_t alignment = getPageSize();
-		alignedSize = alignUp(size * BUFFER_FRAMES, alignment);
+		alignedSize = alignUp(size * frameCount, alignment);
 
 		if (!alignedMalloc((void **) &data, alignedSize, alignment))
 			throw love::Exception("Out of memory.");
@@ -437,8 +459,7 @@ class StreamBufferPinnedMemory final : public StreamBufferSync, public Volatile
 
 	MapInfo map(size_t /*minsize*/) override
 	{
-		// Make sure this frame's section of the buffer is done being used.
-		syncs[frameIndex].cpuWait();
+		waitForFrame();
 
 		MapInfo info;
 		info.size = bufferSize - frameGPUReadOffset;
@@ -506,7 +527,7 @@ class StreamBufferPinnedMemory final : public StreamBufferSync, public Volatile
 
 }; // StreamBufferPinnedMemory
 
-love::graphics::StreamBuffer *CreateStreamBuffer(BufferUsage mode, size_t size)
+love::graphics::StreamBuffer *CreateStreamBuffer(BufferUsage mode, size_t size, int frames)
 {
 	if (gl.isCoreProfile())
 	{
@@ -518,7 +539,7 @@ love::graphics::StreamBuffer *CreateStreamBuffer(BufferUsage mode, size_t size)
 			{
 				try
 				{
-					return new StreamBufferPinnedMemory(mode, size);
+					return new StreamBufferPinnedMemory(mode, size, frames);
 				}
 				catch (love::Exception &)
 				{
@@ -531,7 +552,7 @@ love::graphics::StreamBuffer *CreateStreamBuffer(BufferUsage mode, size_t size)
 			}
 
 			if (GLAD_VERSION_4_4 || GLAD_ARB_buffer_storage)
-				return new StreamBufferPersistentMapSync(mode, size);
+				return new StreamBufferPersistentMapSync(mode, size, frames);
 
 			// Most modern drivers have a separate internal thread which queues
 			// GL commands for the GPU. The queue causes mapping to stall until
@@ -540,7 +561,7 @@ love::graphics::StreamBuffer *CreateStreamBuffer(BufferUsage mode, size_t size)
 			// is opt-in via an API, and we don't do it, so we can use this
 			// instead of the (potentially slower) SubData approach.
 #ifdef LOVE_MACOS
-			return new StreamBufferMapSync(mode, size);
+			return new StreamBufferMapSync(mode, size, frames);
 #endif
 		}
 
@@ -29,7 +29,12 @@ namespace graphics
 namespace opengl
 {
 
-love::graphics::StreamBuffer *CreateStreamBuffer(BufferUsage mode, size_t size);
+// Upper limit for the number of frames of data a stream buffer can cycle
+// through before reusing memory.
+static const int MAX_STREAM_BUFFER_FRAMES = 8;
+
+// A frame count below the default is raised to the default.
+love::graphics::StreamBuffer *CreateStreamBuffer(BufferUsage mode, size_t size, int frames);
 
 } // opengl
 } // graphics
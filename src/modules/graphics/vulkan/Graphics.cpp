@@ -22,6 +22,8 @@
 #include "common/pixelformat.h"
 #include "common/version.h"
 #include "common/memory.h"
+#include "common/trace.h"
+#include "timer/Timer.h"
 #include "window/Window.h"
 #include "Buffer.h"
 #include "Graphics.h"
@@ -555,6 +557,8 @@ void Graphics::present(void *screenshotCallbackdata)
 	if (!isActive())
 		return;
 
+	LOVE_TRACE_ZONE("Graphics::present");
+
 	if (isRenderTargetActive())
 		throw love::Exception("present cannot be called while a render target is active.");
 
@@ -563,6 +567,8 @@ void Graphics::present(void *screenshotCallbackdata)
 
 	deprecations.draw(this);
 
+	endGPUTimingFrame();
+
 	submitGpuCommands(SUBMIT_PRESENT, screenshotCallbackdata);
 
 	VkResult result = VK_SUCCESS;
@@ -604,6 +610,8 @@ void Graphics::present(void *screenshotCallbackdata)
 		buffer->nextFrame();
 	batchedDrawState.indexBuffer->nextFrame();
 
+	updateStreamBufferPacing();
+
 	drawCalls = 0;
 	renderTargetSwitchCount = 0;
 	drawCallsBatched = 0;
@@ -615,6 +623,8 @@ void Graphics::present(void *screenshotCallbackdata)
 	realFrameIndex++;
 
 	beginFrame();
+
+	beginGPUTimingFrame();
 }
 
 void Graphics::backbufferChanged(int width, int height, int pixelwidth, int pixelheight, bool backbufferstencil, bool backbufferdepth, int msaa)
@@ -687,6 +697,7 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 		createCommandPool();
 		createCommandBuffers();
 		createSyncObjects();
+		createTimestampQueryPools();
 	}
 
 	if (localUniformBuffer == nullptr)
@@ -777,11 +788,27 @@ void Graphics::initCapabilities()
 	capabilities.features[FEATURE_TEXEL_BUFFER] = true;
 	capabilities.features[FEATURE_COPY_TEXTURE_TO_BUFFER] = true;
 	capabilities.features[FEATURE_INDIRECT_DRAW] = true;
-	static_assert(FEATURE_MAX_ENUM == 13, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
 
 	VkPhysicalDeviceProperties properties;
 	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
 
+	{
+		QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
+
+		uint32_t queueFamilyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+		bool timestamps = indices.graphicsFamily.hasValue && indices.graphicsFamily.value < queueFamilyCount
+			&& queueFamilies[indices.graphicsFamily.value].timestampValidBits > 0
+			&& properties.limits.timestampPeriod > 0.0f;
+
+		capabilities.features[FEATURE_GPU_TIMESTAMPS] = timestamps;
+		timestampPeriod = properties.limits.timestampPeriod;
+	}
+	static_assert(FEATURE_MAX_ENUM == 14, "Graphics::initCapabilities must be updated when adding a new graphics feature!");
+
 	capabilities.limits[LIMIT_POINT_SIZE] = properties.limits.pointSizeRange[1];
 	capabilities.limits[LIMIT_TEXTURE_SIZE] = properties.limits.maxImageDimension2D;
 	capabilities.limits[LIMIT_TEXTURE_LAYERS] = properties.limits.maxImageArrayLayers;
@@ -813,6 +840,8 @@ void Graphics::unSetMode()
 	if (created)
 		submitGpuCommands(SUBMIT_NOPRESENT);
 
+	clearGPUTiming();
+
 	created = false;
 
 	cleanupSwapChain(true);
@@ -1420,7 +1449,16 @@ void Graphics::beginSwapChainFrame()
 
 void Graphics::beginFrame()
 {
-	vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+	// This fence covers the whole frame (presentation and GPU load), not just
+	// stream buffer memory, so waiting on it is reported as frame pacing.
+	if (vkGetFenceStatus(device, inFlightFences[currentFrame]) == VK_NOT_READY)
+	{
+		double start = love::timer::Timer::getTime();
+		vkWaitForFences(device, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+		frameWaitTime += love::timer::Timer::getTime() - start;
+	}
+
+	readTimestampQueries();
 
 	for (auto &readbackCallback : readbackCallbacks.at(currentFrame))
 		readbackCallback();
@@ -3389,6 +3427,94 @@ void Graphics::createSyncObjects()
 			throw love::Exception("Failed to create Vulkan synchronization objects for a frame!");
 }
 
+bool Graphics::writeGPUTimestamp(uint64 &id)
+{
+	if (timestampQueryPools.size() <= currentFrame)
+		return false;
+
+	TimestampQueryPool &pool = timestampQueryPools[currentFrame];
+	if (pool.pool == VK_NULL_HANDLE || pool.serials.size() >= TIMESTAMP_QUERY_POOL_SIZE)
+		return false;
+
+	// Queries can't be reset inside a render pass.
+	if (pool.needsReset)
+	{
+		vkCmdResetQueryPool(getCommandBufferForDataTransfer(), pool.pool, 0, TIMESTAMP_QUERY_POOL_SIZE);
+		pool.needsReset = false;
+	}
+
+	uint32 index = (uint32) pool.serials.size();
+	vkCmdWriteTimestamp(commandBuffers.at(currentFrame), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, pool.pool, index);
+
+	id = nextTimestampSerial++;
+	pool.serials.push_back(id);
+	return true;
+}
+
+bool Graphics::getGPUTimestamp(uint64 id, uint64 &nanoseconds)
+{
+	auto it = timestampResults.find(id);
+	if (it == timestampResults.end())
+		return false;
+
+	nanoseconds = it->second;
+	return true;
+}
+
+void Graphics::releaseGPUTimestamp(uint64 id)
+{
+	timestampResults.erase(id);
+}
+
+void Graphics::createTimestampQueryPools()
+{
+	timestampQueryPools.clear();
+	timestampQueryPools.resize(MAX_FRAMES_IN_FLIGHT);
+
+	if (!capabilities.features[FEATURE_GPU_TIMESTAMPS])
+		return;
+
+	VkQueryPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	poolInfo.queryCount = TIMESTAMP_QUERY_POOL_SIZE;
+
+	for (TimestampQueryPool &pool : timestampQueryPools)
+	{
+		if (vkCreateQueryPool(device, &poolInfo, nullptr, &pool.pool) != VK_SUCCESS)
+		{
+			pool.pool = VK_NULL_HANDLE;
+			capabilities.features[FEATURE_GPU_TIMESTAMPS] = false;
+		}
+	}
+}
+
+void Graphics::readTimestampQueries()
+{
+	if (timestampQueryPools.size() <= currentFrame)
+		return;
+
+	TimestampQueryPool &pool = timestampQueryPools[currentFrame];
+	if (pool.serials.empty())
+		return;
+
+	// The frame's fence has been waited on, so every query it wrote is done.
+	std::vector<uint64> results(pool.serials.size());
+	VkResult result = vkGetQueryPoolResults(
+		device, pool.pool, 0, (uint32) results.size(),
+		sizeof(uint64) * results.size(), results.data(), sizeof(uint64),
+		VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+
+	if (result == VK_SUCCESS)
+	{
+		for (size_t i = 0; i < results.size(); i++)
+			timestampResults[pool.serials[i]] = (uint64) (results[i] * (double) timestampPeriod);
+	}
+
+	pool.serials.clear();
+	pool.needsReset = true;
+}
+
 void Graphics::cleanup()
 {
 	for (auto &cleanUpFns : cleanUpFunctions)
@@ -3396,6 +3522,16 @@ void Graphics::cleanup()
 			cleanUpFn();
 	cleanUpFunctions.clear();
 
+	clearGPUTiming();
+
+	for (const auto &pool : timestampQueryPools)
+	{
+		if (pool.pool != VK_NULL_HANDLE)
+			vkDestroyQueryPool(device, pool.pool, nullptr);
+	}
+	timestampQueryPools.clear();
+	timestampResults.clear();
+
 	vmaDestroyAllocator(vmaAllocator);
 
 	for (const auto &s : renderFinishedSemaphores)
@@ -300,6 +300,9 @@ class Graphics final : public love::graphics::Graphics
 	void initCapabilities() override;
 	void getAPIStats(int &shaderswitches) const override;
 	void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture) override;
+	bool writeGPUTimestamp(uint64 &id) override;
+	bool getGPUTimestamp(uint64 id, uint64 &nanoseconds) override;
+	void releaseGPUTimestamp(uint64 id) override;
 
 private:
 
@@ -309,6 +312,15 @@ class Graphics final : public love::graphics::Graphics
 		int referenceCount = 0;
 	};
 
+	struct TimestampQueryPool
+	{
+		VkQueryPool pool = VK_NULL_HANDLE;
+		std::vector<uint64> serials;
+		bool needsReset = true;
+	};
+
+	static const uint32 TIMESTAMP_QUERY_POOL_SIZE = MAX_GPU_TIMING_SCOPES * 2;
+
 	bool checkValidationSupport();
 	void pickPhysicalDevice();
 	int rateDeviceSuitability(VkPhysicalDevice device, bool querySwapChain);
@@ -336,6 +348,8 @@ class Graphics final : public love::graphics::Graphics
 	void createCommandPool();
 	void createCommandBuffers();
 	void createSyncObjects();
+	void createTimestampQueryPools();
+	void readTimestampQueries();
 	void cleanup();
 	void cleanupSwapChain(bool destroySwapChainObject);
 	void recreateSwapChain();
@@ -416,6 +430,11 @@ class Graphics final : public love::graphics::Graphics
 	std::vector<std::vector<std::function<void()>>> readbackCallbacks;
 	std::set<StrongRef<Shader>> usedShadersInFrame;
 	RenderpassState renderPassState;
+	// One timestamp query pool for each frame in flight.
+	std::vector<TimestampQueryPool> timestampQueryPools;
+	std::unordered_map<uint64, uint64> timestampResults;
+	uint64 nextTimestampSerial = 1;
+	float timestampPeriod = 1.0f;
 };
 
 } // vulkan
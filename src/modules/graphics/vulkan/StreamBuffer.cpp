@@ -127,6 +127,11 @@ void StreamBuffer::markUsed(size_t usedSize)
 	frameGPUReadOffset += usedSize;
 }
 
+int StreamBuffer::getFrameCount() const
+{
+	return MAX_FRAMES_IN_FLIGHT;
+}
+
 void StreamBuffer::nextFrame()
 {
 	frameIndex = (frameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
@@ -53,6 +53,7 @@ class StreamBuffer final
 	void markUsed(size_t usedSize) override;
 
 	void nextFrame() override;
+	int getFrameCount() const override;
 
 	ptrdiff_t getHandle() const override;
 
@@ -268,6 +268,192 @@ int w_Font_getDPIScale(lua_State *L)
 	return 1;
 }
 
+int w_Font_isSDF(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	luax_pushboolean(L, t->isSDF());
+	return 1;
+}
+
+// width, then a color as numbers or a table, like setColor.
+static Font::SDFEffect checkSDFEffect(lua_State *L, const Font::SDFEffect &current)
+{
+	Font::SDFEffect effect = current;
+	effect.width = (float) luaL_checknumber(L, 2);
+
+	if (lua_istable(L, 3))
+	{
+		for (int i = 1; i <= 4; i++)
+			lua_rawgeti(L, 3, i);
+
+		effect.color.r = (float) luaL_checknumber(L, -4);
+		effect.color.g = (float) luaL_checknumber(L, -3);
+		effect.color.b = (float) luaL_checknumber(L, -2);
+		effect.color.a = (float) luaL_optnumber(L, -1, 1.0);
+
+		lua_pop(L, 4);
+	}
+	else if (!lua_isnoneornil(L, 3))
+	{
+		effect.color.r = (float) luaL_checknumber(L, 3);
+		effect.color.g = (float) luaL_checknumber(L, 4);
+		effect.color.b = (float) luaL_checknumber(L, 5);
+		effect.color.a = (float) luaL_optnumber(L, 6, 1.0);
+	}
+
+	return effect;
+}
+
+static int pushSDFEffect(lua_State *L, const Font::SDFEffect &effect)
+{
+	lua_pushnumber(L, effect.width);
+	lua_pushnumber(L, effect.color.r);
+	lua_pushnumber(L, effect.color.g);
+	lua_pushnumber(L, effect.color.b);
+	lua_pushnumber(L, effect.color.a);
+	return 5;
+}
+
+int w_Font_setOutline(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	t->setSDFOutline(checkSDFEffect(L, t->getSDFOutline()));
+	return 0;
+}
+
+int w_Font_getOutline(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	return pushSDFEffect(L, t->getSDFOutline());
+}
+
+int w_Font_setGlow(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	t->setSDFGlow(checkSDFEffect(L, t->getSDFGlow()));
+	return 0;
+}
+
+int w_Font_getGlow(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	return pushSDFEffect(L, t->getSDFGlow());
+}
+
+// Strings, codepoints, and {first, last} codepoint ranges.
+int w_Font_preload(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	Font::Codepoints codepoints;
+
+	for (int i = 2; i <= std::max(lua_gettop(L), 2); i++)
+	{
+		if (lua_istable(L, i))
+		{
+			lua_rawgeti(L, i, 1);
+			lua_rawgeti(L, i, 2);
+			lua_Number first = luaL_checknumber(L, -2);
+			lua_Number last = luaL_checknumber(L, -1);
+			lua_pop(L, 2);
+
+			if (first < 0 || last > 0x10FFFF || first > last)
+				return luaL_error(L, "Invalid codepoint range: [%d, %d]", (int) first, (int) last);
+
+			for (uint32 c = (uint32) first; c <= (uint32) last; c++)
+				codepoints.push_back(c);
+		}
+		else if (lua_type(L, i) == LUA_TNUMBER)
+			codepoints.push_back((uint32) lua_tonumber(L, i));
+		else
+		{
+			const char *str = luaL_checkstring(L, i);
+			luax_catchexcept(L, [&]() { love::font::getCodepointsFromString(str, codepoints); });
+		}
+	}
+
+	luax_catchexcept(L, [&]() { t->preload(codepoints); });
+	return 0;
+}
+
+int w_Font_setAsync(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	t->setAsync(luax_checkboolean(L, 2));
+	return 0;
+}
+
+int w_Font_isAsync(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	luax_pushboolean(L, t->isAsync());
+	return 1;
+}
+
+int w_Font_getPendingGlyphCount(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	luax_catchexcept(L, [&]() { t->integrateLoadedGlyphs(); });
+	lua_pushinteger(L, t->getPendingGlyphCount());
+	return 1;
+}
+
+int w_Font_setAtlasBudget(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	int width = (int) luaL_optinteger(L, 2, 0);
+	int height = (int) luaL_optinteger(L, 3, width);
+	luax_catchexcept(L, [&]() { t->setAtlasBudget(width, height); });
+	return 0;
+}
+
+int w_Font_getAtlasBudget(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	int width = 0;
+	int height = 0;
+	t->getAtlasBudget(width, height);
+	lua_pushinteger(L, width);
+	lua_pushinteger(L, height);
+	return 2;
+}
+
+int w_Font_getAtlasStats(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	Font::AtlasStats stats = t->getAtlasStats();
+
+	if (lua_istable(L, 2))
+		lua_pushvalue(L, 2);
+	else
+		lua_createtable(L, 0, 8);
+
+	lua_pushinteger(L, stats.textureCount);
+	lua_setfield(L, -2, "textures");
+
+	lua_pushinteger(L, stats.width);
+	lua_setfield(L, -2, "width");
+
+	lua_pushinteger(L, stats.height);
+	lua_setfield(L, -2, "height");
+
+	lua_pushinteger(L, stats.glyphCount);
+	lua_setfield(L, -2, "glyphs");
+
+	lua_pushnumber(L, (lua_Number) stats.glyphPixels);
+	lua_setfield(L, -2, "glyphpixels");
+
+	lua_pushnumber(L, (lua_Number) stats.texturePixels);
+	lua_setfield(L, -2, "texturepixels");
+
+	lua_pushnumber(L, (lua_Number) stats.evictions);
+	lua_setfield(L, -2, "evictions");
+
+	lua_pushnumber(L, (lua_Number) stats.rebuilds);
+	lua_setfield(L, -2, "rebuilds");
+
+	return 1;
+}
+
 static const luaL_Reg w_Font_functions[] =
 {
 	{ "get_height", w_Font_getHeight },
@@ -284,6 +470,18 @@ static const luaL_Reg w_Font_functions[] =
 	{ "get_kerning", w_Font_getKerning },
 	{ "set_fallbacks", w_Font_setFallbacks },
 	{ "get_dpi_scale", w_Font_getDPIScale },
+	{ "is_sdf", w_Font_isSDF },
+	{ "set_outline", w_Font_setOutline },
+	{ "get_outline", w_Font_getOutline },
+	{ "set_glow", w_Font_setGlow },
+	{ "get_glow", w_Font_getGlow },
+	{ "preload", w_Font_preload },
+	{ "set_async", w_Font_setAsync },
+	{ "is_async", w_Font_isAsync },
+	{ "get_pending_glyph_count", w_Font_getPendingGlyphCount },
+	{ "set_atlas_budget", w_Font_setAtlasBudget },
+	{ "get_atlas_budget", w_Font_getAtlasBudget },
+	{ "get_atlas_stats", w_Font_getAtlasStats },
 	{ 0, 0 }
 };
 
@@ -1458,6 +1458,26 @@ int w_newSpriteBatch(lua_State *L)
 	return 1;
 }
 
+int w_newShapeBatch(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	BufferDataUsage usage = BUFFERDATAUSAGE_DYNAMIC;
+	if (!lua_isnoneornil(L, 1))
+	{
+		const char *usagestr = luaL_checkstring(L, 1);
+		if (!getConstant(usagestr, usage))
+			return luax_enumerror(L, "usage hint", getConstants(usage), usagestr);
+	}
+
+	ShapeBatch *t = nullptr;
+	luax_catchexcept(L, [&](){ t = instance()->newShapeBatch(usage); });
+
+	luax_pushtype(L, t);
+	t->release();
+	return 1;
+}
+
 int w_newParticleSystem(lua_State *L)
 {
 	luax_checkgraphicscreated(L);
@@ -2320,6 +2340,46 @@ int w_newTextBatch(lua_State *L)
 	return 1;
 }
 
+int w_newTextLayouts(lua_State *L)
+{
+	luax_checkgraphicscreated(L);
+
+	graphics::Font *font = luax_checkfont(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+	float wrap = (float) luaL_checknumber(L, 3);
+
+	Font::AlignMode align = Font::ALIGN_LEFT;
+	const char *alignstr = lua_isnoneornil(L, 4) ? nullptr : luaL_checkstring(L, 4);
+	if (alignstr != nullptr && !Font::getConstant(alignstr, align))
+		return luax_enumerror(L, "align mode", Font::getConstants(align), alignstr);
+
+	int count = (int) luax_objlen(L, 2);
+	std::vector<love::font::ColoredCodepoints> texts(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		lua_rawgeti(L, 2, i + 1);
+
+		std::vector<love::font::ColoredString> text;
+		luax_checkcoloredstring(L, lua_gettop(L), text);
+		love::font::getCodepointsFromString(text, texts[i]);
+
+		lua_pop(L, 1);
+	}
+
+	std::vector<StrongRef<TextLayout>> layouts;
+	luax_catchexcept(L, [&](){ layouts = font->newTextLayouts(texts, wrap, align); });
+
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++)
+	{
+		luax_pushtype(L, layouts[i].get());
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	return 1;
+}
+
 int w_newText(lua_State *L)
 {
 	luax_markdeprecated(L, 1, "love.graphics.newText", API_FUNCTION, DEPRECATED_RENAMED, "love.graphics.newTextBatch");
@@ -3183,7 +3243,7 @@ int w_getStats(lua_State *L)
 	if (lua_istable(L, 1))
 		lua_pushvalue(L, 1);
 	else
-		lua_createtable(L, 0, 7);
+		lua_createtable(L, 0, 13);
 
 	lua_pushinteger(L, stats.drawCalls);
 	lua_setfield(L, -2, "drawcalls");
@@ -3212,9 +3272,94 @@ int w_getStats(lua_State *L)
 	lua_pushnumber(L, (lua_Number) stats.bufferMemory);
 	lua_setfield(L, -2, "buffermemory");
 
+	lua_pushinteger(L, stats.streamBufferGrows);
+	lua_setfield(L, -2, "streambuffergrows");
+
+	lua_pushinteger(L, stats.streamBufferWaits);
+	lua_setfield(L, -2, "streambufferwaits");
+
+	lua_pushnumber(L, stats.streamBufferWaitTime);
+	lua_setfield(L, -2, "streambufferwaittime");
+
+	lua_pushinteger(L, stats.streamBufferFrames);
+	lua_setfield(L, -2, "streambufferframes");
+
+	lua_pushnumber(L, stats.frameWaitTime);
+	lua_setfield(L, -2, "framewaittime");
+
 	return 1;
 }
 
+int w_setGPUProfilingEnabled(lua_State *L)
+{
+	bool enable = luax_checkboolean(L, 1);
+	luax_catchexcept(L, [&]() { instance()->setGPUProfilingEnabled(enable); });
+	return 0;
+}
+
+int w_isGPUProfilingEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isGPUProfilingEnabled());
+	return 1;
+}
+
+int w_setAdaptiveStreamBuffersEnabled(lua_State *L)
+{
+	instance()->setAdaptiveStreamBuffersEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isAdaptiveStreamBuffersEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isAdaptiveStreamBuffersEnabled());
+	return 1;
+}
+
+int w_pushGPUMarker(lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 1);
+	luax_catchexcept(L, [&]() { instance()->pushGPUMarker(name); });
+	return 0;
+}
+
+int w_popGPUMarker(lua_State *L)
+{
+	luax_catchexcept(L, [&]() { instance()->popGPUMarker(); });
+	return 0;
+}
+
+int w_getGPUTimings(lua_State *L)
+{
+	std::vector<Graphics::GPUTiming> timings;
+	uint64 frame = instance()->getGPUTimings(timings);
+
+	lua_createtable(L, (int) timings.size(), 0);
+
+	for (int i = 0; i < (int) timings.size(); i++)
+	{
+		const Graphics::GPUTiming &timing = timings[i];
+
+		lua_createtable(L, 0, 4);
+
+		luax_pushstring(L, timing.name);
+		lua_setfield(L, -2, "name");
+
+		lua_pushnumber(L, timing.time);
+		lua_setfield(L, -2, "time");
+
+		lua_pushinteger(L, timing.depth);
+		lua_setfield(L, -2, "depth");
+
+		luax_pushboolean(L, timing.pass);
+		lua_setfield(L, -2, "pass");
+
+		lua_rawseti(L, -2, i + 1);
+	}
+
+	lua_pushnumber(L, (lua_Number) frame);
+	return 2;
+}
+
 int w_draw(lua_State *L)
 {
 	Drawable *drawable = nullptr;
@@ -4040,6 +4185,8 @@ static const luaL_Reg functions[] =
 	{ "new_buffer", w_newBuffer },
 	{ "new_mesh", w_newMesh },
 	{ "new_text_batch", w_newTextBatch },
+	{ "new_text_layouts", w_newTextLayouts },
+	{ "new_shape_batch", w_newShapeBatch },
 	{ "_new_video", w_newVideo },
 
 	{ "readback_buffer", w_readbackBuffer },
@@ -4097,6 +4244,13 @@ static const luaL_Reg functions[] =
 	{ "get_system_limits", w_getSystemLimits },
 	{ "get_texture_types", w_getTextureTypes },
 	{ "get_stats", w_getStats },
+	{ "set_gpu_profiling_enabled", w_setGPUProfilingEnabled },
+	{ "is_gpu_profiling_enabled", w_isGPUProfilingEnabled },
+	{ "set_adaptive_stream_buffers_enabled", w_setAdaptiveStreamBuffersEnabled },
+	{ "is_adaptive_stream_buffers_enabled", w_isAdaptiveStreamBuffersEnabled },
+	{ "push_gpu_marker", w_pushGPUMarker },
+	{ "pop_gpu_marker", w_popGPUMarker },
+	{ "get_gpu_timings", w_getGPUTimings },
 
 	{ "capture_screenshot", w_captureScreenshot },
 
@@ -4196,6 +4350,8 @@ static const lua_CFunction types[] =
 	luaopen_shader,
 	luaopen_mesh,
 	luaopen_textbatch,
+	luaopen_textlayout,
+	luaopen_shapebatch,
 	luaopen_video,
 	0
 };
@@ -30,6 +30,8 @@
 #include "wrap_Shader.h"
 #include "wrap_Mesh.h"
 #include "wrap_TextBatch.h"
+#include "wrap_TextLayout.h"
+#include "wrap_ShapeBatch.h"
 #include "wrap_Video.h"
 #include "wrap_Buffer.h"
 #include "wrap_GraphicsReadback.h"
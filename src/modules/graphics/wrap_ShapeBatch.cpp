@@ -0,0 +1,295 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_ShapeBatch.h"
+
+namespace love
+{
+namespace graphics
+{
+
+ShapeBatch *luax_checkshapebatch(lua_State *L, int idx)
+{
+	return luax_checktype<ShapeBatch>(L, idx);
+}
+
+static Graphics::DrawMode checkDrawMode(lua_State *L, int idx)
+{
+	Graphics::DrawMode mode;
+	const char *str = luaL_checkstring(L, idx);
+	if (!Graphics::getConstant(str, mode))
+		luax_enumerror(L, "draw mode", Graphics::getConstants(mode), str);
+	return mode;
+}
+
+static std::vector<Vector2> checkCoords(lua_State *L, int startidx, int minvertices)
+{
+	int args = lua_gettop(L) - startidx + 1;
+
+	bool is_table = false;
+	if (args == 1 && lua_istable(L, startidx))
+	{
+		args = (int) luax_objlen(L, startidx);
+		is_table = true;
+	}
+
+	if (args % 2 != 0)
+		luaL_error(L, "Number of vertex components must be a multiple of two.");
+	else if (args < minvertices * 2)
+		luaL_error(L, "Need at least %d vertices.", minvertices);
+
+	std::vector<Vector2> coords(args / 2);
+
+	for (int i = 0; i < (int) coords.size(); i++)
+	{
+		if (is_table)
+		{
+			lua_rawgeti(L, startidx, (i * 2) + 1);
+			lua_rawgeti(L, startidx, (i * 2) + 2);
+			coords[i].x = luax_checkfloat(L, -2);
+			coords[i].y = luax_checkfloat(L, -1);
+			lua_pop(L, 2);
+		}
+		else
+		{
+			coords[i].x = luax_checkfloat(L, startidx + (i * 2));
+			coords[i].y = luax_checkfloat(L, startidx + (i * 2) + 1);
+		}
+	}
+
+	return coords;
+}
+
+// Takes the same arguments as the love.graphics function of the same name,
+// after the shape name.
+static ShapeBatch::RecordFunction checkShape(lua_State *L, int idx)
+{
+	ShapeBatch::ShapeType shape;
+	const char *shapestr = luaL_checkstring(L, idx);
+	if (!ShapeBatch::getConstant(shapestr, shape))
+		luax_enumerror(L, "shape", ShapeBatch::getConstants(shape), shapestr);
+
+	idx++;
+
+	switch (shape)
+	{
+	case ShapeBatch::SHAPE_RECTANGLE:
+	{
+		Graphics::DrawMode mode = checkDrawMode(L, idx);
+		float x = (float) luaL_checknumber(L, idx + 1);
+		float y = (float) luaL_checknumber(L, idx + 2);
+		float w = (float) luaL_checknumber(L, idx + 3);
+		float h = (float) luaL_checknumber(L, idx + 4);
+
+		if (lua_isnoneornil(L, idx + 5))
+			return [=](Graphics *gfx) { gfx->rectangle(mode, x, y, w, h); };
+
+		float rx = (float) luaL_optnumber(L, idx + 5, 0.0);
+		float ry = (float) luaL_optnumber(L, idx + 6, rx);
+
+		if (lua_isnoneornil(L, idx + 7))
+			return [=](Graphics *gfx) { gfx->rectangle(mode, x, y, w, h, rx, ry); };
+
+		int points = (int) luaL_checkinteger(L, idx + 7);
+		return [=](Graphics *gfx) { gfx->rectangle(mode, x, y, w, h, rx, ry, points); };
+	}
+	case ShapeBatch::SHAPE_CIRCLE:
+	{
+		Graphics::DrawMode mode = checkDrawMode(L, idx);
+		float x = (float) luaL_checknumber(L, idx + 1);
+		float y = (float) luaL_checknumber(L, idx + 2);
+		float radius = (float) luaL_checknumber(L, idx + 3);
+
+		if (lua_isnoneornil(L, idx + 4))
+			return [=](Graphics *gfx) { gfx->circle(mode, x, y, radius); };
+
+		int points = (int) luaL_checkinteger(L, idx + 4);
+		return [=](Graphics *gfx) { gfx->circle(mode, x, y, radius, points); };
+	}
+	case ShapeBatch::SHAPE_ELLIPSE:
+	{
+		Graphics::DrawMode mode = checkDrawMode(L, idx);
+		float x = (float) luaL_checknumber(L, idx + 1);
+		float y = (float) luaL_checknumber(L, idx + 2);
+		float a = (float) luaL_checknumber(L, idx + 3);
+		float b = (float) luaL_optnumber(L, idx + 4, a);
+
+		if (lua_isnoneornil(L, idx + 5))
+			return [=](Graphics *gfx) { gfx->ellipse(mode, x, y, a, b); };
+
+		int points = (int) luaL_checkinteger(L, idx + 5);
+		return [=](Graphics *gfx) { gfx->ellipse(mode, x, y, a, b, points); };
+	}
+	case ShapeBatch::SHAPE_ARC:
+	{
+		Graphics::DrawMode drawmode = checkDrawMode(L, idx);
+		Graphics::ArcMode arcmode = Graphics::ARC_PIE;
+
+		int startidx = idx + 1;
+
+		if (lua_type(L, startidx) == LUA_TSTRING)
+		{
+			const char *arcstr = luaL_checkstring(L, startidx);
+			if (!Graphics::getConstant(arcstr, arcmode))
+				luax_enumerror(L, "arc mode", Graphics::getConstants(arcmode), arcstr);
+
+			startidx++;
+		}
+
+		float x = (float) luaL_checknumber(L, startidx + 0);
+		float y = (float) luaL_checknumber(L, startidx + 1);
+		float radius = (float) luaL_checknumber(L, startidx + 2);
+		float angle1 = (float) luaL_checknumber(L, startidx + 3);
+		float angle2 = (float) luaL_checknumber(L, startidx + 4);
+
+		if (lua_isnoneornil(L, startidx + 5))
+			return [=](Graphics *gfx) { gfx->arc(drawmode, arcmode, x, y, radius, angle1, angle2); };
+
+		int points = (int) luaL_checkinteger(L, startidx + 5);
+		return [=](Graphics *gfx) { gfx->arc(drawmode, arcmode, x, y, radius, angle1, angle2, points); };
+	}
+	case ShapeBatch::SHAPE_POLYGON:
+	{
+		Graphics::DrawMode mode = checkDrawMode(L, idx);
+		std::vector<Vector2> coords = checkCoords(L, idx + 1, 3);
+
+		// make a closed loop
+		coords.push_back(coords[0]);
+
+		return [=](Graphics *gfx) { gfx->polygon(mode, coords.data(), coords.size()); };
+	}
+	case ShapeBatch::SHAPE_LINE:
+	{
+		std::vector<Vector2> coords = checkCoords(L, idx, 2);
+		return [=](Graphics *gfx) { gfx->polyline(coords.data(), coords.size()); };
+	}
+	case ShapeBatch::SHAPE_MAX_ENUM:
+		break;
+	}
+
+	return ShapeBatch::RecordFunction();
+}
+
+int w_ShapeBatch_add(lua_State *L)
+{
+	ShapeBatch *t = luax_checkshapebatch(L, 1);
+	ShapeBatch::RecordFunction record = checkShape(L, 2);
+
+	int index = 0;
+	luax_catchexcept(L, [&](){ index = t->add(record); });
+
+	lua_pushinteger(L, index + 1);
+	return 1;
+}
+
+int w_ShapeBatch_set(lua_State *L)
+{
+	ShapeBatch *t = luax_checkshapebatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+	ShapeBatch::RecordFunction record = checkShape(L, 3);
+
+	luax_catchexcept(L, [&](){ t->set(index, record); });
+	return 0;
+}
+
+int w_ShapeBatch_remove(lua_State *L)
+{
+	ShapeBatch *t = luax_checkshapebatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+	luax_catchexcept(L, [&](){ t->remove(index); });
+	return 0;
+}
+
+int w_ShapeBatch_getEntryCount(lua_State *L)
+{
+	ShapeBatch *t = luax_checkshapebatch(L, 1);
+	lua_pushinteger(L, t->getEntryCount());
+	return 1;
+}
+
+int w_ShapeBatch_clear(lua_State *L)
+{
+	ShapeBatch *t = luax_checkshapebatch(L, 1);
+	luax_catchexcept(L, [&](){ t->clear(); });
+	return 0;
+}
+
+int w_ShapeBatch_setColor(lua_State *L)
+{
+	ShapeBatch *t = luax_checkshapebatch(L, 1);
+	Colorf c;
+
+	if (lua_istable(L, 2))
+	{
+		for (int i = 1; i <= 4; i++)
+			lua_rawgeti(L, 2, i);
+
+		c.r = (float) luaL_checknumber(L, -4);
+		c.g = (float) luaL_checknumber(L, -3);
+		c.b = (float) luaL_checknumber(L, -2);
+		c.a = (float) luaL_optnumber(L, -1, 1.0);
+
+		lua_pop(L, 4);
+	}
+	else
+	{
+		c.r = (float) luaL_checknumber(L, 2);
+		c.g = (float) luaL_checknumber(L, 3);
+		c.b = (float) luaL_checknumber(L, 4);
+		c.a = (float) luaL_optnumber(L, 5, 1.0);
+	}
+
+	t->setColor(c);
+
+	return 0;
+}
+
+int w_ShapeBatch_getColor(lua_State *L)
+{
+	ShapeBatch *t = luax_checkshapebatch(L, 1);
+	Colorf c = t->getColor();
+
+	lua_pushnumber(L, c.r);
+	lua_pushnumber(L, c.g);
+	lua_pushnumber(L, c.b);
+	lua_pushnumber(L, c.a);
+
+	return 4;
+}
+
+static const luaL_Reg w_ShapeBatch_functions[] =
+{
+	{ "add", w_ShapeBatch_add },
+	{ "set", w_ShapeBatch_set },
+	{ "remove", w_ShapeBatch_remove },
+	{ "get_entry_count", w_ShapeBatch_getEntryCount },
+	{ "clear", w_ShapeBatch_clear },
+	{ "set_color", w_ShapeBatch_setColor },
+	{ "get_color", w_ShapeBatch_getColor },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_shapebatch(lua_State *L)
+{
+	return luax_register_type(L, &ShapeBatch::type, w_ShapeBatch_functions, nullptr);
+}
+
+} // graphics
+} // love
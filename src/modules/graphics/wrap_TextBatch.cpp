@@ -62,35 +62,58 @@ int w_TextBatch_setf(lua_State *L)
 	return 0;
 }
 
+static Matrix4 checkTextMatrix(lua_State *L, int startidx)
+{
+	if (luax_istype(L, startidx, math::Transform::type))
+		return luax_totype<math::Transform>(L, startidx)->getMatrix();
+
+	float x  = (float) luaL_optnumber(L, startidx + 0, 0.0);
+	float y  = (float) luaL_optnumber(L, startidx + 1, 0.0);
+	float a  = (float) luaL_optnumber(L, startidx + 2, 0.0);
+	float sx = (float) luaL_optnumber(L, startidx + 3, 1.0);
+	float sy = (float) luaL_optnumber(L, startidx + 4, sx);
+	float ox = (float) luaL_optnumber(L, startidx + 5, 0.0);
+	float oy = (float) luaL_optnumber(L, startidx + 6, 0.0);
+	float kx = (float) luaL_optnumber(L, startidx + 7, 0.0);
+	float ky = (float) luaL_optnumber(L, startidx + 8, 0.0);
+
+	return Matrix4(x, y, a, sx, sy, ox, oy, kx, ky);
+}
+
+static Font::AlignMode checkAlignMode(lua_State *L, int idx)
+{
+	Font::AlignMode align = Font::ALIGN_MAX_ENUM;
+	const char *alignstr = luaL_checkstring(L, idx);
+
+	if (!Font::getConstant(alignstr, align))
+		luax_enumerror(L, "align mode", Font::getConstants(align), alignstr);
+
+	return align;
+}
+
 int w_TextBatch_add(lua_State *L)
 {
 	TextBatch *t = luax_checktextbatch(L, 1);
 
 	int index = 0;
 
+	if (luax_istype(L, 2, TextLayout::type))
+	{
+		TextLayout *layout = luax_totype<TextLayout>(L, 2);
+		Matrix4 m = checkTextMatrix(L, 3);
+
+		luax_catchexcept(L, [&](){ index = t->addLayout(layout, m); });
+
+		lua_pushnumber(L, index + 1);
+		return 1;
+	}
+
 	std::vector<love::font::ColoredString> text;
 	luax_checkcoloredstring(L, 2, text);
 
-	if (luax_istype(L, 3, math::Transform::type))
-	{
-		math::Transform *tf = luax_totype<math::Transform>(L, 3);
-		luax_catchexcept(L, [&](){ index = t->add(text, tf->getMatrix()); });
-	}
-	else
-	{
-		float x  = (float) luaL_optnumber(L, 3, 0.0);
-		float y  = (float) luaL_optnumber(L, 4, 0.0);
-		float a  = (float) luaL_optnumber(L, 5, 0.0);
-		float sx = (float) luaL_optnumber(L, 6, 1.0);
-		float sy = (float) luaL_optnumber(L, 7, sx);
-		float ox = (float) luaL_optnumber(L, 8, 0.0);
-		float oy = (float) luaL_optnumber(L, 9, 0.0);
-		float kx = (float) luaL_optnumber(L, 10, 0.0);
-		float ky = (float) luaL_optnumber(L, 11, 0.0);
-
-		Matrix4 m(x, y, a, sx, sy, ox, oy, kx, ky);
-		luax_catchexcept(L, [&](){ index = t->add(text, m); });
-	}
+	Matrix4 m = checkTextMatrix(L, 3);
+
+	luax_catchexcept(L, [&](){ index = t->add(text, m); });
 
 	lua_pushnumber(L, index + 1);
 	return 1;
@@ -106,35 +129,66 @@ int w_TextBatch_addf(lua_State *L)
 	luax_checkcoloredstring(L, 2, text);
 
 	float wrap = (float) luaL_checknumber(L, 3);
+	Font::AlignMode align = checkAlignMode(L, 4);
+	Matrix4 m = checkTextMatrix(L, 5);
 
-	Font::AlignMode align = Font::ALIGN_MAX_ENUM;
-	const char *alignstr = luaL_checkstring(L, 4);
+	luax_catchexcept(L, [&](){ index = t->addf(text, wrap, align, m); });
 
-	if (!Font::getConstant(alignstr, align))
-		return luax_enumerror(L, "align mode", Font::getConstants(align), alignstr);
+	lua_pushnumber(L, index + 1);
+	return 1;
+}
 
-	if (luax_istype(L, 5, math::Transform::type))
-	{
-		math::Transform *tf = luax_totype<math::Transform>(L, 5);
-		luax_catchexcept(L, [&](){ index = t->addf(text, wrap, align, tf->getMatrix()); });
-	}
-	else
+int w_TextBatch_setEntry(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	if (luax_istype(L, 3, TextLayout::type))
 	{
-		float x  = (float) luaL_optnumber(L, 5, 0.0);
-		float y  = (float) luaL_optnumber(L, 6, 0.0);
-		float a  = (float) luaL_optnumber(L, 7, 0.0);
-		float sx = (float) luaL_optnumber(L, 8, 1.0);
-		float sy = (float) luaL_optnumber(L, 9, sx);
-		float ox = (float) luaL_optnumber(L, 10, 0.0);
-		float oy = (float) luaL_optnumber(L, 11, 0.0);
-		float kx = (float) luaL_optnumber(L, 12, 0.0);
-		float ky = (float) luaL_optnumber(L, 13, 0.0);
-
-		Matrix4 m(x, y, a, sx, sy, ox, oy, kx, ky);
-		luax_catchexcept(L, [&](){ index = t->addf(text, wrap, align, m); });
+		TextLayout *layout = luax_totype<TextLayout>(L, 3);
+		Matrix4 m = checkTextMatrix(L, 4);
+
+		luax_catchexcept(L, [&](){ t->setEntryLayout(index, layout, m); });
+		return 0;
 	}
 
-	lua_pushnumber(L, index + 1);
+	std::vector<love::font::ColoredString> text;
+	luax_checkcoloredstring(L, 3, text);
+
+	Matrix4 m = checkTextMatrix(L, 4);
+
+	luax_catchexcept(L, [&](){ t->setEntry(index, text, m); });
+	return 0;
+}
+
+int w_TextBatch_setEntryf(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	std::vector<love::font::ColoredString> text;
+	luax_checkcoloredstring(L, 3, text);
+
+	float wrap = (float) luaL_checknumber(L, 4);
+	Font::AlignMode align = checkAlignMode(L, 5);
+	Matrix4 m = checkTextMatrix(L, 6);
+
+	luax_catchexcept(L, [&](){ t->setEntryf(index, text, wrap, align, m); });
+	return 0;
+}
+
+int w_TextBatch_remove(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+	luax_catchexcept(L, [&](){ t->remove(index); });
+	return 0;
+}
+
+int w_TextBatch_getEntryCount(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	lua_pushinteger(L, t->getEntryCount());
 	return 1;
 }
 
@@ -192,6 +246,10 @@ static const luaL_Reg w_TextBatch_functions[] =
 	{ "setf", w_TextBatch_setf },
 	{ "add", w_TextBatch_add },
 	{ "addf", w_TextBatch_addf },
+	{ "set_entry", w_TextBatch_setEntry },
+	{ "set_entryf", w_TextBatch_setEntryf },
+	{ "remove", w_TextBatch_remove },
+	{ "get_entry_count", w_TextBatch_getEntryCount },
 	{ "clear", w_TextBatch_clear },
 	{ "set_font", w_TextBatch_setFont },
 	{ "get_font", w_TextBatch_getFont },
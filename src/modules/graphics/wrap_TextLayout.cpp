@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "wrap_TextLayout.h"
+#include "wrap_Font.h"
+
+namespace love
+{
+namespace graphics
+{
+
+TextLayout *luax_checktextlayout(lua_State *L, int idx)
+{
+	return luax_checktype<TextLayout>(L, idx);
+}
+
+int w_TextLayout_getFont(lua_State *L)
+{
+	TextLayout *t = luax_checktextlayout(L, 1);
+	luax_pushtype(L, t->getFont());
+	return 1;
+}
+
+int w_TextLayout_getWidth(lua_State *L)
+{
+	TextLayout *t = luax_checktextlayout(L, 1);
+	lua_pushnumber(L, t->getWidth());
+	return 1;
+}
+
+int w_TextLayout_getHeight(lua_State *L)
+{
+	TextLayout *t = luax_checktextlayout(L, 1);
+	lua_pushnumber(L, t->getHeight());
+	return 1;
+}
+
+int w_TextLayout_getDimensions(lua_State *L)
+{
+	TextLayout *t = luax_checktextlayout(L, 1);
+	lua_pushnumber(L, t->getWidth());
+	lua_pushnumber(L, t->getHeight());
+	return 2;
+}
+
+int w_TextLayout_getBounds(lua_State *L)
+{
+	TextLayout *t = luax_checktextlayout(L, 1);
+	float x, y, w, h;
+	t->getBounds(x, y, w, h);
+	lua_pushnumber(L, x);
+	lua_pushnumber(L, y);
+	lua_pushnumber(L, w);
+	lua_pushnumber(L, h);
+	return 4;
+}
+
+int w_TextLayout_getLineCount(lua_State *L)
+{
+	TextLayout *t = luax_checktextlayout(L, 1);
+	lua_pushinteger(L, (lua_Integer) t->getLines().size());
+	return 1;
+}
+
+int w_TextLayout_getLineBounds(lua_State *L)
+{
+	TextLayout *t = luax_checktextlayout(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	const auto &lines = t->getLines();
+	if (index < 0 || index >= (int) lines.size())
+		return luaL_error(L, "Invalid line index: %d", index + 1);
+
+	const TextLayout::Line &line = lines[index];
+	lua_pushnumber(L, line.x);
+	lua_pushnumber(L, line.y);
+	lua_pushnumber(L, line.width);
+	lua_pushnumber(L, line.height);
+	return 4;
+}
+
+static const luaL_Reg w_TextLayout_functions[] =
+{
+	{ "get_font", w_TextLayout_getFont },
+	{ "get_width", w_TextLayout_getWidth },
+	{ "get_height", w_TextLayout_getHeight },
+	{ "get_dimensions", w_TextLayout_getDimensions },
+	{ "get_bounds", w_TextLayout_getBounds },
+	{ "get_line_count", w_TextLayout_getLineCount },
+	{ "get_line_bounds", w_TextLayout_getLineBounds },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_textlayout(lua_State *L)
+{
+	return luax_register_type(L, &TextLayout::type, w_TextLayout_functions, nullptr);
+}
+
+} // graphics
+} // love
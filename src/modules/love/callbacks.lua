@@ -168,36 +168,57 @@ function love.run()
 	-- We don't want the first frame's dt to include time taken by love.load.
 	if love.timer then love.timer.step() end
 
+	-- Zones are only recorded while love.timer.set_tracing_enabled(true).
+	local trace = love.timer and love.timer.is_tracing_enabled
+	local push_zone = love.timer and love.timer.push_trace_zone
+	local pop_zone = love.timer and love.timer.pop_trace_zone
+
 	-- Main loop time.
 	return function()
+		local tracing = trace and trace()
+		if tracing then push_zone("love.run") end
+
 		-- Process events.
 		if love.event then
+			if tracing then push_zone("love.event") end
 			love.event.pump()
 			for name, a,b,c,d,e,f,g,h in love.event.poll() do
 				if name == "quit" then
 					if not love.quit or not love.quit() then
+						if tracing then pop_zone() pop_zone() end
 						return a or 0, b
 					end
 				end
 				love.handlers[name](a,b,c,d,e,f,g,h)
 			end
+			if tracing then pop_zone() end
 		end
 
 		-- Update dt, as we'll be passing it to update
 		local dt = love.timer and love.timer.step() or 0
 
 		-- Call update and draw
-		if love.update then love.update(dt) end -- will pass 0 if love.timer is disabled
+		if love.update then -- will pass 0 if love.timer is disabled
+			if tracing then push_zone("love.update") end
+			love.update(dt)
+			if tracing then pop_zone() end
+		end
 
 		if love.graphics and love.graphics.is_active() then
 			love.graphics.origin()
 			love.graphics.clear(love.graphics.get_background_color())
 
-			if love.draw then love.draw() end
+			if love.draw then
+				if tracing then push_zone("love.draw") end
+				love.draw()
+				if tracing then pop_zone() end
+			end
 
 			love.graphics.present()
 		end
 
+		if tracing then pop_zone() end
+
 		if love.timer then love.timer.sleep(0.001) end
 	end
 end
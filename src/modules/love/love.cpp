@@ -23,6 +23,7 @@
 #include "common/version.h"
 #include "common/deprecation.h"
 #include "common/runtime.h"
+#include "common/trace.h"
 #include "modules/window/Window.h"
 
 #include "love.h"
@@ -540,6 +541,8 @@ int luaopen_love(lua_State *L)
 
 	love::luax_insistpinnedthread(L);
 
+	love::trace::setThreadName("Main");
+
 	love::luax_insistglobal(L, "love");
 
 	// Set version information.
@@ -79,6 +79,31 @@ void subdivide(vector<love::Vector2> &points, int k)
 		points[i-1 + left.size() - 1] = right[right.size() - i - 1];
 }
 
+/**
+ * Checks whether the inner control points of a piece of curve are within
+ * sqrt(tolerancesq) of the segment between its end points. The curve lies in
+ * the convex hull of its control points, so the curve is within it as well.
+ **/
+bool is_flat(const love::Vector2 *points, size_t count, float tolerancesq)
+{
+	const love::Vector2 &a = points[0];
+	love::Vector2 ab = points[count - 1] - a;
+	float lengthsq = ab.getLengthSquare();
+
+	for (size_t i = 1; i < count - 1; ++i)
+	{
+		love::Vector2 ap = points[i] - a;
+
+		float t = lengthsq > 0.0f ? (ap.x * ab.x + ap.y * ab.y) / lengthsq : 0.0f;
+		t = std::min(std::max(t, 0.0f), 1.0f);
+
+		if ((ap - ab * t).getLengthSquare() > tolerancesq)
+			return false;
+	}
+
+	return true;
+}
+
 }
 
 namespace love
@@ -203,6 +228,28 @@ Vector2 BezierCurve::evaluate(double t) const
 	return points[0];
 }
 
+void BezierCurve::evaluate(const double *t, size_t count, Vector2 *dst) const
+{
+	if (controlPoints.size() < 2)
+		throw Exception("Invalid Bezier curve: Not enough control points.");
+
+	vector<Vector2> points(controlPoints.size());
+
+	for (size_t k = 0; k < count; ++k)
+	{
+		if (t[k] < 0 || t[k] > 1)
+			throw Exception("Invalid evaluation parameter: must be between 0 and 1");
+
+		// de casteljau, as above
+		std::copy(controlPoints.begin(), controlPoints.end(), points.begin());
+		for (size_t step = 1; step < controlPoints.size(); ++step)
+			for (size_t i = 0; i < controlPoints.size() - step; ++i)
+				points[i] = points[i] * (1-t[k]) + points[i+1] * t[k];
+
+		dst[k] = points[0];
+	}
+}
+
 BezierCurve* BezierCurve::getSegment(double t1, double t2) const
 {
 	if (t1 < 0 || t2 > 1)
@@ -275,5 +322,68 @@ vector<Vector2> BezierCurve::renderSegment(double start, double end, int accurac
 	return vertices;
 }
 
+void BezierCurve::renderAdaptive(float tolerance, vector<Vector2> &vertices) const
+{
+	if (controlPoints.size() < 2)
+		throw Exception("Invalid Bezier curve: Not enough control points.");
+	if (!(tolerance > 0))
+		throw Exception("Invalid tolerance: must be greater than 0");
+
+	// Stops runaway subdivision of degenerate curves (e.g. cusps) and tiny
+	// tolerances, at 2^16 segments.
+	const int MAX_DEPTH = 16;
+	const size_t n = controlPoints.size();
+
+	// Pieces still to be flattened, as a stack of control polygons. Splitting
+	// a piece replaces it by its right half and pushes the left half, so the
+	// chain is emitted from start to end and at most MAX_DEPTH + 1 pieces are
+	// waiting. Quadratic and cubic curves don't need a heap allocation.
+	Vector2 localstack[(MAX_DEPTH + 1) * 4];
+	vector<Vector2> heapstack;
+	Vector2 *stack = localstack;
+	if (n > 4)
+	{
+		heapstack.resize((MAX_DEPTH + 1) * n);
+		stack = heapstack.data();
+	}
+
+	int depths[MAX_DEPTH + 1];
+	int count = 1;
+
+	std::copy(controlPoints.begin(), controlPoints.end(), stack);
+	depths[0] = 0;
+
+	vertices.push_back(controlPoints[0]);
+	float tolerancesq = tolerance * tolerance;
+
+	while (count > 0)
+	{
+		Vector2 *piece = stack + (count - 1) * n;
+		int depth = depths[count - 1];
+
+		if (depth >= MAX_DEPTH || is_flat(piece, n, tolerancesq))
+		{
+			vertices.push_back(piece[n - 1]);
+			count--;
+			continue;
+		}
+
+		// de casteljau at t = 0.5 in place: the left edge of the scheme goes
+		// to the next slot, and what's left in this slot is the right half.
+		Vector2 *left = piece + n;
+		for (size_t step = 1; step < n; ++step)
+		{
+			left[step - 1] = piece[0];
+			for (size_t i = 0; i < n - step; ++i)
+				piece[i] = (piece[i] + piece[i+1]) * .5;
+		}
+		left[n - 1] = piece[0];
+
+		depths[count - 1] = depth + 1;
+		depths[count] = depth + 1;
+		count++;
+	}
+}
+
 } // namespace math
 } // namespace love
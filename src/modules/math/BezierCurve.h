@@ -115,6 +115,14 @@ class BezierCurve : public Object
 	 **/
 	Vector2 evaluate(double t) const;
 
+	/**
+	 * Evaluates the curve at many times.
+	 * @param t Curve parameters, each must satisfy 0 <= t <= 1.
+	 * @param count Number of parameters.
+	 * @param dst Receives count points.
+	 **/
+	void evaluate(const double *t, size_t count, Vector2 *dst) const;
+
 	/**
 	 * Get curve segment starting at t1 and ending at t2.
 	 * The new curve will be parametrized from 0 <= t <= 1.
@@ -140,6 +148,17 @@ class BezierCurve : public Object
 	 **/
 	std::vector<Vector2> renderSegment(double start, double end, int accuracy = 4) const;
 
+	/**
+	 * Renders the curve by adaptive subdivision: pieces of the curve are split
+	 * until their control points lie within the tolerance of the line between
+	 * the piece's ends, so flat parts get few vertices and sharp bends many.
+	 * @param tolerance Maximum distance between the curve and the polygon
+	 *        chain. Divide a distance in pixels by the curve's on-screen scale.
+	 * @param vertices The polygon chain is appended to this. Its memory can be
+	 *        reused between calls.
+	 **/
+	void renderAdaptive(float tolerance, std::vector<Vector2> &vertices) const;
+
 private:
 	std::vector<Vector2> controlPoints;
 };
@@ -25,10 +25,14 @@
 #include "common/StringMap.h"
 #include "BezierCurve.h"
 #include "Transform.h"
+#include "image/ImageData.h"
+#include "thread/TaskPool.h"
 
 // STL
+#include <algorithm>
 #include <cmath>
 #include <list>
+#include <set>
 #include <iostream>
 
 // C
@@ -80,20 +84,41 @@ inline bool is_ear(const Vector2 &a, const Vector2 &b, const Vector2 &c, const s
 	return is_oriented_ccw(a,b,c) && !any_point_in_triangle(vertices, a,b,c);
 }
 
-} // anonymous namespace
-
-namespace love
-{
-namespace math
+// check if the polygon is convex and simple, so it can be fanned from any
+// vertex. Collinear corners don't decide the winding, and a polygon which
+// turns around more than once (e.g. a star) is rejected.
+bool is_simple_convex(const std::vector<Vector2> &polygon)
 {
+	size_t n = polygon.size();
+	if (n < 3)
+		return false;
 
-std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon)
-{
-	if (polygon.size() < 3)
-		throw love::Exception("Not a polygon");
-	else if (polygon.size() == 3)
-		return std::vector<Triangle>(1, Triangle(polygon[0], polygon[1], polygon[2]));
+	float winding = 0.0f;
+	double turning = 0.0;
+
+	for (size_t i = 0; i < n; i++)
+	{
+		Vector2 p = polygon[(i + 1) % n] - polygon[i];
+		Vector2 q = polygon[(i + 2) % n] - polygon[(i + 1) % n];
+		float cross = Vector2::cross(p, q);
+
+		if (cross != 0.0f)
+		{
+			if (winding == 0.0f)
+				winding = cross;
+			else if (cross * winding < 0.0f)
+				return false;
+		}
+
+		turning += atan2((double) cross, (double) Vector2::dot(p, q));
+	}
+
+	return winding != 0.0f && fabs(fabs(turning) - 2.0 * LOVE_M_PI) < 0.001;
+}
 
+// ear clipping, O(n^2) or worse, but forgiving with degenerate polygons.
+void triangulate_ear_clipping(const std::vector<Vector2> &polygon, std::vector<int> &indices)
+{
 	// collect list of connections and record leftmost item to check if the polygon
 	// has the expected winding
 	std::vector<size_t> next_idx(polygon.size()), prev_idx(polygon.size());
@@ -122,7 +147,6 @@ std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon)
 	}
 
 	// triangulation according to kong
-	std::vector<Triangle> triangles;
 	size_t n_vertices = polygon.size();
 	size_t current = 1, skipped = 0, next, prev;
 	while (n_vertices > 3)
@@ -132,7 +156,9 @@ std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon)
 		const Vector2 &a = polygon[prev], &b = polygon[current], &c = polygon[next];
 		if (is_ear(a,b,c, concave_vertices))
 		{
-			triangles.push_back(Triangle(a,b,c));
+			indices.push_back((int) prev);
+			indices.push_back((int) current);
+			indices.push_back((int) next);
 			next_idx[prev] = next;
 			prev_idx[next] = prev;
 			concave_vertices.remove(&b);
@@ -147,11 +173,636 @@ std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon)
 	}
 	next = next_idx[current];
 	prev = prev_idx[current];
-	triangles.push_back(Triangle(polygon[prev], polygon[current], polygon[next]));
+	indices.push_back((int) prev);
+	indices.push_back((int) current);
+	indices.push_back((int) next);
+}
+
+// Splits a polygon with holes into y-monotone pieces with a sweep line, then
+// triangulates each piece in linear time, for O(n log n) overall. See de Berg
+// et al., "Computational Geometry: Algorithms and Applications", chapter 3.
+class MonotoneTriangulator
+{
+public:
+
+	MonotoneTriangulator(const std::vector<Vector2> &points, const std::vector<int> &contourSizes);
+
+	// Returns false if the polygon is degenerate or intersects itself.
+	bool triangulate(std::vector<int> &indices);
+
+private:
+
+	// Stands in for the current vertex when searching the sweep line status.
+	enum { QUERY = -1 };
+
+	struct EdgeLess
+	{
+		const MonotoneTriangulator *t;
+		bool operator () (int a, int b) const { return t->isEdgeLeftOf(a, b); }
+	};
+
+	typedef std::set<int, EdgeLess> EdgeSet;
+
+	// > 0 if c is to the left of the line from a to b.
+	double orient(int a, int b, int c) const
+	{
+		const Vector2 &pa = points[a], &pb = points[b], &pc = points[c];
+		return ((double) pb.x - pa.x) * ((double) pc.y - pa.y) - ((double) pb.y - pa.y) * ((double) pc.x - pa.x);
+	}
+
+	// Vertices are swept from the top down, and from left to right.
+	bool above(int a, int b) const { return rank[a] < rank[b]; }
+
+	bool isEdgeLeftOf(int a, int b) const;
+	bool partition();
+	bool triangulateFaces(std::vector<int> &indices);
+	bool triangulateMonotone(const std::vector<int> &face, std::vector<int> &indices);
+	void addTriangle(int a, int b, int c, std::vector<int> &indices);
+
+	const std::vector<Vector2> &points;
+
+	std::vector<int> vertices;
+	std::vector<int> next;
+	std::vector<int> prev;
+	std::vector<int> rank;
+
+	// Pairs of vertices.
+	std::vector<int> diagonals;
+
+	int holeCount;
+	int queryVertex;
+	bool valid;
+
+}; // MonotoneTriangulator
+
+MonotoneTriangulator::MonotoneTriangulator(const std::vector<Vector2> &points, const std::vector<int> &contourSizes)
+	: points(points)
+	, next(points.size(), -1)
+	, prev(points.size(), -1)
+	, rank(points.size(), -1)
+	, holeCount(0)
+	, queryVertex(-1)
+	, valid(true)
+{
+	vertices.reserve(points.size());
+
+	int first = 0;
+	for (size_t c = 0; c < contourSizes.size(); c++)
+	{
+		int size = contourSizes[c];
+		size_t begin = vertices.size();
+
+		// Repeated points would make zero length edges.
+		for (int i = first; i < first + size; i++)
+		{
+			if (vertices.size() == begin || points[i] != points[vertices.back()])
+				vertices.push_back(i);
+		}
+		while (vertices.size() - begin > 1 && points[vertices.back()] == points[vertices[begin]])
+			vertices.pop_back();
+
+		first += size;
+
+		double area = 0.0;
+		for (size_t i = begin; i < vertices.size(); i++)
+		{
+			const Vector2 &a = points[vertices[i]];
+			const Vector2 &b = points[vertices[i + 1 < vertices.size() ? i + 1 : begin]];
+			area += (double) a.x * b.y - (double) b.x * a.y;
+		}
+
+		if (vertices.size() - begin < 3 || area == 0.0)
+		{
+			// Empty holes can be ignored, but an empty outline can't.
+			vertices.resize(begin);
+			if (c == 0)
+				valid = false;
+			continue;
+		}
+
+		// The interior is to the left of every edge: the outline goes counter-
+		// clockwise and holes go clockwise.
+		bool reverse = c == 0 ? area < 0.0 : area > 0.0;
+
+		for (size_t i = begin; i < vertices.size(); i++)
+		{
+			int v = vertices[i];
+			int n = vertices[i + 1 < vertices.size() ? i + 1 : begin];
+			int p = vertices[i > begin ? i - 1 : vertices.size() - 1];
+			next[v] = reverse ? p : n;
+			prev[v] = reverse ? n : p;
+		}
+
+		if (c > 0)
+			holeCount++;
+	}
+}
+
+// Only edges going down, with the interior on their right, are in the status.
+// An edge is referred to by its first vertex. Edges don't cross, so testing
+// the upper vertex of the edge that starts lower against the other edge gives
+// their order.
+bool MonotoneTriangulator::isEdgeLeftOf(int a, int b) const
+{
+	if (a == b)
+		return false;
+	else if (b == QUERY)
+		return orient(a, next[a], queryVertex) > 0.0;
+	else if (a == QUERY)
+		return orient(b, next[b], queryVertex) < 0.0;
+
+	if (above(a, b))
+	{
+		double side = orient(a, next[a], b);
+		if (side == 0.0)
+			side = orient(a, next[a], next[b]);
+		return side > 0.0;
+	}
+	else
+	{
+		double side = orient(b, next[b], a);
+		if (side == 0.0)
+			side = orient(b, next[b], next[a]);
+		return side < 0.0;
+	}
+}
+
+bool MonotoneTriangulator::partition()
+{
+	std::vector<int> order(vertices);
+	std::sort(order.begin(), order.end(), [&](int a, int b)
+	{
+		const Vector2 &pa = points[a], &pb = points[b];
+		if (pa.y != pb.y)
+			return pa.y > pb.y;
+		if (pa.x != pb.x)
+			return pa.x < pb.x;
+		return a < b;
+	});
+
+	for (size_t i = 0; i < order.size(); i++)
+		rank[order[i]] = (int) i;
+
+	EdgeSet status(EdgeLess{this});
+	std::vector<EdgeSet::iterator> edges(points.size(), status.end());
+	std::vector<int> helper(points.size(), -1);
+	std::vector<bool> merge(points.size(), false);
+
+	auto addDiagonal = [&](int a, int b)
+	{
+		diagonals.push_back(a);
+		diagonals.push_back(b);
+	};
+
+	auto insertEdge = [&](int e) -> bool
+	{
+		auto result = status.insert(e);
+		edges[e] = result.first;
+		helper[e] = e;
+		return result.second;
+	};
+
+	auto removeEdge = [&](int e, int v) -> bool
+	{
+		if (edges[e] == status.end())
+			return false;
+		if (merge[helper[e]])
+			addDiagonal(v, helper[e]);
+		status.erase(edges[e]);
+		edges[e] = status.end();
+		return true;
+	};
+
+	// Connects v to the helper of the edge directly left of it.
+	auto updateLeftEdge = [&](int v, bool always) -> bool
+	{
+		queryVertex = v;
+		auto it = status.lower_bound(QUERY);
+		if (it == status.begin())
+			return false;
+		int e = *(--it);
+		if (always || merge[helper[e]])
+			addDiagonal(v, helper[e]);
+		helper[e] = v;
+		return true;
+	};
+
+	for (int v : order)
+	{
+		int p = prev[v];
+		int n = next[v];
+		bool reflex = orient(p, v, n) < 0.0;
+
+		if (above(v, p) && above(v, n))
+		{
+			// Split vertices are connected up, start vertices need nothing.
+			if (reflex && !updateLeftEdge(v, true))
+				return false;
+			if (!insertEdge(v))
+				return false;
+		}
+		else if (above(p, v) && above(n, v))
+		{
+			if (!removeEdge(p, v))
+				return false;
+
+			// Merge vertices are connected down later, end vertices need nothing.
+			if (reflex)
+			{
+				merge[v] = true;
+				if (!updateLeftEdge(v, false))
+					return false;
+			}
+		}
+		else if (above(p, v))
+		{
+			// The interior is to the right of v.
+			if (!removeEdge(p, v) || !insertEdge(v))
+				return false;
+		}
+		else if (!updateLeftEdge(v, false))
+			return false;
+	}
+
+	return status.empty();
+}
+
+bool MonotoneTriangulator::triangulateFaces(std::vector<int> &indices)
+{
+	// Half-edges: polygon edges are referred to by their first vertex, and
+	// diagonal i has a half-edge in each direction after them.
+	int edgeCount = (int) points.size();
+	int halfEdgeCount = edgeCount + (int) diagonals.size();
+
+	std::vector<int> origin(halfEdgeCount);
+	std::vector<int> target(halfEdgeCount);
+	for (int v : vertices)
+	{
+		origin[v] = v;
+		target[v] = next[v];
+	}
+	for (size_t i = 0; i < diagonals.size(); i += 2)
+	{
+		int h = edgeCount + (int) i;
+		origin[h] = target[h + 1] = diagonals[i];
+		target[h] = origin[h + 1] = diagonals[i + 1];
+	}
+
+	// Diagonal half-edges grouped by vertex, ordered counter-clockwise from
+	// the polygon edge leaving the vertex.
+	std::vector<int> offsets(points.size() + 1, 0);
+	for (int h = edgeCount; h < halfEdgeCount; h++)
+		offsets[origin[h] + 1]++;
+	for (size_t i = 1; i < offsets.size(); i++)
+		offsets[i] += offsets[i - 1];
+
+	std::vector<int> outgoing(halfEdgeCount - edgeCount);
+	std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+	for (int h = edgeCount; h < halfEdgeCount; h++)
+		outgoing[fill[origin[h]]++] = h;
+
+	std::vector<double> angles(halfEdgeCount, 0.0);
+	for (int h = edgeCount; h < halfEdgeCount; h++)
+	{
+		int v = origin[h];
+		double dx0 = (double) points[next[v]].x - points[v].x;
+		double dy0 = (double) points[next[v]].y - points[v].y;
+		double dx = (double) points[target[h]].x - points[v].x;
+		double dy = (double) points[target[h]].y - points[v].y;
+		double angle = atan2(dx0 * dy - dy0 * dx, dx0 * dx + dy0 * dy);
+		angles[h] = angle < 0.0 ? angle + 2.0 * LOVE_M_PI : angle;
+	}
+
+	// Following the face on the left of a half-edge, the next half-edge is the
+	// one clockwise from its twin at the target vertex.
+	std::vector<int> faceNext(halfEdgeCount, -1);
+	for (int v : vertices)
+	{
+		int *first = outgoing.data() + offsets[v];
+		int *last = outgoing.data() + offsets[v + 1];
+		std::sort(first, last, [&](int a, int b) { return angles[a] < angles[b]; });
+
+		int previous = v;
+		for (int *h = first; h != last; ++h)
+		{
+			int twin = *h + ((*h - edgeCount) % 2 == 0 ? 1 : -1);
+			faceNext[twin] = previous;
+			previous = *h;
+		}
+		faceNext[prev[v]] = previous;
+	}
+
+	std::vector<bool> visited(halfEdgeCount, false);
+	std::vector<int> face;
+
+	for (int start = 0; start < halfEdgeCount; start++)
+	{
+		if (visited[start] || faceNext[start] < 0)
+			continue;
+
+		face.clear();
+		int h = start;
+		do
+		{
+			if (h < 0 || visited[h] || (int) face.size() > halfEdgeCount)
+				return false;
+			visited[h] = true;
+			face.push_back(origin[h]);
+			h = faceNext[h];
+		} while (h != start);
+
+		if (!triangulateMonotone(face, indices))
+			return false;
+	}
+
+	return true;
+}
+
+bool MonotoneTriangulator::triangulateMonotone(const std::vector<int> &face, std::vector<int> &indices)
+{
+	int size = (int) face.size();
+	if (size < 3)
+		return false;
+
+	int top = 0;
+	int bottom = 0;
+	for (int i = 1; i < size; i++)
+	{
+		if (above(face[i], face[top]))
+			top = i;
+		if (above(face[bottom], face[i]))
+			bottom = i;
+	}
+
+	// Merge the chains into sweep order. Going counter-clockwise from the top
+	// follows the left chain down, the rest is the right chain.
+	std::vector<int> sorted;
+	std::vector<bool> left;
+	sorted.reserve(size);
+	left.reserve(size);
+
+	sorted.push_back(face[top]);
+	left.push_back(true);
+
+	int l = (top + 1) % size;
+	int r = (top + size - 1) % size;
+	int lastleft = face[top];
+	int lastright = face[top];
+	for (int i = 1; i < size; i++)
+	{
+		bool takeleft = r == bottom || (l != bottom && above(face[l], face[r]));
+		int v = takeleft ? face[l] : face[r];
+
+		// Each chain must only go down.
+		int &chainlast = takeleft ? lastleft : lastright;
+		if (!above(chainlast, v))
+			return false;
+		chainlast = v;
+
+		sorted.push_back(v);
+		left.push_back(takeleft);
+
+		if (takeleft)
+			l = (l + 1) % size;
+		else
+			r = (r + size - 1) % size;
+	}
+
+	std::vector<int> stack;
+	std::vector<bool> stackleft;
+	stack.reserve(size);
+	stackleft.reserve(size);
+
+	stack.push_back(sorted[0]);
+	stackleft.push_back(left[0]);
+	stack.push_back(sorted[1]);
+	stackleft.push_back(left[1]);
+
+	for (int j = 2; j < size - 1; j++)
+	{
+		int u = sorted[j];
+
+		if (left[j] != stackleft.back())
+		{
+			for (size_t i = 0; i + 1 < stack.size(); i++)
+				addTriangle(u, stack[i], stack[i + 1], indices);
+
+			int last = sorted[j - 1];
+			stack.clear();
+			stackleft.clear();
+			stack.push_back(last);
+			stackleft.push_back(left[j - 1]);
+		}
+		else
+		{
+			int last = stack.back();
+			bool lastleft = stackleft.back();
+			stack.pop_back();
+			stackleft.pop_back();
+
+			while (!stack.empty())
+			{
+				int top = stack.back();
+				double turn = left[j] ? orient(top, last, u) : orient(u, last, top);
+				if (turn <= 0.0)
+					break;
+
+				addTriangle(u, last, top, indices);
+				last = top;
+				lastleft = stackleft.back();
+				stack.pop_back();
+				stackleft.pop_back();
+			}
+
+			stack.push_back(last);
+			stackleft.push_back(lastleft);
+		}
+
+		stack.push_back(u);
+		stackleft.push_back(left[j]);
+	}
+
+	for (size_t i = 0; i + 1 < stack.size(); i++)
+		addTriangle(sorted[size - 1], stack[i], stack[i + 1], indices);
+
+	return true;
+}
+
+void MonotoneTriangulator::addTriangle(int a, int b, int c, std::vector<int> &indices)
+{
+	if (orient(a, b, c) < 0.0)
+		std::swap(b, c);
+
+	indices.push_back(a);
+	indices.push_back(b);
+	indices.push_back(c);
+}
+
+bool MonotoneTriangulator::triangulate(std::vector<int> &indices)
+{
+	if (!valid)
+		return false;
+
+	size_t start = indices.size();
+	if (!partition() || !triangulateFaces(indices))
+	{
+		indices.resize(start);
+		return false;
+	}
+
+	// A polygon with n vertices and h holes always has n + 2h - 2 triangles,
+	// anything else means the edges cross each other.
+	if (indices.size() - start != (vertices.size() + 2 * holeCount - 2) * 3)
+	{
+		indices.resize(start);
+		return false;
+	}
+
+	return true;
+}
+
+// Adds one row of fBm noise to sums, which must hold width values. Octaves
+// are summed one at a time so the noise type is only checked once per octave.
+void fill_noise_row(const love::math::NoiseSettings &s, int y, int z, int width, bool use3D, double *sums, float *out)
+{
+	std::fill(sums, sums + width, 0.0);
+
+	double frequency = s.frequency;
+	double amplitude = 1.0;
+	double totalamplitude = 0.0;
+
+	for (int octave = 0; octave < s.octaves; octave++)
+	{
+		double fy = (y + s.offsetY) * frequency;
+		double fz = (z + s.offsetZ) * frequency;
+
+		if (s.type == love::math::NOISE_PERLIN)
+		{
+			if (use3D)
+			{
+				for (int x = 0; x < width; x++)
+					sums[x] += Noise1234::noise((x + s.offsetX) * frequency, fy, fz) * amplitude;
+			}
+			else
+			{
+				for (int x = 0; x < width; x++)
+					sums[x] += Noise1234::noise((x + s.offsetX) * frequency, fy) * amplitude;
+			}
+		}
+		else
+		{
+			if (use3D)
+			{
+				for (int x = 0; x < width; x++)
+					sums[x] += SimplexNoise1234::noise((x + s.offsetX) * frequency, fy, fz) * amplitude;
+			}
+			else
+			{
+				for (int x = 0; x < width; x++)
+					sums[x] += SimplexNoise1234::noise((x + s.offsetX) * frequency, fy) * amplitude;
+			}
+		}
+
+		totalamplitude += fabs(amplitude);
+		frequency *= s.lacunarity;
+		amplitude *= s.gain;
+	}
+
+	double scale = totalamplitude > 0.0 ? 1.0 / totalamplitude : 0.0;
+
+	for (int x = 0; x < width; x++)
+		out[x] = (float) (sums[x] * scale * 0.5 + 0.5);
+}
+
+} // anonymous namespace
+
+namespace love
+{
+namespace math
+{
+
+std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon)
+{
+	if (polygon.size() < 3)
+		throw love::Exception("Not a polygon");
+
+	std::vector<int> indices;
+	triangulate(polygon, std::vector<int>(1, (int) polygon.size()), indices);
+
+	std::vector<Triangle> triangles;
+	triangles.reserve(indices.size() / 3);
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		triangles.push_back(Triangle(polygon[indices[i]], polygon[indices[i + 1]], polygon[indices[i + 2]]));
 
 	return triangles;
 }
 
+void triangulate(const std::vector<love::Vector2> &points, const std::vector<int> &contourSizes, std::vector<int> &indices)
+{
+	indices.clear();
+
+	size_t total = 0;
+	for (int size : contourSizes)
+	{
+		if (size < 0)
+			throw love::Exception("Invalid polygon contour size: %d", size);
+		total += size;
+	}
+
+	if (contourSizes.empty() || contourSizes[0] < 3 || total != points.size())
+		throw love::Exception("Not a polygon");
+
+	bool holes = false;
+	for (size_t i = 1; i < contourSizes.size(); i++)
+		holes = holes || contourSizes[i] > 0;
+
+	if (!holes)
+	{
+		int count = contourSizes[0];
+
+		if (count == 3 || is_simple_convex(points))
+		{
+			// Every path returns counter-clockwise triangles, whatever the
+			// winding of the input.
+			double area = 0.0;
+			for (int i = 0; i < count; i++)
+			{
+				const Vector2 &a = points[i];
+				const Vector2 &b = points[(i + 1) % count];
+				area += (double) a.x * b.y - (double) b.x * a.y;
+			}
+
+			bool reverse = area < 0.0;
+
+			indices.reserve((count - 2) * 3);
+			for (int i = 1; i + 1 < count; i++)
+			{
+				indices.push_back(0);
+				indices.push_back(reverse ? i + 1 : i);
+				indices.push_back(reverse ? i : i + 1);
+			}
+			return;
+		}
+
+		// Ear clipping is quick enough for small polygons, and copes better
+		// with degenerate ones.
+		if (count <= 32)
+		{
+			triangulate_ear_clipping(points, indices);
+			return;
+		}
+	}
+
+	MonotoneTriangulator triangulator(points, contourSizes);
+	if (triangulator.triangulate(indices))
+		return;
+
+	if (holes)
+		throw love::Exception("Cannot triangulate polygon: holes must lie inside the outline, and edges must not cross.");
+
+	triangulate_ear_clipping(points, indices);
+}
+
 bool isConvex(const std::vector<love::Vector2> &polygon)
 {
 	if (polygon.size() < 3)
@@ -201,6 +852,7 @@ float linearToGamma(float c)
 
 Math::Math()
 	: Module(M_MATH, "love.math")
+	, taskPool(nullptr)
 {
 	RandomGenerator::Seed seed;
 	seed.b64 = (uint64) time(nullptr);
@@ -211,6 +863,7 @@ Math::Math()
 
 Math::~Math()
 {
+	delete taskPool;
 }
 
 RandomGenerator *Math::newRandomGenerator()
@@ -233,5 +886,98 @@ Transform *Math::newTransform(float x, float y, float a, float sx, float sy, flo
 	return new Transform(x, y, a, sx, sy, ox, oy, kx, ky);
 }
 
+thread::TaskPool *Math::getTaskPool()
+{
+	thread::Lock lock(taskPoolMutex);
+	if (taskPool == nullptr)
+		taskPool = new thread::TaskPool(thread::getProcessorCount(), "MathWorker");
+	return taskPool;
+}
+
+static void checkNoiseSettings(const NoiseSettings &settings, int width, int height, int depth)
+{
+	if (width <= 0 || height <= 0 || depth <= 0)
+		throw love::Exception("Noise field dimensions must be greater than 0.");
+
+	if (settings.octaves < 1)
+		throw love::Exception("Noise octave count must be at least 1.");
+}
+
+void Math::fillNoise(const NoiseSettings &settings, int width, int height, int depth, float *dst)
+{
+	checkNoiseSettings(settings, width, height, depth);
+
+	bool use3D = settings.use3D || depth > 1;
+	int rows = height * depth;
+
+	// Keep ranges large enough that waking the workers is worth it.
+	int minrows = settings.threaded ? std::max(1, 4096 / width) : rows;
+
+	getTaskPool()->parallelFor(rows, minrows, [&](int begin, int end, int /*threadIndex*/)
+	{
+		std::vector<double> sums(width);
+
+		for (int row = begin; row < end; row++)
+			fill_noise_row(settings, row % height, row / height, width, use3D, sums.data(), dst + (size_t) row * width);
+	});
+}
+
+void Math::fillNoise(const NoiseSettings &settings, image::ImageData *dst)
+{
+	int width = dst->getWidth();
+	int height = dst->getHeight();
+
+	checkNoiseSettings(settings, width, height, 1);
+
+	auto setpixel = dst->getPixelSetFunction();
+	if (setpixel == nullptr)
+		throw love::Exception("Cannot fill ImageData with noise: the %s pixel format is not supported.", getPixelFormatName(dst->getFormat()));
+
+	uint8 *data = (uint8 *) dst->getData();
+	size_t pixelsize = dst->getPixelSize();
+	int minrows = settings.threaded ? std::max(1, 4096 / width) : height;
+
+	getTaskPool()->parallelFor(height, minrows, [&](int begin, int end, int /*threadIndex*/)
+	{
+		std::vector<double> sums(width);
+		std::vector<float> values(width);
+
+		for (int y = begin; y < end; y++)
+		{
+			fill_noise_row(settings, y, 0, width, settings.use3D, sums.data(), values.data());
+
+			uint8 *row = data + (size_t) y * width * pixelsize;
+			for (int x = 0; x < width; x++)
+			{
+				Colorf c(values[x], values[x], values[x], 1.0f);
+				setpixel(c, (image::ImageData::Pixel *) (row + x * pixelsize));
+			}
+		}
+	});
+}
+
+bool Math::getConstant(const char *in, NoiseType &out)
+{
+	return noiseTypes.find(in, out);
+}
+
+bool Math::getConstant(NoiseType in, const char *&out)
+{
+	return noiseTypes.find(in, out);
+}
+
+std::vector<std::string> Math::getConstants(NoiseType)
+{
+	return noiseTypes.getNames();
+}
+
+StringMap<NoiseType, NOISE_MAX_ENUM>::Entry Math::noiseTypeEntries[] =
+{
+	{ "simplex", NOISE_SIMPLEX },
+	{ "perlin",  NOISE_PERLIN  },
+};
+
+StringMap<NoiseType, NOISE_MAX_ENUM> Math::noiseTypes(Math::noiseTypeEntries, sizeof(Math::noiseTypeEntries));
+
 } // math
 } // love
@@ -28,22 +28,68 @@
 #include "common/math.h"
 #include "common/Vector.h"
 #include "common/int.h"
+#include "common/StringMap.h"
+#include "thread/threads.h"
 
 // Noise
 #include "libraries/noise1234/noise1234.h"
 #include "libraries/noise1234/simplexnoise1234.h"
 
 // STL
+#include <string>
 #include <vector>
 
 namespace love
 {
+
+namespace thread
+{
+class TaskPool;
+}
+
+namespace image
+{
+class ImageData;
+}
+
 namespace math
 {
 
 class BezierCurve;
 class Transform;
 
+enum NoiseType
+{
+	NOISE_SIMPLEX,
+	NOISE_PERLIN,
+	NOISE_MAX_ENUM
+};
+
+/**
+ * Parameters for filling a grid with fractal (fBm) noise. Sample (x, y, z) of
+ * the grid reads the noise at ((x + offsetX) * frequency, ...) in the first
+ * octave. Each further octave multiplies the frequency by lacunarity and the
+ * amplitude by gain. The sum is normalized to [0, 1], so a single octave gives
+ * the same values as the simplexNoise and perlinNoise functions.
+ **/
+struct NoiseSettings
+{
+	NoiseType type = NOISE_SIMPLEX;
+	double frequency = 1.0 / 32.0;
+	int octaves = 1;
+	double lacunarity = 2.0;
+	double gain = 0.5;
+	double offsetX = 0.0;
+	double offsetY = 0.0;
+	double offsetZ = 0.0;
+
+	// Use 3D noise even for a single layer, to take a slice at offsetZ.
+	bool use3D = false;
+
+	// Split rows across the Math module's worker threads.
+	bool threaded = true;
+};
+
 struct Triangle
 {
 	Triangle(const Vector2 &x, const Vector2 &y, const Vector2 &z)
@@ -60,6 +106,18 @@ struct Triangle
  **/
 std::vector<Triangle> triangulate(const std::vector<love::Vector2> &polygon);
 
+/**
+ * Triangulate a polygon with holes. Convex and small polygons are split
+ * directly, others are split into monotone pieces by a sweep line, which takes
+ * O(n log n) time.
+ *
+ * @param points The vertices of the outline, followed by those of each hole.
+ * @param contourSizes The number of vertices in the outline and in each hole.
+ * @param indices Cleared, then receives three indices into points for each
+ *        triangle. Its memory can be reused between calls.
+ **/
+void triangulate(const std::vector<love::Vector2> &points, const std::vector<int> &contourSizes, std::vector<int> &indices);
+
 /**
  * Checks whether a polygon is convex.
  *
@@ -118,8 +176,32 @@ class Math : public Module
 	Transform *newTransform();
 	Transform *newTransform(float x, float y, float a, float sx, float sy, float ox, float oy, float kx, float ky);
 
+	/**
+	 * Fills a width x height x depth grid of floats with noise, one row after
+	 * another and one layer after another.
+	 **/
+	void fillNoise(const NoiseSettings &settings, int width, int height, int depth, float *dst);
+
+	/**
+	 * Fills every pixel of an ImageData with grayscale noise and an alpha of
+	 * 1, using the pixel format's conversion.
+	 **/
+	void fillNoise(const NoiseSettings &settings, image::ImageData *dst);
+
+	static bool getConstant(const char *in, NoiseType &out);
+	static bool getConstant(NoiseType in, const char *&out);
+	static std::vector<std::string> getConstants(NoiseType);
+
 private:
 
+	thread::TaskPool *getTaskPool();
+
+	thread::TaskPool *taskPool;
+	thread::MutexRef taskPoolMutex;
+
+	static StringMap<NoiseType, NOISE_MAX_ENUM>::Entry noiseTypeEntries[];
+	static StringMap<NoiseType, NOISE_MAX_ENUM> noiseTypes;
+
 	// All love objects accessible in Lua should be heap-allocated,
 	// to guarantee a minimum pointer alignment.
 	StrongRef<RandomGenerator> rng;
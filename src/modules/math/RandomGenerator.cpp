@@ -90,6 +90,119 @@ double RandomGenerator::randomNormal(double stddev)
 	return r * sin(phi) * stddev;
 }
 
+template <typename T>
+static void fillUniformT(RandomGenerator &rng, T *dst, size_t count, double min, double max)
+{
+	for (size_t i = 0; i < count; i++)
+		dst[i] = (T) rng.random(min, max);
+}
+
+template <typename T>
+static void fillNormalT(RandomGenerator &rng, T *dst, size_t count, double stddev, double mean)
+{
+	for (size_t i = 0; i < count; i++)
+		dst[i] = (T) (rng.randomNormal(stddev) + mean);
+}
+
+template <typename T>
+static void fillIntegerT(RandomGenerator &rng, T *dst, size_t count, double min, double max)
+{
+	double range = max - min + 1.0;
+	for (size_t i = 0; i < count; i++)
+		dst[i] = (T) (floor(rng.random() * range) + min);
+}
+
+void RandomGenerator::fillUniform(float *dst, size_t count, double min, double max)
+{
+	fillUniformT(*this, dst, count, min, max);
+}
+
+void RandomGenerator::fillUniform(double *dst, size_t count, double min, double max)
+{
+	fillUniformT(*this, dst, count, min, max);
+}
+
+void RandomGenerator::fillNormal(float *dst, size_t count, double stddev, double mean)
+{
+	fillNormalT(*this, dst, count, stddev, mean);
+}
+
+void RandomGenerator::fillNormal(double *dst, size_t count, double stddev, double mean)
+{
+	fillNormalT(*this, dst, count, stddev, mean);
+}
+
+void RandomGenerator::fillInteger(int32 *dst, size_t count, double min, double max)
+{
+	fillIntegerT(*this, dst, count, min, max);
+}
+
+void RandomGenerator::fillInteger(double *dst, size_t count, double min, double max)
+{
+	fillIntegerT(*this, dst, count, min, max);
+}
+
+// The xorshift state update is linear over GF(2), so advancing it by n steps
+// is a multiplication with the n-th power of its 64x64 bit matrix. Columns
+// are stored as words: column j is the update applied to a state of 1 << j.
+struct XorshiftMatrix
+{
+	uint64 columns[64];
+
+	uint64 apply(uint64 state) const
+	{
+		uint64 result = 0;
+		for (int j = 0; state != 0; j++, state >>= 1)
+		{
+			if (state & 1)
+				result ^= columns[j];
+		}
+		return result;
+	}
+};
+
+static const XorshiftMatrix &getJumpMatrix()
+{
+	static const XorshiftMatrix jumpmatrix = []()
+	{
+		XorshiftMatrix m;
+		for (int j = 0; j < 64; j++)
+		{
+			uint64 s = 1ULL << j;
+			s ^= (s >> 12);
+			s ^= (s << 25);
+			s ^= (s >> 27);
+			m.columns[j] = s;
+		}
+
+		// Square 48 times to get the matrix for 2^48 steps.
+		for (int i = 0; i < 48; i++)
+		{
+			XorshiftMatrix squared;
+			for (int j = 0; j < 64; j++)
+				squared.columns[j] = m.apply(m.columns[j]);
+			m = squared;
+		}
+
+		return m;
+	}();
+
+	return jumpmatrix;
+}
+
+void RandomGenerator::jump()
+{
+	rng_state.b64 = getJumpMatrix().apply(rng_state.b64);
+	last_randomnormal = std::numeric_limits<double>::infinity();
+}
+
+RandomGenerator *RandomGenerator::split()
+{
+	RandomGenerator *stream = new RandomGenerator(*this);
+	jump();
+	return stream;
+}
+
 void RandomGenerator::setSeed(RandomGenerator::Seed newseed)
 {
 	seed = newseed;
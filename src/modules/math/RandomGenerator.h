@@ -112,6 +112,33 @@ class RandomGenerator : public Object
 	 **/
 	double randomNormal(double stddev);
 
+	/**
+	 * Fill an array with floats from random(min, max), i.e.
+	 * random() * (max - min) + min, with randomNormal(stddev) + mean, or with
+	 * integers from floor(random() * (max - min + 1)) + min. Only the latter
+	 * matches the integers returned by random(min, max) in Lua. The generator
+	 * ends up in the same state as when called count times.
+	 **/
+	void fillUniform(float *dst, size_t count, double min, double max);
+	void fillUniform(double *dst, size_t count, double min, double max);
+	void fillNormal(float *dst, size_t count, double stddev, double mean);
+	void fillNormal(double *dst, size_t count, double stddev, double mean);
+	void fillInteger(int32 *dst, size_t count, double min, double max);
+	void fillInteger(double *dst, size_t count, double min, double max);
+
+	/**
+	 * Advance the generator by 2^48 numbers, as if rand() was called that
+	 * many times. The skipped numbers can be generated by a copy made before
+	 * the jump, giving up to 65536 non-overlapping streams from one seed.
+	 **/
+	void jump();
+
+	/**
+	 * Create a generator which continues from the current state, then jump()
+	 * this one past the numbers the new generator will use.
+	 **/
+	RandomGenerator *split();
+
 	/**
 	 * Set pseudo-random seed.
 	 * It's up to the implementation how to use this.
@@ -20,8 +20,10 @@
 
 #include "common/Exception.h"
 #include "wrap_BezierCurve.h"
+#include "common/Data.h"
 
 #include <cmath>
+#include <cstring>
 
 namespace love
 {
@@ -157,6 +159,71 @@ int w_BezierCurve_evaluate(lua_State *L)
 
 }
 
+// Writes points as float pairs into the Data at idx and pushes the point
+// count, or pushes them as a flat table of coordinates if there's no Data.
+static int pushPoints(lua_State *L, const std::vector<Vector2> &points, int idx)
+{
+	if (!lua_isnoneornil(L, idx))
+	{
+		Data *data = luax_checktype<Data>(L, idx);
+		size_t size = points.size() * sizeof(Vector2);
+
+		if (size > data->getSize())
+			return luaL_error(L, "Data is too small to hold %d points (%d bytes needed).", (int) points.size(), (int) size);
+
+		if (size > 0)
+			memcpy(data->getData(), points.data(), size);
+
+		lua_pushinteger(L, (lua_Integer) points.size());
+		return 1;
+	}
+
+	lua_createtable(L, (int) points.size() * 2, 0);
+	for (int i = 0; i < (int) points.size(); ++i)
+	{
+		lua_pushnumber(L, points[i].x);
+		lua_rawseti(L, -2, 2*i+1);
+		lua_pushnumber(L, points[i].y);
+		lua_rawseti(L, -2, 2*i+2);
+	}
+
+	return 1;
+}
+
+int w_BezierCurve_evaluateMany(lua_State *L)
+{
+	BezierCurve *curve = luax_checkbeziercurve(L, 1);
+
+	// Either a table of parameters, or a number of evenly spaced ones.
+	std::vector<double> t;
+	if (lua_istable(L, 2))
+	{
+		int count = (int) luax_objlen(L, 2);
+		t.resize(count);
+		for (int i = 0; i < count; i++)
+		{
+			lua_rawgeti(L, 2, i + 1);
+			t[i] = luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+	}
+	else
+	{
+		int count = (int) luaL_checkinteger(L, 2);
+		if (count < 1)
+			return luaL_argerror(L, 2, "count must be at least 1");
+
+		t.resize(count);
+		for (int i = 0; i < count; i++)
+			t[i] = count > 1 ? (double) i / (count - 1) : 0.0;
+	}
+
+	std::vector<Vector2> points(t.size());
+	luax_catchexcept(L, [&](){ curve->evaluate(t.data(), t.size(), points.data()); });
+
+	return pushPoints(L, points, 3);
+}
+
 int w_BezierCurve_getSegment(lua_State *L)
 {
 	BezierCurve *curve = luax_checkbeziercurve(L, 1);
@@ -213,6 +280,17 @@ int w_BezierCurve_renderSegment(lua_State *L)
 	return 1;
 }
 
+int w_BezierCurve_renderAdaptive(lua_State *L)
+{
+	BezierCurve *curve = luax_checkbeziercurve(L, 1);
+	float tolerance = (float) luaL_optnumber(L, 2, 0.25);
+
+	std::vector<Vector2> points;
+	luax_catchexcept(L, [&](){ curve->renderAdaptive(tolerance, points); });
+
+	return pushPoints(L, points, 3);
+}
+
 static const luaL_Reg w_BezierCurve_functions[] =
 {
 	{ "get_degree", w_BezierCurve_getDegree },
@@ -226,9 +304,11 @@ static const luaL_Reg w_BezierCurve_functions[] =
 	{"rotate", w_BezierCurve_rotate},
 	{"scale", w_BezierCurve_scale},
 	{"evaluate", w_BezierCurve_evaluate},
+	{ "evaluate_many", w_BezierCurve_evaluateMany },
 	{ "get_segment", w_BezierCurve_getSegment },
 	{"render", w_BezierCurve_render},
 	{ "render_segment", w_BezierCurve_renderSegment },
+	{ "render_adaptive", w_BezierCurve_renderAdaptive },
 	{ 0, 0 }
 };
 
@@ -25,10 +25,14 @@
 #include "MathModule.h"
 #include "BezierCurve.h"
 #include "Transform.h"
+#include "common/Data.h"
+#include "data/ByteData.h"
+#include "image/ImageData.h"
 
 #include <cmath>
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
 // Put the Lua code directly into a raw string literal.
 static const char math_lua[] =
@@ -120,6 +124,58 @@ int w_newBezierCurve(lua_State *L)
 	return 1;
 }
 
+int w_renderCurves(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	float tolerance = (float) luaL_optnumber(L, 2, 0.25);
+
+	int curvecount = (int) luax_objlen(L, 1);
+	std::vector<Vector2> points;
+
+	lua_createtable(L, curvecount, 0);
+
+	for (int i = 1; i <= curvecount; i++)
+	{
+		lua_rawgeti(L, 1, i);
+		BezierCurve *curve = luax_checkbeziercurve(L, -1);
+		lua_pop(L, 1);
+
+		size_t start = points.size();
+		luax_catchexcept(L, [&]() { curve->renderAdaptive(tolerance, points); });
+
+		lua_pushinteger(L, (lua_Integer) (points.size() - start));
+		lua_rawseti(L, -2, i);
+	}
+
+	size_t size = points.size() * sizeof(Vector2);
+
+	// Existing ByteData can be reused to avoid an allocation every frame.
+	love::data::ByteData *data = nullptr;
+	if (!lua_isnoneornil(L, 3))
+	{
+		data = luax_checktype<love::data::ByteData>(L, 3);
+		if (data->getSize() < size)
+			return luaL_error(L, "ByteData is too small to hold %d points (%d bytes needed).", (int) points.size(), (int) size);
+		data->retain();
+	}
+	else
+		luax_catchexcept(L, [&]() { data = new love::data::ByteData(std::max(size, sizeof(Vector2)), false); });
+
+	if (size > 0)
+		memcpy(data->getData(), points.data(), size);
+
+	luax_pushtype(L, data);
+	data->release();
+
+	lua_pushinteger(L, (lua_Integer) points.size());
+
+	// Move the per-curve counts after the data and the total.
+	lua_pushvalue(L, -3);
+	lua_remove(L, -4);
+
+	return 3;
+}
+
 int w_newTransform(lua_State *L)
 {
 	Transform *t = nullptr;
@@ -145,24 +201,47 @@ int w_newTransform(lua_State *L)
 	return 1;
 }
 
+static void checkPolygonTable(lua_State *L, int idx, std::vector<love::Vector2> &vertices)
+{
+	int top = (int) luax_objlen(L, idx);
+	vertices.reserve(vertices.size() + top / 2);
+	for (int i = 1; i <= top; i += 2)
+	{
+		lua_rawgeti(L, idx, i);
+		lua_rawgeti(L, idx, i+1);
+
+		Vector2 v;
+		v.x = (float) luaL_checknumber(L, -2);
+		v.y = (float) luaL_checknumber(L, -1);
+		vertices.push_back(v);
+
+		lua_pop(L, 2);
+	}
+}
+
 int w_triangulate(lua_State *L)
 {
 	std::vector<love::Vector2> vertices;
+	std::vector<int> contours;
 	if (lua_istable(L, 1))
 	{
-		int top = (int) luax_objlen(L, 1);
-		vertices.reserve(top / 2);
-		for (int i = 1; i <= top; i += 2)
-		{
-			lua_rawgeti(L, 1, i);
-			lua_rawgeti(L, 1, i+1);
+		checkPolygonTable(L, 1, vertices);
+		contours.push_back((int) vertices.size());
 
-			Vector2 v;
-			v.x = (float) luaL_checknumber(L, -2);
-			v.y = (float) luaL_checknumber(L, -1);
-			vertices.push_back(v);
-
-			lua_pop(L, 2);
+		// Optional list of holes, each a list of vertices.
+		if (!lua_isnoneornil(L, 2))
+		{
+			luaL_checktype(L, 2, LUA_TTABLE);
+			int holecount = (int) luax_objlen(L, 2);
+			for (int i = 1; i <= holecount; i++)
+			{
+				lua_rawgeti(L, 2, i);
+				luaL_checktype(L, -1, LUA_TTABLE);
+				size_t start = vertices.size();
+				checkPolygonTable(L, lua_gettop(L), vertices);
+				contours.push_back((int) (vertices.size() - start));
+				lua_pop(L, 1);
+			}
 		}
 	}
 	else
@@ -176,38 +255,28 @@ int w_triangulate(lua_State *L)
 			v.y = (float) luaL_checknumber(L, i+1);
 			vertices.push_back(v);
 		}
+		contours.push_back((int) vertices.size());
 	}
 
-	if (vertices.size() < 3)
-		return luaL_error(L, "Need at least 3 vertices to triangulate (got %d).", (int)vertices.size());
+	if (contours[0] < 3)
+		return luaL_error(L, "Need at least 3 vertices to triangulate (got %d).", contours[0]);
 
-	std::vector<Triangle> triangles;
+	std::vector<int> indices;
+	luax_catchexcept(L, [&]() { triangulate(vertices, contours, indices); });
 
-	luax_catchexcept(L, [&]() {
-		if (vertices.size() == 3)
-			triangles.push_back(Triangle(vertices[0], vertices[1], vertices[2]));
-		else
-			triangles = triangulate(vertices);
-	});
-
-	lua_createtable(L, (int) triangles.size(), 0);
-	for (int i = 0; i < (int) triangles.size(); ++i)
+	int count = (int) indices.size() / 3;
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; ++i)
 	{
-		const Triangle &tri = triangles[i];
-
 		lua_createtable(L, 6, 0);
-		lua_pushnumber(L, tri.a.x);
-		lua_rawseti(L, -2, 1);
-		lua_pushnumber(L, tri.a.y);
-		lua_rawseti(L, -2, 2);
-		lua_pushnumber(L, tri.b.x);
-		lua_rawseti(L, -2, 3);
-		lua_pushnumber(L, tri.b.y);
-		lua_rawseti(L, -2, 4);
-		lua_pushnumber(L, tri.c.x);
-		lua_rawseti(L, -2, 5);
-		lua_pushnumber(L, tri.c.y);
-		lua_rawseti(L, -2, 6);
+		for (int j = 0; j < 3; j++)
+		{
+			const Vector2 &v = vertices[indices[i * 3 + j]];
+			lua_pushnumber(L, v.x);
+			lua_rawseti(L, -2, j * 2 + 1);
+			lua_pushnumber(L, v.y);
+			lua_rawseti(L, -2, j * 2 + 2);
+		}
 
 		lua_rawseti(L, -2, i+1);
 	}
@@ -408,6 +477,76 @@ int w_simplexNoise(lua_State* L)
 	return 1;
 }
 
+static void checkNoiseSettings(lua_State *L, int idx, NoiseSettings &settings)
+{
+	if (lua_isnoneornil(L, idx))
+		return;
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+
+	lua_getfield(L, idx, "type");
+	if (!lua_isnoneornil(L, -1))
+	{
+		const char *str = luaL_checkstring(L, -1);
+		if (!Math::getConstant(str, settings.type))
+			luax_enumerror(L, "noise type", Math::getConstants(settings.type), str);
+	}
+	lua_pop(L, 1);
+
+	settings.frequency = luax_numberflag(L, idx, "frequency", settings.frequency);
+	settings.octaves = luax_intflag(L, idx, "octaves", settings.octaves);
+	settings.lacunarity = luax_numberflag(L, idx, "lacunarity", settings.lacunarity);
+	settings.gain = luax_numberflag(L, idx, "gain", settings.gain);
+	settings.offsetX = luax_numberflag(L, idx, "x", settings.offsetX);
+	settings.offsetY = luax_numberflag(L, idx, "y", settings.offsetY);
+	settings.threaded = luax_boolflag(L, idx, "threaded", settings.threaded);
+
+	lua_getfield(L, idx, "z");
+	if (!lua_isnoneornil(L, -1))
+	{
+		settings.offsetZ = luaL_checknumber(L, -1);
+		settings.use3D = true;
+	}
+	lua_pop(L, 1);
+}
+
+int w_fillNoise(lua_State *L)
+{
+	NoiseSettings settings;
+
+	if (luax_istype(L, 1, love::image::ImageData::type))
+	{
+		love::image::ImageData *t = luax_checktype<love::image::ImageData>(L, 1);
+		checkNoiseSettings(L, 2, settings);
+		luax_catchexcept(L, [&]() { instance()->fillNoise(settings, t); });
+		return 0;
+	}
+
+	love::Data *data = luax_checktype<love::Data>(L, 1);
+	int width = (int) luaL_checkinteger(L, 2);
+	int height = (int) luaL_checkinteger(L, 3);
+
+	int depth = 1;
+	int settingsidx = 4;
+	if (lua_isnumber(L, 4))
+	{
+		depth = (int) luaL_checkinteger(L, 4);
+		settingsidx = 5;
+	}
+
+	checkNoiseSettings(L, settingsidx, settings);
+
+	if (width <= 0 || height <= 0 || depth <= 0)
+		return luaL_error(L, "Noise field dimensions must be greater than 0.");
+
+	size_t size = (size_t) width * height * depth * sizeof(float);
+	if (size > data->getSize())
+		return luaL_error(L, "Data is too small for a %dx%dx%d noise field (needs %d bytes).", width, height, depth, (int) size);
+
+	luax_catchexcept(L, [&]() { instance()->fillNoise(settings, width, height, depth, (float *) data->getData()); });
+	return 0;
+}
+
 // C functions in a struct, necessary for the FFI versions of math functions.
 struct FFI_Math
 {
@@ -448,6 +587,7 @@ static const luaL_Reg functions[] =
 	{ "_get_random_generator", w__getRandomGenerator },
 	{ "new_random_generator", w_newRandomGenerator },
 	{ "new_bezier_curve", w_newBezierCurve },
+	{ "render_curves", w_renderCurves },
 	{ "new_transform", w_newTransform },
 	{ "triangulate", w_triangulate },
 	{ "is_convex", w_isConvex },
@@ -456,6 +596,7 @@ static const luaL_Reg functions[] =
 	{ "noise", w_noise },
 	{ "perlin_noise", w_perlinNoise },
 	{ "simplex_noise", w_simplexNoise },
+	{ "fill_noise", w_fillNoise },
 
 	{ 0, 0 }
 };
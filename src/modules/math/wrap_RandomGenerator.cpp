@@ -19,9 +19,11 @@
  **/
 
 #include "wrap_RandomGenerator.h"
+#include "common/Data.h"
 
 #include <cmath>
 #include <algorithm>
+#include <vector>
 
 // Put the Lua code directly into a raw string literal.
 static const char randomgenerator_lua[] =
@@ -85,6 +87,117 @@ int w_RandomGenerator_randomNormal(lua_State *L)
 	return 1;
 }
 
+enum RandomFillType
+{
+	RANDOM_FILL_UNIFORM,
+	RANDOM_FILL_NORMAL,
+	RANDOM_FILL_INTEGER,
+};
+
+// Fills the table or Data at index 2 with the number of values at index 3.
+// Data receives floats, or 32 bit integers for RANDOM_FILL_INTEGER.
+static int fillRandom(lua_State *L, RandomGenerator *rng, RandomFillType type, double a, double b)
+{
+	lua_Integer count = luaL_checkinteger(L, 3);
+	if (count < 0)
+		return luaL_argerror(L, 3, "count must not be negative");
+
+	if (lua_istable(L, 2))
+	{
+		std::vector<double> values;
+		luax_catchexcept(L, [&]() { values.resize((size_t) count); });
+
+		if (type == RANDOM_FILL_UNIFORM)
+			rng->fillUniform(values.data(), values.size(), a, b);
+		else if (type == RANDOM_FILL_NORMAL)
+			rng->fillNormal(values.data(), values.size(), a, b);
+		else
+			rng->fillInteger(values.data(), values.size(), a, b);
+
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			lua_pushnumber(L, values[i]);
+			lua_rawseti(L, 2, (int) i + 1);
+		}
+	}
+	else
+	{
+		Data *data = luax_checktype<Data>(L, 2);
+		size_t elementsize = type == RANDOM_FILL_INTEGER ? sizeof(int32) : sizeof(float);
+
+		if ((size_t) count > data->getSize() / elementsize)
+			return luaL_error(L, "Data is too small for %d random values.", (int) count);
+
+		if (type == RANDOM_FILL_UNIFORM)
+			rng->fillUniform((float *) data->getData(), (size_t) count, a, b);
+		else if (type == RANDOM_FILL_NORMAL)
+			rng->fillNormal((float *) data->getData(), (size_t) count, a, b);
+		else
+			rng->fillInteger((int32 *) data->getData(), (size_t) count, a, b);
+	}
+
+	lua_pushvalue(L, 2);
+	return 1;
+}
+
+int w_RandomGenerator_fillUniform(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+	double min = luaL_optnumber(L, 4, 0.0);
+	double max = luaL_optnumber(L, 5, 1.0);
+	return fillRandom(L, rng, RANDOM_FILL_UNIFORM, min, max);
+}
+
+int w_RandomGenerator_fillNormal(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+	double stddev = luaL_optnumber(L, 4, 1.0);
+	double mean = luaL_optnumber(L, 5, 0.0);
+	return fillRandom(L, rng, RANDOM_FILL_NORMAL, stddev, mean);
+}
+
+int w_RandomGenerator_fillInteger(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+
+	// Same arguments as random(max) and random(min, max).
+	double min = 1.0;
+	double max = luaL_checknumber(L, 4);
+	if (!lua_isnoneornil(L, 5))
+	{
+		min = max;
+		max = luaL_checknumber(L, 5);
+	}
+
+	return fillRandom(L, rng, RANDOM_FILL_INTEGER, min, max);
+}
+
+int w_RandomGenerator_jump(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+	rng->jump();
+	return 0;
+}
+
+int w_RandomGenerator_split(lua_State *L)
+{
+	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
+	int count = (int) luaL_optinteger(L, 2, 1);
+	if (count < 1)
+		return luaL_argerror(L, 2, "count must be at least 1");
+
+	luaL_checkstack(L, count, nullptr);
+
+	for (int i = 0; i < count; i++)
+	{
+		RandomGenerator *stream = rng->split();
+		luax_pushtype(L, stream);
+		stream->release();
+	}
+
+	return count;
+}
+
 int w_RandomGenerator_setSeed(lua_State *L)
 {
 	RandomGenerator *rng = luax_checkrandomgenerator(L, 1);
@@ -141,6 +254,11 @@ static const luaL_Reg w_RandomGenerator_functions[] =
 {
 	{ "_random", w_RandomGenerator__random }, // random() is defined in wrap_RandomGenerator.lua.
 	{ "random_normal", w_RandomGenerator_randomNormal },
+	{ "fill_uniform", w_RandomGenerator_fillUniform },
+	{ "fill_normal", w_RandomGenerator_fillNormal },
+	{ "fill_integer", w_RandomGenerator_fillInteger },
+	{ "jump", w_RandomGenerator_jump },
+	{ "split", w_RandomGenerator_split },
 	{ "set_seed", w_RandomGenerator_setSeed },
 	{ "get_seed", w_RandomGenerator_getSeed },
 	{ "set_state", w_RandomGenerator_setState },
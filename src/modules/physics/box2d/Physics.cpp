@@ -23,6 +23,12 @@
 // LOVE
 #include "common/math.h"
 #include "wrap_Body.h"
+#include "TaskPool.h"
+
+// STL
+#include <algorithm>
+#include <exception>
+#include <unordered_set>
 
 namespace love
 {
@@ -37,12 +43,14 @@ float Physics::meter = Physics::DEFAULT_METER;
 Physics::Physics()
 	: Module(M_PHYSICS, "love.physics.box2d")
 	, blockAllocator()
+	, worldPool(nullptr)
 {
 	meter = DEFAULT_METER;
 }
 
 Physics::~Physics()
 {
+	delete worldPool;
 }
 
 World *Physics::newWorld(float gx, float gy, bool sleep)
@@ -50,6 +58,97 @@ World *Physics::newWorld(float gx, float gy, bool sleep)
 	return new World(b2Vec2(gx, gy), sleep);
 }
 
+// Updates a range of Worlds with deferred callbacks.
+class WorldUpdateTask : public b2Task
+{
+public:
+
+	WorldUpdateTask(const std::vector<World *> &worlds, float dt, int velocityIterations, int positionIterations)
+		: worlds(worlds)
+		, errors(worlds.size())
+		, dt(dt)
+		, velocityIterations(velocityIterations)
+		, positionIterations(positionIterations)
+	{}
+
+	void Execute(int32 begin, int32 end, int32 /*threadIndex*/) override
+	{
+		for (int32 i = begin; i < end; i++)
+		{
+			try
+			{
+				worlds[i]->updateDeferred(dt, velocityIterations, positionIterations);
+			}
+			catch (...)
+			{
+				errors[i] = std::current_exception();
+			}
+		}
+	}
+
+	const std::vector<World *> &worlds;
+	std::vector<std::exception_ptr> errors;
+
+private:
+
+	float dt;
+	int velocityIterations;
+	int positionIterations;
+};
+
+void Physics::updateWorlds(const std::vector<World *> &worlds, float dt, int velocityIterations, int positionIterations)
+{
+	std::unordered_set<World *> unique;
+	std::vector<World *> deferred;
+
+	for (World *world : worlds)
+	{
+		if (!unique.insert(world).second)
+			throw love::Exception("The same World cannot be updated twice at once.");
+
+		if (world->isLocked())
+			throw love::Exception("Cannot update a World during its own time step.");
+	}
+
+	// Contact filters and presolve callbacks have to run during the step.
+	for (World *world : worlds)
+	{
+		if (world->canDeferCallbacks())
+			deferred.push_back(world);
+		else
+			world->update(dt, velocityIterations, positionIterations);
+	}
+
+	if (deferred.empty())
+		return;
+
+	TaskPool *pool = nullptr;
+	if (deferred.size() > 1)
+	{
+		thread::Lock lock(worldPoolMutex);
+		if (worldPool == nullptr)
+			worldPool = new TaskPool(thread::getProcessorCount());
+		pool = worldPool;
+	}
+
+	WorldUpdateTask task(deferred, dt, velocityIterations, positionIterations);
+
+	if (pool != nullptr)
+		pool->ParallelFor((int32) deferred.size(), 1, &task);
+	else
+		task.Execute(0, (int32) deferred.size(), 0);
+
+	for (World *world : deferred)
+		world->dispatchDeferredCallbacks();
+
+	// Errors from worker threads are rethrown on this one.
+	for (const std::exception_ptr &error : task.errors)
+	{
+		if (error)
+			std::rethrow_exception(error);
+	}
+}
+
 Body *Physics::newBody(World *world, float x, float y, Body::Type type)
 {
 	return new Body(world, b2Vec2(x, y), type);
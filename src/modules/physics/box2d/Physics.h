@@ -24,6 +24,7 @@
 // LOVE
 #include "common/Module.h"
 #include "common/Vector.h"
+#include "thread/threads.h"
 
 #include "World.h"
 #include "Contact.h"
@@ -53,6 +54,8 @@ namespace physics
 namespace box2d
 {
 
+class TaskPool;
+
 class Physics : public Module
 {
 public:
@@ -73,6 +76,14 @@ class Physics : public Module
 	 **/
 	World *newWorld(float gx, float gy, bool sleep);
 
+	/**
+	 * Updates several independent Worlds one timestep, in parallel. Worlds
+	 * which can't defer their callbacks are updated on the calling thread
+	 * first. The deferred callbacks of the other Worlds are called afterwards,
+	 * in the order the Worlds are given.
+	 **/
+	void updateWorlds(const std::vector<World *> &worlds, float dt, int velocityIterations, int positionIterations);
+
 	/**
 	 * Creates a new Body at the specified position.
 	 * @param world The world to create the Body in.
@@ -392,6 +403,10 @@ class Physics : public Module
 
 	b2BlockAllocator blockAllocator;
 
+	// Threads for updateWorlds, created on first use.
+	TaskPool *worldPool;
+	love::thread::MutexRef worldPoolMutex;
+
 }; // Physics
 
 } // box2d
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_PHYSICS_BOX2D_TASK_POOL_H
+#define LOVE_PHYSICS_BOX2D_TASK_POOL_H
+
+// LOVE
+#include "thread/TaskPool.h"
+
+// Box2D
+#include <box2d/Box2D.h>
+
+namespace love
+{
+namespace physics
+{
+namespace box2d
+{
+
+/**
+ * Runs the parallel parts of a Box2D time step on a thread::TaskPool.
+ **/
+class TaskPool : public b2TaskExecutor
+{
+public:
+
+	/**
+	 * @param threadCount The total number of threads working on a task,
+	 * including the calling thread.
+	 **/
+	TaskPool(int threadCount);
+	virtual ~TaskPool();
+
+	// Implements b2TaskExecutor.
+	int32 GetThreadCount() const override;
+	void ParallelFor(int32 count, int32 minRange, b2Task *task) override;
+
+private:
+
+	thread::TaskPool pool;
+
+}; // TaskPool
+
+} // box2d
+} // physics
+} // love
+
+#endif // LOVE_PHYSICS_BOX2D_TASK_POOL_H
@@ -20,10 +20,17 @@
 
 #include "World.h"
 
+#include "Body.h"
 #include "Shape.h"
 #include "Contact.h"
 #include "Physics.h"
+#include "TaskPool.h"
 #include "common/Reference.h"
+#include "common/trace.h"
+
+// STD
+#include <algorithm>
+#include <limits>
 
 // Needed for World::getJoints. It should be moved to wrapper code...
 #include "wrap_Joint.h"
@@ -56,25 +63,10 @@ void World::ContactCallback::process(b2Contact *contact, const b2ContactImpulse
 	// Process contacts.
 	if (ref != nullptr && L != nullptr)
 	{
-		ref->push(L);
-
-		// Push first shape.
-		{
-			Shape *a = (Shape *)(contact->GetFixtureA()->GetUserData().pointer);
-			if (a != nullptr)
-				luax_pushshape(L, a);
-			else
-				throw love::Exception("A Shape has escaped Memoizer!");
-		}
-
-		// Push second shape.
-		{
-			Shape *b = (Shape *)(contact->GetFixtureB()->GetUserData().pointer);
-			if (b != nullptr)
-				luax_pushshape(L, b);
-			else
-				throw love::Exception("A Shape has escaped Memoizer!");
-		}
+		Shape *a = (Shape *)(contact->GetFixtureA()->GetUserData().pointer);
+		Shape *b = (Shape *)(contact->GetFixtureB()->GetUserData().pointer);
+		if (a == nullptr || b == nullptr)
+			throw love::Exception("A Shape has escaped Memoizer!");
 
 		Contact *cobj = (Contact *)world->findObject(contact);
 		if (!cobj)
@@ -82,8 +74,20 @@ void World::ContactCallback::process(b2Contact *contact, const b2ContactImpulse
 		else
 			cobj->retain();
 
-		luax_pushtype(L, cobj);
+		process(a, b, cobj, impulse);
 		cobj->release();
+	}
+
+}
+
+void World::ContactCallback::process(Shape *a, Shape *b, Contact *contact, const b2ContactImpulse *impulse)
+{
+	if (ref != nullptr && L != nullptr)
+	{
+		ref->push(L);
+		luax_pushshape(L, a);
+		luax_pushshape(L, b);
+		luax_pushtype(L, contact);
 
 		int args = 3;
 		if (impulse)
@@ -97,7 +101,6 @@ void World::ContactCallback::process(b2Contact *contact, const b2ContactImpulse
 		}
 		lua_call(L, args, 0);
 	}
-
 }
 
 World::ContactFilter::ContactFilter()
@@ -268,6 +271,9 @@ World::World()
 	, end(this)
 	, presolve(this)
 	, postsolve(this)
+	, taskPool(nullptr)
+	, deferCallbacks(false)
+	, contactEventsEnabled(false)
 {
 	world = new b2World(b2Vec2(0,0));
 	world->SetAllowSleeping(true);
@@ -286,6 +292,9 @@ World::World(b2Vec2 gravity, bool sleep)
 	, end(this)
 	, presolve(this)
 	, postsolve(this)
+	, taskPool(nullptr)
+	, deferCallbacks(false)
+	, contactEventsEnabled(false)
 {
 	world = new b2World(Physics::scaleDown(gravity));
 	world->SetAllowSleeping(sleep);
@@ -309,6 +318,8 @@ void World::update(float dt)
 
 void World::update(float dt, int velocityIterations, int positionIterations)
 {
+	LOVE_TRACE_ZONE("World::update");
+
 	world->Step(dt, velocityIterations, positionIterations);
 
 	// Destroy all objects marked during the time step.
@@ -338,14 +349,81 @@ void World::update(float dt, int velocityIterations, int positionIterations)
 		destroy();
 }
 
+bool World::canDeferCallbacks() const
+{
+	return filter.ref == nullptr && (presolve.ref == nullptr || contactEventsEnabled);
+}
+
+void World::updateDeferred(float dt, int velocityIterations, int positionIterations)
+{
+	deferCallbacks = true;
+
+	try
+	{
+		update(dt, velocityIterations, positionIterations);
+	}
+	catch (...)
+	{
+		deferCallbacks = false;
+		throw;
+	}
+
+	deferCallbacks = false;
+}
+
+void World::dispatchDeferredCallbacks()
+{
+	// Callbacks may update this World again, which would add to the list.
+	std::vector<DeferredContact> contacts;
+	contacts.swap(deferredContacts);
+
+	for (const DeferredContact &d : contacts)
+		d.callback->process(d.a, d.b, d.contact, d.hasImpulse ? &d.impulse : nullptr);
+}
+
+void World::deferContact(ContactCallback *callback, b2Contact *contact, const b2ContactImpulse *impulse)
+{
+	if (callback->ref == nullptr)
+		return;
+
+	DeferredContact d;
+	d.callback = callback;
+	d.a.set((Shape *)(contact->GetFixtureA()->GetUserData().pointer));
+	d.b.set((Shape *)(contact->GetFixtureB()->GetUserData().pointer));
+	if (d.a.get() == nullptr || d.b.get() == nullptr)
+		throw love::Exception("A Shape has escaped Memoizer!");
+
+	Contact *cobj = (Contact *)findObject(contact);
+	if (cobj == nullptr)
+		d.contact.set(new Contact(this, contact), Acquire::NORETAIN);
+	else
+		d.contact.set(cobj);
+
+	d.hasImpulse = impulse != nullptr;
+	if (impulse != nullptr)
+		d.impulse = *impulse;
+
+	deferredContacts.push_back(d);
+}
+
 void World::BeginContact(b2Contact *contact)
 {
-	begin.process(contact);
+	if (contactEventsEnabled)
+		recordContactEvent(CONTACT_EVENT_BEGIN, contact);
+	else if (deferCallbacks)
+		deferContact(&begin, contact);
+	else
+		begin.process(contact);
 }
 
 void World::EndContact(b2Contact *contact)
 {
-	end.process(contact);
+	if (contactEventsEnabled)
+		recordContactEvent(CONTACT_EVENT_END, contact);
+	else if (deferCallbacks)
+		deferContact(&end, contact);
+	else
+		end.process(contact);
 
 	// Letting the Contact know that the b2Contact will be destroyed any second.
 	Contact *c = (Contact *)findObject(contact);
@@ -356,12 +434,103 @@ void World::EndContact(b2Contact *contact)
 void World::PreSolve(b2Contact *contact, const b2Manifold *oldManifold)
 {
 	B2_NOT_USED(oldManifold); // not sure what to do with this
-	presolve.process(contact);
+
+	// Postsolve events cover touching contacts, presolve is only useful for
+	// disabling contacts from a callback.
+	if (!contactEventsEnabled)
+		presolve.process(contact);
 }
 
 void World::PostSolve(b2Contact *contact, const b2ContactImpulse *impulse)
 {
-	postsolve.process(contact, impulse);
+	if (contactEventsEnabled)
+		recordContactEvent(CONTACT_EVENT_POSTSOLVE, contact, impulse);
+	else if (deferCallbacks)
+		deferContact(&postsolve, contact, impulse);
+	else
+		postsolve.process(contact, impulse);
+}
+
+void World::recordContactEvent(ContactEventType type, b2Contact *contact, const b2ContactImpulse *impulse)
+{
+	ContactEvent e = {};
+	e.type = (uint32) type;
+	e.shapeA = getContactEventShape(contact->GetFixtureA());
+	e.shapeB = getContactEventShape(contact->GetFixtureB());
+
+	if (type != CONTACT_EVENT_END)
+	{
+		b2WorldManifold manifold;
+		contact->GetWorldManifold(&manifold);
+
+		e.pointCount = (uint32) std::min(contact->GetManifold()->pointCount, 2);
+		e.normal[0] = manifold.normal.x;
+		e.normal[1] = manifold.normal.y;
+
+		for (uint32 i = 0; i < e.pointCount; i++)
+		{
+			b2Vec2 point = Physics::scaleUp(manifold.points[i]);
+			e.points[i][0] = point.x;
+			e.points[i][1] = point.y;
+		}
+	}
+
+	if (impulse != nullptr)
+	{
+		for (int i = 0; i < impulse->count && i < 2; i++)
+		{
+			e.normalImpulses[i] = Physics::scaleUp(impulse->normalImpulses[i]);
+			e.tangentImpulses[i] = Physics::scaleUp(impulse->tangentImpulses[i]);
+		}
+	}
+
+	contactEvents.push_back(e);
+}
+
+uint32 World::getContactEventShape(b2Fixture *fixture)
+{
+	Shape *shape = (Shape *)(fixture->GetUserData().pointer);
+	if (shape == nullptr)
+		throw love::Exception("A Shape has escaped Memoizer!");
+
+	auto it = contactEventShapeIndices.find(shape);
+	if (it != contactEventShapeIndices.end())
+		return it->second;
+
+	uint32 index = (uint32) contactEventShapes.size();
+	contactEventShapes.push_back(shape);
+	contactEventShapeIndices[shape] = index;
+	return index;
+}
+
+void World::clearContactEvents()
+{
+	contactEvents.clear();
+	contactEventShapes.clear();
+	contactEventShapeIndices.clear();
+}
+
+void World::setContactEventsEnabled(bool enable)
+{
+	contactEventsEnabled = enable;
+
+	if (!enable)
+		clearContactEvents();
+}
+
+bool World::isContactEventsEnabled() const
+{
+	return contactEventsEnabled;
+}
+
+const std::vector<World::ContactEvent> &World::getContactEvents() const
+{
+	return contactEvents;
+}
+
+const std::vector<StrongRef<Shape>> &World::getContactEventShapes() const
+{
+	return contactEventShapes;
 }
 
 bool World::ShouldCollide(b2Fixture *fixtureA, b2Fixture *fixtureB)
@@ -505,6 +674,33 @@ bool World::isSleepingAllowed() const
 	return world->GetAllowSleeping();
 }
 
+void World::setThreadCount(int count)
+{
+	if (world->IsLocked())
+		throw love::Exception("The thread count cannot be changed during a time step.");
+
+	if (count < 1)
+		throw love::Exception("Invalid thread count: %d", count);
+
+	if (count == getThreadCount())
+		return;
+
+	world->SetTaskExecutor(nullptr);
+	delete taskPool;
+	taskPool = nullptr;
+
+	if (count > 1)
+	{
+		taskPool = new TaskPool(count);
+		world->SetTaskExecutor(taskPool);
+	}
+}
+
+int World::getThreadCount() const
+{
+	return taskPool != nullptr ? taskPool->GetThreadCount() : 1;
+}
+
 bool World::isLocked() const
 {
 	return world->IsLocked();
@@ -547,6 +743,92 @@ int World::getBodies(lua_State *L) const
 	return 1;
 }
 
+static void writeBodyTransform(Body *body, bool velocity, float *out)
+{
+	body->getPosition(out[0], out[1]);
+	out[2] = body->getAngle();
+
+	if (velocity)
+	{
+		body->getLinearVelocity(out[3], out[4]);
+		out[5] = body->getAngularVelocity();
+	}
+}
+
+int World::getBodyTransforms(const std::vector<Body *> *bodies, bool velocity, void *dst, size_t stride) const
+{
+	uint8 *out = (uint8 *) dst;
+	int count = 0;
+
+	if (bodies != nullptr)
+	{
+		for (Body *body : *bodies)
+		{
+			writeBodyTransform(body, velocity, (float *) (out + count * stride));
+			count++;
+		}
+
+		return count;
+	}
+
+	for (b2Body *b = world->GetBodyList(); b != nullptr; b = b->GetNext())
+	{
+		if (b == groundBody)
+			continue;
+
+		Body *body = (Body *)(b->GetUserData().pointer);
+		if (!body)
+			throw love::Exception("A body has escaped Memoizer!");
+
+		writeBodyTransform(body, velocity, (float *) (out + count * stride));
+		count++;
+	}
+
+	return count;
+}
+
+size_t World::getBodyTransformSize(bool velocity)
+{
+	return (velocity ? 6 : 3) * sizeof(float);
+}
+
+size_t World::getStateSize() const
+{
+	return (size_t) world->GetStateSize();
+}
+
+void World::saveState(void *dst) const
+{
+	if (world->IsLocked())
+		throw love::Exception("The World state cannot be saved during a time step.");
+
+	world->SaveState(dst);
+}
+
+void World::restoreState(const void *data, size_t size)
+{
+	if (world->IsLocked())
+		throw love::Exception("The World state cannot be restored during a time step.");
+
+	if (size > (size_t) std::numeric_limits<int32>::max())
+		throw love::Exception("Invalid World state data.");
+
+	// All current b2Contacts are destroyed by a successful restore.
+	std::vector<Contact *> contacts;
+	for (b2Contact *c = world->GetContactList(); c != nullptr; c = c->GetNext())
+	{
+		Contact *contact = (Contact *) findObject(c);
+		if (contact != nullptr)
+			contacts.push_back(contact);
+	}
+
+	if (!world->RestoreState(data, (int32) size))
+		throw love::Exception("The World state data does not match this World's bodies, shapes and joints.");
+
+	for (Contact *contact : contacts)
+		contact->invalidate();
+}
+
 int World::getJoints(lua_State *L) const
 {
 	lua_newtable(L);
@@ -694,6 +976,132 @@ int World::rayCastClosest(lua_State *L)
 	return 0;
 }
 
+// Spreads independent per-item work over the World's threads, if it has any.
+template <typename F>
+static void parallelQuery(TaskPool *pool, int count, const F &func)
+{
+	class QueryTask : public b2Task
+	{
+	public:
+		QueryTask(const F &func) : func(func) {}
+		void Execute(int32 begin, int32 end, int32 /*threadIndex*/) override
+		{
+			for (int32 i = begin; i < end; i++)
+				func(i);
+		}
+		const F &func;
+	};
+
+	QueryTask task(func);
+
+	if (pool != nullptr)
+		pool->ParallelFor(count, 32, &task);
+	else
+		task.Execute(0, count, 0);
+}
+
+static uint32 getBatchShapeIndex(b2Fixture *fixture, std::unordered_map<Shape *, uint32> &indices, std::vector<Shape *> &shapes)
+{
+	Shape *shape = (Shape *)(fixture->GetUserData().pointer);
+	if (shape == nullptr)
+		throw love::Exception("A Shape has escaped Memoizer!");
+
+	auto it = indices.find(shape);
+	if (it != indices.end())
+		return it->second;
+
+	uint32 index = (uint32) shapes.size();
+	shapes.push_back(shape);
+	indices[shape] = index;
+	return index;
+}
+
+void World::rayCastBatch(const float *rays, int count, uint16 categoryMask, bool any, RayCastHit *hits, std::vector<Shape *> &shapes)
+{
+	std::vector<b2Fixture *> fixtures(count);
+
+	parallelQuery(taskPool, count, [&](int i)
+	{
+		const float *r = rays + i * 4;
+		b2Vec2 v1 = Physics::scaleDown(b2Vec2(r[0], r[1]));
+		b2Vec2 v2 = Physics::scaleDown(b2Vec2(r[2], r[3]));
+
+		RayCastHit &hit = hits[i];
+		hit.shape = -1;
+		hit.point[0] = hit.point[1] = 0.0f;
+		hit.normal[0] = hit.normal[1] = 0.0f;
+		hit.fraction = 1.0f;
+
+		// Box2D asserts on empty rays, which can't hit anything anyway.
+		if (v1 == v2)
+			return;
+
+		RayCastOneCallback raycast(categoryMask, any);
+		world->RayCast(&raycast, v1, v2);
+
+		fixtures[i] = raycast.hitFixture;
+		if (raycast.hitFixture != nullptr)
+		{
+			b2Vec2 point = Physics::scaleUp(raycast.hitPoint);
+			hit.point[0] = point.x;
+			hit.point[1] = point.y;
+			hit.normal[0] = raycast.hitNormal.x;
+			hit.normal[1] = raycast.hitNormal.y;
+			hit.fraction = raycast.hitFraction;
+		}
+	});
+
+	std::unordered_map<Shape *, uint32> indices;
+	for (int i = 0; i < count; i++)
+	{
+		if (fixtures[i] != nullptr)
+			hits[i].shape = (int32) getBatchShapeIndex(fixtures[i], indices, shapes);
+	}
+}
+
+void World::getShapesInAreas(const float *boxes, int count, uint16 categoryMask, std::vector<uint32> &offsets, std::vector<uint32> &indices, std::vector<Shape *> &shapes)
+{
+	class AreaCallback : public b2QueryCallback
+	{
+	public:
+		AreaCallback(uint16 categoryMask, std::vector<b2Fixture *> &fixtures)
+			: categoryMask(categoryMask), fixtures(fixtures) {}
+		bool ReportFixture(b2Fixture *f) override
+		{
+			if (categoryMask == 0xFFFF || (categoryMask & f->GetFilterData().categoryBits) != 0)
+				fixtures.push_back(f);
+			return true;
+		}
+		uint16 categoryMask;
+		std::vector<b2Fixture *> &fixtures;
+	};
+
+	std::vector<std::vector<b2Fixture *>> fixtures(count);
+
+	parallelQuery(taskPool, count, [&](int i)
+	{
+		const float *b = boxes + i * 4;
+		b2AABB box;
+		box.lowerBound = Physics::scaleDown(b2Vec2(b[0], b[1]));
+		box.upperBound = Physics::scaleDown(b2Vec2(b[2], b[3]));
+
+		AreaCallback query(categoryMask, fixtures[i]);
+		world->QueryAABB(&query, box);
+	});
+
+	std::unordered_map<Shape *, uint32> shapeIndices;
+	indices.clear();
+	offsets.resize(count + 1);
+	offsets[0] = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		for (b2Fixture *f : fixtures[i])
+			indices.push_back(getBatchShapeIndex(f, shapeIndices, shapes));
+		offsets[i + 1] = (uint32) indices.size();
+	}
+}
+
 void World::destroy()
 {
 	if (world == nullptr)
@@ -715,6 +1123,11 @@ void World::destroy()
 	//disable callbacks
 	begin.ref = end.ref = presolve.ref = postsolve.ref = filter.ref = nullptr;
 
+	// Stop holding on to Shapes, they're about to be destroyed.
+	contactEventsEnabled = false;
+	clearContactEvents();
+	deferredContacts.clear();
+
 	// Cleaning up the world.
 	b2Body *b = world->GetBodyList();
 	while (b)
@@ -734,6 +1147,9 @@ void World::destroy()
 
 	delete world;
 	world = nullptr;
+
+	delete taskPool;
+	taskPool = nullptr;
 }
 
 void World::registerObject(void *b2object, love::Object *object)
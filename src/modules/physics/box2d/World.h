@@ -25,6 +25,7 @@
 #include "common/Object.h"
 #include "common/runtime.h"
 #include "common/Reference.h"
+#include "common/int.h"
 
 // STD
 #include <vector>
@@ -44,6 +45,7 @@ class Contact;
 class Body;
 class Shape;
 class Joint;
+class TaskPool;
 
 /**
  * The World is the "God" container class,
@@ -69,6 +71,48 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 
 	static love::Type type;
 
+	enum ContactEventType
+	{
+		CONTACT_EVENT_BEGIN,
+		CONTACT_EVENT_END,
+		CONTACT_EVENT_POSTSOLVE,
+	};
+
+	/**
+	 * A contact event recorded by update() while contact events are enabled.
+	 * The layout is exposed to Lua as-is by World:get_contact_events.
+	 **/
+	struct ContactEvent
+	{
+		uint32 type;
+
+		// Indices into the list of Shapes referenced by the recorded events.
+		uint32 shapeA;
+		uint32 shapeB;
+
+		// Only set for begin and postsolve events, 0 for end events.
+		uint32 pointCount;
+		float normal[2];
+		float points[2][2];
+
+		// Only set for postsolve events.
+		float normalImpulses[2];
+		float tangentImpulses[2];
+	};
+
+	/**
+	 * The result of one ray in a batched raycast, exposed to Lua as-is by
+	 * World:ray_cast_batch.
+	 **/
+	struct RayCastHit
+	{
+		// Index into the list of hit Shapes, or -1 if the ray hit nothing.
+		int32 shape;
+		float point[2];
+		float normal[2];
+		float fraction;
+	};
+
 	class ContactCallback
 	{
 	public:
@@ -78,6 +122,7 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 		ContactCallback(World *world);
 		~ContactCallback();
 		void process(b2Contact *contact, const b2ContactImpulse *impulse = NULL);
+		void process(Shape *a, Shape *b, Contact *contact, const b2ContactImpulse *impulse);
 	};
 
 	class ContactFilter
@@ -168,6 +213,22 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	void update(float dt);
 	void update(float dt, int velocityIterations, int positionIterations);
 
+	/**
+	 * Whether the World can be updated with deferred callbacks. Contact
+	 * filters and presolve callbacks have to run during the time step, so
+	 * Worlds using them must be updated normally.
+	 **/
+	bool canDeferCallbacks() const;
+
+	/**
+	 * Updates the World without calling into Lua, so it can be done on any
+	 * thread. Begin, end and postsolve callbacks are queued and called by
+	 * dispatchDeferredCallbacks, from the thread owning the Lua state.
+	 * Contacts passed to end callbacks are no longer valid by then.
+	 **/
+	void updateDeferred(float dt, int velocityIterations, int positionIterations);
+	void dispatchDeferredCallbacks();
+
 	// From b2ContactListener
 	void BeginContact(b2Contact *contact);
 	void EndContact(b2Contact *contact);
@@ -216,6 +277,31 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	 **/
 	int getContactFilter(lua_State *L);
 
+	/**
+	 * Enables recording contact events into a flat list during update(),
+	 * instead of calling the begin, end, presolve and postsolve callbacks.
+	 * The contact filter callback is still called.
+	 **/
+	void setContactEventsEnabled(bool enable);
+	bool isContactEventsEnabled() const;
+
+	/**
+	 * Gets the contact events recorded since the events were last cleared.
+	 * This includes end events caused by destroying Shapes or Bodies between
+	 * updates. Events keep accumulating until clearContactEvents is called.
+	 **/
+	const std::vector<ContactEvent> &getContactEvents() const;
+
+	/**
+	 * Gets the Shapes referenced by the recorded contact events' indices.
+	 **/
+	const std::vector<StrongRef<Shape>> &getContactEventShapes() const;
+
+	/**
+	 * Clears the recorded contact events, once they've been handed out.
+	 **/
+	void clearContactEvents();
+
 	/**
 	 * Sets the current gravity of the World.
 	 * @param x Gravity in the x-direction.
@@ -249,6 +335,21 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	 **/
 	bool isSleepingAllowed() const;
 
+	/**
+	 * Sets the number of threads used to step this World. Separate islands of
+	 * Bodies are solved in parallel, and the broad-phase and contact updates
+	 * are split between the threads. Results are identical to stepping on a
+	 * single thread, and collision callbacks are still called from the thread
+	 * calling update.
+	 * @param count The number of threads, including the calling thread.
+	 **/
+	void setThreadCount(int count);
+
+	/**
+	 * Gets the number of threads used to step this World.
+	 **/
+	int getThreadCount() const;
+
 	/**
 	 * Returns whether this World is currently locked.
 	 * If it's locked, it's in the middle of a timestep.
@@ -280,6 +381,42 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	 **/
 	int getBodies(lua_State *L) const;
 
+	/**
+	 * Writes the position and angle of Bodies as consecutive floats, followed
+	 * by their linear and angular velocity if requested.
+	 * @param bodies The Bodies to write, or null for every Body in the World
+	 * in the same order as getBodies.
+	 * @param velocity Whether to include velocities.
+	 * @param dst Receives one record per Body, stride bytes apart.
+	 * @param stride Must be at least getBodyTransformSize(velocity).
+	 * @return The number of Bodies written.
+	 **/
+	int getBodyTransforms(const std::vector<Body *> *bodies, bool velocity, void *dst, size_t stride) const;
+
+	static size_t getBodyTransformSize(bool velocity);
+
+	/**
+	 * Gets the size in bytes of the snapshot written by saveState.
+	 **/
+	size_t getStateSize() const;
+
+	/**
+	 * Saves the simulation state of the World: Body positions and velocities,
+	 * Joint impulses, Contacts and the broad-phase. Stepping the World after
+	 * restoring the snapshot gives the same results as it did after saving.
+	 * @param dst Receives getStateSize() bytes.
+	 **/
+	void saveState(void *dst) const;
+
+	/**
+	 * Restores a snapshot written by saveState. Only snapshots of this World
+	 * are accepted, and only while it has the same Bodies, Shapes and Joints
+	 * as when it was saved; recreating one of them invalidates the snapshot.
+	 * Existing Contact objects become invalid, and no collision callbacks are
+	 * called.
+	 **/
+	void restoreState(const void *data, size_t size);
+
 	/**
 	 * Get an array of all the Joints in the World.
 	 * @return An array of Joints.
@@ -316,6 +453,24 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	int rayCastAny(lua_State *L);
 	int rayCastClosest(lua_State *L);
 
+	/**
+	 * Casts many rays at once, spread over the World's threads.
+	 * @param rays Four floats per ray: x1, y1, x2, y2.
+	 * @param any Whether to stop at any hit instead of the closest one.
+	 * @param hits Receives one result per ray.
+	 * @param shapes Receives the hit Shapes, referenced by index from hits.
+	 **/
+	void rayCastBatch(const float *rays, int count, uint16 categoryMask, bool any, RayCastHit *hits, std::vector<Shape *> &shapes);
+
+	/**
+	 * Finds the Shapes overlapping many bounding boxes at once.
+	 * @param boxes Four floats per box: lx, ly, ux, uy.
+	 * @param offsets Receives count + 1 offsets into indices, the Shapes of
+	 * box i are indices[offsets[i]] up to indices[offsets[i + 1]].
+	 * @param indices Receives indices into shapes.
+	 **/
+	void getShapesInAreas(const float *boxes, int count, uint16 categoryMask, std::vector<uint32> &offsets, std::vector<uint32> &indices, std::vector<Shape *> &shapes);
+
 	/**
 	 * Destroy this world.
 	 **/
@@ -333,6 +488,9 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 	// Ground body
 	b2Body *groundBody;
 
+	// Worker threads for stepping, null when stepping on one thread.
+	TaskPool *taskPool;
+
 	// The list of to be destructed bodies.
 	std::vector<Body *> destructBodies;
 	std::vector<Shape *> destructShapes;
@@ -345,6 +503,29 @@ class World : public Object, public b2ContactListener, public b2ContactFilter, p
 
 	std::unordered_map<void *, love::Object *> box2dObjectMap;
 
+	void recordContactEvent(ContactEventType type, b2Contact *contact, const b2ContactImpulse *impulse = nullptr);
+	uint32 getContactEventShape(b2Fixture *fixture);
+
+	struct DeferredContact
+	{
+		ContactCallback *callback;
+		StrongRef<Shape> a;
+		StrongRef<Shape> b;
+		StrongRef<Contact> contact;
+		b2ContactImpulse impulse;
+		bool hasImpulse;
+	};
+
+	void deferContact(ContactCallback *callback, b2Contact *contact, const b2ContactImpulse *impulse = nullptr);
+
+	bool deferCallbacks;
+	std::vector<DeferredContact> deferredContacts;
+
+	bool contactEventsEnabled;
+	std::vector<ContactEvent> contactEvents;
+	std::vector<StrongRef<Shape>> contactEventShapes;
+	std::unordered_map<Shape *, uint32> contactEventShapeIndices;
+
 }; // World
 
 } // box2d
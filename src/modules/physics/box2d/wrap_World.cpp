@@ -19,6 +19,10 @@
  **/
 
 #include "wrap_World.h"
+#include "wrap_Body.h"
+#include "wrap_Shape.h"
+#include "common/Data.h"
+#include "data/ByteData.h"
 
 namespace love
 {
@@ -83,6 +87,62 @@ int w_World_getContactFilter(lua_State *L)
 	return t->getContactFilter(L);
 }
 
+int w_World_setContactEventsEnabled(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	bool enable = luax_checkboolean(L, 2);
+	t->setContactEventsEnabled(enable);
+	return 0;
+}
+
+int w_World_isContactEventsEnabled(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	luax_pushboolean(L, t->isContactEventsEnabled());
+	return 1;
+}
+
+int w_World_getContactEvents(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	const std::vector<World::ContactEvent> &events = t->getContactEvents();
+	const std::vector<StrongRef<Shape>> &shapes = t->getContactEventShapes();
+	size_t size = events.size() * sizeof(World::ContactEvent);
+
+	// Existing ByteData can be reused to avoid an allocation every frame.
+	love::data::ByteData *data = nullptr;
+	if (!lua_isnoneornil(L, 2))
+	{
+		data = luax_checktype<love::data::ByteData>(L, 2);
+		if (data->getSize() < size)
+			return luaL_error(L, "ByteData is too small to hold %d contact events (%d bytes needed).", (int) events.size(), (int) size);
+		data->retain();
+	}
+	else
+		luax_catchexcept(L, [&]() { data = new love::data::ByteData(std::max(size, sizeof(World::ContactEvent)), false); });
+
+	if (size > 0)
+		memcpy(data->getData(), events.data(), size);
+
+	luax_pushtype(L, data);
+	data->release();
+
+	lua_createtable(L, (int) shapes.size(), 0);
+	for (size_t i = 0; i < shapes.size(); i++)
+	{
+		// Shape indices in the event data are 0-based.
+		luax_pushshape(L, shapes[i].get());
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	lua_pushinteger(L, (lua_Integer) events.size());
+
+	// Events are only handed out once.
+	t->clearContactEvents();
+	return 3;
+}
+
 int w_World_setGravity(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -123,6 +183,21 @@ int w_World_isSleepingAllowed(lua_State *L)
 	return 1;
 }
 
+int w_World_setThreadCount(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	int count = (int) luaL_checkinteger(L, 2);
+	luax_catchexcept(L, [&](){ t->setThreadCount(count); });
+	return 0;
+}
+
+int w_World_getThreadCount(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	lua_pushinteger(L, t->getThreadCount());
+	return 1;
+}
+
 int w_World_isLocked(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -160,6 +235,49 @@ int w_World_getBodies(lua_State *L)
 	return ret;
 }
 
+int w_World_getBodyTransforms(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	bool velocity = luax_optboolean(L, 4, false);
+
+	std::vector<Body *> bodies;
+	bool hasbodies = !lua_isnoneornil(L, 3);
+
+	if (hasbodies)
+	{
+		luaL_checktype(L, 3, LUA_TTABLE);
+		int len = (int) luax_objlen(L, 3);
+		bodies.reserve(len);
+
+		for (int i = 1; i <= len; i++)
+		{
+			lua_rawgeti(L, 3, i);
+			Body *body = luax_checkbody(L, -1);
+			if (body->getWorld() != t)
+				return luaL_error(L, "Body at index %d does not belong to this World.", i);
+			bodies.push_back(body);
+			lua_pop(L, 1);
+		}
+	}
+
+	int count = hasbodies ? (int) bodies.size() : t->getBodyCount();
+	size_t recordsize = World::getBodyTransformSize(velocity);
+
+	// Physics doesn't depend on love.graphics. The ByteData can be uploaded to
+	// a Buffer with Buffer:set_array_data.
+	love::data::ByteData *data = luax_checktype<love::data::ByteData>(L, 2);
+
+	if (count * recordsize > data->getSize())
+		return luaL_error(L, "ByteData is too small to hold %d body transforms (%d bytes needed).", count, (int) (count * recordsize));
+
+	luax_catchexcept(L, [&]() {
+		count = t->getBodyTransforms(hasbodies ? &bodies : nullptr, velocity, data->getData(), recordsize);
+	});
+
+	lua_pushinteger(L, count);
+	return 1;
+}
+
 int w_World_getJoints(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -227,6 +345,164 @@ int w_World_rayCastClosest(lua_State *L)
 	return ret;
 }
 
+// Rays and boxes for batched queries are four floats each, given either as a
+// flat table of numbers or as packed floats in a ByteData.
+static const float *checkQueryList(lua_State *L, int idx, std::vector<float> &storage, int &count)
+{
+	if (luax_istype(L, idx, love::data::ByteData::type))
+	{
+		love::data::ByteData *data = luax_checktype<love::data::ByteData>(L, idx);
+		count = (int) (data->getSize() / (sizeof(float) * 4));
+		return (const float *) data->getData();
+	}
+
+	luaL_checktype(L, idx, LUA_TTABLE);
+	int len = (int) luax_objlen(L, idx);
+	if (len % 4 != 0)
+		luaL_error(L, "Expected four numbers per query, got %d numbers.", len);
+
+	storage.resize(len);
+	for (int i = 0; i < len; i++)
+	{
+		lua_rawgeti(L, idx, i + 1);
+		storage[i] = (float) luaL_checknumber(L, -1);
+		lua_pop(L, 1);
+	}
+
+	count = len / 4;
+	return storage.data();
+}
+
+// Reuses the given ByteData when it's big enough, to avoid an allocation every
+// frame. Leaves the ByteData on the stack.
+static love::data::ByteData *pushQueryData(lua_State *L, int idx, size_t size)
+{
+	love::data::ByteData *data = nullptr;
+	if (!lua_isnoneornil(L, idx))
+	{
+		data = luax_checktype<love::data::ByteData>(L, idx);
+		if (data->getSize() < size)
+			luaL_error(L, "ByteData is too small to hold the query results (%d bytes needed).", (int) size);
+		data->retain();
+	}
+	else
+		luax_catchexcept(L, [&]() { data = new love::data::ByteData(std::max(size, (size_t) 1), false); });
+
+	luax_pushtype(L, data);
+	data->release();
+	return data;
+}
+
+static void pushQueryShapes(lua_State *L, const std::vector<Shape *> &shapes)
+{
+	lua_createtable(L, (int) shapes.size(), 0);
+	for (size_t i = 0; i < shapes.size(); i++)
+	{
+		// Shape indices in the result data are 0-based.
+		luax_pushshape(L, shapes[i]);
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+}
+
+int w_World_rayCastBatch(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	std::vector<float> storage;
+	int count = 0;
+	const float *rays = checkQueryList(L, 2, storage, count);
+
+	const char *mode = luaL_optstring(L, 3, "closest");
+	bool any = false;
+	if (strcmp(mode, "any") == 0)
+		any = true;
+	else if (strcmp(mode, "closest") != 0)
+		return luaL_error(L, "Invalid raycast mode '%s', expected 'closest' or 'any'.", mode);
+
+	uint16 categoryMaskBits = (uint16) luaL_optinteger(L, 4, 0xFFFF);
+
+	love::data::ByteData *data = pushQueryData(L, 5, count * sizeof(World::RayCastHit));
+
+	// The results would overwrite rays which haven't been cast yet.
+	if (rays == data->getData())
+	{
+		storage.assign(rays, rays + count * 4);
+		rays = storage.data();
+	}
+
+	std::vector<Shape *> shapes;
+	luax_catchexcept(L, [&]() {
+		t->rayCastBatch(rays, count, categoryMaskBits, any, (World::RayCastHit *) data->getData(), shapes);
+	});
+
+	pushQueryShapes(L, shapes);
+	lua_pushinteger(L, count);
+	return 3;
+}
+
+int w_World_getShapesInAreas(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+
+	std::vector<float> storage;
+	int count = 0;
+	const float *boxes = checkQueryList(L, 2, storage, count);
+
+	uint16 categoryMaskBits = (uint16) luaL_optinteger(L, 3, 0xFFFF);
+
+	std::vector<uint32> offsets;
+	std::vector<uint32> indices;
+	std::vector<Shape *> shapes;
+	luax_catchexcept(L, [&]() {
+		t->getShapesInAreas(boxes, count, categoryMaskBits, offsets, indices, shapes);
+	});
+
+	// The offsets of every box, then the indices they refer to.
+	size_t offsetsize = offsets.size() * sizeof(uint32);
+	size_t indexsize = indices.size() * sizeof(uint32);
+	love::data::ByteData *data = pushQueryData(L, 4, offsetsize + indexsize);
+
+	memcpy(data->getData(), offsets.data(), offsetsize);
+	if (indexsize > 0)
+		memcpy((uint8 *) data->getData() + offsetsize, indices.data(), indexsize);
+
+	pushQueryShapes(L, shapes);
+	lua_pushinteger(L, count);
+	return 3;
+}
+
+int w_World_saveState(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	size_t size = t->getStateSize();
+
+	love::data::ByteData *data = nullptr;
+	if (!lua_isnoneornil(L, 2))
+	{
+		data = luax_checktype<love::data::ByteData>(L, 2);
+		if (data->getSize() < size)
+			return luaL_error(L, "ByteData is too small to hold the World state (%d bytes needed).", (int) size);
+		data->retain();
+	}
+	else
+		luax_catchexcept(L, [&]() { data = new love::data::ByteData(size, false); });
+
+	luax_pushtype(L, data);
+	data->release();
+
+	luax_catchexcept(L, [&]() { t->saveState(data->getData()); });
+	lua_pushinteger(L, (lua_Integer) size);
+	return 2;
+}
+
+int w_World_restoreState(lua_State *L)
+{
+	World *t = luax_checkworld(L, 1);
+	love::Data *data = luax_checktype<love::Data>(L, 2);
+	luax_catchexcept(L, [&]() { t->restoreState(data->getData(), data->getSize()); });
+	return 0;
+}
+
 int w_World_destroy(lua_State *L)
 {
 	World *t = luax_checkworld(L, 1);
@@ -248,16 +524,22 @@ static const luaL_Reg w_World_functions[] =
 	{ "get_callbacks", w_World_getCallbacks },
 	{ "set_contact_filter", w_World_setContactFilter },
 	{ "get_contact_filter", w_World_getContactFilter },
+	{ "set_contact_events_enabled", w_World_setContactEventsEnabled },
+	{ "is_contact_events_enabled", w_World_isContactEventsEnabled },
+	{ "get_contact_events", w_World_getContactEvents },
 	{ "set_gravity", w_World_setGravity },
 	{ "get_gravity", w_World_getGravity },
 	{ "translate_origin", w_World_translateOrigin },
 	{ "set_sleeping_allowed", w_World_setSleepingAllowed },
 	{ "is_sleeping_allowed", w_World_isSleepingAllowed },
+	{ "set_thread_count", w_World_setThreadCount },
+	{ "get_thread_count", w_World_getThreadCount },
 	{ "is_locked", w_World_isLocked },
 	{ "get_body_count", w_World_getBodyCount },
 	{ "get_joint_count", w_World_getJointCount },
 	{ "get_contact_count", w_World_getContactCount },
 	{ "get_bodies", w_World_getBodies },
+	{ "get_body_transforms", w_World_getBodyTransforms },
 	{ "get_joints", w_World_getJoints },
 	{ "get_contacts", w_World_getContacts },
 	{ "query_shapes_in_area", w_World_queryShapesInArea },
@@ -265,6 +547,10 @@ static const luaL_Reg w_World_functions[] =
 	{ "ray_cast", w_World_rayCast },
 	{ "ray_cast_any", w_World_rayCastAny },
 	{ "ray_cast_closest", w_World_rayCastClosest },
+	{ "ray_cast_batch", w_World_rayCastBatch },
+	{ "get_shapes_in_areas", w_World_getShapesInAreas },
+	{ "save_state", w_World_saveState },
+	{ "restore_state", w_World_restoreState },
 	{ "destroy", w_World_destroy },
 	{ "is_destroyed", w_World_isDestroyed },
 
@@ -21,6 +21,7 @@
 // LOVE
 #include "System.h"
 #include "window/Window.h"
+#include "thread/threads.h"
 
 // SDL
 #include <SDL3/SDL_clipboard.h>
@@ -42,7 +43,7 @@ System::System()
 
 int System::getProcessorCount() const
 {
-	return SDL_GetNumLogicalCPUCores();
+	return love::thread::getProcessorCount();
 }
 
 bool System::isWindowOpen() const
@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "TaskPool.h"
+
+// STL
+#include <algorithm>
+
+namespace love
+{
+namespace thread
+{
+
+TaskPool::TaskPool(int threadCount, const std::string &threadName)
+	: threadCount(std::max(1, std::min(threadCount, (int) MAX_THREADS)))
+	, task(nullptr)
+	, jobID(0)
+	, count(0)
+	, rangeSize(1)
+	, nextRange(0)
+	, activeWorkers(0)
+	, busy(false)
+	, finish(false)
+{
+	for (int i = 1; i < this->threadCount; i++)
+	{
+		Worker *worker = new Worker(this, i, threadName);
+		workers.push_back(worker);
+		worker->start();
+	}
+}
+
+TaskPool::~TaskPool()
+{
+	{
+		Lock lock(mutex);
+		finish = true;
+		startCond->broadcast();
+	}
+
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		delete worker;
+	}
+}
+
+int TaskPool::getThreadCount() const
+{
+	return threadCount;
+}
+
+void TaskPool::parallelFor(int count, int minRange, Task *task)
+{
+	if (count <= 0)
+		return;
+
+	minRange = std::max(minRange, 1);
+
+	bool runInline = workers.empty() || count <= minRange;
+
+	if (!runInline)
+	{
+		Lock lock(mutex);
+		if (busy)
+			runInline = true;
+		else
+		{
+			// Small enough ranges for a few per thread, so uneven ranges
+			// still balance out.
+			int target = (count + threadCount * 4 - 1) / (threadCount * 4);
+
+			busy = true;
+			this->count = count;
+			this->rangeSize = std::max(minRange, target);
+			nextRange = 0;
+			this->task = task;
+			jobID++;
+			startCond->broadcast();
+		}
+	}
+
+	if (runInline)
+	{
+		task->execute(0, count, 0);
+		return;
+	}
+
+	// Doesn't throw, so the job is always finished and reset below.
+	runRanges(task, 0);
+
+	std::exception_ptr jobError;
+
+	{
+		Lock lock(mutex);
+
+		// Workers which haven't picked up the job yet won't anymore.
+		this->task = nullptr;
+
+		while (activeWorkers > 0)
+			doneCond->wait(mutex);
+
+		jobError = error;
+		error = nullptr;
+		busy = false;
+	}
+
+	if (jobError)
+		std::rethrow_exception(jobError);
+}
+
+void TaskPool::runRanges(Task *task, int threadIndex)
+{
+	try
+	{
+		while (true)
+		{
+			int begin = nextRange.fetch_add(rangeSize);
+			if (begin >= count)
+				break;
+
+			task->execute(begin, std::min(count, begin + rangeSize), threadIndex);
+		}
+	}
+	catch (...)
+	{
+		// Skip the remaining ranges. The first error is rethrown by the
+		// thread which called parallelFor.
+		nextRange = count;
+
+		Lock lock(mutex);
+		if (!error)
+			error = std::current_exception();
+	}
+}
+
+TaskPool::Worker::Worker(TaskPool *pool, int index, const std::string &name)
+	: pool(pool)
+	, index(index)
+{
+	threadName = name;
+}
+
+TaskPool::Worker::~Worker()
+{
+}
+
+void TaskPool::Worker::threadFunction()
+{
+	uint64 lastJob = 0;
+
+	Lock lock(pool->mutex);
+
+	while (true)
+	{
+		while (!pool->finish && (pool->task == nullptr || pool->jobID == lastJob))
+			pool->startCond->wait(pool->mutex);
+
+		if (pool->finish)
+			return;
+
+		lastJob = pool->jobID;
+		Task *task = pool->task;
+		pool->activeWorkers++;
+
+		pool->mutex->unlock();
+		pool->runRanges(task, index);
+		pool->mutex->lock();
+
+		if (--pool->activeWorkers == 0)
+			pool->doneCond->signal();
+	}
+}
+
+} // thread
+} // love
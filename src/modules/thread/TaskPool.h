@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_THREAD_TASK_POOL_H
+#define LOVE_THREAD_TASK_POOL_H
+
+// LOVE
+#include "common/int.h"
+#include "threads.h"
+
+// STL
+#include <atomic>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A unit of work which can be split into independent ranges of items.
+ **/
+class Task
+{
+public:
+
+	virtual ~Task() {}
+
+	/**
+	 * Processes the items from begin up to (not including) end.
+	 * @param threadIndex The index of the thread running the range, from 0
+	 * up to the pool's thread count. Useful for per-thread scratch memory.
+	 * It's only unique within a single parallelFor call: a call which runs
+	 * inline because the pool is busy uses index 0 as well, so scratch
+	 * memory must belong to the call rather than to the pool.
+	 **/
+	virtual void execute(int begin, int end, int threadIndex) = 0;
+
+}; // Task
+
+/**
+ * Runs Tasks on a set of worker threads. The thread calling parallelFor takes
+ * part in the work as thread index 0. When the pool is already busy (a
+ * parallelFor call made from inside a task, or from another thread) the work
+ * runs on the calling thread instead. If a task throws, the remaining ranges
+ * are skipped and the first exception is rethrown by parallelFor.
+ **/
+class TaskPool
+{
+public:
+
+	/**
+	 * @param threadCount The total number of threads working on a task,
+	 * including the calling thread.
+	 * @param threadName The name of the worker threads.
+	 **/
+	TaskPool(int threadCount, const std::string &threadName);
+	~TaskPool();
+
+	int getThreadCount() const;
+
+	/**
+	 * Splits count items into ranges of at least minRange items, and runs
+	 * the task on them in parallel. Returns when all items are done.
+	 **/
+	void parallelFor(int count, int minRange, Task *task);
+
+	/**
+	 * Same as above, calling func(begin, end, threadIndex) for each range.
+	 **/
+	template <typename F>
+	void parallelFor(int count, int minRange, const F &func)
+	{
+		class FunctionTask : public Task
+		{
+		public:
+			FunctionTask(const F &func) : func(func) {}
+			void execute(int begin, int end, int threadIndex) override { func(begin, end, threadIndex); }
+			const F &func;
+		};
+
+		FunctionTask task(func);
+		parallelFor(count, minRange, (Task *) &task);
+	}
+
+	static const int MAX_THREADS = 64;
+
+private:
+
+	class Worker : public Threadable
+	{
+	public:
+		Worker(TaskPool *pool, int index, const std::string &name);
+		virtual ~Worker();
+		void threadFunction();
+
+	private:
+		TaskPool *pool;
+		int index;
+	};
+
+	void runRanges(Task *task, int threadIndex);
+
+	int threadCount;
+	std::vector<Worker *> workers;
+
+	MutexRef mutex;
+	ConditionalRef startCond;
+	ConditionalRef doneCond;
+
+	// The current job. Workers only join while task is set.
+	Task *task;
+	uint64 jobID;
+	int count;
+	int rangeSize;
+	std::atomic<int> nextRange;
+	int activeWorkers;
+
+	// The first exception thrown by the current job.
+	std::exception_ptr error;
+
+	bool busy;
+	bool finish;
+
+}; // TaskPool
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_TASK_POOL_H
@@ -19,6 +19,7 @@
  **/
 
 #include "Thread.h"
+#include "common/trace.h"
 
 namespace love
 {
@@ -92,6 +93,8 @@ int Thread::thread_runner(void *data)
 {
 	Thread *self = (Thread *) data; // some compilers don't like 'this'
 
+	trace::setThreadName(self->t->getThreadName());
+
 	self->t->threadFunction();
 
 	{
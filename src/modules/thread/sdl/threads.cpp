@@ -21,6 +21,10 @@
 #include "threads.h"
 #include "Thread.h"
 
+#include <SDL3/SDL_cpuinfo.h>
+
+#include <algorithm>
+
 namespace love
 {
 namespace thread
@@ -105,5 +109,10 @@ thread::Thread *newThread(Threadable *t)
 	return new sdl::Thread(t);
 }
 
+int getProcessorCount()
+{
+	return std::max(SDL_GetNumLogicalCPUCores(), 1);
+}
+
 } // thread
 } // love
@@ -129,6 +129,11 @@ Mutex *newMutex();
 Conditional *newConditional();
 Thread *newThread(Threadable *t);
 
+/**
+ * The number of logical CPU cores, at least 1. Used to size worker pools.
+ **/
+int getProcessorCount();
+
 #if defined(LOVE_LINUX)
 void disableSignals();
 void reenableSignals();
@@ -22,6 +22,7 @@
 
 // LOVE
 #include "wrap_Timer.h"
+#include "common/trace.h"
 
 namespace love
 {
@@ -66,6 +67,42 @@ int w_getTime(lua_State *L)
 	return 1;
 }
 
+int w_setTracingEnabled(lua_State *L)
+{
+	trace::setEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isTracingEnabled(lua_State *L)
+{
+	luax_pushboolean(L, trace::isEnabled());
+	return 1;
+}
+
+int w_pushTraceZone(lua_State *L)
+{
+	size_t len = 0;
+	const char *name = luaL_checklstring(L, 1, &len);
+	if (trace::isEnabled())
+		trace::beginZone(trace::intern(std::string(name, len)));
+	return 0;
+}
+
+int w_popTraceZone(lua_State *L)
+{
+	if (trace::isEnabled())
+		trace::endZone();
+	return 0;
+}
+
+int w_getTrace(lua_State *L)
+{
+	std::string json;
+	luax_catchexcept(L, [&]() { json = trace::toJSON(); });
+	luax_pushstring(L, json);
+	return 1;
+}
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
@@ -75,6 +112,11 @@ static const luaL_Reg functions[] =
 	{ "get_average_delta", w_getAverageDelta },
 	{ "sleep", w_sleep },
 	{ "get_time", w_getTime },
+	{ "set_tracing_enabled", w_setTracingEnabled },
+	{ "is_tracing_enabled", w_isTracingEnabled },
+	{ "push_trace_zone", w_pushTraceZone },
+	{ "pop_trace_zone", w_popTraceZone },
+	{ "get_trace", w_getTrace },
 	{ 0, 0 }
 };
 
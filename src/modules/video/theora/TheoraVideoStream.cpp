@@ -19,6 +19,7 @@
  **/
 
 // STL
+#include <algorithm>
 #include <iostream>
 
 // LOVE
@@ -37,9 +38,13 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 	: demuxer(file)
 	, headerParsed(false)
 	, decoder(nullptr)
-	, frameReady(false)
+	, frontBuffer(nullptr)
+	, wakeup(nullptr)
+	, framesConsumed(false)
 	, lastFrame(0)
 	, nextFrame(0)
+	, lastPosition(0)
+	, frameDuration(1.0 / 30.0)
 {
 	if (demuxer.findStream() != OggDemuxer::TYPE_THEORA)
 		throw love::Exception("Invalid video file, video is not theora");
@@ -47,7 +52,8 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 	th_info_init(&videoInfo);
 
 	frontBuffer = new Frame();
-	backBuffer = new Frame();
+	for (int i = 0; i < MAX_QUEUED_FRAMES; i++)
+		freeFrames.push_back(new Frame());
 
 	try
 	{
@@ -55,7 +61,8 @@ TheoraVideoStream::TheoraVideoStream(love::filesystem::File *file)
 	}
 	catch (love::Exception &ex)
 	{
-		delete backBuffer;
+		for (Frame *frame : freeFrames)
+			delete frame;
 		delete frontBuffer;
 		th_info_clear(&videoInfo);
 		throw ex;
@@ -71,8 +78,11 @@ TheoraVideoStream::~TheoraVideoStream()
 
 	th_info_clear(&videoInfo);
 
+	flushFrames();
+	for (Frame *frame : freeFrames)
+		delete frame;
+
 	delete frontBuffer;
-	delete backBuffer;
 }
 
 int TheoraVideoStream::getWidth() const
@@ -162,14 +172,18 @@ void TheoraVideoStream::parseHeader()
 	decoder = th_decode_alloc(&videoInfo, setupInfo);
 	th_setup_free(setupInfo);
 
-	Frame *buffers[2] = {backBuffer, frontBuffer};
+	if (videoInfo.fps_numerator > 0 && videoInfo.fps_denominator > 0)
+		frameDuration = (double) videoInfo.fps_denominator / (double) videoInfo.fps_numerator;
+
+	std::vector<Frame *> buffers = freeFrames;
+	buffers.push_back(frontBuffer);
 
 	yPlaneXOffset = cPlaneXOffset = videoInfo.pic_x;
 	yPlaneYOffset = cPlaneYOffset = videoInfo.pic_y;
 
 	scaleFormat(videoInfo.pixel_fmt, cPlaneXOffset, cPlaneYOffset);
 
-	for (int i = 0; i < 2; i++)
+	for (size_t i = 0; i < buffers.size(); i++)
 	{
 		buffers[i]->cw = buffers[i]->yw = videoInfo.pic_width;
 		buffers[i]->ch = buffers[i]->yh = videoInfo.pic_height;
@@ -203,15 +217,109 @@ void TheoraVideoStream::seekDecoder(double target)
 	th_decode_ctl(decoder, TH_DECCTL_SET_GRANPOS, &packet.granulepos, sizeof(packet.granulepos));
 }
 
-void TheoraVideoStream::threadedFillBackBuffer(double dt)
+bool TheoraVideoStream::decodeFrame(th_ycbcr_buffer bufferinfo)
 {
+	th_decode_ycbcr_out(decoder, bufferinfo);
+
+	ogg_int64_t decoderPosition;
+	do
+	{
+		if (demuxer.readPacket(packet))
+			return false;
+
+		if (packet.granulepos > 0)
+			th_decode_ctl(decoder, TH_DECCTL_SET_GRANPOS, &packet.granulepos, sizeof(packet.granulepos));
+	} while (th_decode_packetin(decoder, &packet, &decoderPosition) != 0);
+
+	lastFrame = nextFrame;
+	nextFrame = th_granule_time(decoder, decoderPosition);
+	return true;
+}
+
+void TheoraVideoStream::queueFrame(th_ycbcr_buffer bufferinfo, Frame *frame, double time)
+{
+	for (int y = 0; y < frame->yh; ++y)
+	{
+		memcpy(frame->yplane+frame->yw*y,
+				bufferinfo[0].data+
+					bufferinfo[0].stride*(y+yPlaneYOffset)+yPlaneXOffset,
+				frame->yw);
+	}
+
+	for (int y = 0; y < frame->ch; ++y)
+	{
+		memcpy(frame->cbplane+frame->cw*y,
+				bufferinfo[1].data+
+					bufferinfo[1].stride*(y+cPlaneYOffset)+cPlaneXOffset,
+				frame->cw);
+	}
+
+	for (int y = 0; y < frame->ch; ++y)
+	{
+		memcpy(frame->crplane+frame->cw*y,
+				bufferinfo[2].data+
+					bufferinfo[2].stride*(y+cPlaneYOffset)+cPlaneXOffset,
+				frame->cw);
+	}
+
+	love::thread::Lock l(bufferMutex);
+	queuedFrames.push_back({frame, time});
+}
+
+TheoraVideoStream::Frame *TheoraVideoStream::takeFreeFrame(bool recycle)
+{
+	love::thread::Lock l(bufferMutex);
+
+	if (!freeFrames.empty())
+	{
+		Frame *frame = freeFrames.back();
+		freeFrames.pop_back();
+		return frame;
+	}
+
+	// Frames are decoded in order, so the oldest queued one is the first to
+	// be superseded.
+	if (recycle && !queuedFrames.empty())
+	{
+		Frame *frame = queuedFrames.front().frame;
+		queuedFrames.pop_front();
+		return frame;
+	}
+
+	return nullptr;
+}
+
+void TheoraVideoStream::flushFrames()
+{
+	love::thread::Lock l(bufferMutex);
+
+	for (const QueuedFrame &queued : queuedFrames)
+		freeFrames.push_back(queued.frame);
+
+	queuedFrames.clear();
+}
+
+double TheoraVideoStream::threadedFillBackBuffer(double dt)
+{
+	{
+		love::thread::Lock l(bufferMutex);
+		framesConsumed = false;
+	}
+
 	// Synchronize
 	frameSync->update(dt);
 	double position = frameSync->getPosition();
 
-	// Seeking backwards
-	if (position < lastFrame)
+	// Seeking backwards. Frames are decoded ahead, so lastFrame is usually
+	// past the position and can't be used to detect this. Jitter of less
+	// than a frame (e.g. from an audio clock) isn't worth a seek.
+	if (position < lastPosition - frameDuration)
+	{
+		flushFrames();
 		seekDecoder(position);
+	}
+
+	lastPosition = position;
 
 	th_ycbcr_buffer bufferinfo;
 	bool hasFrame = false;
@@ -229,62 +337,59 @@ void TheoraVideoStream::threadedFillBackBuffer(double dt)
 			failedSeek = true;
 		}
 
-		th_decode_ycbcr_out(decoder, bufferinfo);
 		hasFrame = true;
-
-		ogg_int64_t decoderPosition;
-		do
-		{
-			if (demuxer.readPacket(packet))
-				return;
-
-			if (packet.granulepos > 0)
-				th_decode_ctl(decoder, TH_DECCTL_SET_GRANPOS, &packet.granulepos, sizeof(packet.granulepos));
-		} while (th_decode_packetin(decoder, &packet, &decoderPosition) != 0);
-
-		lastFrame = nextFrame;
-		nextFrame = th_granule_time(decoder, decoderPosition);
+		if (!decodeFrame(bufferinfo))
+			return frameDuration;
 	}
 
-	// Only swap once, even if we read many frames to get here
+	// Only queue once, even if we read many frames to get here
 	if (hasFrame)
+		queueFrame(bufferinfo, takeFreeFrame(true), lastFrame);
+
+	// Decode ahead while there's room, so a slow frame doesn't make us late.
+	if (frameSync->isPlaying())
 	{
-		// Don't swap whilst we're writing to the backbuffer
+		while (!demuxer.isEos())
 		{
-			love::thread::Lock l(bufferMutex);
-			frameReady = false;
+			Frame *frame = takeFreeFrame(false);
+			if (frame == nullptr)
+				break;
+
+			if (!decodeFrame(bufferinfo))
+			{
+				love::thread::Lock l(bufferMutex);
+				freeFrames.push_back(frame);
+				break;
+			}
+
+			queueFrame(bufferinfo, frame, lastFrame);
 		}
+	}
 
-		for (int y = 0; y < backBuffer->yh; ++y)
-		{
-			memcpy(backBuffer->yplane+backBuffer->yw*y,
-					bufferinfo[0].data+
-						bufferinfo[0].stride*(y+yPlaneYOffset)+yPlaneXOffset,
-					backBuffer->yw);
-		}
+	// Come back when the oldest queued frame is due, by then it has most
+	// likely been shown and there's room to decode another one.
+	love::thread::Lock l(bufferMutex);
 
-		for (int y = 0; y < backBuffer->ch; ++y)
-		{
-			memcpy(backBuffer->cbplane+backBuffer->cw*y,
-					bufferinfo[1].data+
-						bufferinfo[1].stride*(y+cPlaneYOffset)+cPlaneXOffset,
-					backBuffer->cw);
-		}
+	if (!queuedFrames.empty() && frameSync->isPlaying())
+	{
+		double due = queuedFrames.front().time - position;
+		if (due > 0.0)
+			return std::min(due, frameDuration);
+	}
 
-		for (int y = 0; y < backBuffer->ch; ++y)
-		{
-			memcpy(backBuffer->crplane+backBuffer->cw*y,
-					bufferinfo[2].data+
-						bufferinfo[2].stride*(y+cPlaneYOffset)+cPlaneXOffset,
-					backBuffer->cw);
-		}
+	return frameDuration;
+}
 
-		// Re-enable swapping
-		{
-			love::thread::Lock l(bufferMutex);
-			frameReady = true;
-		}
-	}
+bool TheoraVideoStream::needsFrames()
+{
+	love::thread::Lock l(bufferMutex);
+	return framesConsumed;
+}
+
+void TheoraVideoStream::setWakeup(love::thread::Conditional *wakeup)
+{
+	love::thread::Lock l(bufferMutex);
+	this->wakeup = wakeup;
 }
 
 void TheoraVideoStream::fillBackBuffer()
@@ -294,20 +399,33 @@ void TheoraVideoStream::fillBackBuffer()
 
 bool TheoraVideoStream::swapBuffers()
 {
-	if (demuxer.isEos())
-		return false;
-
 	if (!frameSync->isPlaying())
 		return false;
 
+	double position = frameSync->getPosition();
+
 	love::thread::Lock l(bufferMutex);
-	if (!frameReady)
+
+	// Show the newest frame that's due, and drop any older ones.
+	Frame *frame = nullptr;
+	while (!queuedFrames.empty() && queuedFrames.front().time <= position)
+	{
+		if (frame != nullptr)
+			freeFrames.push_back(frame);
+
+		frame = queuedFrames.front().frame;
+		queuedFrames.pop_front();
+	}
+
+	if (frame == nullptr)
 		return false;
-	frameReady = false;
 
-	Frame *temp = frontBuffer;
-	frontBuffer = backBuffer;
-	backBuffer = temp;
+	freeFrames.push_back(frontBuffer);
+	frontBuffer = frame;
+
+	framesConsumed = true;
+	if (wakeup != nullptr)
+		wakeup->signal();
 
 	return true;
 }
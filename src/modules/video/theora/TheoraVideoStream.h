@@ -29,6 +29,10 @@
 #include "thread/threads.h"
 #include "OggDemuxer.h"
 
+// STL
+#include <deque>
+#include <vector>
+
 // OGG/Theora
 #include <ogg/ogg.h>
 #include <theora/codec.h>
@@ -59,9 +63,36 @@ class TheoraVideoStream : public love::video::VideoStream
 
 	bool isPlaying() const;
 
-	void threadedFillBackBuffer(double dt);
+	/**
+	 * Decodes the frame for the current position, and as many frames after
+	 * it as fit in the queue.
+	 * @param dt Time since the last call.
+	 * @return How long until the stream should be decoded again, in seconds.
+	 **/
+	double threadedFillBackBuffer(double dt);
+
+	/**
+	 * Gets whether frames were consumed since the last threadedFillBackBuffer,
+	 * leaving room to decode more.
+	 **/
+	bool needsFrames();
+
+	/**
+	 * Sets the condition signalled when frames are consumed.
+	 **/
+	void setWakeup(love::thread::Conditional *wakeup);
+
+	// Maximum number of decoded frames waiting to be shown.
+	static const int MAX_QUEUED_FRAMES = 4;
 
 private:
+
+	struct QueuedFrame
+	{
+		Frame *frame;
+		double time;
+	};
+
 	OggDemuxer demuxer;
 
 	bool headerParsed;
@@ -72,20 +103,31 @@ class TheoraVideoStream : public love::video::VideoStream
 	th_dec_ctx *decoder;
 
 	Frame *frontBuffer;
-	Frame *backBuffer;
+
+	// Decoded frames in presentation order, and frames free for decoding.
+	// Guarded by bufferMutex.
+	std::deque<QueuedFrame> queuedFrames;
+	std::vector<Frame *> freeFrames;
 	unsigned int yPlaneXOffset;
 	unsigned int cPlaneXOffset;
 	unsigned int yPlaneYOffset;
 	unsigned int cPlaneYOffset;
 
 	love::thread::MutexRef bufferMutex;
-	bool frameReady;
+	love::thread::Conditional *wakeup;
+	bool framesConsumed;
 
 	double lastFrame;
 	double nextFrame;
+	double lastPosition;
+	double frameDuration;
 
 	void parseHeader();
 	void seekDecoder(double target);
+	bool decodeFrame(th_ycbcr_buffer bufferinfo);
+	void queueFrame(th_ycbcr_buffer bufferinfo, Frame *frame, double time);
+	Frame *takeFreeFrame(bool recycle);
+	void flushFrames();
 }; // TheoraVideoStream
 
 } // theora
@@ -19,12 +19,14 @@
  **/
 
 // STL
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 // LOVE
 #include "Video.h"
-#include "common/delay.h"
 #include "timer/Timer.h"
+#include "common/trace.h"
 
 namespace love
 {
@@ -36,41 +38,48 @@ namespace theora
 Video::Video()
 	: love::video::Video("love.video.theora")
 {
-	workerThread = new Worker();
-	workerThread->start();
+	workers = new WorkerPool(WorkerPool::DEFAULT_THREADS);
 }
 
 Video::~Video()
 {
-	delete workerThread;
+	delete workers;
 }
 
 VideoStream *Video::newVideoStream(love::filesystem::File *file)
 {
 	TheoraVideoStream *stream = new TheoraVideoStream(file);
-	workerThread->addStream(stream);
+	workers->addStream(stream);
 	return stream;
 }
 
-Worker::Worker()
-	: stopping(false)
+Worker::Worker(WorkerPool *pool)
+	: pool(pool)
 {
 	threadName = "VideoWorker";
 }
 
 Worker::~Worker()
 {
-	stop();
 }
 
-void Worker::addStream(TheoraVideoStream *stream)
+void Worker::threadFunction()
 {
-	love::thread::Lock l(mutex);
-	streams.push_back(stream);
-	cond->broadcast();
+	pool->run();
+}
+
+WorkerPool::WorkerPool(int threadCount)
+	: stopping(false)
+{
+	for (int i = 0; i < threadCount; i++)
+	{
+		Worker *worker = new Worker(this);
+		workers.push_back(worker);
+		worker->start();
+	}
 }
 
-void Worker::stop()
+WorkerPool::~WorkerPool()
 {
 	{
 		love::thread::Lock l(mutex);
@@ -78,43 +87,120 @@ void Worker::stop()
 		cond->broadcast();
 	}
 
-	owner->wait();
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		delete worker;
+	}
+
+	// Streams can outlive the module, make sure they don't try to wake us.
+	for (StreamEntry &entry : streams)
+		entry.stream->setWakeup(nullptr);
 }
 
-void Worker::threadFunction()
+void WorkerPool::addStream(TheoraVideoStream *stream)
 {
-	double lastFrame = love::timer::Timer::getTime();
+	love::thread::Lock l(mutex);
 
-	while (true)
+	double now = love::timer::Timer::getTime();
+	streams.push_back({stream, now, now, false});
+
+	stream->setWakeup(cond);
+	cond->broadcast();
+}
+
+int WorkerPool::findDueStream(double now, double &wait)
+{
+	int index = -1;
+	double earliest = std::numeric_limits<double>::infinity();
+
+	for (size_t i = 0; i < streams.size(); i++)
 	{
-		love::sleep(2);
+		const StreamEntry &entry = streams[i];
+		if (entry.busy)
+			continue;
 
-		love::thread::Lock l(mutex);
+		double deadline = entry.deadline;
+
+		// The stream consumed a frame, so it has room to decode another.
+		if (entry.stream->needsFrames())
+			deadline = now;
 
-		while (!stopping && streams.empty())
+		if (deadline < earliest)
 		{
-			cond->wait(mutex);
-			lastFrame = love::timer::Timer::getTime();
+			earliest = deadline;
+			index = (int) i;
 		}
+	}
+
+	if (index >= 0 && earliest > now)
+	{
+		wait = earliest - now;
+		return -1;
+	}
 
-		if (stopping)
-			return;
+	wait = -1.0;
+	return index;
+}
 
-		double curFrame = love::timer::Timer::getTime();
-		double dt = curFrame-lastFrame;
-		lastFrame = curFrame;
+void WorkerPool::run()
+{
+	love::thread::Lock l(mutex);
 
-		for (auto it = streams.begin(); it != streams.end(); ++it)
+	while (!stopping)
+	{
+		// Forget streams nobody else references anymore.
+		for (size_t i = 0; i < streams.size(); i++)
 		{
-			TheoraVideoStream *stream = *it;
-			if (stream->getReferenceCount() == 1)
+			if (!streams[i].busy && streams[i].stream->getReferenceCount() == 1)
 			{
-				// We're the only ones left
-				streams.erase(it);
-				break;
+				streams[i].stream->setWakeup(nullptr);
+				streams.erase(streams.begin() + i);
+				i--;
 			}
+		}
+
+		double now = love::timer::Timer::getTime();
+		double wait = -1.0;
+		int index = findDueStream(now, wait);
 
-			stream->threadedFillBackBuffer(dt);
+		if (index < 0)
+		{
+			// Sleep until the next deadline, or until a stream is added or
+			// consumes a frame. Waiting without a deadline is only done when
+			// there's nothing to decode at all.
+			if (wait >= 0.0)
+				cond->wait(mutex, std::max((int) (wait * 1000.0), 1));
+			else
+				cond->wait(mutex);
+			continue;
+		}
+
+		StreamEntry &entry = streams[index];
+		StrongRef<TheoraVideoStream> stream = entry.stream;
+		double dt = now - entry.lastUpdate;
+
+		entry.busy = true;
+		entry.lastUpdate = now;
+
+		double delay = 0.0;
+		{
+			// Other workers can schedule other streams while this one decodes.
+			mutex->unlock();
+			LOVE_TRACE_ZONE("TheoraVideoStream::threadedFillBackBuffer");
+			delay = stream->threadedFillBackBuffer(dt);
+			mutex->lock();
+		}
+
+		// The list may have changed, find the entry again.
+		for (StreamEntry &e : streams)
+		{
+			if (e.stream.get() == stream.get())
+			{
+				e.busy = false;
+				e.deadline = love::timer::Timer::getTime() + delay;
+				break;
+			}
 		}
 	}
 }
@@ -38,7 +38,7 @@ namespace video
 namespace theora
 {
 
-class Worker;
+class WorkerPool;
 
 class Video : public love::video::Video
 {
@@ -49,31 +49,72 @@ class Video : public love::video::Video
 	VideoStream *newVideoStream(love::filesystem::File* file);
 
 private:
-	Worker *workerThread;
+	WorkerPool *workers;
 }; // Video
 
 class Worker : public love::thread::Threadable
 {
 public:
-	Worker();
+	Worker(WorkerPool *pool);
 	virtual ~Worker();
 
 	// Implements Threadable
 	void threadFunction();
 
+private:
+	WorkerPool *pool;
+}; // Worker
+
+/**
+ * Decodes video streams on a small set of Worker threads. Every stream is
+ * scheduled for when its next frame is due, or earlier when the stream has
+ * room for more decoded frames, so idle workers sleep instead of polling.
+ * Different streams are decoded in parallel, a single stream is only ever
+ * decoded by one worker at a time.
+ **/
+class WorkerPool
+{
+public:
+	WorkerPool(int threadCount);
+	~WorkerPool();
+
 	void addStream(TheoraVideoStream *stream);
-	// Frees itself!
-	void stop();
+
+	static const int DEFAULT_THREADS = 2;
 
 private:
+	friend class Worker;
+
+	struct StreamEntry
+	{
+		StrongRef<TheoraVideoStream> stream;
+
+		// When the stream should be decoded next, and when it last was.
+		double deadline;
+		double lastUpdate;
+
+		// Whether a worker is currently decoding this stream.
+		bool busy;
+	};
 
-	std::vector<StrongRef<TheoraVideoStream>> streams;
+	/**
+	 * Picks the stream with the earliest deadline which is due and not being
+	 * decoded already. The mutex must be held.
+	 * @param wait Set to how long to sleep for if no stream is due.
+	 **/
+	int findDueStream(double now, double &wait);
+
+	// Runs a worker until the pool stops.
+	void run();
+
+	std::vector<StreamEntry> streams;
+	std::vector<Worker *> workers;
 
 	love::thread::MutexRef mutex;
 	love::thread::ConditionalRef cond;
 
 	bool stopping;
-}; // Worker
+}; // WorkerPool
 
 } // theora
 } // video
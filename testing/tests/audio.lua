@@ -150,6 +150,12 @@ love.test.audio.Source = function(test)
   mono:set_rolloff(1)
   test:assert_equals(1, mono:get_rolloff(), 'check rolloff set')
 
+  -- priority
+  test:assert_equals(0, mono:get_priority(), 'check default priority')
+  mono:set_priority(5)
+  test:assert_equals(5, mono:get_priority(), 'check priority set')
+  test:assert_false(mono:is_virtual(), 'check not virtual')
+
   -- create queue source
   local queue = love.audio.new_queueable_source(44100, 16, 1, 3)
   local sdata = love.sound.new_sound_data(1024, 44100, 16, 1)
@@ -332,6 +338,35 @@ love.test.audio.get_recording_devices = function(test)
 end
 
 
+-- love.audio.get_static_cache_limit
+love.test.audio.get_static_cache_limit = function(test)
+  -- check we get a value
+  test:assert_not_nil(love.audio.get_static_cache_limit())
+  -- check setting the limit
+  local limit = love.audio.get_static_cache_limit()
+  love.audio.set_static_cache_limit(1024)
+  test:assert_equals(1024, love.audio.get_static_cache_limit(), 'check limit set')
+  love.audio.set_static_cache_limit(limit)
+end
+
+
+-- love.audio.get_static_cache_usage
+love.test.audio.get_static_cache_usage = function(test)
+  -- static sources from the same file share one cache entry
+  local _, count = love.audio.get_static_cache_usage()
+  local source1 = love.audio.new_source('resources/click.ogg', 'static')
+  local source2 = love.audio.new_source('resources/click.ogg', 'static')
+  local bytes, newcount = love.audio.get_static_cache_usage()
+  test:assert_true(bytes > 0, 'check cache has data')
+  test:assert_range(newcount, math.max(count, 1), count + 1, 'check one entry per file')
+  test:assert_equals(source1:get_duration('samples'), source2:get_duration('samples'), 'check same data')
+  -- stream sources are never cached
+  love.audio.new_source('resources/clickmono.ogg', 'stream')
+  local _, streamcount = love.audio.get_static_cache_usage()
+  test:assert_equals(newcount, streamcount, 'check streams not cached')
+end
+
+
 -- love.audio.get_velocity
 love.test.audio.get_velocity = function(test)
   -- check getting values matches what was set
@@ -343,6 +378,34 @@ love.test.audio.get_velocity = function(test)
 end
 
 
+-- love.audio.get_virtual_source_count
+love.test.audio.get_virtual_source_count = function(test)
+  -- check nothing is virtual by default
+  love.audio.stop()
+  test:assert_equals(0, love.audio.get_virtual_source_count(), 'check none virtual')
+  -- play more sources than there are voices
+  local sources = {}
+  local base = love.audio.new_source('resources/click.ogg', 'static')
+  base:set_looping(true)
+  for i=1,100 do
+    sources[i] = base:clone()
+    -- distinct priorities, so the check doesn't depend on audibility ties
+    sources[i]:set_priority(i)
+    sources[i]:play()
+  end
+  local active = love.audio.get_active_source_count()
+  test:assert_equals(100 - active, love.audio.get_virtual_source_count(), 'check overflow is virtual')
+  -- check the highest priority sources kept their voices and the rest still play
+  for i=1,100 do
+    test:assert_equals(i <= 100 - active, sources[i]:is_virtual(), 'check priority ranks voice ' .. i)
+  end
+  test:assert_true(sources[1]:is_virtual(), 'check low priority virtual')
+  test:assert_true(sources[1]:is_playing(), 'check virtual still playing')
+  love.audio.stop()
+  test:assert_equals(0, love.audio.get_virtual_source_count(), 'check stop clears virtual')
+end
+
+
 -- love.audio.get_volume
 love.test.audio.get_volume = function(test)
   -- check getting values matches what was set
@@ -505,6 +568,20 @@ love.test.audio.set_position = function(test)
 end
 
 
+-- love.audio.set_static_cache_limit
+love.test.audio.set_static_cache_limit = function(test)
+  -- unused data is evicted down to the limit
+  local limit = love.audio.get_static_cache_limit()
+  love.audio.new_source('resources/clickmono.ogg', 'static')
+  collectgarbage('collect')
+  local before = love.audio.get_static_cache_usage()
+  love.audio.set_static_cache_limit(0)
+  local after = love.audio.get_static_cache_usage()
+  test:assert_true(after < before, 'check unused data evicted')
+  love.audio.set_static_cache_limit(limit)
+end
+
+
 -- love.audio.set_velocity
 love.test.audio.set_velocity = function(test)
   -- check setting velocity vals are returned
@@ -303,6 +303,12 @@ love.test.graphics.Font = function(test)
   test:assert_equals(8, #wrappedtext, 'check wrapped lines')
   test:assert_equals('LÖVE is an ', wrappedtext[1], 'check wrapped line')
 
+  -- check shaped text reused from the cache matches
+  local cachedwidth, cachedtext = font:get_wrap('LÖVE is an *awesome* framework you can use to make 2D games in Lua.', 50)
+  test:assert_equals(width, cachedwidth, 'check cached wrap width')
+  test:assert_equals(#wrappedtext, #cachedtext, 'check cached wrapped lines')
+  test:assert_equals(24, font:get_width('test'), 'check cached width')
+
   -- check drawing font 
   local canvas = love.graphics.new_canvas(16, 16)
   love.graphics.set_canvas(canvas)
@@ -325,6 +331,160 @@ love.test.graphics.Font = function(test)
   local imgdata2 = love.graphics.readback_texture(canvas)
   test:compare_img(imgdata2)
 
+  -- check sdf fonts and their effects
+  test:assert_false(font:is_sdf(), 'check regular font')
+  local sdffont = love.graphics.new_font('resources/font.ttf', 32, { sdf = true })
+  test:assert_true(sdffont:is_sdf(), 'check sdf font')
+  test:assert_equals('linear', sdffont:get_filter(), 'check sdf filter')
+  sdffont:set_outline(2, 1, 0, 0, 0.5)
+  sdffont:set_glow(3, {0, 0, 1})
+  local ow, or_, og, ob, oa = sdffont:get_outline()
+  test:assert_equals(2, ow, 'check outline width')
+  test:assert_equals(0.5, oa, 'check outline alpha')
+  local gw, gr, gg, gb, ga = sdffont:get_glow()
+  test:assert_equals(3, gw, 'check glow width')
+  test:assert_equals(1, gb, 'check glow blue')
+  test:assert_equals(1, ga, 'check glow alpha')
+  love.graphics.set_canvas(canvas)
+    love.graphics.clear(0, 0, 0, 0)
+    love.graphics.set_font(sdffont)
+    love.graphics.print('A', 0, 0, 0, 0.5, 0.5)
+  love.graphics.set_canvas()
+  local imgdata3 = love.graphics.readback_texture(canvas)
+  local covered = 0
+  for y=0,15 do
+    for x=0,15 do
+      local _, _, _, a = imgdata3:get_pixel(x, y)
+      if a > 0.5 then covered = covered + 1 end
+    end
+  end
+  test:assert_greater_equal(1, covered, 'check sdf text drawn')
+
+  -- check preloading glyphs in the background
+  local asyncfont = love.graphics.new_font('resources/font.ttf', 8)
+  test:assert_false(asyncfont:is_async(), 'check async def')
+  asyncfont:preload('Aa', {0x30, 0x39}, 0x20AC)
+  local waits = 0
+  while asyncfont:get_pending_glyph_count() > 0 and waits < 200 do
+    love.timer.sleep(0.01)
+    waits = waits + 1
+  end
+  test:assert_equals(0, asyncfont:get_pending_glyph_count(), 'check glyphs preloaded')
+  local ok = pcall(asyncfont.preload, asyncfont, {10, 1})
+  test:assert_false(ok, 'check invalid preload range')
+
+  -- preloaded glyphs draw the same in async mode
+  asyncfont:set_async(true)
+  test:assert_true(asyncfont:is_async(), 'check async set')
+  love.graphics.set_canvas(canvas)
+    love.graphics.clear(0, 0, 0, 0)
+    love.graphics.set_font(asyncfont)
+    love.graphics.print('Aa', 0, 5)
+  love.graphics.set_canvas()
+  local imgdata4 = love.graphics.readback_texture(canvas)
+  local differences = 0
+  for y=0,15 do
+    for x=0,15 do
+      local r1, g1, b1, a1 = imgdata:get_pixel(x, y)
+      local r2, g2, b2, a2 = imgdata4:get_pixel(x, y)
+      if r1 ~= r2 or g1 ~= g2 or b1 ~= b2 or a1 ~= a2 then
+        differences = differences + 1
+      end
+    end
+  end
+  test:assert_equals(0, differences, 'check async text drawn')
+
+  -- check atlas budget and stats
+  local atlasfont = love.graphics.new_font('resources/font.ttf', 8)
+  test:assert_equals(0, atlasfont:get_atlas_budget(), 'check atlas budget def')
+  atlasfont:set_atlas_budget(128, 64)
+  local budgetw, budgeth = atlasfont:get_atlas_budget()
+  test:assert_equals(128, budgetw, 'check atlas budget width')
+  test:assert_equals(64, budgeth, 'check atlas budget height')
+  test:assert_false(pcall(atlasfont.set_atlas_budget, atlasfont, -1), 'check invalid atlas budget')
+  love.graphics.set_canvas(canvas)
+    love.graphics.set_font(atlasfont)
+    love.graphics.print('The quick brown fox jumps over the lazy dog', 0, 0)
+  love.graphics.set_canvas()
+  local stats = atlasfont:get_atlas_stats()
+  test:assert_equals(1, stats.textures, 'check atlas textures')
+  test:assert_greater_equal(26, stats.glyphs, 'check atlas glyphs')
+  test:assert_range(stats.glyphpixels, 1, stats.texturepixels, 'check atlas occupancy')
+  test:assert_equals(0, stats.evictions, 'check atlas evictions')
+
+  -- a budget smaller than the glyphs used evicts the oldest ones
+  local lower = 'abcdefghijklmnopqrstuvwxyz'
+  local upper = 'ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789'
+  local evictfont = love.graphics.new_font('resources/font.ttf', 24)
+  local reffont = love.graphics.new_font('resources/font.ttf', 24)
+  evictfont:set_atlas_budget(128, 128)
+  local lowerwidth = evictfont:get_width(lower)
+  local evictcanvas = love.graphics.new_canvas(64, 32)
+  love.graphics.set_canvas(evictcanvas)
+    love.graphics.set_font(evictfont)
+    love.graphics.print(lower, 0, 0)
+  love.graphics.set_canvas()
+  test:wait_frames(1)
+  love.graphics.set_canvas(evictcanvas)
+    love.graphics.print(upper, 0, 0)
+  love.graphics.set_canvas()
+  test:wait_frames(1)
+  local evictstats = evictfont:get_atlas_stats()
+  test:assert_greater_equal(1, evictstats.evictions, 'check atlas evictions with budget')
+  test:assert_equals(128, evictstats.width, 'check atlas width within budget')
+  test:assert_equals(128, evictstats.height, 'check atlas height within budget')
+  test:assert_equals(lowerwidth, evictfont:get_width(lower), 'check width after eviction')
+  -- evicted glyphs are added back and draw the same as an unbudgeted font
+  love.graphics.set_canvas(evictcanvas)
+    love.graphics.clear(0, 0, 0, 0)
+    love.graphics.set_font(reffont)
+    love.graphics.print('abc', 0, 0)
+  love.graphics.set_canvas()
+  local refdata = love.graphics.readback_texture(evictcanvas)
+  love.graphics.set_canvas(evictcanvas)
+    love.graphics.clear(0, 0, 0, 0)
+    love.graphics.set_font(evictfont)
+    love.graphics.print('abc', 0, 0)
+  love.graphics.set_canvas()
+  local evictdata = love.graphics.readback_texture(evictcanvas)
+  local evictdiffs = 0
+  local drawn = 0
+  for y=0,31 do
+    for x=0,63 do
+      local r1, g1, b1, a1 = refdata:get_pixel(x, y)
+      local r2, g2, b2, a2 = evictdata:get_pixel(x, y)
+      if r1 ~= r2 or g1 ~= g2 or b1 ~= b2 or a1 ~= a2 then
+        evictdiffs = evictdiffs + 1
+      end
+      if a2 > 0 then
+        drawn = drawn + 1
+      end
+    end
+  end
+  test:assert_greater_equal(1, drawn, 'check text drawn after eviction')
+  test:assert_equals(0, evictdiffs, 'check text matches after eviction')
+
+  -- a text batch drawn every frame keeps its glyphs while other text churns
+  local batchfont = love.graphics.new_font('resources/font.ttf', 24)
+  batchfont:set_atlas_budget(128, 128)
+  local batch = love.graphics.new_text_batch(batchfont, 'abcdefghij')
+  local churn = {'ABCDEFGHIJKLMNOPQR', 'STUVWXYZ0123456789'}
+  local batchevictions = 0
+  for frame=1,6 do
+    love.graphics.set_canvas(evictcanvas)
+      local before = batchfont:get_atlas_stats()
+      love.graphics.draw(batch, 0, 0)
+      local after = batchfont:get_atlas_stats()
+      batchevictions = batchevictions + (after.evictions - before.evictions)
+      test:assert_equals(before.glyphs, after.glyphs, 'check batch glyphs kept ' .. frame)
+      love.graphics.set_font(batchfont)
+      love.graphics.print(churn[frame % 2 + 1], 0, 0)
+    love.graphics.set_canvas()
+    test:wait_frames(1)
+  end
+  test:assert_greater_equal(1, batchfont:get_atlas_stats().evictions, 'check other text evicted')
+  test:assert_equals(0, batchevictions, 'check batch draws without evicting')
+
 end
 
 
@@ -1006,6 +1166,74 @@ love.test.graphics.Shader = function(test)
 end
 
 
+-- ShapeBatch (love.graphics.new_shape_batch)
+love.test.graphics.ShapeBatch = function(test)
+
+  -- create batch
+  local batch = love.graphics.new_shape_batch()
+  test:assert_object(batch)
+  test:assert_equals(0, batch:get_entry_count(), 'check initial count')
+
+  -- check colors
+  local r1, g1, b1, a1 = batch:get_color()
+  test:assert_equals(1, r1, 'check initial color r')
+  test:assert_equals(1, g1, 'check initial color g')
+  test:assert_equals(1, b1, 'check initial color b')
+  test:assert_equals(1, a1, 'check initial color a')
+  batch:set_color(1, 0, 0, 1)
+  local r2, g2, b2, a2 = batch:get_color()
+  test:assert_equals(0, g2, 'check set color g')
+
+  -- shapes are recorded without the current transform
+  love.graphics.push()
+  love.graphics.translate(100, 100)
+  test:assert_equals(1, batch:add('rectangle', 'fill', 0, 0, 8, 8), 'check first entry')
+  test:assert_equals(2, batch:add('circle', 'line', 8, 8, 4), 'check second entry')
+  test:assert_equals(3, batch:add('polygon', 'fill', {8, 0, 16, 0, 16, 8}), 'check third entry')
+  test:assert_equals(4, batch:add('line', 0, 15, 16, 15), 'check fourth entry')
+  love.graphics.pop()
+  test:assert_equals(4, batch:get_entry_count(), 'check count')
+
+  -- check drawing the whole batch
+  local canvas = love.graphics.new_canvas(16, 16)
+  love.graphics.set_canvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(batch, 0, 0)
+  love.graphics.set_canvas()
+  local imgdata1 = love.graphics.readback_texture(canvas)
+  local r, g, b = imgdata1:get_pixel(2, 2)
+  test:assert_equals(1, r, 'check rectangle drawn r')
+  test:assert_equals(0, g, 'check rectangle drawn g')
+
+  -- check updating and removing entries
+  batch:set(1, 'rectangle', 'fill', 0, 0, 2, 2)
+  batch:remove(3)
+  test:assert_equals(3, batch:get_entry_count(), 'check removed entry')
+  love.graphics.set_canvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.draw(batch, 0, 0)
+  love.graphics.set_canvas()
+  local imgdata2 = love.graphics.readback_texture(canvas)
+  r, g, b = imgdata2:get_pixel(1, 1)
+  test:assert_equals(1, r, 'check updated rectangle r')
+  r, g, b = imgdata2:get_pixel(4, 4)
+  test:assert_equals(0, r, 'check updated rectangle shrunk')
+  r, g, b = imgdata2:get_pixel(14, 2)
+  test:assert_equals(0, r, 'check removed polygon')
+
+  -- check invalid shapes and indices
+  local ok = pcall(batch.add, batch, 'triangle', 'fill', 0, 0)
+  test:assert_false(ok, 'check invalid shape')
+  ok = pcall(batch.remove, batch, 10)
+  test:assert_false(ok, 'check invalid index')
+
+  -- clear
+  batch:clear()
+  test:assert_equals(0, batch:get_entry_count(), 'check cleared')
+
+end
+
+
 -- SpriteBatch (love.graphics.new_sprite_batch)
 love.test.graphics.SpriteBatch = function(test)
 
@@ -1156,6 +1384,23 @@ love.test.graphics.Text = function(test)
   plaintext:clear()
   test:assert_equals(0, plaintext:get_dimensions(), 'check clearing text')
 
+  -- check updating and removing single entries
+  test:assert_equals(1, plaintext:add('test', 0, 0), 'check first entry')
+  test:assert_equals(2, plaintext:add('more text', 0, 10), 'check second entry')
+  test:assert_equals(3, plaintext:addf('test', 100, 'left', 0, 20), 'check third entry')
+  plaintext:set_entry(2, 'te', 0, 10)
+  test:assert_equals(3, plaintext:get_entry_count(), 'check entry count after set')
+  test:assert_equals(24, plaintext:get_width(1), 'check untouched entry')
+  test:assert_equals(12, plaintext:get_width(2), 'check updated entry')
+  plaintext:set_entryf(1, 'more text', 100, 'left')
+  test:assert_equals(49, plaintext:get_width(1), 'check grown entry')
+  plaintext:remove(2)
+  test:assert_equals(2, plaintext:get_entry_count(), 'check entry count after remove')
+  test:assert_equals(24, plaintext:get_width(2), 'check shifted entry')
+  local ok = pcall(plaintext.remove, plaintext, 3)
+  test:assert_false(ok, 'check invalid entry index')
+  plaintext:clear()
+
   -- check drawing + setting more complex text
   local colortext = love.graphics.new_text_batch(font, {{1, 0, 0, 1}, 'test'})
   test:assert_object(colortext)
@@ -1689,6 +1934,14 @@ love.test.graphics.new_shader = function(test)
 end
 
 
+-- love.graphics.new_shape_batch
+-- @NOTE this is just basic nil checking, objs have their own test method
+love.test.graphics.new_shape_batch = function(test)
+  test:assert_object(love.graphics.new_shape_batch())
+  test:assert_object(love.graphics.new_shape_batch('static'))
+end
+
+
 -- love.graphics.new_sprite_batch
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.new_sprite_batch = function(test)
@@ -1705,6 +1958,33 @@ love.test.graphics.new_text_batch = function(test)
 end
 
 
+-- love.graphics.new_text_layouts
+love.test.graphics.new_text_layouts = function(test)
+  local font = love.graphics.new_font('resources/font.ttf', 8)
+  local paragraphs = {}
+  for i=1,64 do
+    paragraphs[i] = i % 2 == 0 and 'test' or {{1, 0, 0}, 'more ', {0, 1, 0}, 'text'}
+  end
+  local layouts = love.graphics.new_text_layouts(font, paragraphs, 30, 'right')
+  test:assert_equals(64, #layouts, 'check layout count')
+  test:assert_object(layouts[2])
+  -- layouts match the wrapping done by the font
+  local w, lines = font:get_wrap('more text', 30)
+  test:assert_equals(w, layouts[1]:get_width(), 'check layout width')
+  test:assert_equals(#lines, layouts[1]:get_line_count(), 'check layout lines')
+  test:assert_equals(8, layouts[2]:get_height(), 'check layout height')
+  local x, y, lw, lh = layouts[2]:get_line_bounds(1)
+  test:assert_equals(6, x, 'check right aligned line')
+  test:assert_equals(24, lw, 'check line width')
+  -- adding layouts to a batch doesn't change their dimensions
+  local batch = love.graphics.new_text_batch(font)
+  test:assert_equals(1, batch:add(layouts[1], 0, 0), 'check layout entry')
+  test:assert_equals(layouts[1]:get_width(), batch:get_width(1), 'check batch width')
+  batch:set_entry(1, layouts[2])
+  test:assert_equals(24, batch:get_width(1), 'check replaced layout')
+end
+
+
 -- love.graphics.new_texture
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.new_texture = function(test)
@@ -2070,6 +2350,16 @@ love.test.graphics.reset = function(test)
 end
 
 
+-- love.graphics.set_adaptive_stream_buffers_enabled
+love.test.graphics.set_adaptive_stream_buffers_enabled = function(test)
+  test:assert_false(love.graphics.is_adaptive_stream_buffers_enabled(), 'check default')
+  love.graphics.set_adaptive_stream_buffers_enabled(true)
+  test:assert_true(love.graphics.is_adaptive_stream_buffers_enabled(), 'check enabled')
+  love.graphics.set_adaptive_stream_buffers_enabled(false)
+  test:assert_false(love.graphics.is_adaptive_stream_buffers_enabled(), 'check disabled')
+end
+
+
 -- love.graphics.set_background_color
 love.test.graphics.set_background_color = function(test)
   -- check background is set
@@ -2790,7 +3080,9 @@ end
 love.test.graphics.get_stats = function(test)
   local stattypes = {
     'drawcalls', 'canvasswitches', 'texturememory', 'shaderswitches',
-    'drawcallsbatched', 'textures', 'fonts'
+    'drawcallsbatched', 'textures', 'fonts', 'streambuffergrows',
+    'streambufferwaits', 'streambufferwaittime', 'streambufferframes',
+    'framewaittime'
   }
   local stats = love.graphics.get_stats()
   for s=1,#stattypes do
@@ -2807,7 +3099,7 @@ love.test.graphics.get_supported = function(test)
     'clampzero', 'lighten', 'glsl3', 'instancing', 'fullnpot', 
     'pixelshaderhighp', 'shaderderivatives', 'indirectdraw',
     'copytexturetobuffer', 'multicanvasformats', 
-    'clampone', 'glsl4'
+    'clampone', 'glsl4', 'gputimestamps'
   }
   local features = love.graphics.get_supported()
   for g=1,#gfs do
@@ -2816,6 +3108,46 @@ love.test.graphics.get_supported = function(test)
 end
 
 
+-- love.graphics.push_gpu_marker
+-- @NOTE timings are hardware dependent, so only check the marker stack
+love.test.graphics.push_gpu_marker = function(test)
+  local supported = love.graphics.get_supported().gputimestamps
+  if supported then
+    love.graphics.set_gpu_profiling_enabled(true)
+    test:assert_true(love.graphics.is_gpu_profiling_enabled(), 'check profiling enabled')
+  else
+    local ok = pcall(love.graphics.set_gpu_profiling_enabled, true)
+    test:assert_false(ok, 'check unsupported profiling errors')
+  end
+  love.graphics.push_gpu_marker('outer')
+  love.graphics.push_gpu_marker('inner')
+  love.graphics.rectangle('fill', 0, 0, 4, 4)
+  love.graphics.pop_gpu_marker()
+  love.graphics.pop_gpu_marker()
+  local ok = pcall(love.graphics.pop_gpu_marker)
+  test:assert_false(ok, 'check too many pops errors')
+  local timings = love.graphics.get_gpu_timings()
+  test:assert_not_nil(timings)
+  -- resolved timings show up on the trace's GPU track
+  if supported then
+    love.timer.set_tracing_enabled(true)
+    local gputrack = false
+    for _=1,10 do
+      test:wait_frames(1)
+      love.graphics.push_gpu_marker('traced')
+      love.graphics.rectangle('fill', 0, 0, 4, 4)
+      love.graphics.pop_gpu_marker()
+      gputrack = love.timer.get_trace():find('"name":"traced"', 1, true) ~= nil
+      if gputrack then break end
+    end
+    love.timer.set_tracing_enabled(false)
+    test:assert_true(gputrack, 'check gpu zones traced')
+  end
+  love.graphics.set_gpu_profiling_enabled(false)
+  test:assert_false(love.graphics.is_gpu_profiling_enabled(), 'check profiling disabled')
+end
+
+
 -- love.graphics.get_system_limits
 love.test.graphics.get_system_limits = function(test)
   -- cant check values as hardware dependent but we can check the keys in the 
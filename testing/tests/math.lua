@@ -60,6 +60,35 @@ love.test.math.BezierCurve = function(test)
   test:assert_equals(196, #coords1, 'check coords')
   test:assert_equals(20, #coords2, 'check segment coords')
 
+  -- check adaptive rendering follows the tolerance
+  local coarse = curve:render_adaptive(1)
+  local fine = curve:render_adaptive(0.01)
+  test:assert_greater_equal(4, #coarse, 'check adaptive coords')
+  test:assert_greater_equal(#coarse, #fine, 'check finer tolerance adds coords')
+  test:assert_coords({1, 1}, {fine[1], fine[2]}, 'check adaptive start')
+  test:assert_coords({3, 1}, {fine[#fine-1], fine[#fine]}, 'check adaptive end')
+  local line = love.math.new_bezier_curve(0, 0, 5, 5, 10, 10)
+  test:assert_equals(4, #line:render_adaptive(0.01), 'check straight curve coords')
+  local data = love.data.new_byte_data(#fine * 4)
+  test:assert_equals(#fine / 2, curve:render_adaptive(0.01, data), 'check adaptive data count')
+  test:assert_equals(fine[3], data:get_float(8), 'check adaptive data x')
+
+  -- check batch evaluation
+  local samples = curve:evaluate_many({0, 0.25, 1})
+  local ex, ey = curve:evaluate(0.25)
+  test:assert_coords({ex, ey}, {samples[3], samples[4]}, 'check evaluate many')
+  local sampledata = love.data.new_byte_data(11 * 8)
+  test:assert_equals(11, curve:evaluate_many(11, sampledata), 'check evaluate many data')
+  ex, ey = curve:evaluate(0.5)
+  test:assert_range(sampledata:get_float(5 * 8), ex - 0.0001, ex + 0.0001, 'check evenly spaced x')
+
+  -- check rendering many curves at once
+  local points, total, counts = love.math.render_curves({curve, line}, 0.01)
+  test:assert_equals(#fine / 2 + 2, total, 'check curves total')
+  test:assert_equals(#fine / 2, counts[1], 'check curve 1 count')
+  test:assert_equals(2, counts[2], 'check curve 2 count')
+  test:assert_equals(total * 8, points:get_size(), 'check curves data size')
+
   -- check translation values
   px, py = curve:get_control_point(2)
   test:assert_coords({3, 2}, {px, py}, 'check pretransform x/y')
@@ -104,6 +133,39 @@ love.test.math.RandomGenerator = function(test)
   test:assert_not_equals(rng1:random(), rng2:random(), 'check not matching states')
   test:assert_not_equals(rng1:random_normal(), rng2:random_normal(), 'check not matching states')
 
+  -- check bulk fills give the same numbers as single calls
+  rng2:set_state(rng1:get_state())
+  local values = rng1:fill_uniform({}, 100, 5, 10)
+  test:assert_equals(100, #values, 'check table fill count')
+  for i=1,100 do
+    test:assert_equals(rng2:random() * (10 - 5) + 5, values[i], 'check uniform ' .. i)
+  end
+  rng1:fill_normal(values, 3, 2, 50)
+  test:assert_equals(rng2:random_normal(2, 50), values[1], 'check normal 1')
+  test:assert_equals(rng2:random_normal(2, 50), values[2], 'check normal 2')
+  test:assert_equals(rng2:random_normal(2, 50), values[3], 'check normal 3')
+  local ints = love.data.new_byte_data(64 * 4)
+  rng1:fill_integer(ints, 64, -3, 3)
+  for i=0,63 do
+    test:assert_equals(rng2:random(-3, 3), ints:get_int32(i * 4), 'check integer ' .. i)
+  end
+  local floats = love.data.new_byte_data(16 * 4)
+  rng1:fill_uniform(floats, 16)
+  local expected = rng2:random()
+  test:assert_range(floats:get_float(0), expected - 0.000001, expected + 0.000001, 'check float fill')
+  test:assert_equals(false, pcall(rng1.fill_uniform, rng1, floats, 17), 'check data size')
+
+  -- check split streams are reproducible and start where the parent was
+  local rng3 = love.math.new_random_generator(1234)
+  local rng4 = love.math.new_random_generator(1234)
+  local a, b = rng3:split(2)
+  local c = rng4:split()
+  rng4:jump()
+  test:assert_equals(rng4:get_state(), rng3:get_state(), 'check split jumps parent')
+  test:assert_equals(love.math.new_random_generator(1234):random(), a:random(), 'check first stream')
+  test:assert_equals(c:random(), a:random(), 'check matching streams')
+  test:assert_not_equals(a:random(), b:random(), 'check independent streams')
+
 end
 
 
@@ -220,6 +282,51 @@ love.test.math.color_to_bytes = function(test)
 end
 
 
+-- love.math.fill_noise
+love.test.math.fill_noise = function(test)
+  -- a single octave matches the per-sample noise functions
+  local data = love.data.new_byte_data(64 * 48 * 4)
+  love.math.fill_noise(data, 64, 48, { frequency = 0.05, x = 10, y = 20 })
+  for _, p in ipairs({ {0, 0}, {63, 0}, {17, 31}, {63, 47} }) do
+    local x, y = p[1], p[2]
+    local value = data:get_float((y * 64 + x) * 4)
+    local expected = love.math.simplex_noise((x + 10) * 0.05, (y + 20) * 0.05)
+    test:assert_range(value, expected - 0.0001, expected + 0.0001, 'check simplex sample ' .. x .. ',' .. y)
+  end
+  -- the result doesn't depend on threading, and offsets generate neighbours
+  local settings = { type = 'perlin', frequency = 0.03, octaves = 5, gain = 0.6 }
+  local threaded = love.data.new_byte_data(64 * 64 * 4)
+  love.math.fill_noise(threaded, 64, 64, settings)
+  settings.threaded = false
+  settings.y = 32
+  local half = love.data.new_byte_data(64 * 32 * 4)
+  love.math.fill_noise(half, 64, 32, settings)
+  test:assert_equals(threaded:get_float(32 * 64 * 4), half:get_float(0), 'check offset first row')
+  test:assert_equals(threaded:get_float(64 * 64 * 4 - 4), half:get_float(64 * 32 * 4 - 4), 'check offset last row')
+  local minimum, maximum = 1, 0
+  for i = 0, 64 * 64 - 1, 7 do
+    local value = threaded:get_float(i * 4)
+    minimum = math.min(minimum, value)
+    maximum = math.max(maximum, value)
+  end
+  test:assert_greater_equal(0, minimum, 'check fbm minimum')
+  test:assert_less_equal(1, maximum, 'check fbm maximum')
+  -- 3d fields and imagedata targets
+  local volume = love.data.new_byte_data(8 * 8 * 4 * 4)
+  love.math.fill_noise(volume, 8, 8, 4, { frequency = 0.1 })
+  local expected = love.math.simplex_noise(3 * 0.1, 5 * 0.1, 2 * 0.1)
+  local value = volume:get_float(((2 * 8 + 5) * 8 + 3) * 4)
+  test:assert_range(value, expected - 0.0001, expected + 0.0001, 'check 3d sample')
+  local imgdata = love.image.new_image_data(16, 16, 'r32f')
+  love.math.fill_noise(imgdata, { frequency = 0.05 })
+  local r, g, b, a = imgdata:get_pixel(5, 7)
+  expected = love.math.simplex_noise(5 * 0.05, 7 * 0.05)
+  test:assert_range(r, expected - 0.0001, expected + 0.0001, 'check imagedata sample')
+  test:assert_equals(false, pcall(love.math.fill_noise, data, 64, 49), 'check data size')
+  test:assert_equals(false, pcall(love.math.fill_noise, data, 8, 8, { type = 'cubic' }), 'check noise type')
+end
+
+
 -- love.math.gamma_to_linear
 -- @NOTE I tried doing the same formula as the source from MathModule.cpp
 -- but get test failues due to slight differences
@@ -365,4 +472,35 @@ love.test.math.triangulate = function(test)
   local triangles2 = love.math.triangulate({1, 2, 2, 4, 3, 4, 2, 1, 3, 1}) -- weird shape
   test:assert_equals(3, #triangles1, 'check polygon triangles')
   test:assert_equals(3, #triangles2, 'check polygon triangles')
+  -- concave shape with a collinear first corner must not be fanned over its notch
+  local triangles4 = love.math.triangulate({0, 0, 6, 0, 6, 6, 4, 6, 4, 2, 2, 2, 2, 6, 0, 6, 0, 3})
+  local area = 0
+  for _, t in ipairs(triangles4) do
+    area = area + math.abs((t[3] - t[1]) * (t[6] - t[2]) - (t[5] - t[1]) * (t[4] - t[2])) / 2
+  end
+  test:assert_equals(28, area, 'check concave polygon area')
+  -- every path returns the same winding, whatever the input winding
+  local windings = {
+    {0, 0, 0, 1, 1, 1, 1, 0}, -- clockwise convex
+    {0, 0, 1, 0, 1, 1, 0, 1}, -- counter-clockwise convex
+    {0, 0, 0, 6, 2, 6, 2, 2, 4, 2, 4, 6, 6, 6, 6, 0} -- clockwise concave
+  }
+  for i, polygon in ipairs(windings) do
+    for _, t in ipairs(love.math.triangulate(polygon)) do
+      local cross = (t[3] - t[1]) * (t[6] - t[2]) - (t[5] - t[1]) * (t[4] - t[2])
+      test:assert_true(cross > 0, 'check triangle winding ' .. i)
+    end
+  end
+  -- large outline with holes, n + 2h - 2 triangles
+  local outline, hole1, hole2 = {}, {0, 0, 0, 10, 10, 10, 10, 0}, {20, -5, 25, 5, 30, -5}
+  for i = 0, 199 do
+    local angle = i / 200 * math.pi * 2
+    local radius = i % 2 == 0 and 100 or 80
+    table.insert(outline, math.cos(angle) * radius)
+    table.insert(outline, math.sin(angle) * radius)
+  end
+  local triangles3 = love.math.triangulate(outline, {hole1, hole2})
+  test:assert_equals(200 + 7 + 4 - 2, #triangles3, 'check polygon with holes triangles')
+  local ok = pcall(love.math.triangulate, outline, {{200, 200, 300, 200, 300, 300, 200, 300}})
+  test:assert_false(ok, 'check hole outside polygon')
 end
@@ -522,6 +522,19 @@ love.test.physics.World = function(test)
   test:assert_range(world:get_bodies()[1]:getY(), 9, 11, 'check body prop change y')
   test:assert_equals(1, world:get_body_count(), 'check 1 body count')
 
+  -- check bulk transforms match the body
+  local transforms = love.data.new_byte_data(24)
+  test:assert_equals(1, world:get_body_transforms(transforms, nil, true), 'check 1 body transform')
+  local tx, ty, tangle = love.data.unpack('fff', transforms)
+  test:assert_range(tx, 9, 11, 'check body transform x')
+  test:assert_range(ty, 9, 11, 'check body transform y')
+  test:assert_equals(0, tangle, 'check body transform angle')
+  test:assert_equals(1, world:get_body_transforms(transforms, {body1}), 'check body list transform')
+  local otherworld = love.physics.new_world(0, 0, false)
+  local otherbody = love.physics.new_body(otherworld, 0, 0, 'dynamic')
+  test:assert_false(pcall(world.get_body_transforms, world, transforms, {otherbody}), 'check foreign body rejected')
+  otherworld:destroy()
+
   -- check shapes in world
   test:assert_equals(1, #world:get_shapes_in_area(0, 0, 10, 10), 'check shapes in area #1')
   test:assert_equals(0, #world:get_shapes_in_area(20, 20, 30, 30), 'check shapes in area #1')
@@ -532,6 +545,55 @@ love.test.physics.World = function(test)
   world:set_sleeping_allowed(true)
   test:assert_true(world:is_sleeping_allowed(), 'check can sleep')
 
+  -- check threaded stepping gives the same result
+  test:assert_equals(1, world:get_thread_count(), 'check def thread count')
+  -- enough contacts for the narrow phase to be split across threads, with
+  -- callbacks logged to check they're made in the same order
+  local function pile(threads)
+    local pileworld = love.physics.new_world(0, 10, false)
+    pileworld:set_thread_count(threads)
+    local ids, log = {}, {}
+    local function pair(a, b) return ids[a:get_body()] .. ',' .. ids[b:get_body()] end
+    pileworld:set_contact_filter(function(a, b)
+      table.insert(log, 'f' .. pair(a, b))
+      return true
+    end)
+    pileworld:set_callbacks(
+      function(a, b) table.insert(log, 'b' .. pair(a, b)) end,
+      function(a, b) table.insert(log, 'e' .. pair(a, b)) end
+    )
+    local ground = love.physics.new_body(pileworld, 100, 200, 'static')
+    love.physics.new_rectangle_shape(ground, 0, 0, 400, 10)
+    ids[ground] = 0
+    local boxes = {}
+    for i=1,200 do
+      local box = love.physics.new_body(pileworld, (i % 20) * 11, 190 - math.floor(i / 20) * 11, 'dynamic')
+      love.physics.new_rectangle_shape(box, 0, 0, 10, 10)
+      ids[box] = i
+      boxes[i] = box
+    end
+    local contacts = 0
+    for i=1,30 do
+      pileworld:update(1/60)
+      contacts = math.max(contacts, pileworld:get_contact_count())
+    end
+    local positions = {}
+    for i, box in ipairs(boxes) do
+      local x, y = box:get_position()
+      positions[i] = x .. ',' .. y
+    end
+    pileworld:destroy()
+    return table.concat(positions, ';'), table.concat(log, ';'), contacts
+  end
+  local positions1, log1, contacts1 = pile(1)
+  local positions4, log4 = pile(4)
+  test:assert_true(contacts1 >= 64, 'check parallel contact threshold reached')
+  test:assert_equals(positions1, positions4, 'check threaded step positions')
+  test:assert_equals(log1, log4, 'check threaded callback order')
+  world:set_thread_count(2)
+  test:assert_equals(2, world:get_thread_count(), 'check thread count')
+  world:set_thread_count(1)
+
   -- check world objects
   test:assert_equals(0, #world:get_joints(), 'check no joints')
   test:assert_equals(0, world:get_joint_count(), 'check no joints count')
@@ -585,6 +647,17 @@ love.test.physics.World = function(test)
   test:assert_equals(world:ray_cast_closest(0, 0, 200, 200), rectangle1, 'check closest raycast')
   test:assert_not_equals(nil, world:ray_cast_any(0, 0, 200, 200), 'check any raycast')
 
+  -- check batched raycasts and area queries
+  local hits, hitshapes, raycount = world:ray_cast_batch({0, 0, 200, 200, 300, 300, 400, 300})
+  test:assert_equals(2, raycount, 'check batch ray count')
+  test:assert_equals(hitshapes[love.data.unpack('i4', hits) + 1], rectangle1, 'check batch closest raycast')
+  test:assert_equals(-1, love.data.unpack('i4', hits, 25), 'check batch raycast miss')
+  local areas, areashapes, areacount = world:get_shapes_in_areas({0, 0, 10, 10, 20, 20, 30, 30})
+  local first, second, last = love.data.unpack('I4I4I4', areas)
+  test:assert_equals(2, areacount, 'check batch area count')
+  test:assert_equals(1, second - first, 'check batch shapes in area #1')
+  test:assert_equals(0, last - second, 'check batch shapes in area #2')
+
   -- change collision logic
   test:assert_equals(nil, world:get_contact_filter(), 'check def filter')
   world:update(1)
@@ -595,10 +668,74 @@ love.test.physics.World = function(test)
   world:update(1)
   test:assert_equals(1, collisions, 'check collision logic change')
 
+  -- check contact events replace callbacks
+  test:assert_false(world:is_contact_events_enabled(), 'check no contact events')
+  world:set_contact_filter(nil)
+  world:set_contact_events_enabled(true)
+  test:assert_true(world:is_contact_events_enabled(), 'check contact events')
+  body2:set_position(100, 100)
+  world:update(1)
+  body2:set_position(5, 5)
+  world:update(1)
+  local events, eventshapes, count = world:get_contact_events()
+  test:assert_equals(1, collisions, 'check callbacks not called')
+  test:assert_greater_equal(1, count, 'check contact events recorded')
+  test:assert_equals(2, #eventshapes, 'check contact event shapes')
+  test:assert_greater_equal(count * 56, events:get_size(), 'check contact event data size')
+  world:set_contact_events_enabled(false)
+
+  -- check end events from destroying bodies between updates are kept
+  local eventworld = love.physics.new_world(0, 0, false)
+  eventworld:set_contact_events_enabled(true)
+  local eventbody1 = love.physics.new_body(eventworld, 0, 0, 'dynamic')
+  love.physics.new_circle_shape(eventbody1, 0, 0, 10)
+  local eventbody2 = love.physics.new_body(eventworld, 5, 0, 'dynamic')
+  love.physics.new_circle_shape(eventbody2, 0, 0, 10)
+  eventworld:update(1/60)
+  local _, _, begincount = eventworld:get_contact_events()
+  test:assert_greater_equal(1, begincount, 'check begin event recorded')
+  local _, _, readcount = eventworld:get_contact_events()
+  test:assert_equals(0, readcount, 'check events cleared once read')
+  eventbody2:destroy()
+  local enddata, _, endcount = eventworld:get_contact_events()
+  test:assert_equals(1, endcount, 'check end event from destroyed body')
+  test:assert_equals(1, love.data.unpack('I4', enddata), 'check end event type')
+  eventworld:destroy()
+
   -- check gravity
   world:set_gravity(1, 1)
   test:assert_equals(1, world:get_gravity(), 'check grav change')
 
+  -- check state snapshots rewind the simulation
+  local state, statesize = world:save_state()
+  test:assert_equals(statesize, state:get_size(), 'check state size')
+  local sx, sy = body1:get_position()
+  world:update(1)
+  world:update(1)
+  local ex, ey = body1:get_position()
+  test:assert_not_equals(sx, ex, 'check body moved')
+  world:restore_state(state)
+  test:assert_equals(sx, body1:get_x(), 'check restored x')
+  test:assert_equals(sy, body1:get_y(), 'check restored y')
+  world:update(1)
+  world:update(1)
+  test:assert_equals(ex, body1:get_x(), 'check replayed x')
+  test:assert_equals(ey, body1:get_y(), 'check replayed y')
+  love.physics.new_body(world, 0, 0, 'dynamic')
+  test:assert_false(pcall(world.restore_state, world, state), 'check mismatched state')
+  -- same counts aren't enough, the snapshot has to come from this world
+  local twina = love.physics.new_world(0, 10)
+  local twinb = love.physics.new_world(0, 10)
+  local twinbody = love.physics.new_rectangle_body(twina, 'dynamic', 0, 0, 1, 1)
+  love.physics.new_rectangle_body(twinb, 'dynamic', 0, 0, 1, 1)
+  local twinstate = twina:save_state()
+  test:assert_false(pcall(twinb.restore_state, twinb, twinstate), 'check state from other world')
+  twinbody:destroy()
+  love.physics.new_rectangle_body(twina, 'dynamic', 0, 0, 1, 1)
+  test:assert_false(pcall(twina.restore_state, twina, twinstate), 'check state after recreating body')
+  twina:destroy()
+  twinb:destroy()
+
   -- check destruction
   test:assert_false(world:is_destroyed(), 'check not destroyed')
   world:destroy()
@@ -837,3 +974,30 @@ love.test.physics.set_meter = function(test)
   test:assert_equals(100, x, 'check pos x')
   test:assert_equals(100, y, 'check pos y')
 end
+
+
+-- love.physics.update_worlds
+love.test.physics.update_worlds = function(test)
+  -- two worlds with a falling body each, one with a deferred callback
+  local worlds, bodies = {}, {}
+  local begins = 0
+  for i=1,2 do
+    worlds[i] = love.physics.new_world(0, 100, false)
+    love.physics.new_rectangle_shape(love.physics.new_body(worlds[i], 0, 20, 'static'), 0, 0, 100, 10)
+    bodies[i] = love.physics.new_body(worlds[i], 0, 0, 'dynamic')
+    love.physics.new_rectangle_shape(bodies[i], 0, 0, 10, 10)
+  end
+  worlds[1]:set_callbacks(function(a, b, contact)
+    test:assert_false(worlds[1]:is_locked(), 'check callback after update')
+    begins = begins + 1
+  end)
+  for i=1,60 do love.physics.update_worlds(worlds, 1/60) end
+  test:assert_equals(1, begins, 'check deferred begin contact')
+  -- check both worlds stepped the same as each other
+  local x1, y1 = bodies[1]:get_position()
+  local x2, y2 = bodies[2]:get_position()
+  test:assert_range(y1, 5, 15, 'check world 1 updated')
+  test:assert_equals(y1, y2, 'check worlds updated equally')
+  local ok = pcall(love.physics.update_worlds, {worlds[1], worlds[1]}, 1/60)
+  test:assert_false(ok, 'check duplicate worlds')
+end
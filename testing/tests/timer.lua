@@ -37,6 +37,21 @@ love.test.timer.get_time = function(test)
 end
 
 
+-- love.timer.set_tracing_enabled
+love.test.timer.set_tracing_enabled = function(test)
+  love.timer.set_tracing_enabled(true)
+  test:assert_true(love.timer.is_tracing_enabled(), 'check tracing enabled')
+  love.timer.push_trace_zone('test "zone"')
+  love.timer.sleep(0.01)
+  love.timer.pop_trace_zone()
+  love.timer.set_tracing_enabled(false)
+  test:assert_false(love.timer.is_tracing_enabled(), 'check tracing disabled')
+  local trace = love.timer.get_trace()
+  test:assert_true(trace:find('"traceEvents"', 1, true) ~= nil, 'check trace json')
+  test:assert_true(trace:find('test \\"zone\\"', 1, true) ~= nil, 'check zone name escaped')
+end
+
+
 -- love.timer.sleep
 love.test.timer.sleep = function(test)
   local starttime = love.timer.get_time()